@@ -0,0 +1,322 @@
+#include "CDXBVH.h"
+
+#include <algorithm>
+#include <cfloat>
+
+static inline float Min(float a, float b)
+{
+	return a < b ? a : b;
+}
+
+static inline float Max(float a, float b)
+{
+	return a > b ? a : b;
+}
+
+static inline void Subtract(const float * a, const float * b, float * result)
+{
+	result[0] = a[0] - b[0];
+	result[1] = a[1] - b[1];
+	result[2] = a[2] - b[2];
+}
+
+static inline void Cross(const float * a, const float * b, float * result)
+{
+	result[0] = a[1] * b[2] - a[2] * b[1];
+	result[1] = a[2] * b[0] - a[0] * b[2];
+	result[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+static inline float Dot(const float * a, const float * b)
+{
+	return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+static inline void ExpandBounds(float * minimum, float * maximum, const float * point)
+{
+	for (UInt32 axis = 0; axis < 3; axis++) {
+		minimum[axis] = Min(minimum[axis], point[axis]);
+		maximum[axis] = Max(maximum[axis], point[axis]);
+	}
+}
+
+// Slab test, tNear is where the ray enters the box clamped to the origin
+static inline bool IntersectBounds(const float * minimum, const float * maximum, const float * origin, const float * invDir, float maxDist, float & tNear)
+{
+	float t1 = (minimum[0] - origin[0]) * invDir[0];
+	float t2 = (maximum[0] - origin[0]) * invDir[0];
+	float tMin = Min(t1, t2);
+	float tMax = Max(t1, t2);
+
+	t1 = (minimum[1] - origin[1]) * invDir[1];
+	t2 = (maximum[1] - origin[1]) * invDir[1];
+	tMin = Max(tMin, Min(t1, t2));
+	tMax = Min(tMax, Max(t1, t2));
+
+	t1 = (minimum[2] - origin[2]) * invDir[2];
+	t2 = (maximum[2] - origin[2]) * invDir[2];
+	tMin = Max(tMin, Min(t1, t2));
+	tMax = Min(tMax, Max(t1, t2));
+
+	tNear = Max(tMin, 0.0f);
+	return tMax >= tNear && tNear < maxDist;
+}
+
+// Same test as IntersectTriangle in CDXMesh.cpp, t is in units of dir
+static bool IntersectTriangle(const float * origin, const float * dir, const float * v0, const float * v1, const float * v2, float & t)
+{
+	float edge1[3], edge2[3], pvec[3], tvec[3], qvec[3];
+	Subtract(v1, v0, edge1);
+	Subtract(v2, v0, edge2);
+
+	// Near zero means the ray lies in the plane of the triangle
+	Cross(dir, edge2, pvec);
+	float det = Dot(edge1, pvec);
+	if (det > 0)
+		Subtract(origin, v0, tvec);
+	else {
+		Subtract(v0, origin, tvec);
+		det = -det;
+	}
+
+	if (det < 0.0001f)
+		return false;
+
+	float u = Dot(tvec, pvec);
+	if (u < 0.0f || u > det)
+		return false;
+
+	Cross(tvec, edge1, qvec);
+	float v = Dot(dir, qvec);
+	if (v < 0.0f || u + v > det)
+		return false;
+
+	t = Dot(edge2, qvec) * (1.0f / det);
+	return true;
+}
+
+void CDXBVH::Clear()
+{
+	m_nodes.clear();
+	m_faces.clear();
+}
+
+float CDXBVH::FaceCentroid(const float * positions, const CDXMeshFace & face, UInt32 axis) const
+{
+	return Position(positions, face.v1)[axis] + Position(positions, face.v2)[axis] + Position(positions, face.v3)[axis];
+}
+
+void CDXBVH::Build(const float * positions, UInt32 stride, UInt32 vertexCount, const CDXMeshIndex * indices, UInt32 primitiveCount, bool isStrip)
+{
+	Clear();
+	m_stride = stride;
+
+	if (isStrip) {
+		for (UInt32 i = 2; i < primitiveCount; i++) {
+			CDXMeshIndex v1 = indices[i - 2];
+			CDXMeshIndex v2 = indices[i - 1];
+			CDXMeshIndex v3 = indices[i];
+			if (v1 == v2 || v2 == v3 || v3 == v1)
+				continue;
+			if (v1 >= vertexCount || v2 >= vertexCount || v3 >= vertexCount)
+				continue;
+
+			// Every other strip triangle has its winding flipped
+			if (i & 1)
+				m_faces.push_back(CDXMeshFace(v1, v3, v2));
+			else
+				m_faces.push_back(CDXMeshFace(v1, v2, v3));
+		}
+	}
+	else {
+		for (UInt32 f = 0; f < primitiveCount; f++) {
+			const CDXMeshFace * face = (const CDXMeshFace *)&indices[f * 3];
+			if (face->v1 >= vertexCount || face->v2 >= vertexCount || face->v3 >= vertexCount)
+				continue;
+
+			m_faces.push_back(*face);
+		}
+	}
+
+	if (m_faces.empty())
+		return;
+
+	m_nodes.reserve(2 * (m_faces.size() / kMaxLeafFaces) + 1);
+	BuildNode(positions, 0, m_faces.size());
+}
+
+UInt32 CDXBVH::BuildNode(const float * positions, UInt32 start, UInt32 end)
+{
+	UInt32 nodeIndex = m_nodes.size();
+	m_nodes.push_back(Node());
+
+	// Split along the axis where the face centers spread the most
+	float centerMin[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+	float centerMax[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+	for (UInt32 f = start; f < end; f++) {
+		float center[3] = { FaceCentroid(positions, m_faces[f], 0), FaceCentroid(positions, m_faces[f], 1), FaceCentroid(positions, m_faces[f], 2) };
+		ExpandBounds(centerMin, centerMax, center);
+	}
+
+	float extent[3];
+	Subtract(centerMax, centerMin, extent);
+	UInt32 axis = 0;
+	if (extent[1] > extent[0])
+		axis = 1;
+	if (extent[2] > extent[axis])
+		axis = 2;
+
+	if (end - start <= kMaxLeafFaces || extent[axis] <= 0.0f) {
+		Node & node = m_nodes[nodeIndex];
+		node.offset = start;
+		node.count = end - start;
+		FitNode(node, positions);
+		return nodeIndex;
+	}
+
+	UInt32 mid = start + (end - start) / 2;
+	std::nth_element(m_faces.begin() + start, m_faces.begin() + mid, m_faces.begin() + end, [&](const CDXMeshFace & a, const CDXMeshFace & b)
+	{
+		return FaceCentroid(positions, a, axis) < FaceCentroid(positions, b, axis);
+	});
+
+	// Left child always directly follows its parent
+	BuildNode(positions, start, mid);
+	UInt32 right = BuildNode(positions, mid, end);
+
+	Node & node = m_nodes[nodeIndex];
+	node.offset = right;
+	node.count = 0;
+	FitNode(node, positions);
+	return nodeIndex;
+}
+
+void CDXBVH::FitNode(Node & node, const float * positions) const
+{
+	if (node.count == 0) {
+		const Node & left = *(&node + 1);
+		const Node & right = m_nodes[node.offset];
+		for (UInt32 axis = 0; axis < 3; axis++) {
+			node.minimum[axis] = left.minimum[axis];
+			node.maximum[axis] = left.maximum[axis];
+		}
+		ExpandBounds(node.minimum, node.maximum, right.minimum);
+		ExpandBounds(node.minimum, node.maximum, right.maximum);
+		return;
+	}
+
+	for (UInt32 axis = 0; axis < 3; axis++) {
+		node.minimum[axis] = FLT_MAX;
+		node.maximum[axis] = -FLT_MAX;
+	}
+	for (UInt32 f = node.offset; f < node.offset + node.count; f++) {
+		const CDXMeshFace & face = m_faces[f];
+		ExpandBounds(node.minimum, node.maximum, Position(positions, face.v1));
+		ExpandBounds(node.minimum, node.maximum, Position(positions, face.v2));
+		ExpandBounds(node.minimum, node.maximum, Position(positions, face.v3));
+	}
+}
+
+void CDXBVH::Refit(const float * positions)
+{
+	// Children are stored after their parent, walking backwards fits them first
+	for (size_t i = m_nodes.size(); i-- > 0;)
+		FitNode(m_nodes[i], positions);
+}
+
+bool CDXBVH::Intersect(const float * positions, const float * origin, const float * dir, float & dist, CDXMeshFace & face) const
+{
+	if (m_nodes.empty())
+		return false;
+
+	float invDir[3] = { 1.0f / dir[0], 1.0f / dir[1], 1.0f / dir[2] };
+
+	struct StackEntry
+	{
+		UInt32	node;
+		float	tNear;
+	};
+
+	// Median splits keep the depth at log2 of the face count
+	StackEntry stack[64];
+	UInt32 depth = 0;
+
+	float tNear = 0.0f;
+	if (!IntersectBounds(m_nodes[0].minimum, m_nodes[0].maximum, origin, invDir, FLT_MAX, tNear))
+		return false;
+
+	stack[depth].node = 0;
+	stack[depth].tNear = tNear;
+	depth++;
+
+	bool isHit = false;
+	dist = FLT_MAX;
+
+	while (depth > 0)
+	{
+		StackEntry entry = stack[--depth];
+		if (entry.tNear >= dist)
+			continue;
+
+		const Node & node = m_nodes[entry.node];
+		if (node.count > 0) {
+			for (UInt32 f = node.offset; f < node.offset + node.count; f++) {
+				const CDXMeshFace & test = m_faces[f];
+				const float * v0 = Position(positions, test.v1);
+				const float * v1 = Position(positions, test.v2);
+				const float * v2 = Position(positions, test.v3);
+
+				// Skip faces that are in the same direction as the ray
+				float fNormal[3], f1[3], f2[3];
+				Subtract(v1, v0, f1);
+				Subtract(v2, v1, f2);
+				Cross(f1, f2, fNormal);
+				if (Dot(dir, fNormal) >= 0)
+					continue;
+
+				float fDist = -1;
+				if (!IntersectTriangle(origin, dir, v0, v1, v2, fDist))
+					continue;
+
+				if (fDist >= 0 && fDist < dist) {
+					dist = fDist;
+					face = test;
+					isHit = true;
+				}
+			}
+			continue;
+		}
+
+		// Visit the nearer child first so the farther one can be culled
+		UInt32 left = entry.node + 1;
+		UInt32 right = node.offset;
+		float tLeft = 0.0f, tRight = 0.0f;
+		bool hitLeft = IntersectBounds(m_nodes[left].minimum, m_nodes[left].maximum, origin, invDir, dist, tLeft);
+		bool hitRight = IntersectBounds(m_nodes[right].minimum, m_nodes[right].maximum, origin, invDir, dist, tRight);
+
+		if (hitLeft && hitRight) {
+			if (tLeft > tRight) {
+				std::swap(left, right);
+				std::swap(tLeft, tRight);
+			}
+			stack[depth].node = right;
+			stack[depth].tNear = tRight;
+			depth++;
+			stack[depth].node = left;
+			stack[depth].tNear = tLeft;
+			depth++;
+		}
+		else if (hitLeft) {
+			stack[depth].node = left;
+			stack[depth].tNear = tLeft;
+			depth++;
+		}
+		else if (hitRight) {
+			stack[depth].node = right;
+			stack[depth].tNear = tRight;
+			depth++;
+		}
+	}
+
+	return isHit;
+}
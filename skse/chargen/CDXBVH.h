@@ -0,0 +1,55 @@
+#ifndef __CDXBVH__
+#define __CDXBVH__
+
+#pragma once
+
+#include "CDXMeshTypes.h"
+
+#include <vector>
+
+// Bounding volume hierarchy over the triangles of a mesh. Built once from
+// the index data, triangle membership never changes afterwards so vertex
+// edits only need the node bounds refit.
+//
+// Positions are xyz floats, stride floats apart from one vertex to the next,
+// so they can be read straight out of interleaved vertices.
+class CDXBVH
+{
+public:
+	enum
+	{
+		kMaxLeafFaces = 4
+	};
+
+	CDXBVH() : m_stride(3) { }
+
+	// Strip meshes pass their index count as the primitive count
+	void Build(const float * positions, UInt32 stride, UInt32 vertexCount, const CDXMeshIndex * indices, UInt32 primitiveCount, bool isStrip);
+	void Refit(const float * positions);
+	void Clear();
+
+	bool IsEmpty() const { return m_nodes.empty(); }
+
+	// Closest front facing triangle along the ray, dist is in units of dir
+	bool Intersect(const float * positions, const float * origin, const float * dir, float & dist, CDXMeshFace & face) const;
+
+private:
+	struct Node
+	{
+		float	minimum[3];
+		float	maximum[3];
+		UInt32	offset;	// First face of a leaf, right child otherwise
+		UInt32	count;	// Face count, zero for interior nodes
+	};
+
+	const float * Position(const float * positions, CDXMeshIndex i) const { return positions + i * m_stride; }
+	float FaceCentroid(const float * positions, const CDXMeshFace & face, UInt32 axis) const;
+	UInt32 BuildNode(const float * positions, UInt32 start, UInt32 end);
+	void FitNode(Node & node, const float * positions) const;
+
+	UInt32						m_stride;
+	std::vector<Node>			m_nodes;
+	std::vector<CDXMeshFace>	m_faces;
+};
+
+#endif
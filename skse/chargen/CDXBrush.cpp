@@ -4,6 +4,8 @@
 #include "CDXShader.h"
 #include "CDXMaterial.h"
 
+#include <algorithm>
+
 double g_brushProperties[CDXBrush::kBrushTypes][CDXBrush::kBrushProperties][CDXBrush::kBrushPropertyValues];
 
 void CDXBrush::InitGlobals()
@@ -104,9 +106,9 @@ void CDXBasicBrush::EndStroke()
 	m_strokes.clear();
 }
 
-CDXHitIndexMap CDXBasicBrush::GetHitIndices(CDXPickInfo & pickInfo, CDXEditableMesh * mesh)
+void CDXBasicBrush::GetHitIndices(CDXPickInfo & pickInfo, CDXEditableMesh * mesh, CDXHitIndexList & hitIndices)
 {
-	return CDXHitIndexMap();
+	hitIndices.clear();
 }
 
 float CDXBrush::CalculateFalloff(float & dist)
@@ -171,22 +173,29 @@ float CDXBrush::CalculateFalloff(float & dist)
 	return p;*/
 }
 
-CDXHitIndexMap CDXBasicHitBrush::GetHitIndices(CDXPickInfo & pickInfo, CDXEditableMesh * mesh)
+void CDXBasicHitBrush::GetHitIndices(CDXPickInfo & pickInfo, CDXEditableMesh * mesh, CDXHitIndexList & hitIndices)
 {
-	CDXMeshVert * pVertices = mesh->LockVertices();
-	CDXHitIndexMap hitVertex;
-	for (UInt32 i = 0; i < mesh->GetVertexCount(); i++) {
+	hitIndices.clear();
+
+	CDXMeshVert * pVertices = mesh->GetVertices();
+	if (!pVertices)
+		return;
+
+	double radius = m_property[kBrushProperty_Radius][kBrushPropertyValue_Value];
+	mesh->VisitVertices(pickInfo.origin, (float)radius, [&](CDXMeshIndex i)
+	{
 		if (FilterVertex(mesh, pVertices, i))
-			continue;
+			return;
 		CDXVec3 vTest = pVertices[i].Position;
 		CDXVec3 vDiff = pickInfo.origin - vTest;
 		float testRadius = D3DXVec3Length(&vDiff); // Spherical radius
-		if (testRadius <= m_property[kBrushProperty_Radius][kBrushPropertyValue_Value]) {
-			hitVertex.emplace(i, CalculateFalloff(testRadius));
+		if (testRadius <= radius) {
+			hitIndices.push_back(std::make_pair(i, CalculateFalloff(testRadius)));
 		}
-	}
-	mesh->UnlockVertices();
-	return hitVertex;
+	});
+
+	// Strokes apply hits in vertex order
+	std::sort(hitIndices.begin(), hitIndices.end());
 }
 
 bool CDXBasicHitBrush::FilterVertex(CDXEditableMesh * mesh, CDXMeshVert * pVertices, CDXMeshIndex i)
@@ -248,8 +257,8 @@ bool CDXMaskAddBrush::UpdateStroke(CDXPickInfo & pickInfo, CDXEditableMesh * mes
 		if (stroke->IsMirror() != isMirror)
 			continue;
 
-		auto hitVertex = GetHitIndices(pickInfo, stroke->GetMesh());
-		for (auto i : hitVertex) {
+		GetHitIndices(pickInfo, stroke->GetMesh(), m_hitIndices);
+		for (auto & i : m_hitIndices) {
 			CDXStroke::Info strokeInfo;
 			strokeInfo.index = i.first;
 			strokeInfo.strength = m_property[kBrushProperty_Strength][kBrushPropertyValue_Value];
@@ -299,15 +308,15 @@ bool CDXInflateBrush::UpdateStroke(CDXPickInfo & pickInfo, CDXEditableMesh * mes
 		if (stroke->IsMirror() != isMirror)
 			continue;
 
-		auto hitVertex = GetHitIndices(pickInfo, stroke->GetMesh());
+		GetHitIndices(pickInfo, stroke->GetMesh(), m_hitIndices);
 
 		CDXVec3 normal(0, 0, 0);
-		for (auto i : hitVertex) {
+		for (auto & i : m_hitIndices) {
 			normal += mesh->CalculateVertexNormal(i.first);
 		}
 		D3DXVec3Normalize(&normal, &normal);
 
-		for (auto i : hitVertex) {
+		for (auto & i : m_hitIndices) {
 			CDXInflateStroke::InflateInfo strokeInfo;
 			strokeInfo.index = i.first;
 			strokeInfo.strength = m_property[kBrushProperty_Strength][kBrushPropertyValue_Value];
@@ -364,14 +373,9 @@ bool CDXSmoothBrush::UpdateStroke(CDXPickInfo & pickInfo, CDXEditableMesh * mesh
 		if (stroke->IsMirror() != isMirror)
 			continue;
 
-		auto hitVertex = GetHitIndices(pickInfo, stroke->GetMesh());
-		for (auto i : hitVertex) {
-			CDXStroke::Info strokeInfo;
-			strokeInfo.index = i.first;
-			strokeInfo.strength = m_property[kBrushProperty_Strength][kBrushPropertyValue_Value];
-			strokeInfo.falloff = i.second;
-			stroke->Update(&strokeInfo);
-		}
+		// The smooth stroke takes the whole hit set at once
+		GetHitIndices(pickInfo, stroke->GetMesh(), m_hitIndices);
+		std::static_pointer_cast<CDXSmoothStroke>(stroke)->Update(m_hitIndices, m_property[kBrushProperty_Strength][kBrushPropertyValue_Value]);
 	}
 
 	return true;
@@ -396,10 +400,10 @@ bool CDXMoveBrush::BeginStroke(CDXPickInfo & pickInfo, CDXEditableMesh * mesh, b
 
 	CDXStrokePtr stroke = CreateStroke(this, mesh);
 	stroke->SetMirror(isMirror);
-	auto hitIndices = GetHitIndices(pickInfo, mesh);
+	GetHitIndices(pickInfo, mesh, m_hitIndices);
 	auto moveStroke = std::dynamic_pointer_cast<CDXMoveStroke>(stroke);
 	if (moveStroke)
-		moveStroke->SetHitIndices(hitIndices);
+		moveStroke->SetHitIndices(m_hitIndices);
 	stroke->Begin(pickInfo);
 	m_strokes.push_back(stroke);	
 	return true;
@@ -461,7 +465,7 @@ bool CDXMoveBrush::UpdateStroke(CDXPickInfo & pickInfo, CDXEditableMesh * mesh,
 			continue;
 
 		CDXMoveStroke * moveStroke = static_cast<CDXMoveStroke*>(stroke.get());
-		for (auto i : moveStroke->GetHitIndices()) {
+		for (auto & i : moveStroke->GetHitIndices()) {
 			CDXMoveStroke::MoveInfo strokeInfo;
 			strokeInfo.index = i.first;
 			strokeInfo.strength = m_property[kBrushProperty_Strength][kBrushPropertyValue_Value];
@@ -58,7 +58,7 @@ public:
 	float CalculateFalloff(float & dist);
 
 	virtual CDXStrokePtr CreateStroke(CDXBrush * brush, CDXEditableMesh * mesh) = 0;
-	virtual CDXHitIndexMap GetHitIndices(CDXPickInfo & pickInfo, CDXEditableMesh * mesh) = 0;
+	virtual void GetHitIndices(CDXPickInfo & pickInfo, CDXEditableMesh * mesh, CDXHitIndexList & hitIndices) = 0;
 	virtual bool FilterVertex(CDXEditableMesh * mesh, CDXMeshVert * pVertices, CDXMeshIndex i) = 0;
 	virtual bool BeginStroke(CDXPickInfo & pickInfo, CDXEditableMesh * mesh, bool isMirror) = 0;
 	virtual bool UpdateStroke(CDXPickInfo & pickInfo, CDXEditableMesh * mesh, bool isMirror) = 0;
@@ -66,6 +66,7 @@ public:
 
 protected:
 	CDXStrokeList	m_strokes;
+	CDXHitIndexList	m_hitIndices;
 	double			m_property[kBrushProperties][kBrushPropertyValues];
 	bool			m_mirror;
 };
@@ -73,7 +74,7 @@ protected:
 class CDXBasicBrush : public CDXBrush
 {
 public:
-	virtual CDXHitIndexMap GetHitIndices(CDXPickInfo & pickInfo, CDXEditableMesh * mesh);
+	virtual void GetHitIndices(CDXPickInfo & pickInfo, CDXEditableMesh * mesh, CDXHitIndexList & hitIndices);
 	virtual bool FilterVertex(CDXEditableMesh * mesh, CDXMeshVert* pVertices, CDXMeshIndex i) { return false; }
 	virtual void EndStroke();
 };
@@ -81,7 +82,7 @@ public:
 class CDXBasicHitBrush : public CDXBasicBrush
 {
 public:
-	virtual CDXHitIndexMap GetHitIndices(CDXPickInfo & pickInfo, CDXEditableMesh * mesh);
+	virtual void GetHitIndices(CDXPickInfo & pickInfo, CDXEditableMesh * mesh, CDXHitIndexList & hitIndices);
 	virtual bool BeginStroke(CDXPickInfo & pickInfo, CDXEditableMesh * mesh, bool isMirror);
 	virtual bool FilterVertex(CDXEditableMesh * mesh, CDXMeshVert * pVertices, CDXMeshIndex i);
 };
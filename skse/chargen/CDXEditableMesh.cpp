@@ -1,6 +1,8 @@
 #include "CDXEditableMesh.h"
 #include "CDXMaterial.h"
 #include "CDXShader.h"
+#include "CDXPicker.h"
+#include "CDXVertexDeltas.h"
 
 CDXEditableMesh::CDXEditableMesh() : CDXMesh()
 {
@@ -10,8 +12,10 @@ CDXEditableMesh::CDXEditableMesh() : CDXMesh()
 
 CDXEditableMesh::~CDXEditableMesh()
 {
-	m_adjacency.clear();
-	m_vertexEdges.clear();
+	m_topology.Clear();
+	m_spatialHash.Clear();
+	m_normals.Clear();
+	m_shadow.Clear();
 }
 
 bool CDXEditableMesh::IsEditable()
@@ -49,20 +53,6 @@ void CDXEditableMesh::SetLocked(bool l)
 	m_locked = l;
 }
 
-void CDXEditableMesh::VisitAdjacencies(CDXMeshIndex i, std::function<bool(CDXMeshFace&)> functor)
-{
-#ifdef CDX_MUTEX
-	std::lock_guard<std::mutex> guard(m_mutex);
-#endif
-	auto it = m_adjacency.find(i);
-	if (it != m_adjacency.end()) {
-		for (auto adj : it->second) {
-			if (functor(adj))
-				break;
-		}
-	}
-}
-
 void CDXEditableMesh::Render(LPDIRECT3DDEVICE9 pDevice, CDXShader * shader)
 {
 	pDevice->SetRenderState(D3DRS_FILLMODE, D3DFILL_SOLID);
@@ -83,39 +73,105 @@ void CDXEditableMesh::Render(LPDIRECT3DDEVICE9 pDevice, CDXShader * shader)
 
 CDXVec3 CDXEditableMesh::CalculateVertexNormal(CDXMeshIndex i)
 {
-	CDXMeshVert* pVertices = NULL;
-	CDXMeshIndex* pIndices = NULL;
+	CDXMeshVert * pVertices = GetVertices();
+	if (!pVertices)
+		return CDXVec3(0, 0, 0);
+
+	CDXVec3 normal;
+	m_normals.Calculate(&pVertices->Position.x, i, &normal.x);
+	return normal;
+}
 
-	D3DXVECTOR3 vNormal(0, 0, 0);
-	LPDIRECT3DVERTEXBUFFER9 pVB = GetVertexBuffer();
-	pVB->Lock(0, 0, (void**)&pVertices, 0);
+bool CDXEditableMesh::Pick(CDXRayInfo & rayInfo, CDXPickInfo & pickInfo)
+{
+	if (!m_bvh) {
+		BuildBVH();
+		// Built from the vertex buffer, which may lag behind the CPU copy
+		m_boundsDirty = true;
+	}
+
+#ifdef CDX_MUTEX
+	std::lock_guard<std::mutex> guard(m_mutex);
+#endif
+	CDXMeshVert * pVertices = GetVertices();
 	if (!pVertices)
-		return vNormal;
-
-	auto it = m_adjacency.find(i);
-	if (it != m_adjacency.end()) {
-		for (auto tri : it->second) {
-			CDXMeshVert * v1 = &pVertices[tri.v1];
-			CDXMeshVert * v2 = &pVertices[tri.v2];
-			CDXMeshVert * v3 = &pVertices[tri.v3];
-
-			D3DXVECTOR3 e1 = *(D3DXVECTOR3*)v2 - *(D3DXVECTOR3*)v1;
-			D3DXVECTOR3 e2 = *(D3DXVECTOR3*)v3 - *(D3DXVECTOR3*)v2;
-			D3DXVec3Cross(&vNormal, &e1, &e2);
-			D3DXVec3Normalize(&vNormal, &vNormal);
-		}
-		D3DXVec3Normalize(&vNormal, &vNormal);
+		return false;
+
+	return PickVertices(pVertices, rayInfo, pickInfo);
+}
+
+CDXMeshVert * CDXEditableMesh::GetVertices()
+{
+	return (CDXMeshVert *)m_shadow.GetData();
+}
+
+void CDXEditableMesh::SetVertices(const CDXMeshVert * vertices, UInt32 vertexCount)
+{
+	m_shadow.Assign(&vertices->Position.x, sizeof(CDXMeshVert) / sizeof(float), vertexCount);
+	m_spatialHash.Build(&vertices->Position.x, sizeof(CDXMeshVert) / sizeof(float), vertexCount);
+}
+
+void CDXEditableMesh::BuildTopology(const CDXMeshFace * faces, UInt32 faceCount)
+{
+	m_topology.Build(faces, faceCount, m_shadow.Size());
+	CDXMeshVert * pVertices = GetVertices();
+	m_normals.Build(&m_topology, pVertices ? &pVertices->Position.x : NULL, sizeof(CDXMeshVert) / sizeof(float));
+}
+
+void CDXEditableMesh::MoveVertex(CDXMeshIndex i, const CDXVec3 & offset)
+{
+	if (!m_shadow.Move(i, &offset.x))
+		return;
+
+	m_spatialHash.Update(i, &GetVertices()[i].Position.x);
+	m_normals.MarkDirty(i);
+	m_boundsDirty = true;
+}
+
+void CDXEditableMesh::MoveVertices(const CDXVertexDeltas & deltas, float multiplier)
+{
+	deltas.Visit([&](CDXMeshIndex i, const float * offset)
+	{
+		MoveVertex(i, CDXVec3(offset) * multiplier);
+	});
+}
+
+void CDXEditableMesh::SetVertexColor(CDXMeshIndex i, CDXColor color)
+{
+	if (i >= m_shadow.Size())
+		return;
+
+	GetVertices()[i].Color = color;
+	m_shadow.MarkDirty(i);
+}
+
+void CDXEditableMesh::UpdateVertexBuffer()
+{
+#ifdef CDX_MUTEX
+	std::lock_guard<std::mutex> guard(m_mutex);
+#endif
+	if (m_normals.IsDirty()) {
+		CDXMeshVert * vertices = GetVertices();
+		for (auto i : m_normals.Update(&vertices->Position.x, &vertices->Normal.x))
+			m_shadow.MarkDirty(i);
 	}
 
-	pVB->Unlock();
-	return vNormal;
+	if (!m_shadow.IsDirty() || !m_vertexBuffer)
+		return;
+
+	// Only the span between the lowest and highest edited vertex is locked
+	UInt32 offset = m_shadow.GetDirtyBegin() * sizeof(CDXMeshVert);
+	UInt32 length = (m_shadow.GetDirtyEnd() - m_shadow.GetDirtyBegin()) * sizeof(CDXMeshVert);
+
+	CDXMeshVert * pVertices = NULL;
+	if (FAILED(m_vertexBuffer->Lock(offset, length, (void**)&pVertices, 0)))
+		return;
+
+	m_shadow.Upload(&pVertices->Position.x);
+	m_vertexBuffer->Unlock();
 }
 
 bool CDXEditableMesh::IsEdgeVertex(CDXMeshIndex i) const
 {
-	auto it = m_vertexEdges.find(i);
-	if (it != m_vertexEdges.end())
-		return true;
-
-	return false;
+	return m_topology.IsEdgeVertex(i);
 }
\ No newline at end of file
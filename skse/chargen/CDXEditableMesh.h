@@ -4,6 +4,10 @@
 #pragma once
 
 #include "CDXMesh.h"
+#include "CDXMeshTopology.h"
+#include "CDXSpatialHash.h"
+#include "CDXVertexNormals.h"
+#include "CDXVertexShadow.h"
 
 #include <vector>
 #include <map>
@@ -14,15 +18,12 @@
 
 typedef std::unordered_map<CDXMeshIndex, CDXColor>	CDXMaskMap;
 typedef std::pair<CDXMeshIndex, CDXColor>			CDXMaskPair;
+typedef std::vector<CDXMaskPair>					CDXMaskList;
 
 typedef std::unordered_map<CDXMeshIndex, CDXVec3>	CDXVectorMap;
 typedef std::pair<CDXMeshIndex, CDXVec3>			CDXVectorPair;
 
-typedef std::vector<CDXMeshFace>					CDXAdjacentList;
-typedef std::map<CDXMeshIndex, CDXAdjacentList>		CDXAdjacencyMap;
-
-typedef std::unordered_map<CDXMeshEdge, UInt32>		CDXEdgeMap;
-typedef std::unordered_set<CDXMeshIndex>			CDXVertexEdgeList;
+class CDXVertexDeltas;
 
 #define COLOR_UNSELECTED	D3DCOLOR_RGBA(255, 255, 255, 255)
 #define COLOR_SELECTED		D3DCOLOR_RGBA(0, 0, 255, 255)
@@ -34,6 +35,7 @@ public:
 	~CDXEditableMesh();
 
 	virtual void Render(LPDIRECT3DDEVICE9 pDevice, CDXShader * shader);
+	virtual bool Pick(CDXRayInfo & rayInfo, CDXPickInfo & pickInfo);
 	virtual bool IsEditable();
 	virtual bool IsLocked();
 
@@ -41,14 +43,60 @@ public:
 	void SetShowWireframe(bool wf);
 	void SetLocked(bool l);
 
-	void VisitAdjacencies(CDXMeshIndex i, std::function<bool(CDXMeshFace&)> functor);
+	// Calls functor(UInt32 faceIndex, const CDXMeshFace &) for every face using the vertex
+	template<typename F>
+	void VisitFaces(CDXMeshIndex i, F functor) const
+	{
+		m_topology.VisitFaces(i, functor);
+	}
+
+	// Calls functor(CDXMeshIndex) for every vertex sharing an edge with i
+	template<typename F>
+	void VisitNeighbors(CDXMeshIndex i, F functor) const
+	{
+		m_topology.VisitNeighbors(i, functor);
+	}
+
 	bool IsEdgeVertex(CDXMeshIndex i) const;
+	const CDXMeshTopology & GetTopology() const { return m_topology; }
 
 	CDXVec3 CalculateVertexNormal(CDXMeshIndex i);
 
+	// Visits every vertex that may lie within radius of center, falls back
+	// to all vertices when the mesh has no spatial hash
+	template<typename F>
+	void VisitVertices(const CDXVec3 & center, float radius, F functor)
+	{
+		if (m_spatialHash.IsEmpty()) {
+			for (UInt32 i = 0; i < m_vertCount; i++)
+				functor((CDXMeshIndex)i);
+			return;
+		}
+
+		m_spatialHash.Visit(&center.x, radius, functor);
+	}
+
+	// CPU copy of the vertex buffer, picking reads it as well. Edits go
+	// through the setters below and reach the vertex buffer in one lock on
+	// the next UpdateVertexBuffer, which also refreshes the normals around
+	// every moved vertex.
+	CDXMeshVert * GetVertices();
+	void MoveVertex(CDXMeshIndex i, const CDXVec3 & offset);
+	// Moves every vertex of the deltas by its offset times multiplier
+	void MoveVertices(const CDXVertexDeltas & deltas, float multiplier);
+	void SetVertexColor(CDXMeshIndex i, CDXColor color);
+	void UpdateVertexBuffer();
+
 protected:
-	CDXAdjacencyMap		m_adjacency;
-	CDXVertexEdgeList	m_vertexEdges;
+	// Copies the initial vertex data, which the vertex buffer already holds
+	void SetVertices(const CDXMeshVert * vertices, UInt32 vertexCount);
+	// Connectivity and normal cache, needs the vertices set first
+	void BuildTopology(const CDXMeshFace * faces, UInt32 faceCount);
+
+	CDXMeshTopology		m_topology;
+	CDXSpatialHash		m_spatialHash;
+	CDXVertexNormals	m_normals;
+	CDXVertexShadow		m_shadow;
 	bool				m_wireframe;
 	bool				m_locked;
 };
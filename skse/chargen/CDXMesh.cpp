@@ -3,6 +3,7 @@
 #include "CDXCamera.h"
 #include "CDXMaterial.h"
 #include "CDXPicker.h"
+#include "CDXBVH.h"
 
 CDXMesh::CDXMesh()
 {
@@ -13,6 +14,8 @@ CDXMesh::CDXMesh()
 	m_visible = true;
 	m_material = NULL;
 	m_primitiveType = D3DPT_TRIANGLELIST;
+	m_bvh = NULL;
+	m_boundsDirty = false;
 
 	D3DXMatrixIdentity(&m_transform);
 }
@@ -40,6 +43,10 @@ void CDXMesh::Release()
 		delete m_material;
 		m_material = NULL;
 	}
+	if(m_bvh) {
+		delete m_bvh;
+		m_bvh = NULL;
+	}
 }
 
 void CDXMesh::SetMaterial(CDXMaterial * material)
@@ -176,59 +183,85 @@ bool IntersectTriangle( const CDXVec3& orig, const CDXVec3& dir, CDXVec3& v0, CD
 	return true;
 }
 
+void CDXMesh::BuildBVH()
+{
+#ifdef CDX_MUTEX
+	std::lock_guard<std::mutex> guard(m_mutex);
+#endif
+	if (!m_vertexBuffer || !m_indexBuffer)
+		return;
+
+	CDXMeshVert* pVertices = NULL;
+	if (FAILED(m_vertexBuffer->Lock(0, 0, (void**)&pVertices, D3DLOCK_READONLY)))
+		return;
+
+	CDXMeshIndex* pIndices = NULL;
+	if (FAILED(m_indexBuffer->Lock(0, 0, (void**)&pIndices, D3DLOCK_READONLY))) {
+		m_vertexBuffer->Unlock();
+		return;
+	}
+
+	if (!m_bvh)
+		m_bvh = new CDXBVH;
+
+	m_bvh->Build(&pVertices->Position.x, sizeof(CDXMeshVert) / sizeof(float), m_vertCount, pIndices, m_primitiveCount, m_primitiveType == D3DPT_TRIANGLESTRIP);
+	m_boundsDirty = false;
+
+	m_indexBuffer->Unlock();
+	m_vertexBuffer->Unlock();
+}
+
 bool CDXMesh::Pick(CDXRayInfo & rayInfo, CDXPickInfo & pickInfo)
 {
+	if (!m_bvh)
+		BuildBVH();
+
 #ifdef CDX_MUTEX
 	std::lock_guard<std::mutex> guard(m_mutex);
 #endif
-	CDXMeshVert* pVertices = LockVertices();
-	CDXMeshIndex* pIndices = LockIndices();
+	if (!m_bvh || !m_vertexBuffer)
+		return false;
 
-	if (!pVertices || !pIndices)
+	// Read only lock so picking doesn't count as an edit
+	CDXMeshVert* pVertices = NULL;
+	if (FAILED(m_vertexBuffer->Lock(0, 0, (void**)&pVertices, D3DLOCK_READONLY)))
 		return false;
 
-	float hitDist = FLT_MAX;
-	CDXVec3 hitNormal(0, 0, 0);
+	bool isHit = PickVertices(pVertices, rayInfo, pickInfo);
+	m_vertexBuffer->Unlock();
+	return isHit;
+}
 
-	// Edges = Face * 3
-	for(UInt32 e = 0; e < m_primitiveCount * 3; e += 3)
-	{
-		CDXVec3 v0 = pVertices[pIndices[e + 0]].Position;
-		CDXVec3 v1 = pVertices[pIndices[e + 1]].Position;
-		CDXVec3 v2 = pVertices[pIndices[e + 2]].Position;
+bool CDXMesh::PickVertices(const CDXMeshVert * pVertices, CDXRayInfo & rayInfo, CDXPickInfo & pickInfo)
+{
+	if (!m_bvh)
+		return false;
 
-		// Calculate the norm of the face
-		CDXVec3 fNormal(0,0,0);
-		CDXVec3 f1 = v1 - v0;
-		CDXVec3 f2 = v2 - v1;
-		D3DXVec3Cross(&fNormal, &f1, &f2);
-		D3DXVec3Normalize(&fNormal, &fNormal);
-
-		// Normalize the direction, just in case
-		CDXVec3 vDir = rayInfo.direction;
-		D3DXVec3Normalize(&vDir, &vDir);
-
-		// Skip faces that are in the same direction as the ray
-		if(D3DXVec3Dot(&vDir, &fNormal) >= 0)
-			continue;
-
-		// Skip face that doesn't intersect with the ray
-		float fDist = -1;
-		float fBary1 = 0;
-		float fBary2 = 0;
-		if (!IntersectTriangle(rayInfo.origin, rayInfo.direction, v0, v1, v2, &fDist, &fBary1, &fBary2))
-			continue;
-
-		if (fDist < hitDist) {
-			hitDist = fDist;
-			hitNormal = fNormal;
-		}
+	// Vertices moved since the last pick, bounds need to follow them
+	if (m_boundsDirty) {
+		m_bvh->Refit(&pVertices->Position.x);
+		m_boundsDirty = false;
 	}
 
+	float hitDist = FLT_MAX;
+	CDXMeshFace hitFace(0, 0, 0);
+	bool isHit = m_bvh->Intersect(&pVertices->Position.x, &rayInfo.origin.x, &rayInfo.direction.x, hitDist, hitFace);
+
 	pickInfo.ray = rayInfo;
 	pickInfo.dist = hitDist;
 
-	if (hitDist != FLT_MAX) {
+	if (isHit) {
+		CDXVec3 v0 = pVertices[hitFace.v1].Position;
+		CDXVec3 v1 = pVertices[hitFace.v2].Position;
+		CDXVec3 v2 = pVertices[hitFace.v3].Position;
+
+		// Calculate the norm of the face
+		CDXVec3 hitNormal(0, 0, 0);
+		CDXVec3 f1 = v1 - v0;
+		CDXVec3 f2 = v2 - v1;
+		D3DXVec3Cross(&hitNormal, &f1, &f2);
+		D3DXVec3Normalize(&hitNormal, &hitNormal);
+
 		CDXVec3 vHit = rayInfo.origin + rayInfo.direction * hitDist;
 		pickInfo.origin = vHit;
 		pickInfo.normal = hitNormal;
@@ -240,8 +273,6 @@ bool CDXMesh::Pick(CDXRayInfo & rayInfo, CDXPickInfo & pickInfo)
 		pickInfo.isHit = false;
 	}
 
-	UnlockVertices();
-	UnlockIndices();
 	return pickInfo.isHit;
 }
 
@@ -271,6 +302,7 @@ CDXMeshIndex* CDXMesh::LockIndices()
 
 void CDXMesh::UnlockVertices()
 {
+	m_boundsDirty = true;
 	m_vertexBuffer->Unlock();
 }
 void CDXMesh::UnlockIndices()
@@ -9,15 +9,16 @@
 #endif
 
 #include <set>
+#include <vector>
+
+#include "CDXMeshTypes.h"
 
 typedef D3DXMATRIX		CDXMatrix;
-typedef unsigned short	CDXMeshIndex;
 typedef D3DXVECTOR3		CDXVec3;
 typedef D3DXVECTOR2		CDXVec2;
 typedef D3DCOLOR		CDXColor;
 
 typedef std::set<CDXMeshIndex> CDXMeshIndexSet;
-typedef std::map<CDXMeshIndex, float> CDXHitIndexMap;
 
 struct CDXMeshEdge
 {
@@ -31,20 +32,6 @@ struct CDXMeshEdge
 	}
 };
 
-struct CDXMeshFace
-{
-	CDXMeshIndex	v1;
-	CDXMeshIndex	v2;
-	CDXMeshIndex	v3;
-
-	CDXMeshFace(CDXMeshIndex _v1, CDXMeshIndex _v2, CDXMeshIndex _v3)
-	{
-		v1 = _v1;
-		v2 = _v2;
-		v3 = _v3;
-	}
-};
-
 namespace std {
 	template<> struct hash < CDXMeshEdge >
 	{
@@ -107,6 +94,7 @@ const static D3DVERTEXELEMENT9 VertexDecl[6] =
 };
 
 class CDXMaterial;
+class CDXBVH;
 class CDXPicker;
 class CDXShader;
 class CDXEditableMesh;
@@ -144,7 +132,15 @@ public:
 	UInt32 GetPrimitiveCount();
 	UInt32 GetVertexCount();
 
+	// Builds the picking hierarchy from the current buffers, any write to
+	// the vertex buffer refits it on the next pick
+	void BuildBVH();
+
 protected:
+	// Refits the hierarchy if needed and casts the ray against pVertices,
+	// which has to match the vertex buffer layout
+	bool PickVertices(const CDXMeshVert * pVertices, CDXRayInfo & rayInfo, CDXPickInfo & pickInfo);
+
 	bool					m_visible;
 	LPDIRECT3DVERTEXBUFFER9	m_vertexBuffer;
 	UInt32					m_vertCount;
@@ -153,6 +149,8 @@ protected:
 	UInt8					m_primitiveType;
 	CDXMaterial				* m_material;
 	CDXMatrix				m_transform;
+	CDXBVH					* m_bvh;
+	bool					m_boundsDirty;
 
 #ifdef CDX_MUTEX
 	std::mutex				m_mutex;
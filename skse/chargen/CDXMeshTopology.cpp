@@ -0,0 +1,80 @@
+#include "CDXMeshTopology.h"
+
+#include <algorithm>
+
+void CDXMeshTopology::Clear()
+{
+	m_faces.clear();
+	m_faceOffsets.clear();
+	m_vertexFaces.clear();
+	m_neighborOffsets.clear();
+	m_neighbors.clear();
+	m_edgeVertex.clear();
+}
+
+void CDXMeshTopology::Build(const CDXMeshFace * faces, UInt32 faceCount, UInt32 vertexCount)
+{
+	Clear();
+
+	// Degenerate faces have no area and would flag false boundary edges
+	m_faces.reserve(faceCount);
+	for (UInt32 f = 0; f < faceCount; f++) {
+		const CDXMeshFace & face = faces[f];
+		if (face.v1 >= vertexCount || face.v2 >= vertexCount || face.v3 >= vertexCount)
+			continue;
+		if (face.v1 == face.v2 || face.v2 == face.v3 || face.v3 == face.v1)
+			continue;
+		m_faces.push_back(face);
+	}
+
+	// Count faces per vertex, prefix sum into offsets, then place them
+	m_faceOffsets.assign(vertexCount + 1, 0);
+	for (auto & face : m_faces) {
+		m_faceOffsets[face.v1 + 1]++;
+		m_faceOffsets[face.v2 + 1]++;
+		m_faceOffsets[face.v3 + 1]++;
+	}
+	for (UInt32 i = 0; i < vertexCount; i++)
+		m_faceOffsets[i + 1] += m_faceOffsets[i];
+
+	m_vertexFaces.resize(m_faceOffsets[vertexCount]);
+	std::vector<UInt32> cursor(m_faceOffsets.begin(), m_faceOffsets.end() - 1);
+	for (UInt32 f = 0; f < m_faces.size(); f++) {
+		const CDXMeshFace & face = m_faces[f];
+		m_vertexFaces[cursor[face.v1]++] = f;
+		m_vertexFaces[cursor[face.v2]++] = f;
+		m_vertexFaces[cursor[face.v3]++] = f;
+	}
+
+	// Every face lists the two other corners of a vertex once, a neighbor
+	// seen only once shares an edge with a single face
+	m_neighborOffsets.assign(vertexCount + 1, 0);
+	m_neighbors.reserve(m_vertexFaces.size());
+	m_edgeVertex.assign(vertexCount, 0);
+
+	std::vector<CDXMeshIndex> corners;
+	for (UInt32 i = 0; i < vertexCount; i++) {
+		corners.clear();
+		for (UInt32 n = m_faceOffsets[i]; n < m_faceOffsets[i + 1]; n++) {
+			const CDXMeshFace & face = m_faces[m_vertexFaces[n]];
+			if (face.v1 != i) corners.push_back(face.v1);
+			if (face.v2 != i) corners.push_back(face.v2);
+			if (face.v3 != i) corners.push_back(face.v3);
+		}
+
+		std::sort(corners.begin(), corners.end());
+		for (UInt32 c = 0; c < corners.size();) {
+			UInt32 run = c + 1;
+			while (run < corners.size() && corners[run] == corners[c])
+				run++;
+
+			if (run - c == 1)
+				m_edgeVertex[i] = 1;
+
+			m_neighbors.push_back(corners[c]);
+			c = run;
+		}
+
+		m_neighborOffsets[i + 1] = m_neighbors.size();
+	}
+}
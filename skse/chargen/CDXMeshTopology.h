@@ -0,0 +1,61 @@
+#ifndef __CDXMESHTOPOLOGY__
+#define __CDXMESHTOPOLOGY__
+
+#pragma once
+
+#include "CDXMeshTypes.h"
+
+#include <vector>
+
+// Vertex to face and vertex to vertex adjacency in compressed rows. Each
+// vertex owns a contiguous run of a flat array, located through an offset
+// array with one extra trailing entry. Built once, sculpting never changes
+// connectivity.
+class CDXMeshTopology
+{
+public:
+	void Build(const CDXMeshFace * faces, UInt32 faceCount, UInt32 vertexCount);
+	void Clear();
+
+	bool IsEmpty() const { return m_faceOffsets.empty(); }
+	UInt32 GetVertexCount() const { return m_faceOffsets.empty() ? 0 : m_faceOffsets.size() - 1; }
+	UInt32 GetFaceCount() const { return m_faces.size(); }
+	const CDXMeshFace & GetFace(UInt32 f) const { return m_faces[f]; }
+
+	// Vertices on an edge used by only one face
+	bool IsEdgeVertex(CDXMeshIndex i) const { return i < m_edgeVertex.size() && m_edgeVertex[i] != 0; }
+
+	// Calls functor(UInt32 faceIndex, const CDXMeshFace &) for every face using the vertex
+	template<typename F>
+	void VisitFaces(CDXMeshIndex i, F functor) const
+	{
+		if (i >= GetVertexCount())
+			return;
+
+		for (UInt32 n = m_faceOffsets[i]; n < m_faceOffsets[i + 1]; n++) {
+			UInt32 f = m_vertexFaces[n];
+			functor(f, m_faces[f]);
+		}
+	}
+
+	// Calls functor(CDXMeshIndex) once for every vertex sharing an edge with i
+	template<typename F>
+	void VisitNeighbors(CDXMeshIndex i, F functor) const
+	{
+		if (i >= GetVertexCount())
+			return;
+
+		for (UInt32 n = m_neighborOffsets[i]; n < m_neighborOffsets[i + 1]; n++)
+			functor(m_neighbors[n]);
+	}
+
+private:
+	std::vector<CDXMeshFace>	m_faces;
+	std::vector<UInt32>			m_faceOffsets;
+	std::vector<UInt32>			m_vertexFaces;
+	std::vector<UInt32>			m_neighborOffsets;
+	std::vector<CDXMeshIndex>	m_neighbors;
+	std::vector<UInt8>			m_edgeVertex;
+};
+
+#endif
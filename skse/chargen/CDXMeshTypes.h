@@ -0,0 +1,29 @@
+#ifndef __CDXMESHTYPES__
+#define __CDXMESHTYPES__
+
+#pragma once
+
+#include <vector>
+#include <utility>
+
+// Index and face types shared with the mesh kernels, which work on plain
+// floats and don't pull in Direct3D
+typedef unsigned short	CDXMeshIndex;
+
+typedef std::vector<std::pair<CDXMeshIndex, float>> CDXHitIndexList;
+
+struct CDXMeshFace
+{
+	CDXMeshIndex	v1;
+	CDXMeshIndex	v2;
+	CDXMeshIndex	v3;
+
+	CDXMeshFace(CDXMeshIndex _v1, CDXMeshIndex _v2, CDXMeshIndex _v3)
+	{
+		v1 = _v1;
+		v2 = _v2;
+		v3 = _v3;
+	}
+};
+
+#endif
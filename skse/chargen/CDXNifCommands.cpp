@@ -18,11 +18,16 @@
 
 #include "skse/PluginAPI.h"
 
+#include "CDXVertexStreams.h"
+
+#include <mutex>
+#include <unordered_set>
+
 extern MorphHandler			g_morphHandler;
 extern SKSETaskInterface	* g_task;
 extern CDXNifScene			g_World;
 
-void ApplyMorphData(NiGeometry * geometry, CDXVectorMap & vectorMap, float multiplier)
+void ApplyMorphData(NiGeometry * geometry, const CDXVertexDeltas & deltas, float multiplier)
 {
 	Actor * actor = g_World.GetWorkingActor();
 	TESNPC * npc = DYNAMIC_CAST(actor->baseForm, TESForm, TESNPC);
@@ -37,20 +42,19 @@ void ApplyMorphData(NiGeometry * geometry, CDXVectorMap & vectorMap, float multi
 			if (sculptHost) {
 				BSFaceGenBaseMorphExtraData * morphData = (BSFaceGenBaseMorphExtraData *)geometry->GetExtraData("FOD");
 				if (morphData) {
-					for (auto it : vectorMap) {
-						// Store it in the NPC mapped data
-						NiPoint3 temp = *(NiPoint3*)&it.second;
-						temp *= multiplier;
+					CDXVectorStreams offsets;
+					deltas.GetOffsets(offsets, multiplier);
 
-						sculptHost->add(std::make_pair(it.first, temp));
+					// Store it in the NPC mapped data
+					const CDXMeshIndex * indices = deltas.GetIndices();
+					for (UInt32 n = 0; n < deltas.Size(); n++)
+						sculptHost->add(std::make_pair(indices[n], NiPoint3(offsets.x[n], offsets.y[n], offsets.z[n])));
 
-						// Write it to FaceGen
-						morphData->vertexData[it.first] += temp;
-					}
+					// Write it to FaceGen
+					CDXScatterAdd((float *)morphData->vertexData, morphData->vertexCount, indices, offsets, 1.0f);
 
 					// Update FaceGen
-					if (g_task)
-						g_task->AddTask(new CRGNTaskUpdateModel(geometry));
+					CRGNTaskUpdateModel::Queue(geometry);
 				}
 			}
 		}
@@ -63,82 +67,43 @@ void AddStrokeCommand(CDXStroke * stroke, NiGeometry * geometry, SInt32 id)
 		g_task->AddUITask(new CRGNUITaskAddStroke(stroke, geometry, id));
 }
 
-void CDXNifInflateStroke::Undo()
+void CDXNifInflateStroke::ApplyDeltas(const CDXVertexDeltas & deltas, float multiplier)
 {
-	CDXInflateStroke::Undo();
+	CDXInflateStroke::ApplyDeltas(deltas, multiplier);
 	CDXNifMesh * nifMesh = static_cast<CDXNifMesh*>(m_mesh);
 	NiGeometry * geometry = nifMesh->GetNifGeometry();
 	if (geometry) {
-		ApplyMorphData(geometry, m_current, -1.0);
+		ApplyMorphData(geometry, deltas, multiplier);
 	}
 }
 
-void CDXNifInflateStroke::Redo()
+void CDXNifDeflateStroke::ApplyDeltas(const CDXVertexDeltas & deltas, float multiplier)
 {
-	CDXInflateStroke::Redo();
+	CDXDeflateStroke::ApplyDeltas(deltas, multiplier);
 	CDXNifMesh * nifMesh = static_cast<CDXNifMesh*>(m_mesh);
 	NiGeometry * geometry = nifMesh->GetNifGeometry();
 	if (geometry) {
-		ApplyMorphData(geometry, m_current, 1.0);
+		ApplyMorphData(geometry, deltas, multiplier);
 	}
 }
 
-void CDXNifDeflateStroke::Undo()
+void CDXNifSmoothStroke::ApplyDeltas(const CDXVertexDeltas & deltas, float multiplier)
 {
-	CDXDeflateStroke::Undo();
+	CDXSmoothStroke::ApplyDeltas(deltas, multiplier);
 	CDXNifMesh * nifMesh = static_cast<CDXNifMesh*>(m_mesh);
 	NiGeometry * geometry = nifMesh->GetNifGeometry();
 	if (geometry) {
-		ApplyMorphData(geometry, m_current, -1.0);
+		ApplyMorphData(geometry, deltas, multiplier);
 	}
 }
 
-void CDXNifDeflateStroke::Redo()
+void CDXNifMoveStroke::ApplyDeltas(const CDXVertexDeltas & deltas, float multiplier)
 {
-	CDXDeflateStroke::Redo();
+	CDXMoveStroke::ApplyDeltas(deltas, multiplier);
 	CDXNifMesh * nifMesh = static_cast<CDXNifMesh*>(m_mesh);
 	NiGeometry * geometry = nifMesh->GetNifGeometry();
 	if (geometry) {
-		ApplyMorphData(geometry, m_current, 1.0);
-	}
-}
-
-void CDXNifSmoothStroke::Undo()
-{
-	CDXSmoothStroke::Undo();
-	CDXNifMesh * nifMesh = static_cast<CDXNifMesh*>(m_mesh);
-	NiGeometry * geometry = nifMesh->GetNifGeometry();
-	if (geometry) {
-		ApplyMorphData(geometry, m_current, -1.0);
-	}
-}
-void CDXNifSmoothStroke::Redo()
-{
-	CDXSmoothStroke::Redo();
-	CDXNifMesh * nifMesh = static_cast<CDXNifMesh*>(m_mesh);
-	NiGeometry * geometry = nifMesh->GetNifGeometry();
-	if (geometry) {
-		ApplyMorphData(geometry, m_current, 1.0);
-	}
-}
-
-void CDXNifMoveStroke::Undo()
-{
-	CDXMoveStroke::Undo();
-	CDXNifMesh * nifMesh = static_cast<CDXNifMesh*>(m_mesh);
-	NiGeometry * geometry = nifMesh->GetNifGeometry();
-	if (geometry) {
-		ApplyMorphData(geometry, m_current, -1.0);
-	}
-}
-
-void CDXNifMoveStroke::Redo()
-{
-	CDXMoveStroke::Redo();
-	CDXNifMesh * nifMesh = static_cast<CDXNifMesh*>(m_mesh);
-	NiGeometry * geometry = nifMesh->GetNifGeometry();
-	if (geometry) {
-		ApplyMorphData(geometry, m_current, 1.0);
+		ApplyMorphData(geometry, deltas, multiplier);
 	}
 }
 
@@ -147,7 +112,7 @@ void CDXNifInflateStroke::Apply(SInt32 i)
 	CDXNifMesh * nifMesh = static_cast<CDXNifMesh*>(m_mesh);
 	NiGeometry * geometry = nifMesh->GetNifGeometry();
 	if (geometry) {
-		ApplyMorphData(geometry, m_current, 1.0);
+		ApplyMorphData(geometry, m_deltas, 1.0);
 		AddStrokeCommand(this, geometry, i);
 	}
 }
@@ -157,7 +122,7 @@ void CDXNifDeflateStroke::Apply(SInt32 i)
 	CDXNifMesh * nifMesh = static_cast<CDXNifMesh*>(m_mesh);
 	NiGeometry * geometry = nifMesh->GetNifGeometry();
 	if (geometry) {
-		ApplyMorphData(geometry, m_current, 1.0);
+		ApplyMorphData(geometry, m_deltas, 1.0);
 		AddStrokeCommand(this, geometry, i);
 	}
 }
@@ -167,7 +132,7 @@ void CDXNifSmoothStroke::Apply(SInt32 i)
 	CDXNifMesh * nifMesh = static_cast<CDXNifMesh*>(m_mesh);
 	NiGeometry * geometry = nifMesh->GetNifGeometry();
 	if (geometry) {
-		ApplyMorphData(geometry, m_current, 1.0);
+		ApplyMorphData(geometry, m_deltas, 1.0);
 		AddStrokeCommand(this, geometry, i);
 	}	
 }
@@ -177,7 +142,7 @@ void CDXNifMoveStroke::Apply(SInt32 i)
 	CDXNifMesh * nifMesh = static_cast<CDXNifMesh*>(m_mesh);
 	NiGeometry * geometry = nifMesh->GetNifGeometry();
 	if (geometry) {
-		ApplyMorphData(geometry, m_current, 1.0);
+		ApplyMorphData(geometry, m_deltas, 1.0);
 		AddStrokeCommand(this, geometry, i);
 	}
 }
@@ -211,21 +176,55 @@ void CDXNifResetMask::Apply(SInt32 i)
 	}
 }
 
+// Geometry with an update task waiting in the queue
+static std::mutex						s_updateLock;
+static std::unordered_set<NiGeometry*>	s_pendingUpdates;
+
+void CRGNTaskUpdateModel::Queue(NiGeometry * geometry)
+{
+	if (!g_task || !geometry)
+		return;
+
+	{
+		std::lock_guard<std::mutex> guard(s_updateLock);
+		if (!s_pendingUpdates.insert(geometry).second)
+			return;
+	}
+
+	CRGNTaskUpdateModel * task = new CRGNTaskUpdateModel(geometry);
+	task->m_pending = true;
+	g_task->AddTask(task);
+}
+
+void CRGNTaskUpdateModel::ClearPending()
+{
+	if (m_pending) {
+		std::lock_guard<std::mutex> guard(s_updateLock);
+		s_pendingUpdates.erase(m_geometry);
+		m_pending = false;
+	}
+}
+
 CRGNTaskUpdateModel::CRGNTaskUpdateModel(NiGeometry * geometry)
 {
 	m_geometry = geometry;
+	m_pending = false;
 	if (m_geometry)
 		m_geometry->IncRef();
 }
 
 void CRGNTaskUpdateModel::Run()
 {
-	if (m_geometry)
+	if (m_geometry) {
+		// Edits from here on need another update
+		ClearPending();
 		UpdateModelFace(m_geometry);
+	}
 }
 
 void CRGNTaskUpdateModel::Dispose()
 {
+	ClearPending();
 	if (m_geometry)
 		m_geometry->DecRef();
 	delete this;
@@ -333,18 +332,21 @@ CDXNifResetSculpt::CDXNifResetSculpt(CDXNifMesh * mesh) : CDXUndoCommand()
 			if (headPart) {
 				auto sculptHost = sculptTarget->GetSculptHost(SculptData::GetHostByPart(headPart), false);
 				if (sculptHost) {
-					CDXMeshVert* pVertices = m_mesh->LockVertices();
+					CDXVectorMap offsets;
+					CDXMeshVert* pVertices = m_mesh->GetVertices();
 					for (auto it : *sculptHost) {
 						// Skip masked vertices
-						if (pVertices[it.first].Color != COLOR_UNSELECTED)
+						if (it.first >= m_mesh->GetVertexCount() || pVertices[it.first].Color != COLOR_UNSELECTED)
 							continue;
 						// Store it in the NPC mapped data
 						CDXVec3 temp = *(CDXVec3*)&it.second;
-						pVertices[it.first].Position -= temp;
-						m_current.emplace(it.first, -temp);
+						offsets.emplace(it.first, -temp);
 					}
 
-					m_mesh->UnlockVertices();
+					// Kept exact so the sculpt data lands on zero
+					m_deltas.Assign(offsets, false);
+					m_mesh->MoveVertices(m_deltas, 1.0f);
+					m_mesh->UpdateVertexBuffer();
 				}
 			}
 		}
@@ -353,7 +355,7 @@ CDXNifResetSculpt::CDXNifResetSculpt(CDXNifMesh * mesh) : CDXUndoCommand()
 
 CDXNifResetSculpt::~CDXNifResetSculpt()
 {
-	m_current.clear();
+	m_deltas.Clear();
 }
 
 CDXUndoCommand::UndoType CDXNifResetSculpt::GetUndoType()
@@ -361,42 +363,42 @@ CDXUndoCommand::UndoType CDXNifResetSculpt::GetUndoType()
 	return kUndoType_ResetSculpt;
 }
 
-void CDXNifResetSculpt::Redo()
+size_t CDXNifResetSculpt::GetMemoryUsage()
 {
-	CDXMeshVert* pVertices = m_mesh->LockVertices();
-	if (!pVertices)
-		return;
+	return sizeof(*this) + m_deltas.GetMemoryUsage();
+}
 
-	// Do what we have now
-	for (auto it : m_current)
-		pVertices[it.first].Position += it.second;
+CDXEditableMesh * CDXNifResetSculpt::GetDeltaMesh()
+{
+	return m_deltas.IsEmpty() ? NULL : m_mesh;
+}
 
-	m_mesh->UnlockVertices();
+const CDXVertexDeltas * CDXNifResetSculpt::GetDeltas()
+{
+	return m_deltas.IsEmpty() ? NULL : &m_deltas;
+}
 
-	CDXNifMesh * nifMesh = static_cast<CDXNifMesh*>(m_mesh);
-	NiGeometry * geometry = nifMesh->GetNifGeometry();
+void CDXNifResetSculpt::ApplyDeltas(const CDXVertexDeltas & deltas, float multiplier)
+{
+	m_mesh->MoveVertices(deltas, multiplier);
+	m_mesh->UpdateVertexBuffer();
+
+	NiGeometry * geometry = m_mesh->GetNifGeometry();
 	if (geometry) {
-		ApplyMorphData(geometry, m_current, 1.0);
+		ApplyMorphData(geometry, deltas, multiplier);
 	}
 }
 
-void CDXNifResetSculpt::Undo()
+void CDXNifResetSculpt::Redo()
 {
-	CDXMeshVert* pVertices = m_mesh->LockVertices();
-	if (!pVertices)
-		return;
+	// Do what we have now
+	ApplyDeltas(m_deltas, 1.0f);
+}
 
+void CDXNifResetSculpt::Undo()
+{
 	// Undo what we did
-	for (auto it : m_current)
-		pVertices[it.first].Position -= it.second;
-
-	m_mesh->UnlockVertices();
-
-	CDXNifMesh * nifMesh = static_cast<CDXNifMesh*>(m_mesh);
-	NiGeometry * geometry = nifMesh->GetNifGeometry();
-	if (geometry) {
-		ApplyMorphData(geometry, m_current, -1.0);
-	}
+	ApplyDeltas(m_deltas, -1.0f);
 }
 
 void CDXNifResetSculpt::Apply(SInt32 i)
@@ -404,7 +406,7 @@ void CDXNifResetSculpt::Apply(SInt32 i)
 	CDXNifMesh * nifMesh = static_cast<CDXNifMesh*>(m_mesh);
 	NiGeometry * geometry = nifMesh->GetNifGeometry();
 	if (geometry) {
-		ApplyMorphData(geometry, m_current, 1.0);
+		ApplyMorphData(geometry, m_deltas, 1.0);
 		if (g_task)
 			g_task->AddUITask(new CRGNUITaskStandardCommand(this, geometry, i));
 	}
@@ -436,7 +438,8 @@ CDXNifImportGeometry::CDXNifImportGeometry(CDXNifMesh * mesh, NiGeometry * sourc
 
 					if (dstData && srcData && dstData->m_usVertices == srcData->m_usVertices) {
 
-						CDXMeshVert* pVertices = m_mesh->LockVertices();
+						CDXVectorMap offsets;
+						CDXMeshVert* pVertices = m_mesh->GetVertices();
 
 						for (UInt32 i = 0; i < srcData->m_usVertices; i++) {
 
@@ -446,13 +449,14 @@ CDXNifImportGeometry::CDXNifImportGeometry(CDXNifMesh * mesh, NiGeometry * sourc
 							NiPoint3 diff = (srcTransform * srcData->m_pkVertex[i]) - (dstTransform * dstData->m_pkVertex[i]);
 							CDXVec3 temp = *(CDXVec3*)&diff;
 
-							pVertices[i].Position += temp;
-
 							// Store it in the action
-							m_current.emplace(i, temp);
+							offsets.emplace(i, temp);
 						}
 
-						m_mesh->UnlockVertices();
+						// Kept exact so the result matches the source geometry
+						m_deltas.Assign(offsets, false);
+						m_mesh->MoveVertices(m_deltas, 1.0f);
+						m_mesh->UpdateVertexBuffer();
 					}
 				}
 			}
@@ -462,7 +466,7 @@ CDXNifImportGeometry::CDXNifImportGeometry(CDXNifMesh * mesh, NiGeometry * sourc
 
 CDXNifImportGeometry::~CDXNifImportGeometry()
 {
-	m_current.clear();
+	m_deltas.Clear();
 }
 
 CDXUndoCommand::UndoType CDXNifImportGeometry::GetUndoType()
@@ -470,42 +474,42 @@ CDXUndoCommand::UndoType CDXNifImportGeometry::GetUndoType()
 	return kUndoType_Import;
 }
 
-void CDXNifImportGeometry::Redo()
+size_t CDXNifImportGeometry::GetMemoryUsage()
 {
-	CDXMeshVert* pVertices = m_mesh->LockVertices();
-	if (!pVertices)
-		return;
+	return sizeof(*this) + m_deltas.GetMemoryUsage();
+}
 
-	// Do what we have now
-	for (auto it : m_current)
-		pVertices[it.first].Position += it.second;
+CDXEditableMesh * CDXNifImportGeometry::GetDeltaMesh()
+{
+	return m_deltas.IsEmpty() ? NULL : m_mesh;
+}
+
+const CDXVertexDeltas * CDXNifImportGeometry::GetDeltas()
+{
+	return m_deltas.IsEmpty() ? NULL : &m_deltas;
+}
 
-	m_mesh->UnlockVertices();
+void CDXNifImportGeometry::ApplyDeltas(const CDXVertexDeltas & deltas, float multiplier)
+{
+	m_mesh->MoveVertices(deltas, multiplier);
+	m_mesh->UpdateVertexBuffer();
 
-	CDXNifMesh * nifMesh = static_cast<CDXNifMesh*>(m_mesh);
-	NiGeometry * geometry = nifMesh->GetNifGeometry();
+	NiGeometry * geometry = m_mesh->GetNifGeometry();
 	if (geometry) {
-		ApplyMorphData(geometry, m_current, 1.0);
+		ApplyMorphData(geometry, deltas, multiplier);
 	}
 }
 
-void CDXNifImportGeometry::Undo()
+void CDXNifImportGeometry::Redo()
 {
-	CDXMeshVert* pVertices = m_mesh->LockVertices();
-	if (!pVertices)
-		return;
+	// Do what we have now
+	ApplyDeltas(m_deltas, 1.0f);
+}
 
+void CDXNifImportGeometry::Undo()
+{
 	// Undo what we did
-	for (auto it : m_current)
-		pVertices[it.first].Position -= it.second;
-
-	m_mesh->UnlockVertices();
-
-	CDXNifMesh * nifMesh = static_cast<CDXNifMesh*>(m_mesh);
-	NiGeometry * geometry = nifMesh->GetNifGeometry();
-	if (geometry) {
-		ApplyMorphData(geometry, m_current, -1.0);
-	}
+	ApplyDeltas(m_deltas, -1.0f);
 }
 
 void CDXNifImportGeometry::Apply(SInt32 i)
@@ -513,7 +517,7 @@ void CDXNifImportGeometry::Apply(SInt32 i)
 	CDXNifMesh * nifMesh = static_cast<CDXNifMesh*>(m_mesh);
 	NiGeometry * geometry = nifMesh->GetNifGeometry();
 	if (geometry) {
-		ApplyMorphData(geometry, m_current, 1.0);
+		ApplyMorphData(geometry, m_deltas, 1.0);
 		if (g_task)
 			g_task->AddUITask(new CRGNUITaskStandardCommand(this, geometry, i));
 	}
@@ -37,8 +37,7 @@ public:
 	CDXNifInflateStroke(CDXBrush * brush, CDXEditableMesh * mesh) : CDXInflateStroke(brush, mesh) { }
 
 	virtual void Apply(SInt32 i);
-	virtual void Undo();
-	virtual void Redo();
+	virtual void ApplyDeltas(const CDXVertexDeltas & deltas, float multiplier);
 };
 
 class CDXNifDeflateStroke : public CDXDeflateStroke
@@ -47,8 +46,7 @@ public:
 	CDXNifDeflateStroke(CDXBrush * brush, CDXEditableMesh * mesh) : CDXDeflateStroke(brush, mesh) { }
 
 	virtual void Apply(SInt32 i);
-	virtual void Undo();
-	virtual void Redo();
+	virtual void ApplyDeltas(const CDXVertexDeltas & deltas, float multiplier);
 };
 
 class CDXNifSmoothStroke : public CDXSmoothStroke
@@ -57,8 +55,7 @@ public:
 	CDXNifSmoothStroke(CDXBrush * brush, CDXEditableMesh * mesh) : CDXSmoothStroke(brush, mesh) { }
 
 	virtual void Apply(SInt32 i);
-	virtual void Undo();
-	virtual void Redo();
+	virtual void ApplyDeltas(const CDXVertexDeltas & deltas, float multiplier);
 };
 
 
@@ -68,14 +65,13 @@ public:
 	CDXNifMoveStroke(CDXBrush * brush, CDXEditableMesh * mesh) : CDXMoveStroke(brush, mesh) { }
 
 	virtual void Apply(SInt32 i);
-	virtual void Undo();
-	virtual void Redo();
+	virtual void ApplyDeltas(const CDXVertexDeltas & deltas, float multiplier);
 };
 
 class CDXNifResetMask : public CDXResetMask
 {
 public:
-	CDXNifResetMask(CDXMesh * mesh) : CDXResetMask(mesh) { }
+	CDXNifResetMask(CDXEditableMesh * mesh) : CDXResetMask(mesh) { }
 
 	virtual void Apply(SInt32 i);
 };
@@ -91,11 +87,16 @@ public:
 	virtual void Redo();
 	virtual void Apply(SInt32 i);
 
-	UInt32 Length() const { return m_current.size(); }
+	virtual size_t GetMemoryUsage();
+	virtual CDXEditableMesh * GetDeltaMesh();
+	virtual const CDXVertexDeltas * GetDeltas();
+	virtual void ApplyDeltas(const CDXVertexDeltas & deltas, float multiplier);
+
+	UInt32 Length() const { return m_deltas.Size(); }
 
 private:
-	CDXNifMesh * m_mesh;
-	CDXVectorMap	m_current;
+	CDXNifMesh		* m_mesh;
+	CDXVertexDeltas	m_deltas;
 };
 
 class CDXNifImportGeometry : public CDXUndoCommand
@@ -109,23 +110,35 @@ public:
 	virtual void Redo();
 	virtual void Apply(SInt32 i);
 
-	UInt32 Length() const { return m_current.size(); }
+	virtual size_t GetMemoryUsage();
+	virtual CDXEditableMesh * GetDeltaMesh();
+	virtual const CDXVertexDeltas * GetDeltas();
+	virtual void ApplyDeltas(const CDXVertexDeltas & deltas, float multiplier);
+
+	UInt32 Length() const { return m_deltas.Size(); }
 
 private:
 	CDXNifMesh		* m_mesh;
-	CDXVectorMap	m_current;
+	CDXVertexDeltas	m_deltas;
 };
 
+// Queue keeps at most one update per geometry waiting, every edit made
+// before the task runs shares that one refresh
 class CRGNTaskUpdateModel : public TaskDelegate
 {
 public:
 	CRGNTaskUpdateModel(NiGeometry * geometry);
 
+	static void Queue(NiGeometry * geometry);
+
 	virtual void Run();
 	virtual void Dispose();
 
 private:
+	void ClearPending();
+
 	NiGeometry * m_geometry;
+	bool m_pending;
 };
 
 class CRGNUITaskAddStroke : public UIDelegate_v1
@@ -1,6 +1,7 @@
 #include "CDXNifMesh.h"
 #include "CDXScene.h"
 #include "CDXShader.h"
+#include "CDXVertexStreams.h"
 
 #include "skse/NiGeometry.h"
 #include "skse/NiRTTI.h"
@@ -133,92 +134,60 @@ CDXNifMesh * CDXNifMesh::Create(LPDIRECT3DDEVICE9 pDevice, NiGeometry * geometry
 				nifMesh->m_indexBuffer = indexBuffer;
 				indexBuffer->Unlock();
 
+				// Transform the positions as streams, then interleave them into the buffer
+				CDXVectorStreams positions;
+				positions.Gather((const float *)geometryData->m_pkVertex, 3, vertCount);
+				positions.Transform((const float *)localTransform.rot.data, (const float *)&localTransform.pos, localTransform.scale);
+
 				vertexBuffer->Lock(0, 0, (void**)&pVertices, 0);
+				positions.Scatter((float *)&pVertices[0].Position, sizeof(CDXMeshVert) / sizeof(float));
 				for (UInt32 i = 0; i < vertCount; i++) {
-					NiPoint3 xformed = localTransform * geometryData->m_pkVertex[i];
 					NiPoint2 uv = geometryData->m_pkTexture[i];
-					pVertices[i].Position = *(D3DXVECTOR3*)&xformed;
 					D3DXVECTOR3 vNormal(0, 0, 0);
 					pVertices[i].Normal = vNormal;
 					pVertices[i].Tex = *(D3DXVECTOR2*)&uv;
 					pVertices[i].Color = COLOR_UNSELECTED;
-
-					// Build adjacency table
-					if (nifMesh->m_morphable) {
-						for (UInt32 f = 0; f < triangleCount; f++) {
-							if (triShapeData) {
-								CDXMeshFace * face = (CDXMeshFace *)&pIndices[f * 3];
-								if (i == face->v1 || i == face->v2 || i == face->v3)
-									nifMesh->m_adjacency[i].push_back(*face);
-							}
-							else if (triStripsData) {
-								UInt16 v1 = 0, v2 = 0, v3 = 0;
-								GetTriangleIndices(triStripsData, f, v1, v2, v3);
-								if (i == v1 || i == v2 || i == v3)
-									nifMesh->m_adjacency[i].push_back(CDXMeshFace(v1, v2, v3));
-							}
-						}
-					}
 				}
 
 				nifMesh->m_vertexBuffer = vertexBuffer;
 
-				// Don't need edge table if not editable
+				// Only need adjacency and vertex normals when it's editable
 				if (nifMesh->m_morphable) {
-					CDXEdgeMap edges;
+					std::vector<CDXMeshFace> faces;
+					faces.reserve(triangleCount);
 					for (UInt32 f = 0; f < triangleCount; f++) {
-
 						if (triShapeData) {
 							CDXMeshFace * face = (CDXMeshFace *)&pIndices[f * 3];
-							auto it = edges.emplace(CDXMeshEdge(min(face->v1, face->v2), max(face->v1, face->v2)), 1);
-							if (it.second == false)
-								it.first->second++;
-							it = edges.emplace(CDXMeshEdge(min(face->v2, face->v3), max(face->v2, face->v3)), 1);
-							if (it.second == false)
-								it.first->second++;
-							it = edges.emplace(CDXMeshEdge(min(face->v3, face->v1), max(face->v3, face->v1)), 1);
-							if (it.second == false)
-								it.first->second++;
+							faces.push_back(*face);
 						}
 						else if (triStripsData) {
 							UInt16 v1 = 0, v2 = 0, v3 = 0;
 							GetTriangleIndices(triStripsData, f, v1, v2, v3);
-							auto it = edges.emplace(CDXMeshEdge(min(v1, v2), max(v1, v2)), 1);
-							if (it.second == false)
-								it.first->second++;
-							it = edges.emplace(CDXMeshEdge(min(v2, v3), max(v2, v3)), 1);
-							if (it.second == false)
-								it.first->second++;
-							it = edges.emplace(CDXMeshEdge(min(v3, v1), max(v3, v1)), 1);
-							if (it.second == false)
-								it.first->second++;
+							faces.push_back(CDXMeshFace(v1, v2, v3));
 						}
 					}
 
-					for (auto e : edges) {
-						if (e.second == 1) {
-							nifMesh->m_vertexEdges.insert(e.first.p1);
-							nifMesh->m_vertexEdges.insert(e.first.p2);
-						}
-					}
-				}
+					nifMesh->SetVertices(pVertices, vertCount);
+					nifMesh->BuildTopology(faces.data(), faces.size());
+
+					// Setup normals, derive them from the faces when the nif has none
+					CDXMeshVert * meshVertices = nifMesh->GetVertices();
+					if (!geometryData->m_pkNormal && meshVertices)
+						nifMesh->m_normals.CalculateAll(&meshVertices->Position.x, &meshVertices->Normal.x);
 
-				// Only need vertex normals when it's editable
-				if (nifMesh->m_morphable) {
 					for (UInt32 i = 0; i < vertCount; i++) {
-						// Setup normals
-						D3DXVECTOR3 vNormal(0, 0, 0);
-						if (!geometryData->m_pkNormal)
-							vNormal = nifMesh->CalculateVertexNormal(i);
-						else
-							vNormal = *(D3DXVECTOR3*)&geometryData->m_pkNormal[i];
-
-						pVertices[i].Normal = vNormal;
+						if (geometryData->m_pkNormal)
+							meshVertices[i].Normal = *(D3DXVECTOR3*)&geometryData->m_pkNormal[i];
+
+						pVertices[i].Normal = meshVertices[i].Normal;
 					}
 				}
 
 				vertexBuffer->Unlock();
 
+				if (nifMesh->m_morphable)
+					nifMesh->BuildBVH();
+
 				CDXMaterial * material = new CDXMaterial;
 				material->SetDiffuseTexture(diffuseTexture);
 				material->SetSpecularColor(D3DXVECTOR3(1.0f, 1.0f, 1.0f));
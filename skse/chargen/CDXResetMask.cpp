@@ -1,23 +1,23 @@
 #include "CDXResetMask.h"
 
-CDXResetMask::CDXResetMask(CDXMesh * mesh)
+CDXResetMask::CDXResetMask(CDXEditableMesh * mesh)
 {
 	m_mesh = mesh;
 
-	CDXMeshVert* pVertices = NULL;
-	LPDIRECT3DVERTEXBUFFER9 pVB = m_mesh->GetVertexBuffer();
+	CDXMeshVert* pVertices = m_mesh->GetVertices();
+	if (!pVertices)
+		return;
 
-	pVB->Lock(0, 0, (void**)&pVertices, 0);
 	for (CDXMeshIndex i = 0; i < m_mesh->GetVertexCount(); i++) {
 		CDXColor unselected = COLOR_UNSELECTED;
 		if (pVertices[i].Color != unselected) {
-			m_previous[i] = pVertices[i].Color;
-			pVertices[i].Color = unselected;
-			m_current[i] = unselected;
+			m_previous.push_back(std::make_pair(i, pVertices[i].Color));
+			m_mesh->SetVertexColor(i, unselected);
+			m_current.push_back(std::make_pair(i, unselected));
 		}
 	}
 
-	pVB->Unlock();
+	m_mesh->UpdateVertexBuffer();
 }
 
 CDXResetMask::~CDXResetMask()
@@ -26,6 +26,11 @@ CDXResetMask::~CDXResetMask()
 	m_previous.clear();
 }
 
+size_t CDXResetMask::GetMemoryUsage()
+{
+	return sizeof(*this) + (m_previous.capacity() + m_current.capacity()) * sizeof(CDXMaskPair);
+}
+
 CDXUndoCommand::UndoType CDXResetMask::GetUndoType()
 {
 	return kUndoType_ResetMask;
@@ -33,32 +38,18 @@ CDXUndoCommand::UndoType CDXResetMask::GetUndoType()
 
 void CDXResetMask::Redo()
 {
-	CDXMeshVert* pVertices = NULL;
-	CDXMeshIndex* pIndices = NULL;
-
-	LPDIRECT3DVERTEXBUFFER9 pVB = m_mesh->GetVertexBuffer();
-
-	pVB->Lock(0, 0, (void**)&pVertices, 0);
-
 	// Do what we have now
-	for (auto it : m_current)
-		pVertices[it.first].Color = it.second;
+	for (auto & it : m_current)
+		m_mesh->SetVertexColor(it.first, it.second);
 
-	pVB->Unlock();
+	m_mesh->UpdateVertexBuffer();
 }
 
 void CDXResetMask::Undo()
 {
-	CDXMeshVert* pVertices = NULL;
-	CDXMeshIndex* pIndices = NULL;
-
-	LPDIRECT3DVERTEXBUFFER9 pVB = m_mesh->GetVertexBuffer();
-
-	pVB->Lock(0, 0, (void**)&pVertices, 0);
-
 	// Undo what we did
-	for (auto it : m_previous)
-		pVertices[it.first].Color = it.second;
+	for (auto & it : m_previous)
+		m_mesh->SetVertexColor(it.first, it.second);
 
-	pVB->Unlock();
+	m_mesh->UpdateVertexBuffer();
 }
\ No newline at end of file
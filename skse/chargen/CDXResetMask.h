@@ -9,17 +9,18 @@
 class CDXResetMask : public CDXUndoCommand
 {
 public:
-	CDXResetMask::CDXResetMask(CDXMesh * mesh);
+	CDXResetMask::CDXResetMask(CDXEditableMesh * mesh);
 	virtual ~CDXResetMask();
 
 	virtual UndoType GetUndoType();
 	virtual void Redo();
 	virtual void Undo();
+	virtual size_t GetMemoryUsage();
 
 protected:
-	CDXMesh		* m_mesh;
-	CDXMaskMap	m_previous;
-	CDXMaskMap	m_current;
+	CDXEditableMesh	* m_mesh;
+	CDXMaskList	m_previous;
+	CDXMaskList	m_current;
 };
 
 #endif
\ No newline at end of file
@@ -278,5 +278,12 @@ bool CDXScene::Pick(int x, int y, CDXPicker & picker)
 		}
 	}
 
+	// Upload everything both strokes changed with one lock per mesh
+	for (auto mesh : m_meshes)
+	{
+		if (mesh->IsEditable())
+			((CDXEditableMesh*)mesh)->UpdateVertexBuffer();
+	}
+
 	return hitVertices;
 }
@@ -0,0 +1,32 @@
+#include "CDXSmooth.h"
+
+void CDXSmoothVertex(const CDXMeshTopology & topology, const float * positions, UInt32 stride, CDXMeshIndex i, float strength, float falloff, float * offset)
+{
+	float target[3] = { 0, 0, 0 };
+	UInt32 totalCount = 0;
+	topology.VisitFaces(i, [&](UInt32, const CDXMeshFace & face)
+	{
+		const float * p1 = positions + face.v1 * stride;
+		const float * p2 = positions + face.v2 * stride;
+		const float * p3 = positions + face.v3 * stride;
+		for (UInt32 k = 0; k < 3; k++)
+			target[k] += (p1[k] + p2[k] + p3[k]) * (1.0f / 3.0f);
+		totalCount++;
+	});
+
+	if (totalCount == 0) {
+		offset[0] = offset[1] = offset[2] = 0.0f;
+		return;
+	}
+
+	const float * position = positions + i * stride;
+	float inverse = 1.0f / totalCount;
+	for (UInt32 k = 0; k < 3; k++)
+		offset[k] = (target[k] * inverse - position[k]) * strength * falloff;
+}
+
+void CDXSmoothHits(const CDXMeshTopology & topology, const float * positions, UInt32 stride, const CDXHitIndexList & hits, size_t begin, size_t end, float strength, float * offsets)
+{
+	for (size_t h = begin; h < end; h++)
+		CDXSmoothVertex(topology, positions, stride, hits[h].first, strength, hits[h].second, offsets + h * 3);
+}
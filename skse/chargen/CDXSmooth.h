@@ -0,0 +1,17 @@
+#ifndef __CDXSMOOTH__
+#define __CDXSMOOTH__
+
+#pragma once
+
+#include "CDXMeshTopology.h"
+
+// Laplacian step of the smooth brush. A vertex moves towards the average
+// centroid of its faces, scaled by strength and falloff. Positions are xyz
+// floats stride floats apart, offsets are written as packed xyz.
+void CDXSmoothVertex(const CDXMeshTopology & topology, const float * positions, UInt32 stride, CDXMeshIndex i, float strength, float falloff, float * offset);
+
+// Offsets of hits [begin, end) into offsets[n * 3]. Only positions are read,
+// so splitting the hits across any number of threads gives the same result.
+void CDXSmoothHits(const CDXMeshTopology & topology, const float * positions, UInt32 stride, const CDXHitIndexList & hits, size_t begin, size_t end, float strength, float * offsets);
+
+#endif
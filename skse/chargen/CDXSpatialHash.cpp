@@ -0,0 +1,151 @@
+#include "CDXSpatialHash.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Cell coordinates are clamped so far away queries can't overflow
+#define SPATIAL_HASH_CELL_LIMIT	(1 << 20)
+
+void CDXSpatialHash::Clear()
+{
+	m_heads.clear();
+	m_next.clear();
+	m_prev.clear();
+	m_bucket.clear();
+	m_visited.clear();
+}
+
+void CDXSpatialHash::Build(const float * positions, UInt32 stride, UInt32 vertexCount)
+{
+	Clear();
+	if (vertexCount == 0)
+		return;
+
+	float minimum[3] = { positions[0], positions[1], positions[2] };
+	float maximum[3] = { positions[0], positions[1], positions[2] };
+	for (UInt32 i = 1; i < vertexCount; i++) {
+		const float * position = positions + i * stride;
+		for (UInt32 axis = 0; axis < 3; axis++) {
+			if (position[axis] < minimum[axis])
+				minimum[axis] = position[axis];
+			if (position[axis] > maximum[axis])
+				maximum[axis] = position[axis];
+		}
+	}
+
+	// Roughly cbrt(n) cells along the longest side, a surface mesh then
+	// averages a handful of vertices per occupied cell
+	float longest = 0.0f;
+	for (UInt32 axis = 0; axis < 3; axis++) {
+		if (maximum[axis] - minimum[axis] > longest)
+			longest = maximum[axis] - minimum[axis];
+	}
+	float cells = (float)pow((double)vertexCount, 1.0 / 3.0);
+	float cellSize = longest / (cells > 1.0f ? cells : 1.0f);
+	if (cellSize <= 0.0f)
+		cellSize = 1.0f;
+	m_invCellSize = 1.0f / cellSize;
+
+	UInt32 bucketCount = 1;
+	while (bucketCount < vertexCount * 2)
+		bucketCount <<= 1;
+	m_mask = bucketCount - 1;
+
+	m_heads.assign(bucketCount, kInvalidIndex);
+	m_next.assign(vertexCount, kInvalidIndex);
+	m_prev.assign(vertexCount, kInvalidIndex);
+	m_bucket.assign(vertexCount, kInvalidIndex);
+
+	for (UInt32 i = 0; i < vertexCount; i++)
+		Link(i, GetBucket(positions + i * stride));
+}
+
+SInt32 CDXSpatialHash::GetCell(float value) const
+{
+	float cell = floor(value * m_invCellSize);
+	if (cell < -SPATIAL_HASH_CELL_LIMIT)
+		return -SPATIAL_HASH_CELL_LIMIT;
+	if (cell > SPATIAL_HASH_CELL_LIMIT)
+		return SPATIAL_HASH_CELL_LIMIT;
+	return (SInt32)cell;
+}
+
+UInt32 CDXSpatialHash::GetBucket(SInt32 x, SInt32 y, SInt32 z) const
+{
+	return (((UInt32)x * 73856093) ^ ((UInt32)y * 19349663) ^ ((UInt32)z * 83492791)) & m_mask;
+}
+
+UInt32 CDXSpatialHash::GetBucket(const float * position) const
+{
+	return GetBucket(GetCell(position[0]), GetCell(position[1]), GetCell(position[2]));
+}
+
+void CDXSpatialHash::Link(UInt32 i, UInt32 bucket)
+{
+	UInt32 head = m_heads[bucket];
+	m_next[i] = head;
+	m_prev[i] = kInvalidIndex;
+	if (head != kInvalidIndex)
+		m_prev[head] = i;
+	m_heads[bucket] = i;
+	m_bucket[i] = bucket;
+}
+
+void CDXSpatialHash::Unlink(UInt32 i)
+{
+	UInt32 next = m_next[i];
+	UInt32 prev = m_prev[i];
+	if (prev != kInvalidIndex)
+		m_next[prev] = next;
+	else
+		m_heads[m_bucket[i]] = next;
+	if (next != kInvalidIndex)
+		m_prev[next] = prev;
+}
+
+void CDXSpatialHash::Update(CDXMeshIndex i, const float * position)
+{
+	if (i >= m_bucket.size())
+		return;
+
+	UInt32 bucket = GetBucket(position);
+	if (bucket == m_bucket[i])
+		return;
+
+	Unlink(i);
+	Link(i, bucket);
+}
+
+void CDXSpatialHash::GatherBuckets(const float * center, float radius) const
+{
+	m_visited.clear();
+	if (m_heads.empty())
+		return;
+
+	SInt32 x0 = GetCell(center[0] - radius), x1 = GetCell(center[0] + radius);
+	SInt32 y0 = GetCell(center[1] - radius), y1 = GetCell(center[1] + radius);
+	SInt32 z0 = GetCell(center[2] - radius), z1 = GetCell(center[2] + radius);
+
+	// Once the sphere covers more cells than there are buckets every bucket
+	// gets visited anyway
+	UInt64 cells = (UInt64)(x1 - x0 + 1) * (UInt64)(y1 - y0 + 1) * (UInt64)(z1 - z0 + 1);
+	if (cells >= m_heads.size()) {
+		for (UInt32 bucket = 0; bucket < m_heads.size(); bucket++)
+			m_visited.push_back(bucket);
+		return;
+	}
+
+	for (SInt32 z = z0; z <= z1; z++) {
+		for (SInt32 y = y0; y <= y1; y++) {
+			for (SInt32 x = x0; x <= x1; x++) {
+				UInt32 bucket = GetBucket(x, y, z);
+				if (m_heads[bucket] != kInvalidIndex)
+					m_visited.push_back(bucket);
+			}
+		}
+	}
+
+	// Different cells can share a bucket, visit each one only once
+	std::sort(m_visited.begin(), m_visited.end());
+	m_visited.erase(std::unique(m_visited.begin(), m_visited.end()), m_visited.end());
+}
@@ -0,0 +1,60 @@
+#ifndef __CDXSPATIALHASH__
+#define __CDXSPATIALHASH__
+
+#pragma once
+
+#include "CDXMeshTypes.h"
+
+#include <vector>
+
+// Hashed uniform grid over vertex positions. Every vertex sits in the
+// bucket of the cell it was last reported in, buckets are intrusive lists
+// so moving a vertex never allocates. Visited vertices are only candidates,
+// callers still test the actual distance. Positions are xyz floats, stride
+// floats apart from one vertex to the next.
+class CDXSpatialHash
+{
+public:
+	enum
+	{
+		kInvalidIndex = 0xFFFFFFFF
+	};
+
+	CDXSpatialHash() : m_invCellSize(1.0f), m_mask(0) { }
+
+	void Build(const float * positions, UInt32 stride, UInt32 vertexCount);
+	void Update(CDXMeshIndex i, const float * position);
+	void Clear();
+
+	bool IsEmpty() const { return m_heads.empty(); }
+
+	// Calls functor(CDXMeshIndex) once for every vertex in the cells touched
+	// by the sphere
+	template<typename F>
+	void Visit(const float * center, float radius, F functor) const
+	{
+		GatherBuckets(center, radius);
+		for (UInt32 bucket : m_visited) {
+			for (UInt32 i = m_heads[bucket]; i != kInvalidIndex; i = m_next[i])
+				functor((CDXMeshIndex)i);
+		}
+	}
+
+private:
+	UInt32 GetBucket(SInt32 x, SInt32 y, SInt32 z) const;
+	UInt32 GetBucket(const float * position) const;
+	SInt32 GetCell(float value) const;
+	void Link(UInt32 i, UInt32 bucket);
+	void Unlink(UInt32 i);
+	void GatherBuckets(const float * center, float radius) const;
+
+	float					m_invCellSize;
+	UInt32					m_mask;
+	std::vector<UInt32>		m_heads;
+	std::vector<UInt32>		m_next;
+	std::vector<UInt32>		m_prev;
+	std::vector<UInt32>		m_bucket;
+	mutable std::vector<UInt32>	m_visited;
+};
+
+#endif
@@ -1,5 +1,14 @@
 #include "CDXStroke.h"
 #include "CDXBrush.h"
+#include "CDXSmooth.h"
+
+#include <algorithm>
+#include <ppl.h>
+
+// Below this many hits a sample is smoothed inline, scheduling would cost more than it saves
+#define SMOOTH_PARALLEL_HITS	512
+// Hits handed to a worker at a time
+#define SMOOTH_BLOCK_HITS		128
 
 CDXStroke::CDXStroke(CDXBrush * brush, CDXEditableMesh * mesh)
 {
@@ -9,6 +18,40 @@ CDXStroke::CDXStroke(CDXBrush * brush, CDXEditableMesh * mesh)
 	m_mirror = false;
 }
 
+size_t CDXStroke::GetMemoryUsage()
+{
+	return sizeof(*this) + m_deltas.GetMemoryUsage();
+}
+
+CDXEditableMesh * CDXStroke::GetDeltaMesh()
+{
+	return m_deltas.IsEmpty() ? NULL : m_mesh;
+}
+
+const CDXVertexDeltas * CDXStroke::GetDeltas()
+{
+	return m_deltas.IsEmpty() ? NULL : &m_deltas;
+}
+
+void CDXStroke::ApplyDeltas(const CDXVertexDeltas & deltas, float multiplier)
+{
+	m_mesh->MoveVertices(deltas, multiplier);
+	m_mesh->UpdateVertexBuffer();
+}
+
+void CDXStroke::StoreDeltas(CDXVectorMap & offsets)
+{
+	m_deltas.Assign(offsets, true);
+	m_deltas.Visit([&](CDXMeshIndex i, const float * offset)
+	{
+		m_mesh->MoveVertex(i, CDXVec3(offset) - offsets[i]);
+	});
+	m_mesh->UpdateVertexBuffer();
+
+	// The map is only needed while the stroke is running
+	CDXVectorMap().swap(offsets);
+}
+
 CDXUndoCommand::UndoType CDXBasicStroke::GetUndoType()
 {
 	return CDXUndoCommand::kUndoType_Stroke;
@@ -19,30 +62,21 @@ void CDXBasicStroke::Begin(CDXPickInfo & pickInfo)
 	m_origin = pickInfo.origin;
 }
 
-void CDXBasicHitStroke::Redo()
+void CDXBasicHitStroke::End()
 {
-	CDXMeshVert* pVertices = m_mesh->LockVertices();
-	if (!pVertices)
-		return;
+	StoreDeltas(m_current);
+}
 
+void CDXBasicHitStroke::Redo()
+{
 	// Do what we have now
-	for (auto it : m_current)
-		pVertices[it.first].Position += it.second;
-
-	m_mesh->UnlockVertices();
+	ApplyDeltas(m_deltas, 1.0f);
 }
 
 void CDXBasicHitStroke::Undo()
 {
-	CDXMeshVert* pVertices = m_mesh->LockVertices();
-	if (!pVertices)
-		return;
-
 	// Undo what we did
-	for (auto it : m_current)
-		pVertices[it.first].Position -= it.second;
-
-	m_mesh->UnlockVertices();
+	ApplyDeltas(m_deltas, -1.0f);
 }
 
 CDXMaskAddStroke::~CDXMaskAddStroke()
@@ -56,35 +90,44 @@ CDXStroke::StrokeType CDXMaskAddStroke::GetStrokeType()
 	return kStrokeType_Mask_Add;
 }
 
-void CDXMaskAddStroke::Redo()
+size_t CDXMaskAddStroke::GetMemoryUsage()
 {
-	CDXMeshVert* pVertices = m_mesh->LockVertices();
-	if (!pVertices)
-		return;
+	return CDXBasicStroke::GetMemoryUsage() + (m_previousColors.capacity() + m_currentColors.capacity()) * sizeof(CDXMaskPair);
+}
 
+void CDXMaskAddStroke::End()
+{
+	// Only sorted lists are kept for the undo stack
+	m_previousColors.assign(m_previous.begin(), m_previous.end());
+	m_currentColors.assign(m_current.begin(), m_current.end());
+	std::sort(m_previousColors.begin(), m_previousColors.end());
+	std::sort(m_currentColors.begin(), m_currentColors.end());
+
+	CDXMaskMap().swap(m_previous);
+	CDXMaskMap().swap(m_current);
+}
+
+void CDXMaskAddStroke::Redo()
+{
 	// Do what we have now
-	for (auto it : m_current)
-		pVertices[it.first].Color = it.second;
+	for (auto & it : m_currentColors)
+		m_mesh->SetVertexColor(it.first, it.second);
 
-	m_mesh->UnlockVertices();
+	m_mesh->UpdateVertexBuffer();
 }
 
 void CDXMaskAddStroke::Undo()
 {
-	CDXMeshVert* pVertices = m_mesh->LockVertices();
-	if (!pVertices)
-		return;
-
 	// Undo what we did
-	for (auto it : m_previous)
-		pVertices[it.first].Color = it.second;
+	for (auto & it : m_previousColors)
+		m_mesh->SetVertexColor(it.first, it.second);
 
-	m_mesh->UnlockVertices();
+	m_mesh->UpdateVertexBuffer();
 }
 
 void CDXMaskAddStroke::Update(CDXStroke::Info * info)
 {
-	CDXMeshVert * pVertices = m_mesh->LockVertices();
+	CDXMeshVert * pVertices = m_mesh->GetVertices();
 	if (!pVertices)
 		return;
 
@@ -94,9 +137,7 @@ void CDXMaskAddStroke::Update(CDXStroke::Info * info)
 	if (ret.second)
 		m_previous.emplace(info->index, pVertices[info->index].Color);
 
-	pVertices[info->index].Color = color;
-
-	m_mesh->UnlockVertices();
+	m_mesh->SetVertexColor(info->index, color);
 }
 
 CDXStroke::StrokeType CDXMaskSubtractStroke::GetStrokeType()
@@ -106,7 +147,7 @@ CDXStroke::StrokeType CDXMaskSubtractStroke::GetStrokeType()
 
 void CDXMaskSubtractStroke::Update(CDXStroke::Info * info)
 {
-	CDXMeshVert * pVertices = m_mesh->LockVertices();
+	CDXMeshVert * pVertices = m_mesh->GetVertices();
 	if (!pVertices)
 		return;
 
@@ -117,9 +158,8 @@ void CDXMaskSubtractStroke::Update(CDXStroke::Info * info)
 		if (ret.second)
 			m_previous.emplace(info->index, pVertices[info->index].Color);
 
-		pVertices[info->index].Color = color;
+		m_mesh->SetVertexColor(info->index, color);
 	}
-	m_mesh->UnlockVertices();
 }
 
 CDXInflateStroke::~CDXInflateStroke()
@@ -134,17 +174,12 @@ CDXStroke::StrokeType CDXInflateStroke::GetStrokeType()
 
 void CDXInflateStroke::Update(CDXStroke::Info * info)
 {
-	CDXMeshVert * pVertices = m_mesh->LockVertices();
-	if (!pVertices)
-		return;
-
 	CDXVec3 vertexNormal = ((InflateInfo*)info)->normal;
 	CDXVec3 difference = vertexNormal * info->strength * info->falloff;	
 
 	m_current.emplace(info->index, CDXVec3(0, 0, 0));
 	m_current[info->index] += difference;
-	pVertices[info->index].Position += difference;
-	m_mesh->UnlockVertices();
+	m_mesh->MoveVertex(info->index, difference);
 }
 
 CDXStroke::StrokeType CDXDeflateStroke::GetStrokeType()
@@ -154,17 +189,12 @@ CDXStroke::StrokeType CDXDeflateStroke::GetStrokeType()
 
 void CDXDeflateStroke::Update(CDXStroke::Info * info)
 {
-	CDXMeshVert * pVertices = m_mesh->LockVertices();
-	if (!pVertices)
-		return;
-
 	CDXVec3 vertexNormal = ((InflateInfo*)info)->normal;
 	CDXVec3 difference = vertexNormal * info->strength * info->falloff;
 
 	m_current.emplace(info->index, CDXVec3(0, 0, 0));
 	m_current[info->index] -= difference;
-	pVertices[info->index].Position -= difference;
-	m_mesh->UnlockVertices();
+	m_mesh->MoveVertex(info->index, -difference);
 }
 
 CDXSmoothStroke::~CDXSmoothStroke()
@@ -177,43 +207,61 @@ CDXStroke::StrokeType CDXSmoothStroke::GetStrokeType()
 	return kStrokeType_Smooth;
 }
 
+CDXVec3 CDXSmoothStroke::CalculateOffset(const CDXMeshVert * pVertices, CDXMeshIndex i, double strength, double falloff)
+{
+	CDXVec3 offset;
+	CDXSmoothVertex(m_mesh->GetTopology(), &pVertices->Position.x, sizeof(CDXMeshVert) / sizeof(float), i, (float)strength, (float)falloff, &offset.x);
+	return offset;
+}
+
 void CDXSmoothStroke::Update(CDXStroke::Info * info)
 {
-	CDXMeshVert * pVertices = m_mesh->LockVertices();
+	CDXMeshVert * pVertices = m_mesh->GetVertices();
 	if (!pVertices)
 		return;
 
-	CDXVec3 newPos = CDXVec3(0, 0, 0);
-
-	UInt32 totalCount = 0;
-	m_mesh->VisitAdjacencies(info->index, [&](CDXMeshFace & face)
-	{
-		CDXMeshIndex m1 = face.v1;
-		if (m1 >= m_mesh->GetVertexCount())
-			return false;
-
-		CDXMeshIndex m2 = face.v2;
-		if (m2 >= m_mesh->GetVertexCount())
-			return false;
-		
-		CDXMeshIndex m3 = face.v3;
-		if (m3 >= m_mesh->GetVertexCount())
-			return false;
-		
-		CDXVec3 sum = pVertices[m1].Position + pVertices[m2].Position + pVertices[m3].Position;
-		newPos += sum / 3;
-		totalCount++;
-		return false;
-	});
-
-	newPos /= totalCount;
+	CDXVec3 difference = CalculateOffset(pVertices, info->index, info->strength, info->falloff);
 
-	CDXVec3 difference = (newPos - pVertices[info->index].Position) * info->strength * info->falloff;
-	
 	m_current.emplace(info->index, CDXVec3(0,0,0));
 	m_current[info->index] += difference;
-	pVertices[info->index].Position += difference;
-	m_mesh->UnlockVertices();
+	m_mesh->MoveVertex(info->index, difference);
+}
+
+void CDXSmoothStroke::Update(const CDXHitIndexList & hits, double strength)
+{
+	CDXMeshVert * pVertices = m_mesh->GetVertices();
+	if (!pVertices)
+		return;
+
+	// Every offset is read from the old positions before any vertex moves,
+	// so the workers never see each others writes
+	m_offsets.resize(hits.size());
+	if (m_offsets.empty())
+		return;
+
+	const CDXMeshTopology & topology = m_mesh->GetTopology();
+	const float * positions = &pVertices->Position.x;
+	UInt32 stride = sizeof(CDXMeshVert) / sizeof(float);
+	float * offsets = &m_offsets[0].x;
+
+	if (hits.size() >= SMOOTH_PARALLEL_HITS) {
+		size_t blocks = (hits.size() + SMOOTH_BLOCK_HITS - 1) / SMOOTH_BLOCK_HITS;
+		concurrency::parallel_for((size_t)0, blocks, [&](size_t b)
+		{
+			size_t begin = b * SMOOTH_BLOCK_HITS;
+			size_t end = min(begin + SMOOTH_BLOCK_HITS, hits.size());
+			CDXSmoothHits(topology, positions, stride, hits, begin, end, (float)strength, offsets);
+		});
+	}
+	else
+		CDXSmoothHits(topology, positions, stride, hits, 0, hits.size(), (float)strength, offsets);
+
+	for (size_t h = 0; h < hits.size(); h++) {
+		CDXMeshIndex i = hits[h].first;
+		m_current.emplace(i, CDXVec3(0,0,0));
+		m_current[i] += m_offsets[h];
+		m_mesh->MoveVertex(i, m_offsets[h]);
+	}
 }
 
 CDXMoveStroke::~CDXMoveStroke()
@@ -236,33 +284,21 @@ void CDXMoveStroke::Begin(CDXPickInfo & pickInfo)
 
 void CDXMoveStroke::Redo()
 {
-	CDXMeshVert* pVertices = m_mesh->LockVertices();
-	if (!pVertices)
-		return;
-
 	// Do what we have now
-	for (auto it : m_current)
-		pVertices[it.first].Position += it.second;
-
-	m_mesh->UnlockVertices();
+	ApplyDeltas(m_deltas, 1.0f);
 }
 
 void CDXMoveStroke::Undo()
 {
-	CDXMeshVert* pVertices = m_mesh->LockVertices();
-	if (!pVertices)
-		return;
-
 	// Undo what we did
-	for (auto it : m_current)
-		pVertices[it.first].Position -= it.second;
-
-	m_mesh->UnlockVertices();
+	ApplyDeltas(m_deltas, -1.0f);
 }
 
 void CDXMoveStroke::Update(CDXStroke::Info * info)
 {
-	CDXMeshVert * pVertices = m_mesh->LockVertices();
+	CDXMeshVert * pVertices = m_mesh->GetVertices();
+	if (!pVertices)
+		return;
 
 	m_previous.emplace(info->index, pVertices[info->index].Position);
 	CDXVec3 newPosition = m_previous[info->index] + ((MoveInfo*)info)->offset * info->strength * info->falloff;
@@ -270,12 +306,12 @@ void CDXMoveStroke::Update(CDXStroke::Info * info)
 
 	m_current.emplace(info->index, CDXVec3(0, 0, 0));
 	m_current[info->index] += difference;
-	pVertices[info->index].Position += difference;
-
-	m_mesh->UnlockVertices();
+	m_mesh->MoveVertex(info->index, difference);
 }
 
 void CDXMoveStroke::End()
 {
 	m_hitIndices.clear();
+	CDXVectorMap().swap(m_previous);
+	StoreDeltas(m_current);
 }
\ No newline at end of file
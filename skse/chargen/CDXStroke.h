@@ -5,6 +5,7 @@
 
 #include "CDXUndo.h"
 #include "CDXEditableMesh.h"
+#include "CDXVertexDeltas.h"
 #include "CDXPicker.h"
 
 class CDXBrush;
@@ -41,16 +42,26 @@ public:
 	virtual void Apply(SInt32 i) = 0;
 	virtual UInt32 Length() = 0;
 
+	virtual size_t GetMemoryUsage();
+	virtual CDXEditableMesh * GetDeltaMesh();
+	virtual const CDXVertexDeltas * GetDeltas();
+	virtual void ApplyDeltas(const CDXVertexDeltas & deltas, float multiplier);
+
 	CDXVec3 GetOrigin() { return m_origin; }
 	void SetMirror(bool m) { m_mirror = m; }
 	bool IsMirror() const { return m_mirror; }
 	CDXEditableMesh	* GetMesh() { return m_mesh; }
 
 protected:
+	// Keeps the offsets of a finished stroke as quantized deltas and moves
+	// the vertices onto the rounded offsets, so Undo returns exactly
+	void StoreDeltas(CDXVectorMap & offsets);
+
 	CDXVec3				m_origin;
 	CDXEditableMesh		* m_mesh;
 	CDXBrush			* m_brush;
 	bool				m_mirror;
+	CDXVertexDeltas		m_deltas;
 };
 
 typedef std::shared_ptr<CDXStroke> CDXStrokePtr;
@@ -72,9 +83,10 @@ class CDXBasicHitStroke : public CDXBasicStroke
 public:
 	CDXBasicHitStroke(CDXBrush * brush, CDXEditableMesh * mesh) : CDXBasicStroke(brush, mesh) { };
 
+	virtual void End();
 	virtual void Undo();
 	virtual void Redo();
-	virtual UInt32 Length() { return m_current.size(); }
+	virtual UInt32 Length() { return m_deltas.Size(); }
 
 protected:
 	CDXVectorMap m_current;
@@ -88,13 +100,17 @@ public:
 
 	virtual StrokeType GetStrokeType();
 	virtual void Update(Info * strokeInfo);
+	virtual void End();
 	virtual void Undo();
 	virtual void Redo();
-	virtual UInt32 Length() { return m_current.size(); }
+	virtual UInt32 Length() { return m_currentColors.size(); }
+	virtual size_t GetMemoryUsage();
 
 protected:
 	CDXMaskMap m_previous;
 	CDXMaskMap m_current;
+	CDXMaskList m_previousColors;
+	CDXMaskList m_currentColors;
 };
 
 class CDXMaskSubtractStroke : public CDXMaskAddStroke
@@ -139,6 +155,15 @@ public:
 
 	virtual StrokeType GetStrokeType();
 	virtual void Update(Info * strokeInfo);
+
+	// Smooths all hits of one sample against the positions from before it,
+	// the result does not depend on hit order or on how the work is split
+	void Update(const CDXHitIndexList & hits, double strength);
+
+protected:
+	CDXVec3 CalculateOffset(const CDXMeshVert * pVertices, CDXMeshIndex i, double strength, double falloff);
+
+	std::vector<CDXVec3>	m_offsets;
 };
 
 
@@ -160,16 +185,16 @@ public:
 	virtual void End();
 	virtual void Undo();
 	virtual void Redo();
-	virtual UInt32 Length() { return m_current.size(); }
+	virtual UInt32 Length() { return m_deltas.Size(); }
 
 	CDXRayInfo & GetRayInfo() { return m_rayInfo; }
 
-	void SetHitIndices(CDXHitIndexMap & indices) { m_hitIndices = indices; }
-	CDXHitIndexMap & GetHitIndices() { return m_hitIndices; }
+	void SetHitIndices(CDXHitIndexList & indices) { m_hitIndices = indices; }
+	CDXHitIndexList & GetHitIndices() { return m_hitIndices; }
 
 protected:
 	CDXRayInfo		m_rayInfo;
-	CDXHitIndexMap	m_hitIndices;
+	CDXHitIndexList	m_hitIndices;
 	CDXVectorMap	m_previous;
 	CDXVectorMap	m_current;
 };
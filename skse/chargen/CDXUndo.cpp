@@ -1,53 +1,186 @@
 #include "CDXUndo.h"
+#include "CDXVertexDeltas.h"
+
+#include <algorithm>
 
 CDXUndoStack	g_undoStack;
 
+// Sums the offsets of consecutive delta commands on one mesh, applied
+// through the last of them once the run ends
+class CDXUndoBatch
+{
+public:
+	CDXUndoBatch() : m_target(NULL), m_mesh(NULL) { }
+
+	bool Add(CDXUndoCommand * action, float multiplier)
+	{
+		CDXEditableMesh * mesh = action->GetDeltaMesh();
+		const CDXVertexDeltas * deltas = action->GetDeltas();
+		if (!mesh || !deltas)
+			return false;
+
+		if (m_mesh != mesh) {
+			Apply();
+			m_mesh = mesh;
+		}
+		m_target = action;
+
+		// Indices are sorted, the last one bounds the whole step
+		if (!deltas->IsEmpty()) {
+			UInt32 count = deltas->GetIndex(deltas->Size() - 1) + 1;
+			if (m_touched.size() < count) {
+				m_touched.resize(count, 0);
+				m_sums.resize(count * 3);
+			}
+		}
+
+		deltas->Visit([&](CDXMeshIndex i, const float * offset)
+		{
+			float * sum = &m_sums[i * 3];
+			if (!m_touched[i]) {
+				m_touched[i] = 1;
+				sum[0] = sum[1] = sum[2] = 0.0f;
+				m_indices.push_back(i);
+			}
+			sum[0] += offset[0] * multiplier;
+			sum[1] += offset[1] * multiplier;
+			sum[2] += offset[2] * multiplier;
+		});
+
+		return true;
+	}
+
+	void Apply()
+	{
+		if (!m_target)
+			return;
+
+		std::sort(m_indices.begin(), m_indices.end());
+
+		std::vector<float> offsets(m_indices.size() * 3);
+		for (UInt32 n = 0; n < m_indices.size(); n++) {
+			const float * sum = &m_sums[m_indices[n] * 3];
+			offsets[n * 3 + 0] = sum[0];
+			offsets[n * 3 + 1] = sum[1];
+			offsets[n * 3 + 2] = sum[2];
+			m_touched[m_indices[n]] = 0;
+		}
+
+		CDXVertexDeltas merged;
+		merged.Assign(m_indices, offsets, false);
+		m_target->ApplyDeltas(merged, 1.0f);
+
+		m_indices.clear();
+		m_target = NULL;
+		m_mesh = NULL;
+	}
+
+private:
+	CDXUndoCommand				* m_target;
+	CDXEditableMesh				* m_mesh;
+	std::vector<UInt8>			m_touched;
+	std::vector<float>			m_sums;		// x, y, z per vertex
+	std::vector<CDXMeshIndex>	m_indices;
+};
+
 CDXUndoStack::CDXUndoStack()
 {
+	m_head = 0;
+	m_count = 0;
+	m_dropped = 0;
 	m_index = -1;
 	m_maxStack = 512;
+	m_memory = 0;
+	m_memoryBudget = 32 * 1024 * 1024;
 }
 
 void CDXUndoStack::Release()
 {
+	m_actions.clear();
+	m_usage.clear();
+	m_head = 0;
+	m_count = 0;
+	m_dropped = 0;
 	m_index = -1;
-	clear();
+	m_memory = 0;
+}
+
+void CDXUndoStack::Truncate(UInt32 count)
+{
+	while (m_count > count) {
+		m_count--;
+		UInt32 slot = (m_head + m_count) % m_maxStack;
+		m_memory -= m_usage[slot];
+		m_usage[slot] = 0;
+		m_actions[slot].reset();
+	}
+
+	if (m_dropped > m_count)
+		m_dropped = m_count;
+}
+
+void CDXUndoStack::TrimMemory()
+{
+	// Always keep the newest action
+	while (m_memory > m_memoryBudget && m_dropped + 1 < m_count) {
+		UInt32 slot = (m_head + m_dropped) % m_maxStack;
+		m_memory -= m_usage[slot];
+		m_usage[slot] = 0;
+		m_actions[slot].reset();
+		m_dropped++;
+	}
 }
 
 SInt32 CDXUndoStack::Push(CDXUndoCommandPtr action)
 {
-	CDXUndoStack::iterator actionIt;
-	int maxState = size() - 1;
-	if(m_index != maxState) { // Not at the end, erase everything from now til the end
-		erase(begin() + (m_index + 1), end());
-		m_index++;
-	} else if(size() == m_maxStack) { // Stack is full
-		erase(begin());
-	} else
-		m_index++;
+	if (m_actions.empty()) {
+		m_actions.resize(m_maxStack);
+		m_usage.resize(m_maxStack, 0);
+	}
+
+	// Not at the end, erase everything from now til the end
+	Truncate(m_index + 1);
+
+	if (m_count == m_maxStack) { // Stack is full, reuse the oldest slot
+		m_memory -= m_usage[m_head];
+		m_usage[m_head] = 0;
+		m_actions[m_head].reset();
+		m_head = (m_head + 1) % m_maxStack;
+		m_count--;
+		if (m_dropped > 0)
+			m_dropped--;
+	}
+
+	UInt32 slot = (m_head + m_count) % m_maxStack;
+	m_actions[slot] = action;
+	m_usage[slot] = action->GetMemoryUsage();
+	m_memory += m_usage[slot];
+	m_count++;
+	m_index = m_count - 1;
 
-	push_back(action);
+	TrimMemory();
 	return m_index;
 }
 
 SInt32 CDXUndoStack::Undo(bool doUpdate)
 {
-	if(m_index > -1) {
-		if(doUpdate)
-			at(m_index)->Undo();
+	if (m_index >= (SInt32)m_dropped) {
+		if (doUpdate)
+			At(m_index)->Undo();
 		m_index--;
-		return m_index;
-	} 
-	return -1;
+	}
+
+	// At a dropped boundary the index stays put, -1 reads as before the first action
+	return m_index;
 }
 
 SInt32 CDXUndoStack::Redo(bool doUpdate)
 {
-	SInt32 maxState = size() - 1;
-	if(m_index < maxState) {
+	SInt32 maxState = m_count - 1;
+	if (m_index < maxState) {
 		m_index++;
-		if(doUpdate) 
-			at(m_index)->Redo();
+		if (doUpdate)
+			At(m_index)->Redo();
 		return m_index;
 	}
 	return -1;
@@ -55,15 +188,43 @@ SInt32 CDXUndoStack::Redo(bool doUpdate)
 
 SInt32 CDXUndoStack::GoTo(SInt32 index, bool doUpdate)
 {
-	SInt32 result = -1;
-	SInt32 amount = index - m_index;
+	SInt32 minState = (SInt32)m_dropped - 1;
+	SInt32 maxState = m_count - 1;
+	if (index < -1 || index > maxState)
+		return -1;
+
+	// Dropped actions can't be undone, stop at the oldest one still held
+	if (index < minState)
+		index = minState;
+
+	if (index == m_index)
+		return m_index;
 
-	if (amount == 0)
+	if (!doUpdate) {
+		m_index = index;
 		return m_index;
+	}
 
-	for (UInt32 i = 0; i < abs(amount); i++) {
-		result = amount < 0 ? Undo(doUpdate) : Redo(doUpdate);
+	// Runs of vertex offsets on the same mesh are summed and applied once,
+	// anything else flushes the run and applies itself in order
+	CDXUndoBatch batch;
+	while (m_index > index) {
+		CDXUndoCommand * action = At(m_index).get();
+		if (!batch.Add(action, -1.0f)) {
+			batch.Apply();
+			action->Undo();
+		}
+		m_index--;
 	}
-	
-	return result;
-}
\ No newline at end of file
+	while (m_index < index) {
+		CDXUndoCommand * action = At(m_index + 1).get();
+		if (!batch.Add(action, 1.0f)) {
+			batch.Apply();
+			action->Redo();
+		}
+		m_index++;
+	}
+	batch.Apply();
+
+	return m_index;
+}
@@ -6,6 +6,9 @@
 #include <vector>
 #include <memory>
 
+class CDXEditableMesh;
+class CDXVertexDeltas;
+
 class CDXUndoCommand
 {
 public:
@@ -23,11 +26,24 @@ public:
 	virtual UndoType GetUndoType() { return kUndoType_None; }
 	virtual void Undo() { };
 	virtual void Redo() { };
+
+	// Bytes held by the command, counted against the stack budget
+	virtual size_t GetMemoryUsage() { return sizeof(CDXUndoCommand); }
+
+	// Commands that do nothing but move vertices expose their offsets, so
+	// GoTo can sum a run of them and apply every vertex once
+	virtual CDXEditableMesh * GetDeltaMesh() { return NULL; }
+	virtual const CDXVertexDeltas * GetDeltas() { return NULL; }
+	virtual void ApplyDeltas(const CDXVertexDeltas &, float) { };
 };
 
 typedef std::shared_ptr<CDXUndoCommand> CDXUndoCommandPtr;
 
-class CDXUndoStack : public std::vector<CDXUndoCommandPtr>
+// Actions live in a ring of m_maxStack slots, a full stack reuses the slot
+// of its oldest action. When the actions outgrow the memory budget the
+// oldest ones are dropped early, their slots stay so indices don't move
+// but they can no longer be undone.
+class CDXUndoStack
 {
 public:
 	CDXUndoStack();
@@ -39,12 +55,25 @@ public:
 	SInt32 GetIndex() const { return m_index; }
 
 	UInt32 GetLimit() const { return m_maxStack; }
+	UInt32 GetSize() const { return m_count; }
+	size_t GetMemoryUsage() const { return m_memory; }
 
 	void Release();
 
 protected:
+	CDXUndoCommandPtr & At(SInt32 index) { return m_actions[(m_head + index) % m_maxStack]; }
+	void Truncate(UInt32 count);
+	void TrimMemory();
+
+	std::vector<CDXUndoCommandPtr>	m_actions;
+	std::vector<size_t>				m_usage;	// Bytes of each slot when it was pushed
+	UInt32	m_head;
+	UInt32	m_count;
+	UInt32	m_dropped;
 	SInt32	m_index;
 	UInt32	m_maxStack;
+	size_t	m_memory;
+	size_t	m_memoryBudget;
 };
 
 extern CDXUndoStack	g_undoStack;
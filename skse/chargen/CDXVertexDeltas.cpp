@@ -0,0 +1,67 @@
+#include "CDXVertexDeltas.h"
+#include "CDXVertexStreams.h"
+
+#include <cmath>
+
+#define DELTA_QUANTIZE_RANGE	32767.0f
+
+void CDXVertexDeltas::Clear()
+{
+	std::vector<CDXMeshIndex>().swap(m_indices);
+	std::vector<SInt16>().swap(m_quantized);
+	std::vector<float>().swap(m_offsets);
+	m_scale = 0.0f;
+}
+
+void CDXVertexDeltas::Assign(const std::vector<CDXMeshIndex> & indices, const std::vector<float> & offsets, bool quantize)
+{
+	Clear();
+	m_indices = indices;
+
+	if (!quantize) {
+		m_offsets = offsets;
+		return;
+	}
+
+	float largest = 0.0f;
+	for (auto value : offsets) {
+		if (fabs(value) > largest)
+			largest = fabs(value);
+	}
+
+	m_scale = largest / DELTA_QUANTIZE_RANGE;
+	float invScale = m_scale > 0.0f ? 1.0f / m_scale : 0.0f;
+
+	m_quantized.resize(offsets.size());
+	for (UInt32 n = 0; n < offsets.size(); n++) {
+		float q = floor(offsets[n] * invScale + 0.5f);
+		if (q < -DELTA_QUANTIZE_RANGE)
+			q = -DELTA_QUANTIZE_RANGE;
+		if (q > DELTA_QUANTIZE_RANGE)
+			q = DELTA_QUANTIZE_RANGE;
+		m_quantized[n] = (SInt16)q;
+	}
+}
+
+size_t CDXVertexDeltas::GetMemoryUsage() const
+{
+	return m_indices.capacity() * sizeof(CDXMeshIndex) + m_quantized.capacity() * sizeof(SInt16) + m_offsets.capacity() * sizeof(float);
+}
+
+void CDXVertexDeltas::GetOffsets(CDXVectorStreams & offsets, float multiplier) const
+{
+	UInt32 count = m_indices.size();
+	if (m_quantized.empty()) {
+		offsets.Gather(m_offsets.data(), 3, count);
+		offsets.Scale(multiplier);
+		return;
+	}
+
+	offsets.Resize(count);
+	const SInt16 * q = m_quantized.data();
+	for (UInt32 n = 0; n < count; n++, q += 3) {
+		offsets.x[n] = q[0] * m_scale * multiplier;
+		offsets.y[n] = q[1] * m_scale * multiplier;
+		offsets.z[n] = q[2] * m_scale * multiplier;
+	}
+}
@@ -0,0 +1,98 @@
+#ifndef __CDXVERTEXDELTAS__
+#define __CDXVERTEXDELTAS__
+
+#pragma once
+
+#include "CDXMeshTypes.h"
+
+#include <algorithm>
+#include <vector>
+
+class CDXVectorStreams;
+
+// Per vertex offsets of one undo step, sorted by vertex index. Quantized
+// offsets are kept as 16 bit integers on a scale fit to the largest
+// component of the step, others keep full floats. Offsets are xyz floats.
+class CDXVertexDeltas
+{
+public:
+	CDXVertexDeltas() : m_scale(0.0f) { }
+
+	// Takes any map from vertex index to an xyz vector, like CDXVectorMap
+	template<typename M>
+	void Assign(const M & offsets, bool quantize)
+	{
+		std::vector<std::pair<CDXMeshIndex, const float *>> sorted;
+		sorted.reserve(offsets.size());
+		for (auto & it : offsets)
+			sorted.push_back(std::make_pair(it.first, (const float *)&it.second));
+
+		std::sort(sorted.begin(), sorted.end(), [](const std::pair<CDXMeshIndex, const float *> & a, const std::pair<CDXMeshIndex, const float *> & b)
+		{
+			return a.first < b.first;
+		});
+
+		std::vector<CDXMeshIndex> indices(sorted.size());
+		std::vector<float> packed(sorted.size() * 3);
+		for (UInt32 n = 0; n < sorted.size(); n++) {
+			indices[n] = sorted[n].first;
+			packed[n * 3 + 0] = sorted[n].second[0];
+			packed[n * 3 + 1] = sorted[n].second[1];
+			packed[n * 3 + 2] = sorted[n].second[2];
+		}
+
+		Assign(indices, packed, quantize);
+	}
+
+	// Indices have to be sorted, offsets holds the xyz of indices[n] at n * 3
+	void Assign(const std::vector<CDXMeshIndex> & indices, const std::vector<float> & offsets, bool quantize);
+	void Clear();
+
+	UInt32 Size() const { return m_indices.size(); }
+	bool IsEmpty() const { return m_indices.empty(); }
+	bool IsQuantized() const { return !m_quantized.empty(); }
+	size_t GetMemoryUsage() const;
+
+	// Quantizing rounds to the nearest step, so no component is further
+	// than half a step from the offset it was assigned
+	float GetMaxError() const { return m_scale * 0.5f; }
+
+	CDXMeshIndex GetIndex(UInt32 n) const { return m_indices[n]; }
+	const CDXMeshIndex * GetIndices() const { return m_indices.data(); }
+	void GetOffset(UInt32 n, float * offset) const
+	{
+		if (m_quantized.empty()) {
+			offset[0] = m_offsets[n * 3 + 0];
+			offset[1] = m_offsets[n * 3 + 1];
+			offset[2] = m_offsets[n * 3 + 2];
+			return;
+		}
+
+		const SInt16 * q = &m_quantized[n * 3];
+		offset[0] = q[0] * m_scale;
+		offset[1] = q[1] * m_scale;
+		offset[2] = q[2] * m_scale;
+	}
+
+	// Calls functor(CDXMeshIndex, const float * offset) in vertex order
+	template<typename F>
+	void Visit(F functor) const
+	{
+		float offset[3];
+		for (UInt32 n = 0; n < m_indices.size(); n++) {
+			GetOffset(n, offset);
+			functor(m_indices[n], (const float *)offset);
+		}
+	}
+
+	// Unpacks every offset times multiplier, offsets.x[n] belongs to GetIndex(n)
+	void GetOffsets(CDXVectorStreams & offsets, float multiplier) const;
+
+private:
+	std::vector<CDXMeshIndex>	m_indices;
+	std::vector<SInt16>			m_quantized;	// x, y, z per vertex
+	std::vector<float>			m_offsets;		// x, y, z per vertex
+	float						m_scale;
+};
+
+#endif
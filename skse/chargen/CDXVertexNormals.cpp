@@ -0,0 +1,227 @@
+#include "CDXVertexNormals.h"
+
+#include <algorithm>
+#include <cmath>
+
+void CDXVertexNormals::Clear()
+{
+	m_topology = NULL;
+	m_stride = 3;
+	m_faceNormals.clear();
+	m_weldNext.clear();
+	m_dirty.clear();
+	m_isDirty.clear();
+	m_faceStamp.clear();
+	m_vertexStamp.clear();
+	m_updated.clear();
+	m_stamp = 0;
+}
+
+void CDXVertexNormals::Build(const CDXMeshTopology * topology, const float * positions, UInt32 stride)
+{
+	Clear();
+	m_topology = topology;
+	m_stride = stride;
+
+	UInt32 faceCount = topology->GetFaceCount();
+	UInt32 vertexCount = topology->GetVertexCount();
+
+	m_faceNormals.resize(faceCount * 3);
+	for (UInt32 f = 0; f < faceCount; f++)
+		FaceNormal(positions, topology->GetFace(f), &m_faceNormals[f * 3]);
+
+	BuildWelds(positions, vertexCount);
+
+	m_isDirty.assign(vertexCount, 0);
+	m_faceStamp.assign(faceCount, 0);
+	m_vertexStamp.assign(vertexCount, 0);
+}
+
+void CDXVertexNormals::BuildWelds(const float * positions, UInt32 vertexCount)
+{
+	m_weldNext.resize(vertexCount);
+
+	// Sorting by position puts copies next to each other, each run of equal
+	// positions is linked into a ring, a lone vertex points at itself
+	std::vector<CDXMeshIndex> order(vertexCount);
+	for (UInt32 i = 0; i < vertexCount; i++)
+		order[i] = i;
+
+	auto position = [&](CDXMeshIndex i) { return positions + i * m_stride; };
+	auto less = [&](CDXMeshIndex a, CDXMeshIndex b)
+	{
+		const float * pa = position(a);
+		const float * pb = position(b);
+		if (pa[0] != pb[0]) return pa[0] < pb[0];
+		if (pa[1] != pb[1]) return pa[1] < pb[1];
+		if (pa[2] != pb[2]) return pa[2] < pb[2];
+		return a < b;
+	};
+	auto equal = [&](CDXMeshIndex a, CDXMeshIndex b)
+	{
+		const float * pa = position(a);
+		const float * pb = position(b);
+		return pa[0] == pb[0] && pa[1] == pb[1] && pa[2] == pb[2];
+	};
+	std::sort(order.begin(), order.end(), less);
+
+	for (UInt32 n = 0; n < vertexCount;) {
+		UInt32 run = n + 1;
+		while (run < vertexCount && equal(order[n], order[run]))
+			run++;
+
+		for (UInt32 k = n; k < run; k++)
+			m_weldNext[order[k]] = order[k + 1 < run ? k + 1 : n];
+
+		n = run;
+	}
+}
+
+void CDXVertexNormals::FaceNormal(const float * positions, const CDXMeshFace & face, float * normal) const
+{
+	const float * p1 = positions + face.v1 * m_stride;
+	const float * p2 = positions + face.v2 * m_stride;
+	const float * p3 = positions + face.v3 * m_stride;
+
+	float e1[3] = { p2[0] - p1[0], p2[1] - p1[1], p2[2] - p1[2] };
+	float e2[3] = { p3[0] - p2[0], p3[1] - p2[1], p3[2] - p2[2] };
+
+	normal[0] = e1[1] * e2[2] - e1[2] * e2[1];
+	normal[1] = e1[2] * e2[0] - e1[0] * e2[2];
+	normal[2] = e1[0] * e2[1] - e1[1] * e2[0];
+}
+
+bool CDXVertexNormals::WriteNormal(float * normals, CDXMeshIndex i) const
+{
+	float normal[3] = { 0, 0, 0 };
+	CDXMeshIndex v = i;
+	do {
+		m_topology->VisitFaces(v, [&](UInt32 f, const CDXMeshFace &)
+		{
+			normal[0] += m_faceNormals[f * 3 + 0];
+			normal[1] += m_faceNormals[f * 3 + 1];
+			normal[2] += m_faceNormals[f * 3 + 2];
+		});
+	} while ((v = m_weldNext[v]) != i);
+
+	// Keep the old normal where there is no surface to derive one from
+	float lengthSq = normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2];
+	if (lengthSq <= 0.0f)
+		return false;
+
+	float scale = 1.0f / sqrtf(lengthSq);
+	float * out = normals + i * m_stride;
+	out[0] = normal[0] * scale;
+	out[1] = normal[1] * scale;
+	out[2] = normal[2] * scale;
+	return true;
+}
+
+void CDXVertexNormals::CalculateAll(const float * positions, float * normals)
+{
+	if (!m_topology)
+		return;
+
+	for (UInt32 f = 0; f < m_topology->GetFaceCount(); f++)
+		FaceNormal(positions, m_topology->GetFace(f), &m_faceNormals[f * 3]);
+
+	for (UInt32 i = 0; i < m_topology->GetVertexCount(); i++)
+		WriteNormal(normals, i);
+
+	for (auto i : m_dirty)
+		m_isDirty[i] = 0;
+	m_dirty.clear();
+}
+
+void CDXVertexNormals::Calculate(const float * positions, CDXMeshIndex i, float * normal) const
+{
+	normal[0] = normal[1] = normal[2] = 0.0f;
+	if (!m_topology || i >= m_weldNext.size())
+		return;
+
+	CDXMeshIndex v = i;
+	do {
+		m_topology->VisitFaces(v, [&](UInt32, const CDXMeshFace & face)
+		{
+			float faceNormal[3];
+			FaceNormal(positions, face, faceNormal);
+			normal[0] += faceNormal[0];
+			normal[1] += faceNormal[1];
+			normal[2] += faceNormal[2];
+		});
+	} while ((v = m_weldNext[v]) != i);
+
+	float lengthSq = normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2];
+	if (lengthSq > 0.0f) {
+		float scale = 1.0f / sqrtf(lengthSq);
+		normal[0] *= scale;
+		normal[1] *= scale;
+		normal[2] *= scale;
+	}
+}
+
+void CDXVertexNormals::MarkDirty(CDXMeshIndex i)
+{
+	if (i >= m_isDirty.size() || m_isDirty[i])
+		return;
+
+	m_isDirty[i] = 1;
+	m_dirty.push_back(i);
+}
+
+UInt32 CDXVertexNormals::NextStamp()
+{
+	// Stamps tell whether a face or vertex was already handled this update
+	if (++m_stamp == 0) {
+		std::fill(m_faceStamp.begin(), m_faceStamp.end(), 0);
+		std::fill(m_vertexStamp.begin(), m_vertexStamp.end(), 0);
+		m_stamp = 1;
+	}
+
+	return m_stamp;
+}
+
+const std::vector<CDXMeshIndex> & CDXVertexNormals::Update(const float * positions, float * normals)
+{
+	m_updated.clear();
+	if (m_dirty.empty())
+		return m_updated;
+
+	UInt32 stamp = NextStamp();
+
+	// Every face touching a moved vertex changed, and with it the normal of
+	// each of its corners and of the copies welded to them
+	for (auto i : m_dirty) {
+		m_isDirty[i] = 0;
+		m_topology->VisitFaces(i, [&](UInt32 f, const CDXMeshFace & face)
+		{
+			if (m_faceStamp[f] == stamp)
+				return;
+
+			m_faceStamp[f] = stamp;
+			FaceNormal(positions, face, &m_faceNormals[f * 3]);
+
+			CDXMeshIndex corners[3] = { face.v1, face.v2, face.v3 };
+			for (auto corner : corners) {
+				CDXMeshIndex v = corner;
+				do {
+					if (m_vertexStamp[v] != stamp) {
+						m_vertexStamp[v] = stamp;
+						m_updated.push_back(v);
+					}
+				} while ((v = m_weldNext[v]) != corner);
+			}
+		});
+	}
+	m_dirty.clear();
+
+	// Face normals are all current now, sum them in one pass
+	size_t written = 0;
+	for (auto v : m_updated) {
+		if (WriteNormal(normals, v))
+			m_updated[written++] = v;
+	}
+	m_updated.resize(written);
+
+	return m_updated;
+}
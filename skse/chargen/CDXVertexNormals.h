@@ -0,0 +1,60 @@
+#ifndef __CDXVERTEXNORMALS__
+#define __CDXVERTEXNORMALS__
+
+#pragma once
+
+#include "CDXMeshTopology.h"
+
+#include <vector>
+
+// Smooth vertex normals kept in step with vertex edits. Face normals are
+// cached unnormalized, so their length is twice the face area and summing
+// them weights every face by its area. Moving a vertex only refreshes its
+// own faces and the vertices of those faces.
+//
+// Vertices at exactly the same position, like the copies along a UV seam,
+// share one normal summed over all of their faces, so seams stay smooth.
+//
+// Positions and normals are xyz floats, stride floats apart from one vertex
+// to the next, so they can be read straight out of interleaved vertices.
+class CDXVertexNormals
+{
+public:
+	CDXVertexNormals() : m_topology(NULL), m_stride(3), m_stamp(0) { }
+
+	// The topology has to outlive this object
+	void Build(const CDXMeshTopology * topology, const float * positions, UInt32 stride);
+	void Clear();
+
+	// Writes the normal of every vertex from scratch
+	void CalculateAll(const float * positions, float * normals);
+
+	// Normal of one vertex from the current positions, skips the cache
+	void Calculate(const float * positions, CDXMeshIndex i, float * normal) const;
+
+	void MarkDirty(CDXMeshIndex i);
+	bool IsDirty() const { return !m_dirty.empty(); }
+
+	// Refreshes the normals around every vertex marked since the last
+	// update, returns the vertices whose normal was rewritten
+	const std::vector<CDXMeshIndex> & Update(const float * positions, float * normals);
+
+private:
+	void FaceNormal(const float * positions, const CDXMeshFace & face, float * normal) const;
+	bool WriteNormal(float * normals, CDXMeshIndex i) const;
+	void BuildWelds(const float * positions, UInt32 vertexCount);
+	UInt32 NextStamp();
+
+	const CDXMeshTopology *		m_topology;
+	UInt32						m_stride;
+	std::vector<float>			m_faceNormals;	// xyz per face
+	std::vector<CDXMeshIndex>	m_weldNext;		// Ring through the vertices sharing a position
+	std::vector<CDXMeshIndex>	m_dirty;
+	std::vector<UInt8>			m_isDirty;
+	std::vector<UInt32>			m_faceStamp;
+	std::vector<UInt32>			m_vertexStamp;
+	UInt32						m_stamp;
+	std::vector<CDXMeshIndex>	m_updated;
+};
+
+#endif
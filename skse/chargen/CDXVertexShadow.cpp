@@ -0,0 +1,54 @@
+#include "CDXVertexShadow.h"
+
+#include <string.h>
+
+void CDXVertexShadow::Assign(const float * vertices, UInt32 stride, UInt32 count)
+{
+	m_stride = stride;
+	m_data.assign(vertices, vertices + count * stride);
+	m_dirtyBegin = 0;
+	m_dirtyEnd = 0;
+}
+
+void CDXVertexShadow::Clear()
+{
+	m_data.clear();
+	m_dirtyBegin = 0;
+	m_dirtyEnd = 0;
+}
+
+bool CDXVertexShadow::Move(CDXMeshIndex i, const float * offset)
+{
+	if (i >= Size())
+		return false;
+
+	float * position = &m_data[i * m_stride];
+	position[0] += offset[0];
+	position[1] += offset[1];
+	position[2] += offset[2];
+	MarkDirty(i);
+	return true;
+}
+
+void CDXVertexShadow::MarkDirty(CDXMeshIndex i)
+{
+	if (m_dirtyBegin == m_dirtyEnd) {
+		m_dirtyBegin = i;
+		m_dirtyEnd = i + 1;
+		return;
+	}
+
+	if (i < m_dirtyBegin)
+		m_dirtyBegin = i;
+	if (i >= m_dirtyEnd)
+		m_dirtyEnd = i + 1;
+}
+
+void CDXVertexShadow::Upload(float * dest)
+{
+	if (m_dirtyBegin == m_dirtyEnd)
+		return;
+
+	memcpy(dest, &m_data[m_dirtyBegin * m_stride], (m_dirtyEnd - m_dirtyBegin) * m_stride * sizeof(float));
+	m_dirtyBegin = m_dirtyEnd = 0;
+}
@@ -0,0 +1,45 @@
+#ifndef __CDXVERTEXSHADOW__
+#define __CDXVERTEXSHADOW__
+
+#pragma once
+
+#include "CDXMeshTypes.h"
+
+#include <vector>
+
+// CPU copy of interleaved vertex data and the span of it edited since the
+// last upload. Vertices are stride floats apart with the xyz position first.
+// Edits only widen the span, so an upload is always one contiguous copy
+// from the lowest to the highest edited vertex.
+class CDXVertexShadow
+{
+public:
+	CDXVertexShadow() : m_stride(3), m_dirtyBegin(0), m_dirtyEnd(0) { }
+
+	void Assign(const float * vertices, UInt32 stride, UInt32 count);
+	void Clear();
+
+	UInt32 Size() const { return m_data.size() / m_stride; }
+	UInt32 GetStride() const { return m_stride; }
+	float * GetData() { return m_data.empty() ? NULL : &m_data[0]; }
+
+	// Adds offset to the position of vertex i, false if there is no such vertex
+	bool Move(CDXMeshIndex i, const float * offset);
+	void MarkDirty(CDXMeshIndex i);
+
+	bool IsDirty() const { return m_dirtyBegin != m_dirtyEnd; }
+	UInt32 GetDirtyBegin() const { return m_dirtyBegin; }
+	UInt32 GetDirtyEnd() const { return m_dirtyEnd; }
+
+	// Copies the dirty vertices to dest, which maps the vertex at
+	// GetDirtyBegin, and starts a new span
+	void Upload(float * dest);
+
+private:
+	std::vector<float>	m_data;
+	UInt32				m_stride;
+	UInt32				m_dirtyBegin;
+	UInt32				m_dirtyEnd;
+};
+
+#endif
@@ -0,0 +1,148 @@
+#include "CDXVertexStreams.h"
+
+#include <algorithm>
+#include <xmmintrin.h>
+
+// Turns four x, y and z lanes into twelve floats in xyz order
+static inline void InterleaveXYZ(__m128 vx, __m128 vy, __m128 vz, __m128 & d0, __m128 & d1, __m128 & d2)
+{
+	__m128 xyLo = _mm_unpacklo_ps(vx, vy);	// x0 y0 x1 y1
+	__m128 xyHi = _mm_unpackhi_ps(vx, vy);	// x2 y2 x3 y3
+	__m128 zx = _mm_shuffle_ps(vz, xyLo, _MM_SHUFFLE(2, 2, 0, 0));	// z0 z0 x1 x1
+	__m128 yz = _mm_shuffle_ps(xyLo, vz, _MM_SHUFFLE(1, 1, 3, 3));	// y1 y1 z1 z1
+	__m128 zx3 = _mm_shuffle_ps(vz, xyHi, _MM_SHUFFLE(2, 2, 2, 2));	// z2 z2 x3 x3
+	__m128 yz3 = _mm_shuffle_ps(xyHi, vz, _MM_SHUFFLE(3, 3, 3, 2));	// x3 y3 z3 z3
+
+	d0 = _mm_shuffle_ps(xyLo, zx, _MM_SHUFFLE(2, 0, 1, 0));	// x0 y0 z0 x1
+	d1 = _mm_shuffle_ps(yz, xyHi, _MM_SHUFFLE(1, 0, 2, 0));	// y1 z1 x2 y2
+	d2 = _mm_shuffle_ps(zx3, yz3, _MM_SHUFFLE(2, 1, 2, 0));	// z2 x3 y3 z3
+}
+
+void CDXVectorStreams::Resize(UInt32 count)
+{
+	x.resize(count);
+	y.resize(count);
+	z.resize(count);
+}
+
+void CDXVectorStreams::Clear()
+{
+	x.clear();
+	y.clear();
+	z.clear();
+}
+
+void CDXVectorStreams::Gather(const float * source, UInt32 stride, UInt32 count)
+{
+	Resize(count);
+	for (UInt32 i = 0; i < count; i++, source += stride) {
+		x[i] = source[0];
+		y[i] = source[1];
+		z[i] = source[2];
+	}
+}
+
+void CDXVectorStreams::Scatter(float * dest, UInt32 stride) const
+{
+	UInt32 count = Size();
+	UInt32 i = 0;
+	if (stride == 3) {
+		for (; i + 4 <= count; i += 4, dest += 12) {
+			__m128 d0, d1, d2;
+			InterleaveXYZ(_mm_loadu_ps(&x[i]), _mm_loadu_ps(&y[i]), _mm_loadu_ps(&z[i]), d0, d1, d2);
+			_mm_storeu_ps(dest + 0, d0);
+			_mm_storeu_ps(dest + 4, d1);
+			_mm_storeu_ps(dest + 8, d2);
+		}
+	}
+
+	for (; i < count; i++, dest += stride) {
+		dest[0] = x[i];
+		dest[1] = y[i];
+		dest[2] = z[i];
+	}
+}
+
+void CDXVectorStreams::Scale(float multiplier)
+{
+	UInt32 count = Size();
+	UInt32 i = 0;
+	__m128 factor = _mm_set1_ps(multiplier);
+	for (; i + 4 <= count; i += 4) {
+		_mm_storeu_ps(&x[i], _mm_mul_ps(_mm_loadu_ps(&x[i]), factor));
+		_mm_storeu_ps(&y[i], _mm_mul_ps(_mm_loadu_ps(&y[i]), factor));
+		_mm_storeu_ps(&z[i], _mm_mul_ps(_mm_loadu_ps(&z[i]), factor));
+	}
+
+	for (; i < count; i++) {
+		x[i] *= multiplier;
+		y[i] *= multiplier;
+		z[i] *= multiplier;
+	}
+}
+
+void CDXVectorStreams::Transform(const float * rotation, const float * translation, float scale)
+{
+	const float * r = rotation;
+	const float * t = translation;
+
+	UInt32 count = Size();
+	UInt32 i = 0;
+	__m128 r0 = _mm_set1_ps(r[0]), r1 = _mm_set1_ps(r[1]), r2 = _mm_set1_ps(r[2]);
+	__m128 r3 = _mm_set1_ps(r[3]), r4 = _mm_set1_ps(r[4]), r5 = _mm_set1_ps(r[5]);
+	__m128 r6 = _mm_set1_ps(r[6]), r7 = _mm_set1_ps(r[7]), r8 = _mm_set1_ps(r[8]);
+	__m128 tx = _mm_set1_ps(t[0]), ty = _mm_set1_ps(t[1]), tz = _mm_set1_ps(t[2]);
+	__m128 s = _mm_set1_ps(scale);
+	for (; i + 4 <= count; i += 4) {
+		__m128 vx = _mm_loadu_ps(&x[i]);
+		__m128 vy = _mm_loadu_ps(&y[i]);
+		__m128 vz = _mm_loadu_ps(&z[i]);
+
+		__m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(r0, vx), _mm_mul_ps(r1, vy)), _mm_mul_ps(r2, vz));
+		__m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(r3, vx), _mm_mul_ps(r4, vy)), _mm_mul_ps(r5, vz));
+		__m128 rz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(r6, vx), _mm_mul_ps(r7, vy)), _mm_mul_ps(r8, vz));
+
+		_mm_storeu_ps(&x[i], _mm_add_ps(_mm_mul_ps(rx, s), tx));
+		_mm_storeu_ps(&y[i], _mm_add_ps(_mm_mul_ps(ry, s), ty));
+		_mm_storeu_ps(&z[i], _mm_add_ps(_mm_mul_ps(rz, s), tz));
+	}
+
+	for (; i < count; i++) {
+		float vx = x[i], vy = y[i], vz = z[i];
+		x[i] = (r[0] * vx + r[1] * vy + r[2] * vz) * scale + t[0];
+		y[i] = (r[3] * vx + r[4] * vy + r[5] * vz) * scale + t[1];
+		z[i] = (r[6] * vx + r[7] * vy + r[8] * vz) * scale + t[2];
+	}
+}
+
+void CDXScatterAdd(float * vectors, UInt32 vectorCount, const CDXMeshIndex * indices, const CDXVectorStreams & offsets, float multiplier)
+{
+	UInt32 count = std::lower_bound(indices, indices + offsets.Size(), vectorCount) - indices;
+
+	const float * px = offsets.x.data();
+	const float * py = offsets.y.data();
+	const float * pz = offsets.z.data();
+
+	__m128 factor = _mm_set1_ps(multiplier);
+	UInt32 n = 0;
+	while (n < count) {
+		// Unique sorted indices four apart over four entries are consecutive
+		if (n + 4 <= count && indices[n + 3] == indices[n] + 3) {
+			__m128 d0, d1, d2;
+			InterleaveXYZ(_mm_mul_ps(_mm_loadu_ps(px + n), factor), _mm_mul_ps(_mm_loadu_ps(py + n), factor), _mm_mul_ps(_mm_loadu_ps(pz + n), factor), d0, d1, d2);
+
+			float * out = vectors + indices[n] * 3;
+			_mm_storeu_ps(out + 0, _mm_add_ps(_mm_loadu_ps(out + 0), d0));
+			_mm_storeu_ps(out + 4, _mm_add_ps(_mm_loadu_ps(out + 4), d1));
+			_mm_storeu_ps(out + 8, _mm_add_ps(_mm_loadu_ps(out + 8), d2));
+			n += 4;
+		}
+		else {
+			float * out = vectors + indices[n] * 3;
+			out[0] += px[n] * multiplier;
+			out[1] += py[n] * multiplier;
+			out[2] += pz[n] * multiplier;
+			n++;
+		}
+	}
+}
@@ -0,0 +1,36 @@
+#ifndef __CDXVERTEXSTREAMS__
+#define __CDXVERTEXSTREAMS__
+
+#pragma once
+
+#include "CDXMeshTypes.h"
+
+#include <vector>
+
+// Structure of arrays copy of xyz vectors. Gathered out of and scattered back
+// into interleaved vertex data so the per vertex math in between runs four
+// vectors at a time with SSE.
+class CDXVectorStreams
+{
+public:
+	void Resize(UInt32 count);
+	void Clear();
+	UInt32 Size() const { return x.size(); }
+
+	// stride is the distance between two vectors in floats, 3 for packed xyz
+	void Gather(const float * source, UInt32 stride, UInt32 count);
+	void Scatter(float * dest, UInt32 stride) const;
+
+	void Scale(float multiplier);
+	// v = (rotation * v) * scale + translation, rotation is row major
+	void Transform(const float * rotation, const float * translation, float scale);
+
+	std::vector<float>	x, y, z;
+};
+
+// Adds offsets[n] * multiplier to vectors[indices[n]] of packed xyz vectors.
+// Indices are sorted and unique, from the first one past vectorCount on
+// they are skipped. Runs of four consecutive indices are added with SSE.
+void CDXScatterAdd(float * vectors, UInt32 vectorCount, const CDXMeshIndex * indices, const CDXVectorStreams & offsets, float multiplier);
+
+#endif
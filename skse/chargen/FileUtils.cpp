@@ -62,11 +62,11 @@ bool BSReadLine(BSResourceNiBinaryStream* fin, std::string* str)
 
 void BSReadAll(BSResourceNiBinaryStream* fin, std::string* str)
 {
-	char ch;
-	UInt32 ret = fin->Read(&ch, 1);
+	char buffer[0x10000];
+	UInt32 ret = fin->Read(buffer, sizeof(buffer));
 	while (ret > 0) {
-		str->push_back(ch);
-		ret = fin->Read(&ch, 1);
+		str->append(buffer, ret);
+		ret = fin->Read(buffer, sizeof(buffer));
 	}
 }
 
@@ -23,6 +23,7 @@ extern UInt32	g_customDataMax;
 extern bool		g_externalHeads;
 extern bool		g_extendedMorphs;
 extern bool		g_allowAllMorphs;
+extern bool		g_parallelTRICache;
 
 static const UInt32 kInstallRegenHeadHook_Base = 0x005A4B80 + 0x49B;
 static const UInt32 kInstallRegenHeadHook_Entry_retn = kInstallRegenHeadHook_Base + 0x8;
@@ -144,16 +145,6 @@ void RemoveCachedTRIFiles()
 }
 #endif
 
-class ExtendedMorphCache : public MorphMap::Visitor
-{
-public:
-	virtual bool Accept(BSFixedString morphName)
-	{
-		g_morphHandler.GetExtendedModelTri(morphName);
-		return false;
-	}
-};
-
 SInt32 GetGameSettingInt(const char * key)
 {
 	Setting	* setting = (*g_gameSettingCollection)->Get(key);
@@ -204,20 +195,18 @@ void _cdecl LoadActorValues_Hook()
 		}*/
 
 		if (g_extendedMorphs) {
+			std::vector<BGSHeadPart*> headParts;
+			headParts.reserve(dataHandler->headParts.count);
+
 			BGSHeadPart * part = NULL;
 			for (UInt32 i = 0; i < dataHandler->headParts.count; i++)
 			{
-				if (dataHandler->headParts.GetNthItem(i, part)) {
-					if (g_morphHandler.CacheHeadPartModel(part)) {
-
-						BSFixedString key = part->chargenMorph.GetModelName();
-
-						// Cache all of the extended morphs
-						ExtendedMorphCache extendedCache;
-						g_morphHandler.VisitMorphMap(key, extendedCache);
-					}
-				}
+				if (dataHandler->headParts.GetNthItem(i, part) && part)
+					headParts.push_back(part);
 			}
+
+			// Cache all of the head part and extended morphs
+			g_morphHandler.CacheHeadPartModels(headParts, g_parallelTRICache);
 		}
 
 		// Create default slider maps
@@ -0,0 +1,471 @@
+#include "JsonStream.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <cmath>
+
+UInt32 JsonStreamValue::AsUInt() const
+{
+	switch (type) {
+		case kType_Number:
+			if (number >= 4294967295.0)
+				return 0xFFFFFFFF;
+			if (number < 0.0)
+				return (UInt32)AsInt();
+			return (UInt32)number;
+		case kType_Bool:
+			return boolean ? 1 : 0;
+		default:
+			break;
+	}
+
+	return 0;
+}
+
+SInt32 JsonStreamValue::AsInt() const
+{
+	switch (type) {
+		case kType_Number:
+			if (number >= 2147483647.0)
+				return 0x7FFFFFFF;
+			if (number <= -2147483648.0)
+				return (SInt32)0x80000000;
+			return (SInt32)number;
+		case kType_Bool:
+			return boolean ? 1 : 0;
+		default:
+			break;
+	}
+
+	return 0;
+}
+
+float JsonStreamValue::AsFloat() const
+{
+	switch (type) {
+		case kType_Number:
+			return (float)number;
+		case kType_Bool:
+			return boolean ? 1.0f : 0.0f;
+		default:
+			break;
+	}
+
+	return 0.0f;
+}
+
+bool JsonStreamValue::AsBool() const
+{
+	switch (type) {
+		case kType_Number:
+			return number != 0.0;
+		case kType_Bool:
+			return boolean;
+		default:
+			break;
+	}
+
+	return false;
+}
+
+const std::string & JsonStreamValue::AsString() const
+{
+	static const std::string empty;
+	return type == kType_String ? string : empty;
+}
+
+JsonStreamReader::JsonStreamReader(const char * begin, const char * end)
+{
+	m_begin = begin;
+	m_pos = begin;
+	m_end = end;
+	m_error = NULL;
+	m_depth = 0;
+}
+
+bool JsonStreamReader::Fail(const char * error)
+{
+	if (!m_error)
+		m_error = error;
+
+	// Stop every later read at the error
+	m_end = m_pos;
+	return false;
+}
+
+void JsonStreamReader::SkipWhitespace()
+{
+	while (m_pos < m_end)
+	{
+		char c = *m_pos;
+		if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+			m_pos++;
+		}
+		else if (c == '/' && m_end - m_pos >= 2 && m_pos[1] == '/') {
+			m_pos += 2;
+			while (m_pos < m_end && *m_pos != '\n')
+				m_pos++;
+		}
+		else if (c == '/' && m_end - m_pos >= 2 && m_pos[1] == '*') {
+			const char * start = m_pos;
+			m_pos += 2;
+			while (m_end - m_pos >= 2 && !(m_pos[0] == '*' && m_pos[1] == '/'))
+				m_pos++;
+
+			if (m_end - m_pos < 2) {
+				m_pos = start;
+				Fail("unterminated comment");
+				return;
+			}
+			m_pos += 2;
+		}
+		else
+			break;
+	}
+}
+
+bool JsonStreamReader::Expect(char c)
+{
+	SkipWhitespace();
+	if (m_pos >= m_end || *m_pos != c)
+		return Fail("unexpected character");
+
+	m_pos++;
+	return true;
+}
+
+JsonStreamValue::Type JsonStreamReader::Peek()
+{
+	SkipWhitespace();
+	if (m_pos >= m_end)
+		return JsonStreamValue::kType_Null;
+
+	switch (*m_pos) {
+		case '{':	return JsonStreamValue::kType_Object;
+		case '[':	return JsonStreamValue::kType_Array;
+		case '"':	return JsonStreamValue::kType_String;
+		case 't':
+		case 'f':	return JsonStreamValue::kType_Bool;
+		case 'n':	return JsonStreamValue::kType_Null;
+	}
+
+	return JsonStreamValue::kType_Number;
+}
+
+bool JsonStreamReader::BeginObject()
+{
+	if (m_depth >= kMaxDepth)
+		return Fail("nesting too deep");
+	if (!Expect('{'))
+		return false;
+
+	m_first[m_depth++] = true;
+	return true;
+}
+
+bool JsonStreamReader::NextMember(std::string & name)
+{
+	if (m_depth == 0)
+		return Fail("not in an object");
+
+	SkipWhitespace();
+	if (m_pos >= m_end)
+		return Fail("unexpected end of object");
+
+	if (*m_pos == '}') {
+		m_pos++;
+		m_depth--;
+		return false;
+	}
+
+	if (!m_first[m_depth - 1] && !Expect(','))
+		return false;
+	m_first[m_depth - 1] = false;
+
+	SkipWhitespace();
+	if (m_pos >= m_end || *m_pos != '"')
+		return Fail("expected member name");
+
+	return ReadString(name) && Expect(':');
+}
+
+bool JsonStreamReader::BeginArray()
+{
+	if (m_depth >= kMaxDepth)
+		return Fail("nesting too deep");
+	if (!Expect('['))
+		return false;
+
+	m_first[m_depth++] = true;
+	return true;
+}
+
+bool JsonStreamReader::NextElement()
+{
+	if (m_depth == 0)
+		return Fail("not in an array");
+
+	SkipWhitespace();
+	if (m_pos >= m_end)
+		return Fail("unexpected end of array");
+
+	if (*m_pos == ']') {
+		m_pos++;
+		m_depth--;
+		return false;
+	}
+
+	if (!m_first[m_depth - 1] && !Expect(','))
+		return false;
+	m_first[m_depth - 1] = false;
+	return true;
+}
+
+bool JsonStreamReader::ReadLiteral(const char * literal, UInt32 length)
+{
+	if ((UInt32)(m_end - m_pos) < length || memcmp(m_pos, literal, length) != 0)
+		return Fail("invalid literal");
+
+	m_pos += length;
+	return true;
+}
+
+static bool DecodeHex(const char * p, UInt32 & value)
+{
+	value = 0;
+	for (UInt32 i = 0; i < 4; i++) {
+		char c = p[i];
+		value <<= 4;
+		if (c >= '0' && c <= '9')
+			value |= c - '0';
+		else if (c >= 'a' && c <= 'f')
+			value |= c - 'a' + 10;
+		else if (c >= 'A' && c <= 'F')
+			value |= c - 'A' + 10;
+		else
+			return false;
+	}
+
+	return true;
+}
+
+static void AppendUTF8(std::string & str, UInt32 cp)
+{
+	if (cp < 0x80) {
+		str += (char)cp;
+	}
+	else if (cp < 0x800) {
+		str += (char)(0xC0 | (cp >> 6));
+		str += (char)(0x80 | (cp & 0x3F));
+	}
+	else if (cp < 0x10000) {
+		str += (char)(0xE0 | (cp >> 12));
+		str += (char)(0x80 | ((cp >> 6) & 0x3F));
+		str += (char)(0x80 | (cp & 0x3F));
+	}
+	else {
+		str += (char)(0xF0 | (cp >> 18));
+		str += (char)(0x80 | ((cp >> 12) & 0x3F));
+		str += (char)(0x80 | ((cp >> 6) & 0x3F));
+		str += (char)(0x80 | (cp & 0x3F));
+	}
+}
+
+bool JsonStreamReader::ReadString(std::string & str)
+{
+	// Opening quote was checked by the caller
+	m_pos++;
+	str.clear();
+
+	const char * run = m_pos;
+	while (m_pos < m_end)
+	{
+		char c = *m_pos;
+		if (c == '"') {
+			str.append(run, m_pos);
+			m_pos++;
+			return true;
+		}
+
+		if (c != '\\') {
+			m_pos++;
+			continue;
+		}
+
+		str.append(run, m_pos);
+		if (m_end - m_pos < 2)
+			break;
+
+		c = m_pos[1];
+		m_pos += 2;
+		switch (c) {
+			case '"':	str += '"'; break;
+			case '\\':	str += '\\'; break;
+			case '/':	str += '/'; break;
+			case 'b':	str += '\b'; break;
+			case 'f':	str += '\f'; break;
+			case 'n':	str += '\n'; break;
+			case 'r':	str += '\r'; break;
+			case 't':	str += '\t'; break;
+			case 'u':
+			{
+				UInt32 cp = 0;
+				if (m_end - m_pos < 4 || !DecodeHex(m_pos, cp))
+					return Fail("invalid unicode escape");
+				m_pos += 4;
+
+				if (cp >= 0xD800 && cp <= 0xDBFF) {
+					UInt32 low = 0;
+					if (m_end - m_pos < 6 || m_pos[0] != '\\' || m_pos[1] != 'u' || !DecodeHex(m_pos + 2, low) || low < 0xDC00 || low > 0xDFFF)
+						return Fail("invalid surrogate pair");
+					m_pos += 6;
+					cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+				}
+
+				AppendUTF8(str, cp);
+				break;
+			}
+			default:
+				return Fail("invalid escape");
+		}
+
+		run = m_pos;
+	}
+
+	return Fail("unterminated string");
+}
+
+bool JsonStreamReader::ReadNumber(double & number)
+{
+	const char * start = m_pos;
+	const char * p = m_pos;
+
+	bool negative = false;
+	if (p < m_end && *p == '-') {
+		negative = true;
+		p++;
+	}
+
+	if (p >= m_end || *p < '0' || *p > '9')
+		return Fail("invalid number");
+
+	// Integers short enough to be exact skip strtod
+	UInt64 mantissa = 0;
+	UInt32 digits = 0;
+	if (*p == '0') {
+		p++;
+		digits++;
+	}
+	else {
+		while (p < m_end && *p >= '0' && *p <= '9') {
+			mantissa = mantissa * 10 + (*p - '0');
+			p++;
+			digits++;
+		}
+	}
+
+	bool integer = true;
+	if (p < m_end && *p == '.') {
+		integer = false;
+		p++;
+		if (p >= m_end || *p < '0' || *p > '9')
+			return Fail("invalid number");
+		while (p < m_end && *p >= '0' && *p <= '9')
+			p++;
+	}
+
+	if (p < m_end && (*p == 'e' || *p == 'E')) {
+		integer = false;
+		p++;
+		if (p < m_end && (*p == '+' || *p == '-'))
+			p++;
+		if (p >= m_end || *p < '0' || *p > '9')
+			return Fail("invalid number");
+		while (p < m_end && *p >= '0' && *p <= '9')
+			p++;
+	}
+
+	m_pos = p;
+	if (integer && digits < 19) {
+		number = negative ? -(double)mantissa : (double)mantissa;
+		return true;
+	}
+
+	// The document isn't terminated, strtod needs its own copy
+	char buffer[64];
+	size_t length = p - start;
+	if (length < sizeof(buffer)) {
+		memcpy(buffer, start, length);
+		buffer[length] = 0;
+		number = strtod(buffer, NULL);
+	}
+	else {
+		std::string copy(start, p);
+		number = strtod(copy.c_str(), NULL);
+	}
+
+	if (!std::isfinite(number)) {
+		m_pos = start;
+		return Fail("number out of range");
+	}
+
+	return true;
+}
+
+bool JsonStreamReader::ReadValue(JsonStreamValue & value)
+{
+	value.type = Peek();
+	if (m_pos >= m_end)
+		return Fail("expected value");
+
+	switch (value.type) {
+		case JsonStreamValue::kType_Object:
+		case JsonStreamValue::kType_Array:
+			return Skip();
+		case JsonStreamValue::kType_String:
+			return ReadString(value.string);
+		case JsonStreamValue::kType_Bool:
+			value.boolean = *m_pos == 't';
+			return value.boolean ? ReadLiteral("true", 4) : ReadLiteral("false", 5);
+		case JsonStreamValue::kType_Null:
+			return ReadLiteral("null", 4);
+		default:
+			break;
+	}
+
+	return ReadNumber(value.number);
+}
+
+bool JsonStreamReader::Skip()
+{
+	std::string scratch;
+	switch (Peek()) {
+		case JsonStreamValue::kType_Object:
+			if (!BeginObject())
+				return false;
+			while (NextMember(scratch)) {
+				if (!Skip())
+					return false;
+			}
+			return !Failed();
+		case JsonStreamValue::kType_Array:
+			if (!BeginArray())
+				return false;
+			while (NextElement()) {
+				if (!Skip())
+					return false;
+			}
+			return !Failed();
+		default:
+			break;
+	}
+
+	JsonStreamValue value;
+	return ReadValue(value);
+}
+
+bool JsonStreamReader::AtEnd()
+{
+	SkipWhitespace();
+	return !Failed() && m_pos >= m_end;
+}
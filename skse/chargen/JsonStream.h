@@ -0,0 +1,87 @@
+#pragma once
+
+#include <string>
+
+// Scalar read from a JsonStreamReader. Conversions follow jsoncpp, values
+// of another type read as zero or empty.
+class JsonStreamValue
+{
+public:
+	enum Type
+	{
+		kType_Null = 0,
+		kType_Bool,
+		kType_Number,
+		kType_String,
+		kType_Array,
+		kType_Object
+	};
+
+	JsonStreamValue() : type(kType_Null), number(0.0), boolean(false) { }
+
+	bool IsNull() const { return type == kType_Null; }
+
+	UInt32 AsUInt() const;
+	SInt32 AsInt() const;
+	float AsFloat() const;
+	bool AsBool() const;
+	const std::string & AsString() const;
+
+	Type		type;
+	double		number;
+	bool		boolean;
+	std::string	string;
+};
+
+// Pull parser over a json document held in memory. Values are visited in
+// document order without building a tree, every value must be consumed by
+// a Read, Skip or Begin call before moving to the next member or element.
+// Accepts the comments jsoncpp allows, anything else malformed stops the
+// reader at the first error.
+class JsonStreamReader
+{
+public:
+	enum
+	{
+		kMaxDepth = 64
+	};
+
+	JsonStreamReader(const char * begin, const char * end);
+
+	// Type of the next value, kType_Null on error
+	JsonStreamValue::Type Peek();
+
+	bool BeginObject();
+	// Reads the next member name of the current object, false at its end
+	bool NextMember(std::string & name);
+
+	bool BeginArray();
+	// Moves to the next element of the current array, false at its end
+	bool NextElement();
+
+	// Reads a scalar, containers are skipped and read as their type
+	bool ReadValue(JsonStreamValue & value);
+	bool Skip();
+
+	// True if only whitespace and comments remain
+	bool AtEnd();
+
+	bool Failed() const { return m_error != NULL; }
+	const char * GetError() const { return m_error; }
+	UInt32 GetOffset() const { return m_pos - m_begin; }
+
+private:
+	bool Fail(const char * error);
+	void SkipWhitespace();
+	bool Expect(char c);
+	bool ReadString(std::string & str);
+	bool ReadNumber(double & number);
+	bool ReadLiteral(const char * literal, UInt32 length);
+
+	const char	* m_begin;
+	const char	* m_pos;
+	const char	* m_end;
+	const char	* m_error;
+	UInt32		m_depth;
+	bool		m_first[kMaxDepth];
+};
@@ -9,8 +9,8 @@
 
 #pragma warning(disable: 4995)
 #include "meshloader.h"
-#include <fstream>
-using namespace std;
+#include "ObjReader.h"
+#include <stdio.h>
 #pragma warning(default: 4995)
 
 
@@ -83,9 +83,10 @@ template<typename TYPE> HRESULT CGrowableArray <TYPE>::SetSize( int nNewMaxSize
 		}
 	}
 
-	// Adjust buffer.  Note that there's no need to check for error
-	// since if it happens, nOldSize == nNewMaxSize will be true.)
+	// Adjust buffer. On failure the elements past nOldSize were never allocated.
 	HRESULT hr = SetSizeInternal( nNewMaxSize );
+	if( FAILED( hr ) )
+		return hr;
 
 	if( nOldSize < nNewMaxSize )
 	{
@@ -99,6 +100,7 @@ template<typename TYPE> HRESULT CGrowableArray <TYPE>::SetSize( int nNewMaxSize
 		}
 	}
 
+	m_nSize = nNewMaxSize;
 	return hr;
 }
 
@@ -308,7 +310,7 @@ void CMeshLoader::Destroy()
 //--------------------------------------------------------------------------------------
 HRESULT CMeshLoader::Create( IDirect3DDevice9* pd3dDevice, const WCHAR* strFilename )
 {
-    WCHAR str[ MAX_PATH ] = {0};
+    HRESULT hr;
 
     // Start clean
     Destroy();
@@ -319,7 +321,7 @@ HRESULT CMeshLoader::Create( IDirect3DDevice9* pd3dDevice, const WCHAR* strFilen
     // Load the vertex buffer, index buffer, and subset information from a file. In this case, 
     // an .obj file was chosen for simplicity, but it's meant to illustrate that ID3DXMesh objects
     // can be filled from any mesh file format once the necessary data is extracted from file.
-    LoadGeometryFromOBJ( strFilename );
+    V_RETURN( LoadGeometryFromOBJ( strFilename ) );
 
     // Create the encapsulated mesh
     ID3DXMesh* pMesh = NULL;
@@ -368,205 +370,56 @@ HRESULT CMeshLoader::Create( IDirect3DDevice9* pd3dDevice, const WCHAR* strFilen
 //--------------------------------------------------------------------------------------
 HRESULT CMeshLoader::LoadGeometryFromOBJ( const WCHAR* strFileName )
 {
-    WCHAR strMaterialFilename[MAX_PATH] = {0};
-    char str[MAX_PATH];
-
-    WideCharToMultiByte( CP_ACP, 0, strFileName, -1, str, MAX_PATH, NULL, NULL );
-
-    // Create temporary storage for the input data. Once the data has been loaded into
-    // a reasonable format we can create a D3DXMesh object and load it with the mesh data.
-    CGrowableArray <D3DXVECTOR3> Positions;
-    CGrowableArray <D3DXVECTOR2> TexCoords;
-    CGrowableArray <D3DXVECTOR3> Normals;
+    HRESULT hr;
 
-    DWORD dwCurSubset = 0;
+    // Read the whole file at once, ObjReader parses the buffer in memory
+    FILE* pFile = _wfopen( strFileName, L"rb" );
+    if( pFile == NULL )
+        return E_FAIL;
 
-    // File input
-    WCHAR strCommand[256] = {0};
-    wifstream InFile( str );
-    if( !InFile )
-        return NULL;
-
-    for(; ; )
+    fseek( pFile, 0, SEEK_END );
+    long nFileSize = ftell( pFile );
+    fseek( pFile, 0, SEEK_SET );
+    if( nFileSize <= 0 )
     {
-        InFile >> strCommand;
-        if( !InFile )
-            break;
-
-        if( 0 == wcscmp( strCommand, L"#" ) )
-        {
-            // Comment
-        }
-        else if( 0 == wcscmp( strCommand, L"v" ) )
-        {
-            // Vertex Position
-            float x, y, z;
-            InFile >> x >> y >> z;
-            Positions.Add( D3DXVECTOR3( x, y, z ) );
-        }
-        else if( 0 == wcscmp( strCommand, L"vt" ) )
-        {
-            // Vertex TexCoord
-            float u, v;
-            InFile >> u >> v;
-            TexCoords.Add( D3DXVECTOR2( u, v ) );
-        }
-        else if( 0 == wcscmp( strCommand, L"vn" ) )
-        {
-            // Vertex Normal
-            float x, y, z;
-            InFile >> x >> y >> z;
-            Normals.Add( D3DXVECTOR3( x, y, z ) );
-        }
-        else if( 0 == wcscmp( strCommand, L"f" ) )
-        {
-            // Face
-            UINT iPosition, iTexCoord, iNormal;
-            VERTEX vertex;
-
-            for( UINT iFace = 0; iFace < 3; iFace++ )
-            {
-                ZeroMemory( &vertex, sizeof( VERTEX ) );
-
-                // OBJ format uses 1-based arrays
-                InFile >> iPosition;
-                vertex.position = Positions[ iPosition - 1 ];
-
-                if( '/' == InFile.peek() )
-                {
-                    InFile.ignore();
-
-                    if( '/' != InFile.peek() )
-                    {
-                        // Optional texture coordinate
-                        InFile >> iTexCoord;
-                        vertex.texcoord = TexCoords[ iTexCoord - 1 ];
-                    }
-
-                    if( '/' == InFile.peek() )
-                    {
-                        InFile.ignore();
-
-                        // Optional vertex normal
-                        InFile >> iNormal;
-                        vertex.normal = Normals[ iNormal - 1 ];
-                    }
-                }
-
-                // If a duplicate vertex doesn't exist, add this vertex to the Vertices
-                // list. Store the index in the Indices array. The Vertices and Indices
-                // lists will eventually become the Vertex Buffer and Index Buffer for
-                // the mesh.
-                DWORD index = AddVertex( iPosition, &vertex );
-                m_Indices.Add( index );
-            }
-            m_Attributes.Add( dwCurSubset );
-        }
-        
-        InFile.ignore( 1000, '\n' );
+        fclose( pFile );
+        return E_FAIL;
     }
 
-    // Cleanup
-    InFile.close();
-    DeleteCache();
-
-    return S_OK;
-}
-
-
-//--------------------------------------------------------------------------------------
-DWORD CMeshLoader::AddVertex( UINT hash, VERTEX* pVertex )
-{
-    // If this vertex doesn't already exist in the Vertices list, create a new entry.
-    // Add the index of the vertex to the Indices list.
-    bool bFoundInList = false;
-    DWORD index = 0;
-
-    // Since it's very slow to check every element in the vertex list, a hashtable stores
-    // vertex indices according to the vertex position's index as reported by the OBJ file
-    if( ( UINT )m_VertexCache.GetSize() > hash )
+    char* pBuffer = new char[nFileSize];
+    size_t nRead = fread( pBuffer, 1, nFileSize, pFile );
+    fclose( pFile );
+
+    ObjReader reader;
+    bool bRead = reader.Read( pBuffer, pBuffer + nRead );
+    SAFE_DELETE_ARRAY( pBuffer );
+    if( !bRead )
+        return E_FAIL;
+
+    // ObjVertex matches VERTEX, the arrays are copied over whole
+    static_assert( sizeof( ObjVertex ) == sizeof( VERTEX ), "ObjVertex must match VERTEX" );
+
+    int nVertices = ( int )reader.vertices.size();
+    int nIndices = ( int )reader.indices.size();
+    if( FAILED( hr = m_Vertices.SetSize( nVertices ) ) ||
+        FAILED( hr = m_Indices.SetSize( nIndices ) ) ||
+        FAILED( hr = m_Attributes.SetSize( nIndices / 3 ) ) )
+        return hr;
+
+    if( nVertices > 0 )
+        memcpy( m_Vertices.GetData(), &reader.vertices[0], nVertices * sizeof( VERTEX ) );
+    if( nIndices > 0 )
     {
-        CacheEntry* pEntry = m_VertexCache.GetAt( hash );
-        while( pEntry != NULL )
-        {
-            VERTEX* pCacheVertex = m_Vertices.GetData() + pEntry->index;
-
-            // If this vertex is identical to the vertex already in the list, simply
-            // point the index buffer to the existing vertex
-            if( 0 == memcmp( pVertex, pCacheVertex, sizeof( VERTEX ) ) )
-            {
-                bFoundInList = true;
-                index = pEntry->index;
-                break;
-            }
-
-            pEntry = pEntry->pNext;
-        }
-    }
-
-    // Vertex was not found in the list. Create a new entry, both within the Vertices list
-    // and also within the hashtable cache
-    if( !bFoundInList )
-    {
-        // Add to the Vertices list
-        index = m_Vertices.GetSize();
-        m_Vertices.Add( *pVertex );
-
-        // Add this to the hashtable
-        CacheEntry* pNewEntry = new CacheEntry;
-        if( pNewEntry == NULL )
-            return E_OUTOFMEMORY;
-
-        pNewEntry->index = index;
-        pNewEntry->pNext = NULL;
-
-        // Grow the cache if needed
-        while( ( UINT )m_VertexCache.GetSize() <= hash )
-        {
-            m_VertexCache.Add( NULL );
-        }
-
-        // Add to the end of the linked list
-        CacheEntry* pCurEntry = m_VertexCache.GetAt( hash );
-        if( pCurEntry == NULL )
-        {
-            // This is the head element
-            m_VertexCache.SetAt( hash, pNewEntry );
-        }
-        else
-        {
-            // Find the tail
-            while( pCurEntry->pNext != NULL )
-            {
-                pCurEntry = pCurEntry->pNext;
-            }
+        memcpy( m_Indices.GetData(), &reader.indices[0], nIndices * sizeof( DWORD ) );
 
-            pCurEntry->pNext = pNewEntry;
-        }
+        // Every face belongs to the first subset
+        ZeroMemory( m_Attributes.GetData(), ( nIndices / 3 ) * sizeof( DWORD ) );
     }
 
-    return index;
+    return S_OK;
 }
 
 
-//--------------------------------------------------------------------------------------
-void CMeshLoader::DeleteCache()
-{
-    // Iterate through all the elements in the cache and subsequent linked lists
-    for( int i = 0; i < m_VertexCache.GetSize(); i++ )
-    {
-        CacheEntry* pEntry = m_VertexCache.GetAt( i );
-        while( pEntry != NULL )
-        {
-            CacheEntry* pNext = pEntry->pNext;
-            SAFE_DELETE( pEntry );
-            pEntry = pNext;
-        }
-    }
-
-    m_VertexCache.RemoveAll();
-}
-
 //--------------------------------------------------------------------------------------
 void CMeshLoader::InitMaterial( Material* pMaterial )
 {
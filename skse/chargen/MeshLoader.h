@@ -165,14 +165,6 @@ struct VERTEX
 };
 
 
-// Used for a hashtable vertex cache when creating the mesh from a .obj file
-struct CacheEntry
-{
-    UINT index;
-    CacheEntry* pNext;
-};
-
-
 // Material properties per mesh subset
 struct Material
 {
@@ -226,13 +218,10 @@ private:
     HRESULT LoadGeometryFromOBJ( const WCHAR* strFilename );
     void    InitMaterial( Material* pMaterial );
 
-    DWORD   AddVertex( UINT hash, VERTEX* pVertex );
-    void    DeleteCache();
 
     IDirect3DDevice9* m_pd3dDevice;    // Direct3D Device object associated with this mesh
     ID3DXMesh* m_pMesh;         // Encapsulated D3DX Mesh
 
-    CGrowableArray <CacheEntry*> m_VertexCache;   // Hashtable cache for locating duplicate vertices
     CGrowableArray <VERTEX> m_Vertices;      // Filled and copied to the vertex buffer
     CGrowableArray <DWORD> m_Indices;       // Filled and copied to the index buffer
     CGrowableArray <DWORD> m_Attributes;    // Filled and copied to the attribute buffer
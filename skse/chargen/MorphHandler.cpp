@@ -27,6 +27,7 @@
 #include "ScaleformFunctions.h"
 #include "Hooks.h"
 #include "NifUtils.h"
+#include "PresetJson.h"
 
 #include "interfaces/OverrideVariant.h"
 #include "interfaces/OverrideInterface.h"
@@ -41,6 +42,10 @@ extern OverlayInterface		* g_overlayInterface;
 
 #include <map>
 #include <vector>
+#include <unordered_set>
+#include <algorithm>
+#include <ppl.h>
+#include <xmmintrin.h>
 
 extern float g_sliderMultiplier;
 extern float g_sliderInterval;
@@ -84,6 +89,31 @@ bool SliderSet::for_each_slider(std::function<bool(SliderGenderPtr)> func)
 	return false;
 }
 
+SliderInternalPtr SliderSet::FindSlider(UInt8 gender, BSFixedString name)
+{
+	if (!m_indexed)
+	{
+		for (UInt32 i = 0; i <= 1; i++)
+			m_index[i].clear();
+
+		for_each_slider([&](SliderGenderPtr genders) {
+			for (UInt32 i = 0; i <= 1; i++) {
+				if (genders->slider[i])
+					m_index[i].emplace(genders->slider[i]->name, genders->slider[i]);
+			}
+			return false;
+		});
+
+		m_indexed = true;
+	}
+
+	auto it = m_index[gender].find(name);
+	if (it != m_index[gender].end())
+		return it->second;
+
+	return NULL;
+}
+
 SliderSetPtr RaceMap::GetSliderSet(TESRace * race)
 {
 	RaceMap::iterator it = find(race);
@@ -102,10 +132,9 @@ SInt32 ReadTRIVertexCount(const char * triPath)
 	char filePath[MAX_PATH];
 	memset(filePath, 0, MAX_PATH);
 	sprintf_s(filePath, MAX_PATH, "Meshes\\%s", triPath);
-	BSFixedString newPath(filePath);
 
-	// Cached file already exists, load it
-	BSResourceNiBinaryStream file(newPath.data);
+	// Called from worker threads, the path is not interned
+	BSResourceNiBinaryStream file(filePath);
 	if (!file.IsValid()) {
 		return -1;
 	}
@@ -124,7 +153,7 @@ SInt32 ReadTRIVertexCount(const char * triPath)
 bool TRIFile::Load(const char * triPath)
 {
 	if (triPath[0] == 0) {
-		return -1;
+		return false;
 	}
 
 	char filePath[MAX_PATH];
@@ -137,76 +166,138 @@ bool TRIFile::Load(const char * triPath)
 		return false;
 	}
 
-	char header[0x08];
-	file.Read(header, 0x08);
-	if (strncmp(header, "FRTRI003", 8) != 0)
-		return false;
-
-	file.Read(&vertexCount, sizeof(vertexCount));
+	// Pull the whole file in large blocks and decode from memory
+	std::vector<UInt8> buffer;
+	UInt32 read = 0;
+	do {
+		size_t offset = buffer.size();
+		buffer.resize(offset + 0x10000);
+		read = file.Read(&buffer[offset], 0x10000);
+		buffer.resize(offset + read);
+	} while (read > 0);
 
-	UInt32 polytris = 0, polyquads = 0, unk2 = 0, unk3 = 0, 
-		uvverts = 0, flags = 0, numMorphs = 0, numMods = 0, 
-		modVerts = 0, unk7 = 0, unk8 = 0, unk9 = 0, unk10 = 0;
-
-	file.Read(&polytris, sizeof(polytris));
-	file.Read(&polyquads, sizeof(polyquads));
-	file.Read(&unk2, sizeof(unk2));
-	file.Read(&unk3, sizeof(unk3));
-	file.Read(&uvverts, sizeof(uvverts));
-	file.Read(&flags, sizeof(flags));
-	file.Read(&numMorphs, sizeof(numMorphs));
-	file.Read(&numMods, sizeof(numMods));
-	file.Read(&modVerts, sizeof(modVerts));
-	file.Read(&unk7, sizeof(unk7));
-	file.Read(&unk8, sizeof(unk8));
-	file.Read(&unk9, sizeof(unk9));
-	file.Read(&unk10, sizeof(unk10));
+	struct Header
+	{
+		char	magic[8];
+		UInt32	vertexCount;
+		UInt32	polytris;
+		UInt32	polyquads;
+		UInt32	unk2;
+		UInt32	unk3;
+		UInt32	uvverts;
+		UInt32	flags;
+		UInt32	numMorphs;
+		UInt32	numMods;
+		UInt32	modVerts;
+		UInt32	unk7;
+		UInt32	unk8;
+		UInt32	unk9;
+		UInt32	unk10;
+	};
 
-	// Skip reference verts
-	file.Seek(vertexCount * 3 * sizeof(float));
+	if (buffer.size() < sizeof(Header))
+		return false;
 
-	// Skip polytris
-	file.Seek(polytris * 3 * sizeof(UInt32));
+	Header header;
+	memcpy(&header, &buffer[0], sizeof(header));
+	if (strncmp(header.magic, "FRTRI003", 8) != 0)
+		return false;
 
-	// Skip UV
-	if (uvverts > 0)
-		file.Seek(uvverts * 2 * sizeof(float));
+	vertexCount = header.vertexCount;
 
-	// Skip text coords
-	file.Seek(polytris * 3 * sizeof(UInt32));
+	// Skip reference verts, polytris, UV and text coords
+	UInt64 offset = sizeof(Header);
+	offset += (UInt64)header.vertexCount * 3 * sizeof(float);
+	offset += (UInt64)header.polytris * 3 * sizeof(UInt32);
+	offset += (UInt64)header.uvverts * 2 * sizeof(float);
+	offset += (UInt64)header.polytris * 3 * sizeof(UInt32);
 
-	for (UInt32 i = 0; i < numMorphs; i++)
+	UInt64 morphSize = (UInt64)header.vertexCount * 3 * sizeof(SInt16);
+	for (UInt32 i = 0; i < header.numMorphs; i++)
 	{
 		UInt32 strLen = 0;
-		file.Read(&strLen, sizeof(strLen));
+		if (offset + sizeof(strLen) > buffer.size())
+			break;
+		memcpy(&strLen, &buffer[offset], sizeof(strLen));
+		offset += sizeof(strLen);
 
-		char * name = new char[strLen+1];
-		for (UInt32 l = 0; l < strLen; l++)
-		{
-			file.Read(&name[l], sizeof(char));
+		float mult = 0.0f;
+		if (offset + strLen + sizeof(mult) + morphSize > buffer.size()) {
+			_ERROR("%s - Truncated morph %d in %s", __FUNCTION__, i, filePath);
+			break;
 		}
-		name[strLen] = 0;
 
-		float mult = 0.0f;
-		file.Read(&mult, sizeof(mult));
+		std::string name((const char *)&buffer[offset], strLen);
+		offset += strLen;
+		memcpy(&mult, &buffer[offset], sizeof(mult));
+		offset += sizeof(mult);
 
 		Morph morph;
-		morph.name = BSFixedString(name);
+		morph.name = BSFixedString(name.c_str());
 		morph.multiplier = mult;
+		morph.Decode((const SInt16 *)&buffer[offset], header.vertexCount);
+		offset += morphSize;
 
-		for (UInt32 v = 0; v < vertexCount; v++)
-		{
-			Morph::Vertex vert;
-			file.Read(&vert, sizeof(vert));
-			morph.vertices.push_back(vert);
-		}
-
-		morphs.insert(std::make_pair(morph.name, morph));
+		morphs.insert(std::make_pair(morph.name, std::move(morph)));
 	}
 
 	return true;
 }
 
+void TRIFile::Morph::Decode(const SInt16 * packed, UInt32 count)
+{
+	x.resize(count);
+	y.resize(count);
+	z.resize(count);
+	for (UInt32 i = 0; i < count; i++)
+	{
+		x[i] = (float)packed[i * 3 + 0] * multiplier;
+		y[i] = (float)packed[i * 3 + 1] * multiplier;
+		z[i] = (float)packed[i * 3 + 2] * multiplier;
+	}
+}
+
+void TRIFile::Morph::Apply(NiPoint3 * vertices, UInt32 count, float relative) const
+{
+	const float * px = x.data();
+	const float * py = y.data();
+	const float * pz = z.data();
+	float * dst = (float *)vertices;
+
+	UInt32 i = 0;
+	__m128 factor = _mm_set1_ps(relative);
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128 vx = _mm_mul_ps(_mm_loadu_ps(px + i), factor);
+		__m128 vy = _mm_mul_ps(_mm_loadu_ps(py + i), factor);
+		__m128 vz = _mm_mul_ps(_mm_loadu_ps(pz + i), factor);
+
+		// Interleave four deltas into xyz order
+		__m128 xyLo = _mm_unpacklo_ps(vx, vy);	// x0 y0 x1 y1
+		__m128 xyHi = _mm_unpackhi_ps(vx, vy);	// x2 y2 x3 y3
+		__m128 zx = _mm_shuffle_ps(vz, xyLo, _MM_SHUFFLE(2, 2, 0, 0));	// z0 z0 x1 x1
+		__m128 yz = _mm_shuffle_ps(xyLo, vz, _MM_SHUFFLE(1, 1, 3, 3));	// y1 y1 z1 z1
+		__m128 zx3 = _mm_shuffle_ps(vz, xyHi, _MM_SHUFFLE(2, 2, 2, 2));	// z2 z2 x3 x3
+		__m128 yz3 = _mm_shuffle_ps(xyHi, vz, _MM_SHUFFLE(3, 3, 3, 2));	// x3 y3 z3 z3
+
+		__m128 d0 = _mm_shuffle_ps(xyLo, zx, _MM_SHUFFLE(2, 0, 1, 0));	// x0 y0 z0 x1
+		__m128 d1 = _mm_shuffle_ps(yz, xyHi, _MM_SHUFFLE(1, 0, 2, 0));	// y1 z1 x2 y2
+		__m128 d2 = _mm_shuffle_ps(zx3, yz3, _MM_SHUFFLE(2, 1, 2, 0));	// z2 x3 y3 z3
+
+		float * out = dst + i * 3;
+		_mm_storeu_ps(out + 0, _mm_add_ps(_mm_loadu_ps(out + 0), d0));
+		_mm_storeu_ps(out + 4, _mm_add_ps(_mm_loadu_ps(out + 4), d1));
+		_mm_storeu_ps(out + 8, _mm_add_ps(_mm_loadu_ps(out + 8), d2));
+	}
+
+	for (; i < count; i++)
+	{
+		vertices[i].x += px[i] * relative;
+		vertices[i].y += py[i] * relative;
+		vertices[i].z += pz[i] * relative;
+	}
+}
+
 bool TRIFile::Apply(NiGeometry * geometry, BSFixedString morphName, float relative)
 {
 	BSFaceGenBaseMorphExtraData * extraData = (BSFaceGenBaseMorphExtraData *)geometry->GetExtraData("FOD");
@@ -223,17 +314,10 @@ bool TRIFile::Apply(NiGeometry * geometry, BSFixedString morphName, float relati
 		return false;
 
 	// What?
-	if (extraData->vertexCount != morph->second.vertices.size())
+	if (extraData->vertexCount != morph->second.x.size())
 		return false;
 
-	UInt32 size = morph->second.vertices.size();
-	for (UInt32 i = 0; i < size; i++)
-	{
-		auto & vert = morph->second.vertices.at(i);
-		extraData->vertexData[i].x += (float)((double)vert.x * (double)morph->second.multiplier * (double)relative);
-		extraData->vertexData[i].y += (float)((double)vert.y * (double)morph->second.multiplier * (double)relative);
-		extraData->vertexData[i].z += (float)((double)vert.z * (double)morph->second.multiplier * (double)relative);
-	}
+	morph->second.Apply(extraData->vertexData, morph->second.x.size(), relative);
 
 	UpdateModelFace(geometry);
 	return true;
@@ -398,6 +482,7 @@ bool RaceMap::AddSliderMap(TESRace * race, SliderMapPtr sliderMap)
 	if(it != end()) {
 		//std::pair<SliderSet::iterator,bool> ret;
 		auto ret = it->second->insert(sliderMap);
+		it->second->InvalidateIndex();
 		return ret.second;
 	} else {
 		SliderSetPtr sliderMaps = std::make_shared<SliderSet>();
@@ -539,21 +624,97 @@ bool MorphHandler::GetModelTri(BSFixedString filePath, TRIModelData & modelData)
 	return false;
 }
 
-TRIModelData & MorphHandler::GetExtendedModelTri(BSFixedString morphName, bool cacheTRI)
+static BSFixedString GetExtendedModelPath(BSFixedString morphName)
 {
 	std::string filePath(SLIDER_DIRECTORY);
 	filePath.append(morphName.data);
-	BSFixedString morphFile(filePath.c_str());
+	return BSFixedString(filePath.c_str());
+}
+
+static TESModelTri * CreateModelTri(BSFixedString morphFile)
+{
+	void* memory = FormHeap_Allocate(sizeof(TESModelTri));
+	memset(memory, 0, sizeof(TESModelTri));
+	((UInt32*)memory)[0] = 0x010A2E08;
+	TESModelTri* xData = (TESModelTri*)memory;
+	xData->SetModelName(morphFile.data);
+	return xData;
+}
+
+void MorphHandler::CacheHeadPartModels(const std::vector<BGSHeadPart*> & headParts, bool parallel)
+{
+	struct PendingModel
+	{
+		BSFixedString	path;
+		BGSHeadPart		* headPart;
+		SInt32			vertexCount;
+	};
+
+	std::vector<PendingModel> pending;
+	std::unordered_set<const char*> queued;
+
+	class PendingMorphVisitor : public MorphMap::Visitor
+	{
+	public:
+		PendingMorphVisitor(ModelMap & modelMap, std::vector<PendingModel> & pending, std::unordered_set<const char*> & queued) : m_modelMap(modelMap), m_pending(pending), m_queued(queued) { }
+
+		virtual bool Accept(BSFixedString morphName)
+		{
+			BSFixedString morphFile = GetExtendedModelPath(morphName);
+			if (m_modelMap.find(morphFile) == m_modelMap.end() && m_queued.insert(morphFile.data).second)
+				m_pending.push_back({ morphFile, NULL, -1 });
+			return false;
+		}
+
+	private:
+		ModelMap						& m_modelMap;
+		std::vector<PendingModel>		& m_pending;
+		std::unordered_set<const char*>	& m_queued;
+	};
+
+	// Gather every TRI not cached yet, strings are interned here on the main thread
+	PendingMorphVisitor visitor(m_modelMap, pending, queued);
+	for (auto headPart : headParts)
+	{
+		BSFixedString modelPath = headPart->chargenMorph.GetModelName();
+		if (modelPath == BSFixedString(""))
+			continue;
+
+		if (m_modelMap.find(modelPath) == m_modelMap.end() && queued.insert(modelPath.data).second)
+			pending.push_back({ modelPath, headPart, -1 });
+
+		VisitMorphMap(modelPath, visitor);
+	}
+
+	auto readModel = [](PendingModel & model)
+	{
+		model.vertexCount = ReadTRIVertexCount(model.path.data);
+	};
+
+	if (parallel)
+		concurrency::parallel_for_each(pending.begin(), pending.end(), readModel);
+	else
+		std::for_each(pending.begin(), pending.end(), readModel);
+
+	// Game objects are bound and the map is filled on the main thread
+	for (auto & model : pending)
+	{
+		TRIModelData data;
+		data.vertexCount = model.vertexCount;
+		data.morphModel = model.headPart ? &model.headPart->chargenMorph : CreateModelTri(model.path);
+		m_modelMap.emplace(model.path, data);
+	}
+
+	_DMESSAGE("%s - Cached %d TRI models", __FUNCTION__, pending.size());
+}
+
+TRIModelData & MorphHandler::GetExtendedModelTri(BSFixedString morphName, bool cacheTRI)
+{
+	BSFixedString morphFile = GetExtendedModelPath(morphName);
 	ModelMap::iterator it = m_modelMap.find(morphFile);
 	if(it == m_modelMap.end()) {
-		void* memory = FormHeap_Allocate(sizeof(TESModelTri));
-		memset(memory, 0, sizeof(TESModelTri));
-		((UInt32*)memory)[0] = 0x010A2E08;
-		TESModelTri* xData = (TESModelTri*)memory;
-		xData->SetModelName(morphFile.data);
-
 		TRIModelData data;
-		data.morphModel = xData;
+		data.morphModel = CreateModelTri(morphFile);
 		if (!cacheTRI) {
 			data.vertexCount = ReadTRIVertexCount(morphFile.data);
 		}
@@ -749,13 +910,7 @@ void MorphHandler::ApplyPresetData(Actor * actor, PresetDataPtr presetData, bool
 			g_overlayInterface->RevertOverlays(actor, true);
 
 		if ((applyType & kPresetApplyOverrides) == kPresetApplyOverrides)
-		{
-			for (auto & nodes : presetData->overrideData) {
-				for (auto & value : nodes.second) {
-					g_overrideInterface->AddNodeOverride(actor, gender == 1 ? true : false, nodes.first, value);
-				}
-			}
-		}
+			AddNodeOverrides(actor, gender == 1 ? true : false, presetData->overrideData);
 
 		if ((applyType & kPresetApplySkinOverrides) == kPresetApplySkinOverrides)
 		{
@@ -790,17 +945,60 @@ void MorphHandler::ApplyPresetData(Actor * actor, PresetDataPtr presetData, bool
 		g_bodyMorphInterface->ClearMorphs(actor);
 
 		if ((applyType & kPresetApplyBodyMorphs) == kPresetApplyBodyMorphs)
-		{
-			for (auto & morph : presetData->bodyMorphData) {
-				for (auto & keys : morph.second)
-					g_bodyMorphInterface->SetMorph(actor, morph.first, keys.first, keys.second);
-			}
-		}
+			SetBodyMorphs(actor, presetData->bodyMorphData);
 
 		g_bodyMorphInterface->UpdateModelWeight(actor);
 	}
 }
 
+void MorphHandler::AddNodeOverrides(Actor * actor, bool isFemale, PresetData::OverrideData & overrideData)
+{
+	if (g_overrideInterface->GetVersion() < OverrideInterface::kPluginVersion_NodeArrays) {
+		for (auto & nodes : overrideData) {
+			for (auto & value : nodes.second)
+				g_overrideInterface->AddNodeOverride(actor, isFemale, nodes.first, value);
+		}
+		return;
+	}
+
+	std::vector<BSFixedString> nodeNames;
+	std::vector<OverrideVariant> values;
+	for (auto & nodes : overrideData) {
+		for (auto & value : nodes.second) {
+			nodeNames.push_back(nodes.first);
+			values.push_back(value);
+		}
+	}
+
+	if (!values.empty())
+		g_overrideInterface->AddNodeOverrideArray(actor, isFemale, values.size(), &nodeNames[0], &values[0]);
+}
+
+void MorphHandler::SetBodyMorphs(Actor * actor, PresetData::BodyMorphData & bodyMorphData)
+{
+	if (g_bodyMorphInterface->GetVersion() < BodyMorphInterface::kPluginVersion_MorphArrays) {
+		for (auto & morph : bodyMorphData) {
+			for (auto & keys : morph.second)
+				g_bodyMorphInterface->SetMorph(actor, morph.first, keys.first, keys.second);
+		}
+		return;
+	}
+
+	std::vector<BSFixedString> morphNames;
+	std::vector<BSFixedString> morphKeys;
+	std::vector<float> values;
+	for (auto & morph : bodyMorphData) {
+		for (auto & keys : morph.second) {
+			morphNames.push_back(morph.first);
+			morphKeys.push_back(keys.first);
+			values.push_back(keys.second);
+		}
+	}
+
+	if (!values.empty())
+		g_bodyMorphInterface->SetMorphArray(actor, values.size(), &morphNames[0], &morphKeys[0], &values[0]);
+}
+
 bool MorphMap::Visit(BSFixedString key, Visitor & visitor)
 {
 	MorphMap::iterator it = find(key);
@@ -1183,17 +1381,7 @@ SliderInternalPtr MorphHandler::GetSlider(TESRace * race, UInt8 gender, BSFixedS
 {
 	SliderSetPtr sliderMaps = m_raceMap.GetSliderSet(race);
 	if(sliderMaps)
-	{
-		SliderInternalPtr sliderInternal;
-		sliderMaps->for_each_slider([&](SliderGenderPtr genders) {
-			sliderInternal = genders->slider[gender];
-			if (sliderInternal && sliderInternal->name == name)
-				return true;
-			return false;
-		});
-		if (sliderInternal)
-			return sliderInternal;
-	}
+		return sliderMaps->FindSlider(gender, name);
 
 	return NULL;
 }
@@ -1262,8 +1450,7 @@ void MorphHandler::ApplyMorph(TESNPC * npc, BGSHeadPart * headPart, BSFaceGenNiN
 					if (sculptHost) {
 						BSFaceGenBaseMorphExtraData * extraData = (BSFaceGenBaseMorphExtraData *)geometry->GetExtraData("FOD");
 						if (extraData) {
-							for (auto data : *sculptHost)
-								extraData->vertexData[data.first] += data.second;
+							sculptHost->Apply(extraData->vertexData, extraData->vertexCount);
 						}
 					}
 				}
@@ -1279,6 +1466,13 @@ void MorphHandler::ApplyMorph(TESNPC * npc, BGSHeadPart * headPart, BSFaceGenNiN
 		return;
 
 	UInt8 gender = CALL_MEMBER_FN(npc, GetSex)();
+
+	NiGeometry * headGeometry = NULL;
+	if (headPart) {
+		NiAVObject * object = faceNode->GetObjectByName(&headPart->partName.data);
+		if (object)
+			headGeometry = object->GetAsNiGeometry();
+	}
 	
 	for(auto it = valueSet->begin(); it != valueSet->end(); ++it)
 	{
@@ -1303,6 +1497,9 @@ void MorphHandler::ApplyMorph(TESNPC * npc, BGSHeadPart * headPart, BSFaceGenNiN
 
 				float relative = abs(it->second);
 				if(relative > 1.0) {
+					if(headGeometry && ApplyScaledMorph(headPart, headGeometry, morphName, relative))
+						continue;
+
 					UInt32 count = (UInt32)relative;
 					float difference = relative - count;
 					for(UInt32 i = 0; i < count; i++)
@@ -1335,8 +1532,7 @@ void MorphHandler::ApplyMorphs(TESNPC * npc, BSFaceGenNiNode * faceNode)
 					if (sculptHost) {
 						BSFaceGenBaseMorphExtraData * extraData = (BSFaceGenBaseMorphExtraData *)geometry->GetExtraData("FOD");
 						if (extraData) {
-							for (auto data : *sculptHost)
-								extraData->vertexData[data.first] += data.second;
+							sculptHost->Apply(extraData->vertexData, extraData->vertexCount);
 						}
 					}
 				}
@@ -1355,6 +1551,23 @@ void MorphHandler::ApplyMorphs(TESNPC * npc, BSFaceGenNiNode * faceNode)
 
 	UInt8 gender = CALL_MEMBER_FN(npc, GetSex)();
 
+	// Geometry whose name doesn't resolve to a head part is only reachable through
+	// the npc's own ApplyMorph, scaled morphs fall back to it when there is any
+	std::vector<std::pair<BGSHeadPart*, NiGeometry*>> faceParts;
+	bool unresolvedParts = false;
+	VisitObjects(faceNode, [&](NiAVObject* object)
+	{
+		if (NiGeometry * geometry = object->GetAsNiGeometry()) {
+			std::string headPartName = object->m_name;
+			BGSHeadPart * headPart = GetHeadPartByName(headPartName);
+			if (headPart)
+				faceParts.push_back(std::make_pair(headPart, geometry));
+			else
+				unresolvedParts = true;
+		}
+
+		return false;
+	});
 	
 	for(auto it = valueSet->begin(); it != valueSet->end(); ++it)
 	{
@@ -1378,13 +1591,28 @@ void MorphHandler::ApplyMorphs(TESNPC * npc, BSFaceGenNiNode * faceNode)
 					morphName = slider->upperBound;
 
 				float relative = abs(it->second);
-				if(relative > 1.0) {
+				if(relative > 1.0 && unresolvedParts) {
 					UInt32 count = (UInt32)relative;
 					float difference = relative - count;
 					for(UInt32 i = 0; i < count; i++)
 						SetMorph(npc, faceNode, morphName.data, 1.0);
 					relative = difference;
 				}
+				else if(relative > 1.0) {
+					// Apply the full factor once per part, parts without the morph cached take the repeated path
+					UInt32 count = (UInt32)relative;
+					float difference = relative - count;
+					for (auto & part : faceParts) {
+						if (ApplyScaledMorph(part.first, part.second, morphName, relative))
+							continue;
+
+						for(UInt32 i = 0; i < count; i++)
+							CALL_MEMBER_FN(FaceGen::GetSingleton(), ApplyMorph)(faceNode, part.first, &morphName, 1.0);
+						if (difference > 0.0)
+							CALL_MEMBER_FN(FaceGen::GetSingleton(), ApplyMorph)(faceNode, part.first, &morphName, difference);
+					}
+					continue;
+				}
 
 #ifdef _DEBUG_MORPH
 				_DMESSAGE("Applying Full Slider %s value %f", morphName.data, it->value);
@@ -1395,6 +1623,44 @@ void MorphHandler::ApplyMorphs(TESNPC * npc, BSFaceGenNiNode * faceNode)
 	}
 }
 
+bool MorphHandler::ApplyScaledMorph(BGSHeadPart * headPart, NiGeometry * geometry, BSFixedString morphName, float relative)
+{
+	if (!CacheHeadPartModel(headPart, true))
+		return false;
+
+	BSFixedString modelPath = headPart->chargenMorph.GetModelName();
+	TRIModelData modelData;
+	if (!GetModelTri(modelPath, modelData) || !modelData.triFile)
+		return false;
+
+	if (!modelData.triFile->Apply(geometry, morphName, relative))
+		return false;
+
+	// Extended morphs registered for this TRI take the same factor
+	class ScaledMorphVisitor : public MorphMap::Visitor
+	{
+	public:
+		ScaledMorphVisitor(NiGeometry * geometry, BSFixedString morphName, float relative) : m_geometry(geometry), m_morphName(morphName), m_relative(relative) { }
+
+		virtual bool Accept(BSFixedString extendedName)
+		{
+			TRIModelData & morphData = g_morphHandler.GetExtendedModelTri(extendedName, true);
+			if (morphData.morphModel && morphData.triFile)
+				morphData.triFile->Apply(m_geometry, m_morphName, m_relative);
+			return false;
+		}
+
+	private:
+		NiGeometry		* m_geometry;
+		BSFixedString	m_morphName;
+		float			m_relative;
+	};
+
+	ScaledMorphVisitor visitor(geometry, morphName, relative);
+	VisitMorphMap(modelPath, visitor);
+	return true;
+}
+
 void MorphHandler::SetMorph(TESNPC * npc, BSFaceGenNiNode * faceNode, const char * name, float relative)
 {
 #ifdef _DEBUG_MORPH
@@ -1735,6 +2001,8 @@ struct PresetHeader
 	{
 		kSignature =		MACRO_SWAP32('SKSE'),	// endian-swapping so the order matches
 		kVersion =			3,
+		kVersion_Sectioned =	4,
+		kVersion_BinarySections =	5,
 
 		kVersion_Invalid =	0
 	};
@@ -1745,21 +2013,161 @@ struct PresetHeader
 	UInt32	runtimeVersion;
 };
 
+// Sectioned binary presets follow the header with a table of contents and
+// the sections it lists, stored in table order so a reader that only wants
+// the leading sections can stop early. Each section holds its part of the
+// json preset tree as a compact json object, from kVersion_BinarySections on
+// the slider and sculpt sections are packed by PresetBinaryCodec instead.
+struct PresetSectionEntry
+{
+	UInt32	type;
+	UInt32	offset;
+	UInt32	length;
+};
+
 #include <json/json.h>
 
-bool MorphHandler::SaveJsonPreset(const char * filePath)
+struct PresetSectionMember
 {
-	Json::StyledWriter writer;
-	Json::Value root;
+	UInt32		section;
+	const char	* parent;
+	const char	* name;
+};
 
-	IFileStream		currentFile;
-	IFileStream::MakeAllDirs(filePath);
-	if (!currentFile.Create(filePath))
+static const PresetSectionMember s_presetSectionMembers[] = {
+	{ MorphHandler::kPresetSectionMetadata, NULL, "version" },
+	{ MorphHandler::kPresetSectionMetadata, NULL, "mods" },
+	{ MorphHandler::kPresetSectionMetadata, NULL, "headParts" },
+	{ MorphHandler::kPresetSectionMetadata, NULL, "actor" },
+	{ MorphHandler::kPresetSectionMetadata, NULL, "tintInfo" },
+	{ MorphHandler::kPresetSectionMetadata, NULL, "faceTextures" },
+	{ MorphHandler::kPresetSectionSliders, "morphs", "default" },
+	{ MorphHandler::kPresetSectionSliders, "morphs", "custom" },
+	{ MorphHandler::kPresetSectionSliders, NULL, "bodyMorphs" },
+	{ MorphHandler::kPresetSectionOverrides, NULL, "transforms" },
+	{ MorphHandler::kPresetSectionOverrides, NULL, "overrides" },
+	{ MorphHandler::kPresetSectionOverrides, NULL, "skinOverrides" },
+	{ MorphHandler::kPresetSectionSculpt, "morphs", "sculptDivisor" },
+	{ MorphHandler::kPresetSectionSculpt, "morphs", "sculpt" }
+};
+
+static void SplitPresetSections(Json::Value & root, UInt32 sections, Json::Value & section)
+{
+	section = Json::Value(Json::objectValue);
+	for (auto & member : s_presetSectionMembers)
 	{
-		_ERROR("%s: couldn't create preset file (%s) Error (%d)", __FUNCTION__, filePath, GetLastError());
+		if ((member.section & sections) == 0)
+			continue;
+
+		if (member.parent) {
+			if (root.isMember(member.parent) && root[member.parent].isMember(member.name))
+				section[member.parent][member.name] = root[member.parent][member.name];
+		}
+		else if (root.isMember(member.name))
+			section[member.name] = root[member.name];
+	}
+}
+
+static const UInt32 kPresetReadChunk = 0x10000;
+
+// Packs the slider and sculpt sections, the json for them is parsed back so
+// WritePresetJson stays the one place a preset is gathered
+static bool EncodePresetSection(UInt32 type, const std::string & json, std::string & out)
+{
+	out.clear();
+	if (type != MorphHandler::kPresetSectionSliders && type != MorphHandler::kPresetSectionSculpt) {
+		out = json;
+		return false;
+	}
+
+	PresetJsonParser parser;
+	if (!parser.Parse(json.c_str(), json.c_str() + json.length())) {
+		_ERROR("%s: Error occured parsing section %08X, %s at offset %d.", __FUNCTION__, type, parser.GetError(), parser.GetOffset());
 		return true;
 	}
 
+	if (type == MorphHandler::kPresetSectionSliders)
+		PresetBinaryCodec::WriteSliders(parser.data, out);
+	else
+		PresetBinaryCodec::WriteSculpt(parser.data, out);
+	return false;
+}
+
+// Hands the requested sections following the header to functor
+static bool ReadPresetSections(BSResourceNiBinaryStream & file, UInt32 sections, std::function<bool(UInt32, const char*, const char*)> functor)
+{
+	UInt32 sectionCount = 0;
+	if (file.Read(&sectionCount, sizeof(sectionCount)) != sizeof(sectionCount) || sectionCount > 32) {
+		_ERROR("%s: invalid section count", __FUNCTION__);
+		return true;
+	}
+
+	std::vector<PresetSectionEntry> toc(sectionCount);
+	if (sectionCount > 0 && file.Read(&toc[0], sectionCount * sizeof(PresetSectionEntry)) != sectionCount * sizeof(PresetSectionEntry)) {
+		_ERROR("%s: truncated table of contents", __FUNCTION__);
+		return true;
+	}
+
+	UInt32 remaining = 0;
+	for (auto & entry : toc)
+		remaining |= entry.type & sections;
+
+	// Sections are read in place without seeking, they must follow the table
+	UInt32 position = sizeof(PresetHeader) + sizeof(sectionCount) + sectionCount * sizeof(PresetSectionEntry);
+
+	std::vector<char> buffer;
+	for (auto & entry : toc)
+	{
+		if (remaining == 0)
+			break;
+
+		if (entry.offset != position) {
+			_ERROR("%s: section %08X out of order", __FUNCTION__, entry.type);
+			return true;
+		}
+		if (entry.length > 0x7FFFFFFF - position) {
+			_ERROR("%s: section %08X has invalid length %u", __FUNCTION__, entry.type, entry.length);
+			return true;
+		}
+		position += entry.length;
+
+		// Unwanted sections are skipped, a truncated one fails on the next read
+		if ((entry.type & sections) == 0) {
+			if (entry.length > 0)
+				file.Seek(entry.length);
+			continue;
+		}
+
+		// The length comes from the file, grow the buffer only as data actually
+		// arrives so a corrupt table can't allocate more than the file holds
+		buffer.clear();
+		while (buffer.size() < entry.length)
+		{
+			UInt32 offset = buffer.size();
+			UInt32 chunk = min(entry.length - offset, kPresetReadChunk);
+			buffer.resize(offset + chunk);
+			if (file.Read(&buffer[offset], chunk) != chunk) {
+				_ERROR("%s: truncated section %08X", __FUNCTION__, entry.type);
+				return true;
+			}
+		}
+
+		if (buffer.empty())
+			continue;
+
+		remaining &= ~entry.type;
+
+		if (functor(entry.type, &buffer[0], &buffer[0] + buffer.size())) {
+			_ERROR("%s: Error occured reading section %08X", __FUNCTION__, entry.type);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void MorphHandler::WritePresetJson(Json::Value & root)
+{
 	Json::Value versionInfo;
 	versionInfo["signature"] = PresetHeader::kSignature;
 	versionInfo["formatVersion"] = PresetHeader::kVersion;
@@ -2105,6 +2513,22 @@ bool MorphHandler::SaveJsonPreset(const char * filePath)
 	root["morphs"]["custom"] = customMorphInfo;
 	root["morphs"]["sculptDivisor"] = VERTEX_MULTIPLIER;
 	root["morphs"]["sculpt"] = sculptData;
+}
+
+bool MorphHandler::SaveJsonPreset(const char * filePath)
+{
+	Json::StyledWriter writer;
+	Json::Value root;
+
+	IFileStream		currentFile;
+	IFileStream::MakeAllDirs(filePath);
+	if (!currentFile.Create(filePath))
+	{
+		_ERROR("%s: couldn't create preset file (%s) Error (%d)", __FUNCTION__, filePath, GetLastError());
+		return true;
+	}
+
+	WritePresetJson(root);
 
 	std::string data = writer.write(root);
 	currentFile.WriteBuf(data.c_str(), data.length());
@@ -2128,168 +2552,39 @@ bool MorphHandler::SaveBinaryPreset(const char * filePath)
 	{
 		PresetHeader fileHeader;
 		fileHeader.signature =		PresetHeader::kSignature;
-		fileHeader.formatVersion =	PresetHeader::kVersion;
+		fileHeader.formatVersion =	PresetHeader::kVersion_BinarySections;
 		fileHeader.skseVersion =	PACKED_SKSE_VERSION;
 		fileHeader.runtimeVersion =	RUNTIME_VERSION_1_9_32_0;
 
-		currentFile.Skip(sizeof(fileHeader));
-
-		PlayerCharacter * player = (*g_thePlayer);
-		TESNPC * npc = DYNAMIC_CAST(player->baseForm, TESForm, TESNPC);
-		DataHandler * dataHandler = DataHandler::GetSingleton();
-
-		typedef std::map<UInt8, const char *> ModMap;
-		typedef std::pair<UInt8, const char*> ModPair;
+		Json::Value root;
+		WritePresetJson(root);
 
-		typedef std::map<UInt8, BGSHeadPart*> PartMap;
-		typedef std::pair<UInt8, BGSHeadPart*> PartPair;
+		Json::FastWriter writer;
+		std::string sectionData[kNumPresetSections];
+		PresetSectionEntry toc[kNumPresetSections];
 
-		typedef std::pair<UInt32, const char*> TintCouple;
-		typedef std::map<UInt8, TintCouple> TintMap;
-		typedef std::pair<UInt8, TintCouple> TintPair;
-
-		ModMap modList;
-		PartMap partList;
+		UInt32 sectionCount = kNumPresetSections;
+		UInt32 offset = sizeof(fileHeader) + sizeof(sectionCount) + sizeof(toc);
+		for (UInt32 i = 0; i < kNumPresetSections; i++)
+		{
+			Json::Value section;
+			SplitPresetSections(root, 1 << i, section);
+			if (EncodePresetSection(1 << i, writer.write(section), sectionData[i])) {
+				currentFile.Close();
+				return true;
+			}
 
-		UInt32 numHeadParts = 0;
-		BGSHeadPart ** headParts = NULL;
-		if (CALL_MEMBER_FN(npc, HasOverlays)()) {
-			numHeadParts = GetNumActorBaseOverlays(npc);
-			headParts = GetActorBaseOverlays(npc);
-		} else {
-			numHeadParts = npc->numHeadParts;
-			headParts = npc->headparts;
+			toc[i].type = 1 << i;
+			toc[i].offset = offset;
+			toc[i].length = sectionData[i].length();
+			offset += toc[i].length;
 		}
-		for (UInt32 i = 0; i < numHeadParts; i++) // Acquire all unique parts
-		{
-			BGSHeadPart * headPart = headParts[i];
-			if(headPart && !headPart->IsExtraPart()) {
-				UInt8 modIndex = headPart->formID >> 24;
-				ModInfo* modInfo = dataHandler->modList.modInfoList.GetNthItem(modIndex);
-				if(modInfo) {
-					modList.emplace(modInfo->modIndex, modInfo->name);
-					partList.emplace(i, headPart);
-				}
-			}
-		}
-
-		TintMap tintList;
-		for(UInt32 i = 0; i < player->tintMasks.count; i++)
-		{
-			TintMask * tintMask = NULL;
-			if(player->tintMasks.GetNthItem(i, tintMask))
-			{
-				UInt32 tintColor = ((UInt32)(tintMask->alpha * 255.0) << 24) | tintMask->color.red << 16 | tintMask->color.green << 8 | tintMask->color.blue;
-				tintList.emplace(i, TintCouple(tintColor, tintMask->texture->str.data));
-			}
-		}
-
-		UInt8 modCount = modList.size();
-		UInt8 partCount = partList.size();
-		UInt8 tintCount = tintList.size();
-
-		currentFile.Write8(modCount);
-		for(auto mIt = modList.begin(); mIt != modList.end(); ++mIt)
-		{
-			currentFile.Write8(mIt->first);
-
-			UInt16 strLen = strlen(mIt->second);
-			currentFile.Write16(strLen);
-			currentFile.WriteBuf(mIt->second, strLen);
-		}
-
-		currentFile.Write8(partCount);
-		for(auto pIt = partList.begin(); pIt != partList.end(); ++pIt)
-		{
-			currentFile.Write8(pIt->first);
-			currentFile.Write32(pIt->second->formID);
-		}
-
-		currentFile.WriteFloat(npc->weight);
-
-		if (npc->faceMorph)
-		{
-			currentFile.Write8(TESNPC::FaceMorphs::kNumPresets);
-			for (UInt8 p = 0; p < TESNPC::FaceMorphs::kNumPresets; p++)
-				currentFile.Write8(npc->faceMorph->presets[p]);
-
-			currentFile.Write8(TESNPC::FaceMorphs::kNumOptions);
-			for (UInt8 o = 0; o < TESNPC::FaceMorphs::kNumOptions; o++)
-				currentFile.WriteFloat(npc->faceMorph->option[o]);
-		}
-		else {
-			currentFile.Write8(0);
-			currentFile.Write8(0);
-		}		
-
-		UInt32 hairColor = 0;
-		if(npc->headData && npc->headData->hairColor) {
-			hairColor = npc->headData->hairColor->color.red << 16 | npc->headData->hairColor->color.green << 8 | npc->headData->hairColor->color.blue;
-		}
-		currentFile.Write32(hairColor);
-
-		currentFile.Write8(tintCount);
-		for(auto tmIt = tintList.begin(); tmIt != tintList.end(); ++tmIt)
-		{
-			currentFile.Write8(tmIt->first);
-			currentFile.Write32(tmIt->second.first);
-
-			UInt16 strLen = strlen(tmIt->second.second);
-			currentFile.Write16(strLen);
-			currentFile.WriteBuf(tmIt->second.second, strLen);
-		}
-
-		SInt64 offset = currentFile.GetOffset();
-		currentFile.Skip(sizeof(UInt8));
-		UInt8 totalMorphs = 0;
-
-		ValueSet * valueSet = m_valueMap.GetValueSet(npc);
-		if(valueSet)
-		{
-			for(auto it = valueSet->begin(); it != valueSet->end(); ++it)
-			{
-				if(it->second != 0.0) {
-					UInt16 strLen = strlen(it->first.data);
-					currentFile.Write16(strLen);
-					currentFile.WriteBuf(it->first.data, strLen);
 
-					currentFile.WriteFloat(it->second);
-					totalMorphs++;
-				}
-			}
-		}
-		
-		SInt64 jumpBack = currentFile.GetOffset();
-		currentFile.SetOffset(offset);
-		currentFile.Write8(totalMorphs);
-		
-		currentFile.SetOffset(jumpBack);
-		offset = currentFile.GetOffset();
-		currentFile.Skip(sizeof(UInt8));
-		UInt8 totalTextures = 0;
-		BGSHeadPart * facePart = npc->GetCurrentHeadPartByType(BGSHeadPart::kTypeFace);
-		if (facePart) {
-			BGSTextureSet * textureSet = GetTextureSetForPart(npc, facePart);
-			if (textureSet) {
-				for (UInt8 i = 0; i < BSShaderTextureSet::kNumTextures; i++) {
-					const char * texturePath = textureSet->textureSet.GetTexturePath(i);
-					if (texturePath != NULL) {
-						UInt16 strLen = strlen(texturePath);
-						currentFile.Write8(i);
-						currentFile.Write16(strLen);
-						currentFile.WriteBuf(texturePath, strLen);
-						totalTextures++;
-					}
-				}
-			}
-		}
-		currentFile.SetOffset(offset);
-		currentFile.Write8(totalTextures);
-
-		// write header
-		currentFile.SetOffset(0);
 		currentFile.WriteBuf(&fileHeader, sizeof(fileHeader));
-
+		currentFile.Write32(sectionCount);
+		currentFile.WriteBuf(toc, sizeof(toc));
+		for (UInt32 i = 0; i < kNumPresetSections; i++)
+			currentFile.WriteBuf(sectionData[i].c_str(), sectionData[i].length());
 	}
 	catch(...)
 	{
@@ -2306,337 +2601,275 @@ PresetData::PresetData()
 	hairColor = 0;
 }
 
-bool MorphHandler::LoadJsonPreset(const char * filePath, PresetDataPtr presetData)
+// Parses json presets into PresetJsonData, then resolves what the game has
+// to look up once every section is in. Binary presets feed each of their
+// sections through Decode before finishing.
+class PresetJsonDecoder
 {
-	bool loadError = false;
-	BSResourceNiBinaryStream file(filePath);
-	if (!file.IsValid()) {
-		_ERROR("%s: File %s failed to open.", __FUNCTION__, filePath);
-		loadError = true;
-		return loadError;
+public:
+	bool Decode(const char * begin, const char * end);
+	// Sections of kVersion_BinarySections presets and of the preset index
+	bool DecodeSection(UInt32 type, const char * begin, const char * end);
+	bool Finish(PresetData & presetData);
+
+private:
+	static void ReadOverrideValues(const std::vector<PresetJsonData::Value> & values, std::vector<OverrideVariant> & variants);
+
+	PresetJsonParser	m_parser;
+};
+
+bool PresetJsonDecoder::Decode(const char * begin, const char * end)
+{
+	if (!m_parser.Parse(begin, end)) {
+		_ERROR("%s: Error occured parsing json, %s at offset %d.", __FUNCTION__, m_parser.GetError(), m_parser.GetOffset());
+		return true;
 	}
 
-	std::string in;
-	BSReadAll(&file, &in);
+	return false;
+}
 
-	Json::Features features;
-	features.all();
+bool PresetJsonDecoder::DecodeSection(UInt32 type, const char * begin, const char * end)
+{
+	bool result = true;
+	if (type == MorphHandler::kPresetSectionSliders)
+		result = PresetBinaryCodec::ReadSliders(begin, end, m_parser.data);
+	else if (type == MorphHandler::kPresetSectionSculpt)
+		result = PresetBinaryCodec::ReadSculpt(begin, end, m_parser.data);
+	else
+		return Decode(begin, end);
 
-	Json::Value root;
-	Json::Reader reader(features);
+	if (!result) {
+		_ERROR("%s: Error occured reading packed section %08X.", __FUNCTION__, type);
+		return true;
+	}
 
-	bool parseSuccess = reader.parse(in, root);
-	if (!parseSuccess) {
-		_ERROR("%s: Error occured parsing json for %s.", __FUNCTION__, filePath);
-		loadError = true;
-		return loadError;
+	return false;
+}
+
+void PresetJsonDecoder::ReadOverrideValues(const std::vector<PresetJsonData::Value> & values, std::vector<OverrideVariant> & variants)
+{
+	for (auto & value : values)
+	{
+		OverrideVariant variant;
+		variant.key = value.key;
+		variant.type = value.type;
+		variant.index = value.index;
+		variant.data.u = 0;
+		switch (variant.type) {
+			case OverrideVariant::kType_Bool:
+				variant.data.b = value.data.AsBool();
+				break;
+			case OverrideVariant::kType_Int:
+				variant.data.i = value.data.AsInt();
+				break;
+			case OverrideVariant::kType_Float:
+				variant.data.f = value.data.AsFloat();
+				break;
+			case OverrideVariant::kType_String:
+				variant.data.str = BSFixedString(value.data.AsString().c_str()).data;
+				break;
+			default:
+				break;
+		}
+
+		variants.push_back(variant);
 	}
+}
+
+bool PresetJsonDecoder::Finish(PresetData & presetData)
+{
+	const PresetJsonData & data = m_parser.data;
 
-	Json::Value defaultValue;
-	Json::Value version = root["version"];
-	if (version.empty()) {
+	bool loadError = false;
+	if (!data.hasVersion) {
 		_ERROR("%s: No version header.", __FUNCTION__);
 		loadError = true;
 		return loadError;
 	}
 
-	UInt32 signature = version["signature"].asUInt();
-	if (signature != PresetHeader::kSignature)
+	if (data.signature != PresetHeader::kSignature)
 	{
-		_ERROR("%s: invalid file signature (found %08X expected %08X)", __FUNCTION__, signature, PresetHeader::kSignature);
+		_ERROR("%s: invalid file signature (found %08X expected %08X)", __FUNCTION__, data.signature, PresetHeader::kSignature);
 		loadError = true;
 		return loadError;
 	}
 
-	UInt32 formatVersion = version["formatVersion"].asUInt();
-	if (formatVersion <= PresetHeader::kVersion_Invalid)
+	if (data.formatVersion <= PresetHeader::kVersion_Invalid)
 	{
-		_ERROR("%s: version invalid (%08X)", __FUNCTION__, formatVersion);
+		_ERROR("%s: version invalid (%08X)", __FUNCTION__, data.formatVersion);
 		loadError = true;
 		return loadError;
 	}
 
-	Json::Value mods = root["mods"];
-	if (mods.empty()) {
+	if (!data.hasMods) {
 		_ERROR("%s: No mods header.", __FUNCTION__);
 		loadError = true;
 		return loadError;
 	}
 
-	DataHandler * dataHandler = DataHandler::GetSingleton();
-
 	std::map<UInt8, std::string> modList;
-	if (mods.type() == Json::arrayValue) {
-		for (auto & mod : mods) {
-			UInt8 modIndex = mod["index"].asUInt();
-			std::string modName = mod["name"].asString();
-
-			modList.emplace(modIndex, modName);
-			presetData->modList.push_back(modName);
-		}
+	for (auto & mod : data.mods)
+	{
+		modList.emplace(mod.index, mod.name);
+		presetData.modList.push_back(mod.name);
 	}
 
-	Json::Value headParts = root["headParts"];
-	if (!headParts.empty() && headParts.type() == Json::arrayValue) {
-		for (auto & part : headParts) {
+	presetData.weight = data.weight;
+	presetData.hairColor = data.hairColor;
 
-			UInt8 partType = part["type"].asUInt();
-			UInt32 formId = part["formId"].asUInt();
-
-			UInt8 modIndex = formId >> 24;
-			auto it = modList.find(modIndex);
-			if (it != modList.end()) {
-				UInt8 gameIndex = dataHandler->GetModIndex(it->second.c_str());
-				if (gameIndex != 255) {
-					formId = (formId & 0x00FFFFFF) | (gameIndex << 24);
-					TESForm * headPartForm = LookupFormByID(formId);
-					if (headPartForm) {
-						BGSHeadPart * headPart = DYNAMIC_CAST(headPartForm, TESForm, BGSHeadPart);
-						if (headPart) {
-							presetData->headParts.push_back(headPart);
-						}
-					}
-					else {
-						_WARNING("Could not resolve part %08X", formId);
+	DataHandler * dataHandler = DataHandler::GetSingleton();
+	for (auto & part : data.headParts)
+	{
+		UInt32 formId = part.formId;
+		UInt8 modIndex = formId >> 24;
+		auto it = modList.find(modIndex);
+		if (it != modList.end()) {
+			UInt8 gameIndex = dataHandler->GetModIndex(it->second.c_str());
+			if (gameIndex != 255) {
+				formId = (formId & 0x00FFFFFF) | (gameIndex << 24);
+				TESForm * headPartForm = LookupFormByID(formId);
+				if (headPartForm) {
+					BGSHeadPart * headPart = DYNAMIC_CAST(headPartForm, TESForm, BGSHeadPart);
+					if (headPart) {
+						presetData.headParts.push_back(headPart);
 					}
 				}
 				else {
-					_WARNING("Could not load part type %d from %s; mod not found.", partType, it->second.c_str());
+					_WARNING("Could not resolve part %08X", formId);
 				}
 			}
+			else {
+				_WARNING("Could not load part type %d from %s; mod not found.", part.type, it->second.c_str());
+			}
 		}
 	}
 
-	Json::Value actor = root["actor"];
-	if (!actor.empty() && actor.type() == Json::objectValue) {
-		presetData->weight = actor["weight"].asFloat();
-		presetData->hairColor = actor["hairColor"].asUInt();
-	}
-
-
-	Json::Value tintInfo = root["tintInfo"];
-	if (!tintInfo.empty() && tintInfo.type() == Json::arrayValue) {
-		for (auto & tint : tintInfo) {
-			PresetData::Tint tintData;
-			tintData.color = tint["color"].asUInt();
-			tintData.index = tint["index"].asUInt();
-			tintData.name = tint["texture"].asString().c_str();
-			presetData->tints.push_back(tintData);
-		}
+	for (auto & tint : data.tints)
+	{
+		PresetData::Tint tintData;
+		tintData.index = tint.index;
+		tintData.color = tint.color;
+		tintData.name = tint.texture.c_str();
+		presetData.tints.push_back(tintData);
 	}
 
-	Json::Value faceTextures = root["faceTextures"];
-	if (!faceTextures.empty() && faceTextures.type() == Json::arrayValue) {
-		for (auto & faceTexture : faceTextures) {
-			PresetData::Texture texture;
-			texture.index = faceTexture["index"].asUInt();
-			texture.name = faceTexture["texture"].asString().c_str();
-			presetData->faceTextures.push_back(texture);
-		}
+	for (auto & faceTexture : data.faceTextures)
+	{
+		PresetData::Texture texture;
+		texture.index = faceTexture.index;
+		texture.name = faceTexture.texture.c_str();
+		presetData.faceTextures.push_back(texture);
 	}
 
-	Json::Value morphs = root["morphs"];
-	if (!morphs.empty()) {
-		Json::Value defaultMorphs = morphs["default"];
-		if (!defaultMorphs.empty()) {
-			Json::Value presets = defaultMorphs["presets"];
-			for (auto & preset : presets) {
-				UInt32 presetValue = preset.asUInt();
-				if (presetValue == 255)
-					presetValue = -1;
-
-				presetData->presets.push_back(presetValue);
-			}
-
-			Json::Value morphs = defaultMorphs["morphs"];
-			for (auto & morph : morphs) {
-				presetData->morphs.push_back(morph.asFloat());
-			}
-		}
-		Json::Value customMorphs = morphs["custom"];
-		if (!customMorphs.empty()) {
-			for (auto & customMorph : customMorphs) {
-				PresetData::Morph morph;
-				morph.name = customMorph["name"].asString().c_str();
-				morph.value = customMorph["value"].asFloat();
-				presetData->customMorphs.push_back(morph);
-			}
-		}
-
-		SInt32 multiplier = -1;
-
-		Json::Value sculptMult = morphs["sculptDivisor"];
-		if (!sculptMult.empty())
-			multiplier = sculptMult.asInt();
-
-		Json::Value sculptData = morphs["sculpt"];
-		if (!sculptData.empty()) {
-			presetData->sculptData = std::make_shared<SculptData>();
-			for (auto & hostFile : sculptData) {
-				BSFixedString host = hostFile["host"].asString().c_str();
-				Json::Value data = hostFile["data"];
+	presetData.presets = data.presets;
+	presetData.morphs = data.morphs;
 
-				auto sculptedData = std::make_shared<MappedSculptData>();
-				for (auto & morphData : data) {
-					UInt16 index = morphData[0].asUInt();
-					NiPoint3 pt;
-
-					if (multiplier > 0) {
-						pt.x = (float)morphData[1].asInt() / (float)multiplier;
-						pt.y = (float)morphData[2].asInt() / (float)multiplier;
-						pt.z = (float)morphData[3].asInt() / (float)multiplier;
-					} else {
-						pt.x = morphData[1].asFloat();
-						pt.y = morphData[2].asFloat();
-						pt.z = morphData[3].asFloat();
-					}
+	for (auto & customMorph : data.customMorphs)
+	{
+		PresetData::Morph morph;
+		morph.name = customMorph.name.c_str();
+		morph.value = customMorph.value;
+		presetData.customMorphs.push_back(morph);
+	}
 
-					sculptedData->force_insert(std::make_pair(index, pt));
+	if (!data.sculpt.empty()) {
+		presetData.sculptData = std::make_shared<SculptData>();
+		for (auto & sculptHost : data.sculpt)
+		{
+			auto sculptedData = std::make_shared<MappedSculptData>();
+			for (auto & vertex : sculptHost.vertices)
+			{
+				NiPoint3 pt;
+				if (data.sculptDivisor > 0) {
+					pt.x = (float)vertex.fixed[0] / (float)data.sculptDivisor;
+					pt.y = (float)vertex.fixed[1] / (float)data.sculptDivisor;
+					pt.z = (float)vertex.fixed[2] / (float)data.sculptDivisor;
+				} else {
+					pt.x = vertex.value[0];
+					pt.y = vertex.value[1];
+					pt.z = vertex.value[2];
 				}
 
-				presetData->sculptData->emplace(host, sculptedData);
+				sculptedData->force_insert(std::make_pair(vertex.index, pt));
 			}
+
+			presetData.sculptData->emplace(BSFixedString(sculptHost.host.c_str()), sculptedData);
 		}
 	}
 
-	Json::Value transforms = root["transforms"];
-	if (!transforms.empty()) {
-		for (auto & xForm : transforms) {
-			bool isFirstPerson = xForm["firstPerson"].asBool();
-			BSFixedString nodeName = xForm["node"].asString().c_str();
-
-			Json::Value keys = xForm["keys"];
-			for (auto & key : keys) {
-				BSFixedString keyName = key["name"].asString().c_str();
-
-				Json::Value values = key["values"];
-				for (auto & jvalue : values) {
-					OverrideVariant value;
-					value.key = jvalue["key"].asUInt();
-					value.type = jvalue["type"].asInt();
-					value.index = jvalue["index"].asInt();
-					switch (value.type) {
-						case OverrideVariant::kType_Bool:
-						value.data.b = jvalue["data"].asBool();
-						break;
-						case OverrideVariant::kType_Int:
-						value.data.i = jvalue["data"].asInt();
-						break;
-						case OverrideVariant::kType_Float:
-						value.data.f = jvalue["data"].asFloat();
-						break;
-						case OverrideVariant::kType_String:
-						value.data.str = BSFixedString(jvalue["data"].asString().c_str()).data;
-						break;
-					}
+	for (auto & transform : data.transforms)
+	{
+		BSFixedString nodeName(transform.node.c_str());
+		for (auto & key : transform.keys)
+		{
+			if (key.values.empty())
+				continue;
 
-					presetData->transformData[isFirstPerson ? 1 : 0][nodeName][keyName].push_back(value);
-				}
-			}
+			auto & values = presetData.transformData[transform.firstPerson ? 1 : 0][nodeName][BSFixedString(key.name.c_str())];
+			ReadOverrideValues(key.values, values);
 		}
 	}
 
-	Json::Value overrides = root["overrides"];
-	if (!overrides.empty()) {
-		for (auto & ovr : overrides) {
-			BSFixedString node = ovr["node"].asString().c_str();
-			Json::Value values = ovr["values"];
-			for (auto & jvalue : values) {
-				OverrideVariant value;
-				value.key = jvalue["key"].asUInt();
-				value.type = jvalue["type"].asInt();
-				value.index = jvalue["index"].asInt();
-				switch (value.type) {
-					case OverrideVariant::kType_Bool:
-					value.data.b = jvalue["data"].asBool();
-					break;
-					case OverrideVariant::kType_Int:
-					value.data.i = jvalue["data"].asInt();
-					break;
-					case OverrideVariant::kType_Float:
-					value.data.f = jvalue["data"].asFloat();
-					break;
-					case OverrideVariant::kType_String:
-					value.data.str = BSFixedString(jvalue["data"].asString().c_str()).data;
-					break;
-				}
-				presetData->overrideData[node].push_back(value);
-			}
-		}
+	for (auto & entry : data.overrides)
+	{
+		if (!entry.values.empty())
+			ReadOverrideValues(entry.values, presetData.overrideData[BSFixedString(entry.node.c_str())]);
 	}
 
-	Json::Value skinOverrides = root["skinOverrides"];
-	if (!skinOverrides.empty()) {
-		for (auto & skinData : skinOverrides) {
-			bool isFirstPerson = skinData["firstPerson"].asBool();
-			UInt32 slotMask = skinData["slotMask"].asUInt();
+	for (auto & skin : data.skinOverrides)
+	{
+		if (!skin.values.empty())
+			ReadOverrideValues(skin.values, presetData.skinData[skin.firstPerson ? 1 : 0][skin.slotMask]);
+	}
 
-			Json::Value values = skinData["values"];
-			for (auto & jvalue : values) {
-				OverrideVariant value;
-				value.key = jvalue["key"].asUInt();
-				value.type = jvalue["type"].asInt();
-				value.index = jvalue["index"].asInt();
-				switch (value.type) {
-					case OverrideVariant::kType_Bool:
-						value.data.b = jvalue["data"].asBool();
-						break;
-					case OverrideVariant::kType_Int:
-						value.data.i = jvalue["data"].asInt();
-						break;
-					case OverrideVariant::kType_Float:
-						value.data.f = jvalue["data"].asFloat();
-						break;
-					case OverrideVariant::kType_String:
-						value.data.str = BSFixedString(jvalue["data"].asString().c_str()).data;
-						break;
-				}
+	for (auto & bodyMorph : data.bodyMorphs)
+	{
+		BSFixedString morphName(bodyMorph.name.c_str());
+		if (bodyMorph.hasLegacy)
+			presetData.bodyMorphData[morphName]["RSMLegacy"] = bodyMorph.legacyValue;
 
-				presetData->skinData[isFirstPerson ? 1 : 0][slotMask].push_back(value);
+		for (auto & key : bodyMorph.keys)
+		{
+			// If the keys were mapped by mod name, skip them if they arent in load order
+			const char * ext = strrchr(key.key.c_str(), '.');
+			ext = ext ? ext + 1 : key.key.c_str();
+			if (_stricmp(ext, "esp") == 0 || _stricmp(ext, "esm") == 0)
+			{
+				if (!dataHandler->LookupModByName(key.key.c_str()))
+					continue;
 			}
+
+			presetData.bodyMorphData[morphName][BSFixedString(key.key.c_str())] = key.value;
 		}
 	}
 
-	Json::Value bodyMorphs = root["bodyMorphs"];
-	if (!bodyMorphs.empty()) {
-		for (auto & bm : bodyMorphs) {
-			BSFixedString name = bm["name"].asString().c_str();
+	return loadError;
+}
 
-			// Legacy version
-			Json::Value keyless = bm["value"];
-			if (!keyless.empty())
-			{
-				float value = bm["value"].asFloat();
-				presetData->bodyMorphData[name]["RSMLegacy"] = value;
-			}
+bool MorphHandler::LoadJsonPreset(const char * filePath, PresetDataPtr presetData)
+{
+	bool loadError = false;
+	BSResourceNiBinaryStream file(filePath);
+	if (!file.IsValid()) {
+		_ERROR("%s: File %s failed to open.", __FUNCTION__, filePath);
+		loadError = true;
+		return loadError;
+	}
 
-			// New version
-			Json::Value values = bm["keys"];
-			if (!values.empty())
-			{
-				for (auto & jvalue : values) {
-					BSFixedString key = jvalue["key"].asString().c_str();
-					float value = jvalue["value"].asFloat();
-
-					// If the keys were mapped by mod name, skip them if they arent in load order
-					std::string strKey(key.data);
-					BSFixedString ext(strKey.substr(strKey.find_last_of(".") + 1).c_str());
-					if (ext == "esp" || ext == "esm")
-					{
-						if (!dataHandler->LookupModByName(key.data))
-							continue;
-					}
+	std::string in;
+	BSReadAll(&file, &in);
 
-					presetData->bodyMorphData[name][key] = value;
-				}
-			}
-		}
+	PresetJsonDecoder decoder;
+	loadError = decoder.Decode(in.c_str(), in.c_str() + in.length());
+	if (loadError) {
+		_ERROR("%s: Error occured parsing json for %s.", __FUNCTION__, filePath);
+		return loadError;
 	}
 
-	return loadError;
+	return decoder.Finish(*presetData);
 }
 
-bool MorphHandler::LoadBinaryPreset(const char * filePath, PresetDataPtr presetData)
+bool MorphHandler::LoadBinaryPreset(const char * filePath, PresetDataPtr presetData, UInt32 sections)
 {
 	bool loadError = false;
 	BSResourceNiBinaryStream file(filePath);
@@ -2671,6 +2904,19 @@ bool MorphHandler::LoadBinaryPreset(const char * filePath, PresetDataPtr presetD
 			goto done;
 		}
 
+		if(header.formatVersion >= PresetHeader::kVersion_Sectioned)
+		{
+			PresetJsonDecoder decoder;
+			bool packed = header.formatVersion >= PresetHeader::kVersion_BinarySections;
+			loadError = ReadPresetSections(file, sections | kPresetSectionMetadata, [&decoder, packed](UInt32 type, const char * begin, const char * end)
+			{
+				return packed ? decoder.DecodeSection(type, begin, end) : decoder.Decode(begin, end);
+			});
+			if(!loadError)
+				loadError = decoder.Finish(*presetData);
+			goto done;
+		}
+
 		DataHandler * dataHandler = DataHandler::GetSingleton();
 
 		typedef std::map<UInt8, std::string> ModMap;
@@ -2848,6 +3094,116 @@ done:
 	return loadError;
 }
 
+// Preset index entries hold each section as its type and length followed by
+// the section, packed the way kVersion_BinarySections presets store it
+static void AppendPresetMetadata(std::string & metadata, UInt32 type, const char * begin, const char * end)
+{
+	UInt32 length = end - begin;
+	metadata.append((const char*)&type, sizeof(type));
+	metadata.append((const char*)&length, sizeof(length));
+	metadata.append(begin, end);
+}
+
+bool MorphHandler::ReadPresetMetadata(const char * filePath, bool json, std::string & metadata)
+{
+	bool loadError = false;
+	BSResourceNiBinaryStream file(filePath);
+	if (!file.IsValid()) {
+		_ERROR("%s: File %s failed to open.", __FUNCTION__, filePath);
+		loadError = true;
+		return loadError;
+	}
+
+	metadata.clear();
+	if (json)
+	{
+		std::string in;
+		BSReadAll(&file, &in);
+
+		Json::Features features;
+		features.all();
+
+		Json::Value root;
+		Json::Reader reader(features);
+		if (!reader.parse(in, root)) {
+			_ERROR("%s: Error occured parsing json for %s.", __FUNCTION__, filePath);
+			loadError = true;
+			return loadError;
+		}
+
+		Json::FastWriter writer;
+		UInt32 types[] = { kPresetSectionMetadata, kPresetSectionSliders };
+		for (auto type : types)
+		{
+			Json::Value section;
+			SplitPresetSections(root, type, section);
+
+			std::string data;
+			if (EncodePresetSection(type, writer.write(section), data)) {
+				loadError = true;
+				return loadError;
+			}
+			AppendPresetMetadata(metadata, type, data.c_str(), data.c_str() + data.length());
+		}
+	}
+	else
+	{
+		PresetHeader header;
+		if (file.Read(&header, sizeof(header)) != sizeof(header) || header.signature != PresetHeader::kSignature || header.formatVersion < PresetHeader::kVersion_Sectioned) {
+			loadError = true;
+			return loadError;
+		}
+
+		// Sections of older presets are json, pack them like the newer ones
+		bool packed = header.formatVersion >= PresetHeader::kVersion_BinarySections;
+		loadError = ReadPresetSections(file, kPresetSectionMetadata | kPresetSectionSliders, [&metadata, packed](UInt32 type, const char * begin, const char * end)
+		{
+			if (packed) {
+				AppendPresetMetadata(metadata, type, begin, end);
+				return false;
+			}
+
+			std::string data;
+			if (EncodePresetSection(type, std::string(begin, end), data))
+				return true;
+			AppendPresetMetadata(metadata, type, data.c_str(), data.c_str() + data.length());
+			return false;
+		});
+	}
+
+	return loadError;
+}
+
+bool MorphHandler::LoadPresetMetadata(const std::string & metadata, PresetDataPtr presetData)
+{
+	PresetJsonDecoder decoder;
+	const char * cursor = metadata.c_str();
+	const char * end = cursor + metadata.length();
+	while (cursor != end)
+	{
+		UInt32 header[2];
+		if ((size_t)(end - cursor) < sizeof(header)) {
+			_ERROR("%s: truncated preset metadata.", __FUNCTION__);
+			return true;
+		}
+		memcpy(header, cursor, sizeof(header));
+		cursor += sizeof(header);
+
+		if ((size_t)(end - cursor) < header[1]) {
+			_ERROR("%s: truncated preset metadata.", __FUNCTION__);
+			return true;
+		}
+
+		if (decoder.DecodeSection(header[0], cursor, cursor + header[1])) {
+			_ERROR("%s: Error occured parsing preset metadata.", __FUNCTION__);
+			return true;
+		}
+		cursor += header[1];
+	}
+
+	return decoder.Finish(*presetData);
+}
+
 BSFixedString SculptData::GetHostByPart(BGSHeadPart * headPart)
 {
 	const char * morphPath = headPart->chargenMorph.GetModelName();
@@ -2865,6 +3221,54 @@ BSFixedString SculptData::GetHostByPart(BGSHeadPart * headPart)
 	return BSFixedString("");
 }
 
+void PackedSculptData::Pack(const std::unordered_map<UInt16, NiPoint3> & data)
+{
+	indices.clear();
+	indices.reserve(data.size());
+	float maxDelta = 0.0f;
+	for (auto & it : data) {
+		indices.push_back(it.first);
+		maxDelta = max(maxDelta, max(abs(it.second.x), max(abs(it.second.y), abs(it.second.z))));
+	}
+
+	std::sort(indices.begin(), indices.end());
+
+	scale = max(1.0f / VERTEX_MULTIPLIER, maxDelta / 32767.0f);
+	float invScale = 1.0f / scale;
+
+	x.resize(indices.size());
+	y.resize(indices.size());
+	z.resize(indices.size());
+	for (UInt32 i = 0; i < indices.size(); i++) {
+		const NiPoint3 & delta = data.find(indices[i])->second;
+		x[i] = (SInt16)floor(delta.x * invScale + 0.5f);
+		y[i] = (SInt16)floor(delta.y * invScale + 0.5f);
+		z[i] = (SInt16)floor(delta.z * invScale + 0.5f);
+	}
+}
+
+void PackedSculptData::Apply(NiPoint3 * vertices, UInt32 vertexCount) const
+{
+	// Indices are sorted, everything from the first out of range one on is skipped
+	UInt32 count = std::lower_bound(indices.begin(), indices.end(), vertexCount) - indices.begin();
+	for (UInt32 i = 0; i < count; i++) {
+		NiPoint3 & vertex = vertices[indices[i]];
+		vertex.x += x[i] * scale;
+		vertex.y += y[i] * scale;
+		vertex.z += z[i] * scale;
+	}
+}
+
+void MappedSculptData::Apply(NiPoint3 * vertices, UInt32 vertexCount)
+{
+	if (!m_packed) {
+		m_packed.reset(new PackedSculptData);
+		m_packed->Pack(m_data);
+	}
+
+	m_packed->Apply(vertices, vertexCount);
+}
+
 MappedSculptDataPtr SculptData::GetSculptHost(BSFixedString host, bool create)
 {
 	auto it = find(host);
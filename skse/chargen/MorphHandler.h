@@ -19,6 +19,13 @@ class TESRace;
 class BGSHeadPart;
 class TESForm;
 class TESModelTri;
+class NiGeometry;
+class NiPoint3;
+
+namespace Json
+{
+	class Value;
+}
 
 #define SLIDER_OFFSET 200
 #define SLIDER_CATEGORY_EXTRA 512
@@ -157,7 +164,17 @@ typedef std::shared_ptr<SliderMap>	SliderMapPtr;
 class SliderSet : public std::set<SliderMapPtr>
 {
 public:
+	SliderSet() : m_indexed(false) { }
+
 	bool for_each_slider(std::function<bool(SliderGenderPtr)> func);
+
+	// Name lookup matching the first slider for_each_slider would visit
+	SliderInternalPtr FindSlider(UInt8 gender, BSFixedString name);
+	void InvalidateIndex() { m_indexed = false; }
+
+private:
+	bool m_indexed;
+	std::unordered_map<BSFixedString, SliderInternalPtr> m_index[2];
 };
 
 typedef std::shared_ptr<SliderSet> SliderSetPtr;
@@ -197,28 +214,65 @@ public:
 #define VERTEX_THRESHOLD 0.00001
 #define VERTEX_MULTIPLIER 10000
 
-class MappedSculptData : public std::unordered_map<UInt16, NiPoint3>
+// Sorted copy of a sculpt used to apply it in one linear pass. Deltas are
+// quantized to SInt16 with a per-part scale as in the TRIP layout, the scale
+// is never finer than the 1/VERTEX_MULTIPLIER precision presets keep.
+class PackedSculptData
+{
+public:
+	PackedSculptData() : scale(0.0f) { }
+
+	void Pack(const std::unordered_map<UInt16, NiPoint3> & data);
+	void Apply(NiPoint3 * vertices, UInt32 vertexCount) const;
+
+	float					scale;
+	std::vector<UInt16>		indices;
+	std::vector<SInt16>		x, y, z;
+};
+
+// Sculpt offsets of one host by vertex index. Changes go through
+// force_insert and add so the packed copy is dropped with them.
+class MappedSculptData
 {
 public:
+	typedef std::unordered_map<UInt16, NiPoint3>	Map;
+	typedef Map::value_type							value_type;
+	typedef Map::const_iterator						const_iterator;
+
+	const_iterator begin() const { return m_data.begin(); }
+	const_iterator end() const { return m_data.end(); }
+	const_iterator find(UInt16 index) const { return m_data.find(index); }
+	size_t size() const { return m_data.size(); }
+	bool empty() const { return m_data.empty(); }
+
 	void force_insert(value_type const & v)
 	{
 		if (abs(v.second.x) < VERTEX_THRESHOLD && abs(v.second.y) < VERTEX_THRESHOLD && abs(v.second.z) < VERTEX_THRESHOLD)
 			return;
 
-		auto res = insert(v);
+		m_packed.reset();
+		auto res = m_data.insert(v);
 		if (!res.second)
 			(*res.first).second = v.second;
 	}
 
 	void add(value_type const & v)
 	{
-		auto res = insert(v);
+		m_packed.reset();
+		auto res = m_data.insert(v);
 		if (!res.second)
 			(*res.first).second += v.second;
 
 		if (abs((*res.first).second.x) < VERTEX_THRESHOLD && abs((*res.first).second.y) < VERTEX_THRESHOLD && abs((*res.first).second.z) < VERTEX_THRESHOLD)
-			erase(res.first);
+			m_data.erase(res.first);
 	}
+
+	// Adds the sculpt to vertices, packing it first if it changed
+	void Apply(NiPoint3 * vertices, UInt32 vertexCount);
+
+private:
+	Map									m_data;
+	std::unique_ptr<PackedSculptData>	m_packed;
 };
 typedef std::shared_ptr<MappedSculptData> MappedSculptDataPtr;
 
@@ -297,17 +351,16 @@ public:
 	bool Load(const char * triPath);
 	bool Apply(NiGeometry * geometry, BSFixedString morph, float relative);
 
+	// Deltas are stored pre-multiplied and split per axis
 	struct Morph
 	{
 		BSFixedString name;
 		float multiplier;
-		
-		struct Vertex
-		{
-			SInt16 x, y, z;
-		};
 
-		std::vector<Vertex> vertices;
+		std::vector<float> x, y, z;
+
+		void Decode(const SInt16 * packed, UInt32 count);
+		void Apply(NiPoint3 * vertices, UInt32 count, float relative) const;
 	};
 
 	SInt32 vertexCount;
@@ -346,6 +399,9 @@ public:
 	void ApplyMorph(TESNPC * npc, BGSHeadPart * headPart, BSFaceGenNiNode * faceNode);
 	void ApplyMorphs(TESNPC * npc, BSFaceGenNiNode * faceNode);
 
+	// Applies a morph to one head part at its full factor in a single pass, false if the part's TRI doesn't provide it
+	bool ApplyScaledMorph(BGSHeadPart * headPart, NiGeometry * geometry, BSFixedString morphName, float relative);
+
 	void LoadSliders(SliderArray * sliderArray, RaceMenuSlider * slider);
 
 	void ReadMorphs(std::string fixedPath, std::string modName, std::string fileName);
@@ -361,6 +417,8 @@ public:
 	bool VisitMorphMap(BSFixedString key, MorphMap::Visitor & visitor);
 
 	bool CacheHeadPartModel(BGSHeadPart * headPart, bool cacheTRI = false);
+	// Reads the vertex counts of the head part TRIs and their extended morphs, on worker threads if parallel
+	void CacheHeadPartModels(const std::vector<BGSHeadPart*> & headParts, bool parallel);
 	bool GetModelTri(BSFixedString filePath, TRIModelData & modelData);
 	TRIModelData & GetExtendedModelTri(BSFixedString morphName, bool cacheTRI = false);
 
@@ -396,9 +454,21 @@ public:
 	bool ErasePreset(TESNPC * npc);
 	void ClearPresets();
 
+	// Sections of a binary preset, metadata is always loaded
+	enum PresetSections
+	{
+		kPresetSectionMetadata  = (1 << 0),
+		kPresetSectionSliders   = (1 << 1),
+		kPresetSectionOverrides = (1 << 2),
+		kPresetSectionSculpt    = (1 << 3),
+		kPresetSectionAll       = kPresetSectionMetadata | kPresetSectionSliders | kPresetSectionOverrides | kPresetSectionSculpt,
+
+		kNumPresetSections      = 4
+	};
+
 	bool SaveBinaryPreset(const char * filePath);
 	//bool LoadPreset(const char * filePath, GFxMovieView * movieView, GFxValue * rootObject);
-	bool LoadBinaryPreset(const char * filePath, PresetDataPtr presetData);
+	bool LoadBinaryPreset(const char * filePath, PresetDataPtr presetData, UInt32 sections = kPresetSectionAll);
 
 	enum ApplyTypes
 	{
@@ -412,9 +482,21 @@ public:
 
 	void ApplyPresetData(Actor * actor, PresetDataPtr presetData, bool setSkinColor = false, ApplyTypes applyType = kPresetApplyAll);
 
+	// Hand preset values to nioverride, in a single call where its interface
+	// version has the array entry points
+	static void AddNodeOverrides(Actor * actor, bool isFemale, PresetData::OverrideData & overrideData);
+	static void SetBodyMorphs(Actor * actor, PresetData::BodyMorphData & bodyMorphData);
+
 	bool SaveJsonPreset(const char * filePath);
 	bool LoadJsonPreset(const char * filePath, PresetDataPtr presetData);
 
+	// Metadata and slider sections of a preset packed for the preset index.
+	// Fails for binary presets older than the sectioned format.
+	bool ReadPresetMetadata(const char * filePath, bool json, std::string & metadata);
+	bool LoadPresetMetadata(const std::string & metadata, PresetDataPtr presetData);
+
+	void WritePresetJson(Json::Value & root);
+
 #ifdef _DEBUG_DATADUMP
 	void DumpAll();
 #endif
@@ -1,6 +1,8 @@
 #include "NifUtils.h"
 
 #include <unordered_map>
+#include <memory>
+#include <ppltasks.h>
 
 #include "common/IFileStream.h"
 
@@ -19,6 +21,8 @@
 #include "skse/NiTextures.h"
 #include "skse/NiExtraData.h"
 #include "skse/NiAllocator.h"
+
+#include "skse/PluginAPI.h"
 #include <d3dx9.h>
 #pragma comment(lib, "d3dx9.lib")
 
@@ -26,6 +30,8 @@ typedef NiSourceTexture * (* _NiRenderedTextureToNiSourceTexture)(NiRenderedText
 const _NiRenderedTextureToNiSourceTexture NiRenderedTextureToNiSourceTexture = (_NiRenderedTextureToNiSourceTexture)0x00C8CD60;
 UInt8 * g_bAlwaysCreateRendererData = (UInt8 *)0x012C5D48; // This is set as 1 in 0x00C6DBF0 (SetupRenderer)
 
+extern SKSETaskInterface	* g_task;
+
 void SaveSourceDDS(NiSourceTexture * pkSrcTexture, const char * pcFileName)
 {
 	if(!pkSrcTexture)
@@ -79,14 +85,86 @@ void SaveSourceDDS(NiSourceTexture * pkSrcTexture, const char * pcFileName)
 	}
 }
 
-void SaveRenderedDDS(NiRenderedTexture * pkTexture, const char * pcFileName)
+NiSourceTexture * GetRenderedSourceTexture(NiRenderedTexture * pkTexture)
 {
 	UInt8 oldVal = *g_bAlwaysCreateRendererData;
 	*g_bAlwaysCreateRendererData = 0; // Need to set this to 0 because NiSourceTexture is inited with flag DestroyAppData = 0x04, and CreateRenderData checks this
 	NiSourceTexture * pkSrcTexture = NiRenderedTextureToNiSourceTexture(pkTexture, 1);
 	*g_bAlwaysCreateRendererData = oldVal;
+	return pkSrcTexture;
+}
+
+void SaveRenderedDDS(NiRenderedTexture * pkTexture, const char * pcFileName)
+{
+	SaveSourceDDS(GetRenderedSourceTexture(pkTexture), pcFileName);
+}
+
+// Reads the pixels of a rendered texture back from the renderer, main thread only
+bool CopyRenderedPixels(NiRenderedTexture * pkTexture, UInt32 & uiWidth, UInt32 & uiHeight, std::vector<UInt8> & pixels)
+{
+	NiSourceTexture * pkSrcTexture = GetRenderedSourceTexture(pkTexture);
+	if (!pkSrcTexture || !pkSrcTexture->pixelData)
+		return true;
+
+	uiWidth = pkSrcTexture->GetWidth();
+	uiHeight = pkSrcTexture->GetHeight();
 
-	SaveSourceDDS(pkSrcTexture, pcFileName);
+	UInt8 * pucSrc = pkSrcTexture->pixelData->GetPixels();
+	pixels.assign(pucSrc, pucSrc + uiWidth * uiHeight * 4);
+	return false;
+}
+
+// Same layout D3DX writes for an uncompressed A8R8G8B8 texture without mipmaps
+struct DDSHeader
+{
+	UInt32	magic;
+	UInt32	size;
+	UInt32	flags;
+	UInt32	height;
+	UInt32	width;
+	UInt32	pitch;
+	UInt32	depth;
+	UInt32	mipMapCount;
+	UInt32	reserved1[11];
+	UInt32	pfSize;
+	UInt32	pfFlags;
+	UInt32	pfFourCC;
+	UInt32	pfRGBBitCount;
+	UInt32	pfRBitMask;
+	UInt32	pfGBitMask;
+	UInt32	pfBBitMask;
+	UInt32	pfABitMask;
+	UInt32	caps;
+	UInt32	caps2;
+	UInt32	caps3;
+	UInt32	caps4;
+	UInt32	reserved2;
+};
+
+// Builds the dds file of A8R8G8B8 pixels in memory, needs no device so any thread may call it
+void EncodeDDS(UInt32 uiWidth, UInt32 uiHeight, const std::vector<UInt8> & pixels, std::vector<UInt8> & output)
+{
+	DDSHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = MAKEFOURCC('D', 'D', 'S', ' ');
+	header.size = sizeof(DDSHeader) - sizeof(UInt32);
+	header.flags = 0x0000100F; // DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PITCH | DDSD_PIXELFORMAT
+	header.height = uiHeight;
+	header.width = uiWidth;
+	header.pitch = uiWidth * 4;
+	header.pfSize = 32;
+	header.pfFlags = 0x00000041; // DDPF_RGB | DDPF_ALPHAPIXELS
+	header.pfRGBBitCount = 32;
+	header.pfRBitMask = 0x00FF0000;
+	header.pfGBitMask = 0x0000FF00;
+	header.pfBBitMask = 0x000000FF;
+	header.pfABitMask = 0xFF000000;
+	header.caps = 0x00001000; // DDSCAPS_TEXTURE
+
+	output.resize(sizeof(header) + pixels.size());
+	memcpy(&output[0], &header, sizeof(header));
+	if (!pixels.empty())
+		memcpy(&output[sizeof(header)], &pixels[0], pixels.size());
 }
 
 NiTriBasedGeom * GetHeadTriBasedGeom(Actor * actor, UInt32 partType)
@@ -215,6 +293,91 @@ std::pair<BGSTextureSet*, BGSHeadPart*> GetTextureSetForPartByName(TESNPC * npc,
 	return std::make_pair<BGSTextureSet*, BGSHeadPart*>(NULL, NULL);
 }
 
+// What the dds worker needs, copied out on the main thread
+struct ExportHeadData
+{
+	UInt32				formId;
+	std::string			nifPath;
+	std::string			ddsPath;
+	bool				nifError;
+	UInt32				tintWidth;
+	UInt32				tintHeight;
+	std::vector<UInt8>	tintPixels;
+};
+
+typedef std::shared_ptr<ExportHeadData> ExportHeadDataPtr;
+
+// Exports run one after another so two of them never write the same file at once,
+// only touched from the main thread
+static concurrency::task<void>	s_exportQueue;
+static bool						s_exportQueued = false;
+
+// Writes next to the target and renames it over, an export cut off by the game
+// closing never leaves a truncated file behind
+static bool WriteExportFile(const std::string & filePath, const std::vector<UInt8> & data)
+{
+	std::string tempPath = filePath + ".tmp";
+
+	IFileStream		currentFile;
+	IFileStream::MakeAllDirs(filePath.c_str());
+	if (!currentFile.Create(tempPath.c_str()))
+	{
+		_ERROR("%s: couldn't create file (%s) Error (%d)", __FUNCTION__, tempPath.c_str(), GetLastError());
+		return true;
+	}
+
+	currentFile.WriteBuf(&data[0], data.size());
+	currentFile.Close();
+
+	if (!MoveFileEx(tempPath.c_str(), filePath.c_str(), MOVEFILE_REPLACE_EXISTING))
+	{
+		_ERROR("%s: couldn't replace file (%s) Error (%d)", __FUNCTION__, filePath.c_str(), GetLastError());
+		DeleteFile(tempPath.c_str());
+		return true;
+	}
+
+	return false;
+}
+
+// NiStream and the copied tree share textures, materials and skin data with the
+// live nodes, so saving and releasing them stays on the main thread
+static bool SaveExportNif(NiNode * rootNode, const char * filePath)
+{
+	IFileStream::MakeAllDirs(filePath);
+
+	UInt8 niStreamMemory[0x5B4];
+	memset(niStreamMemory, 0, 0x5B4);
+	NiStream * niStream = (NiStream *)niStreamMemory;
+	CALL_MEMBER_FN(niStream, ctor)();
+	CALL_MEMBER_FN(niStream, AddObject)(rootNode);
+	bool saved = niStream->SavePath(filePath);
+	CALL_MEMBER_FN(niStream, dtor)();
+	return !saved;
+}
+
+// Worker side, touches nothing but the copied pixels
+static void RunExportHead(ExportHeadDataPtr data)
+{
+	bool ddsError = false;
+	if (!data->tintPixels.empty())
+	{
+		std::vector<UInt8> dds;
+		EncodeDDS(data->tintWidth, data->tintHeight, data->tintPixels, dds);
+		std::vector<UInt8>().swap(data->tintPixels);
+
+		ddsError = WriteExportFile(data->ddsPath, dds);
+	}
+
+	if (g_task)
+		g_task->AddTask(new SKSETaskExportHeadComplete(data->formId, data->nifPath, data->nifError, data->ddsPath, ddsError));
+}
+
+void WaitForHeadExports()
+{
+	if (s_exportQueued)
+		s_exportQueue.wait();
+}
+
 SKSETaskExportHead::SKSETaskExportHead(Actor * actor, BSFixedString nifPath, BSFixedString ddsPath) : m_nifPath(nifPath), m_ddsPath(ddsPath)
 {
 	m_formId = actor->formID;
@@ -248,7 +411,13 @@ void SKSETaskExportHead::Run()
 		UpdateModelFace(faceNode);
 	}
 
-	IFileStream::MakeAllDirs(m_nifPath.data);
+	ExportHeadDataPtr data = std::make_shared<ExportHeadData>();
+	data->formId = m_formId;
+	data->nifPath = m_nifPath.data;
+	data->ddsPath = m_ddsPath.data;
+	data->nifError = false;
+	data->tintWidth = 0;
+	data->tintHeight = 0;
 
 	BSFadeNode * rootNode = BSFadeNode::Create();
 	rootNode->IncRef();
@@ -385,7 +554,8 @@ void SKSETaskExportHead::Run()
 							if (material) {
 								if (material->GetShaderType() == BSShaderMaterial::kShaderType_FaceGen) {
 									BSMaskedShaderMaterial * maskedMaterial = static_cast<BSMaskedShaderMaterial *>(material);
-									SaveRenderedDDS(niptr_cast<NiRenderedTexture>(maskedMaterial->renderedTexture), m_ddsPath.data);
+									if (CopyRenderedPixels(niptr_cast<NiRenderedTexture>(maskedMaterial->renderedTexture), data->tintWidth, data->tintHeight, data->tintPixels))
+										_ERROR("%s - failed to read tint mask for %s", __FUNCTION__, m_ddsPath.data);
 								}
 							}
 						}
@@ -402,22 +572,35 @@ void SKSETaskExportHead::Run()
 
 	rootNode->AttachChild(skinnedNode, true);
 
-	UInt8 niStreamMemory[0x5B4];
-	memset(niStreamMemory, 0, 0x5B4);
-	NiStream * niStream = (NiStream *)niStreamMemory;
-	CALL_MEMBER_FN(niStream, ctor)();
-	CALL_MEMBER_FN(niStream, AddObject)(rootNode);
-	niStream->SavePath(m_nifPath.data);
-	CALL_MEMBER_FN(niStream, dtor)();
-
-	rootNode->DecRef();
-
 	if (animationData) {
 		animationData->overrideFlag = 0;
 		CALL_MEMBER_FN(animationData, Reset)(1.0, 1, 1, 0, 0);
 		FaceGen::GetSingleton()->isReset = 1;
 		UpdateModelFace(faceNode);
 	}
+
+	data->nifError = SaveExportNif(rootNode, m_nifPath.data);
+	rootNode->DecRef();
+
+	auto job = [data]() { RunExportHead(data); };
+	s_exportQueue = s_exportQueued ? s_exportQueue.then(job) : concurrency::create_task(job);
+	s_exportQueued = true;
+}
+
+SKSETaskExportHeadComplete::SKSETaskExportHeadComplete(UInt32 formId, const std::string & nifPath, bool nifError, const std::string & ddsPath, bool ddsError)
+	: m_formId(formId), m_nifPath(nifPath), m_ddsPath(ddsPath), m_nifError(nifError), m_ddsError(ddsError)
+{
+
+}
+
+void SKSETaskExportHeadComplete::Run()
+{
+	if (m_nifError)
+		_ERROR("%s - failed to export head of %08X to %s", __FUNCTION__, m_formId, m_nifPath.c_str());
+	if (m_ddsError)
+		_ERROR("%s - failed to export tint mask of %08X to %s", __FUNCTION__, m_formId, m_ddsPath.c_str());
+	if (!m_nifError && !m_ddsError)
+		_MESSAGE("%s - exported head of %08X to %s", __FUNCTION__, m_formId, m_nifPath.c_str());
 }
 
 bool VisitObjects(NiAVObject * parent, std::function<bool(NiAVObject*)> functor)
@@ -465,7 +648,7 @@ UInt16 GetStripLengthSum(NiTriStripsData * strips)
 	return strips->m_usTriangles + 2 * strips->m_usStrips;
 }
 
-void GetTriangleIndices(NiTriStripsData * strips, UInt16 i, UInt16 v0, UInt16 v1, UInt16 v2)
+void GetTriangleIndices(NiTriStripsData * strips, UInt16 i, UInt16 & v0, UInt16 & v1, UInt16 & v2)
 {
 	UInt16 usTriangles;
 	UInt16 usStrip = 0;
@@ -6,6 +6,8 @@
 #include "skse/NiTypes.h"
 
 #include <functional>
+#include <string>
+#include <vector>
 
 class NiSourceTexture;
 class NiRenderedTexture;
@@ -16,6 +18,8 @@ class BSFaceGenNiNode;
 class NiGeometry;
 class NiTriStripsData;
 
+// Run copies the face and its tint mask and saves the nif on the main thread, the
+// dds is encoded and written by a worker which queues SKSETaskExportHeadComplete
 class SKSETaskExportHead : public TaskDelegate
 {
 	virtual void Run();
@@ -29,6 +33,24 @@ public:
 	BSFixedString	m_ddsPath;
 };
 
+class SKSETaskExportHeadComplete : public TaskDelegate
+{
+	virtual void Run();
+	virtual void Dispose() { delete this; }
+
+public:
+	SKSETaskExportHeadComplete::SKSETaskExportHeadComplete(UInt32 formId, const std::string & nifPath, bool nifError, const std::string & ddsPath, bool ddsError);
+
+	UInt32			m_formId;
+	std::string		m_nifPath;
+	std::string		m_ddsPath;
+	bool			m_nifError;
+	bool			m_ddsError;
+};
+
+// Blocks until every queued head export has written its files
+void WaitForHeadExports();
+
 class SKSETaskRefreshTintMask : public TaskDelegate
 {
 	virtual void Run();
@@ -49,10 +71,13 @@ NiTriBasedGeom * GetTriBasedGeomByHeadPart(BSFaceGenNiNode * faceNode, BGSHeadPa
 
 void SaveSourceDDS(NiSourceTexture * pkSrcTexture, const char * pcFileName);
 void SaveRenderedDDS(NiRenderedTexture * pkTexture, const char * pcFileName);
+NiSourceTexture * GetRenderedSourceTexture(NiRenderedTexture * pkTexture);
+bool CopyRenderedPixels(NiRenderedTexture * pkTexture, UInt32 & uiWidth, UInt32 & uiHeight, std::vector<UInt8> & pixels);
+void EncodeDDS(UInt32 uiWidth, UInt32 uiHeight, const std::vector<UInt8> & pixels, std::vector<UInt8> & output);
 
 bool VisitObjects(NiAVObject * parent, std::function<bool(NiAVObject*)> functor);
 
 NiTransform GetGeometryTransform(NiGeometry * geometry);
 
 UInt16	GetStripLengthSum(NiTriStripsData * strips);
-void GetTriangleIndices(NiTriStripsData * strips, UInt16 i, UInt16 v0, UInt16 v1, UInt16 v2);
+void GetTriangleIndices(NiTriStripsData * strips, UInt16 i, UInt16 & v0, UInt16 & v1, UInt16 & v2);
@@ -0,0 +1,368 @@
+#include "ObjReader.h"
+
+#include <string.h>
+
+enum
+{
+	kCommand_None = 0,
+	kCommand_Position,
+	kCommand_TexCoord,
+	kCommand_Normal,
+	kCommand_Face
+};
+
+static const double s_pow10[] =
+{
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static inline bool IsBlank(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+static inline bool IsDigit(char c)
+{
+	return (UInt32)(c - '0') < 10;
+}
+
+static inline const char * SkipBlanks(const char * p, const char * end)
+{
+	while (p < end && IsBlank(*p))
+		p++;
+	return p;
+}
+
+static inline const char * FindLineEnd(const char * p, const char * end)
+{
+	const char * newline = (const char *)memchr(p, '\n', end - p);
+	return newline ? newline : end;
+}
+
+static UInt32 ReadCommand(const char *& p, const char * end)
+{
+	p = SkipBlanks(p, end);
+	if (end - p < 2)
+		return kCommand_None;
+
+	if (p[0] == 'v') {
+		if (IsBlank(p[1])) {
+			p += 1;
+			return kCommand_Position;
+		}
+		if (end - p < 3 || !IsBlank(p[2]))
+			return kCommand_None;
+		if (p[1] == 't') {
+			p += 2;
+			return kCommand_TexCoord;
+		}
+		if (p[1] == 'n') {
+			p += 2;
+			return kCommand_Normal;
+		}
+	}
+	else if (p[0] == 'f' && IsBlank(p[1])) {
+		p += 1;
+		return kCommand_Face;
+	}
+
+	return kCommand_None;
+}
+
+// Up to 19 significant digits are gathered into an integer and scaled once
+// by a power of ten. False if there is no digit.
+static bool ReadFloat(const char *& p, const char * end, float & value)
+{
+	p = SkipBlanks(p, end);
+
+	bool negative = false;
+	if (p < end && (*p == '-' || *p == '+'))
+		negative = *p++ == '-';
+
+	UInt64 mantissa = 0;
+	SInt32 digits = 0;
+	SInt32 exponent = 0;
+	bool any = false;
+	for (; p < end && IsDigit(*p); p++) {
+		any = true;
+		if (digits < 19) {
+			mantissa = mantissa * 10 + (*p - '0');
+			if (mantissa)
+				digits++;
+		}
+		else
+			exponent++;
+	}
+
+	if (p < end && *p == '.') {
+		for (p++; p < end && IsDigit(*p); p++) {
+			any = true;
+			if (digits < 19) {
+				mantissa = mantissa * 10 + (*p - '0');
+				if (mantissa)
+					digits++;
+				exponent--;
+			}
+		}
+	}
+
+	if (!any)
+		return false;
+
+	if (p < end && (*p == 'e' || *p == 'E')) {
+		p++;
+		bool negativeExponent = false;
+		if (p < end && (*p == '-' || *p == '+'))
+			negativeExponent = *p++ == '-';
+
+		SInt32 e = 0;
+		for (; p < end && IsDigit(*p); p++) {
+			if (e < 10000)
+				e = e * 10 + (*p - '0');
+		}
+		exponent += negativeExponent ? -e : e;
+	}
+
+	double result = (double)mantissa;
+	if (mantissa) {
+		for (; exponent > 22; exponent -= 22)
+			result *= 1e22;
+		for (; exponent < -22; exponent += 22)
+			result /= 1e22;
+		result = exponent < 0 ? result / s_pow10[-exponent] : result * s_pow10[exponent];
+	}
+
+	value = (float)(negative ? -result : result);
+	return true;
+}
+
+// 1 based index, negative ones count back from the last element read so far
+static bool ReadIndex(const char *& p, const char * end, UInt32 count, UInt32 & index)
+{
+	bool negative = false;
+	if (p < end && *p == '-') {
+		negative = true;
+		p++;
+	}
+
+	if (p >= end || !IsDigit(*p))
+		return false;
+
+	UInt64 value = 0;
+	for (; p < end && IsDigit(*p); p++) {
+		if (value <= 0xFFFFFFFF)
+			value = value * 10 + (*p - '0');
+	}
+
+	if (value == 0 || value > count)
+		return false;
+
+	index = negative ? (UInt32)(count - value) : (UInt32)(value - 1);
+	return true;
+}
+
+static inline UInt32 HashCorner(UInt32 position, UInt32 texcoord, UInt32 normal)
+{
+	UInt32 h = position * 0x9E3779B1;
+	h ^= texcoord * 0x85EBCA77;
+	h ^= normal * 0xC2B2AE3D;
+	return h ^ (h >> 15);
+}
+
+void ObjReader::Clear()
+{
+	vertices.clear();
+	indices.clear();
+	m_positions.clear();
+	m_texcoords.clear();
+	m_normals.clear();
+	m_cache.clear();
+	m_error = NULL;
+	m_line = 0;
+}
+
+bool ObjReader::Fail(const char * error, UInt32 line)
+{
+	m_error = error;
+	m_line = line;
+	return false;
+}
+
+void ObjReader::GrowCache()
+{
+	Corner empty = { 0, 0, 0, kNoIndex };
+	std::vector<Corner> cache(m_cache.empty() ? 64 : m_cache.size() * 2, empty);
+
+	UInt32 mask = cache.size() - 1;
+	for (auto & corner : m_cache) {
+		if (corner.vertex == kNoIndex)
+			continue;
+
+		UInt32 i = HashCorner(corner.position, corner.texcoord, corner.normal) & mask;
+		while (cache[i].vertex != kNoIndex)
+			i = (i + 1) & mask;
+		cache[i] = corner;
+	}
+
+	m_cache.swap(cache);
+}
+
+UInt32 ObjReader::AddCorner(UInt32 position, UInt32 texcoord, UInt32 normal)
+{
+	// Keep the cache at most half full
+	if ((vertices.size() + 1) * 2 > m_cache.size())
+		GrowCache();
+
+	UInt32 mask = m_cache.size() - 1;
+	UInt32 i = HashCorner(position, texcoord, normal) & mask;
+	for (; m_cache[i].vertex != kNoIndex; i = (i + 1) & mask) {
+		const Corner & corner = m_cache[i];
+		if (corner.position == position && corner.texcoord == texcoord && corner.normal == normal)
+			return corner.vertex;
+	}
+
+	ObjVertex vertex;
+	memcpy(vertex.position, &m_positions[position * 3], sizeof(vertex.position));
+	if (normal != kNoIndex)
+		memcpy(vertex.normal, &m_normals[normal * 3], sizeof(vertex.normal));
+	else
+		memset(vertex.normal, 0, sizeof(vertex.normal));
+	if (texcoord != kNoIndex)
+		memcpy(vertex.texcoord, &m_texcoords[texcoord * 2], sizeof(vertex.texcoord));
+	else
+		memset(vertex.texcoord, 0, sizeof(vertex.texcoord));
+
+	Corner corner = { position, texcoord, normal, (UInt32)vertices.size() };
+	m_cache[i] = corner;
+	vertices.push_back(vertex);
+	return corner.vertex;
+}
+
+bool ObjReader::Read(const char * begin, const char * end)
+{
+	Clear();
+
+	// Counting pass, every array is allocated once at its final size
+	UInt32 positions = 0, texcoords = 0, normals = 0, triangles = 0;
+	for (const char * line = begin; line < end;) {
+		const char * lineEnd = FindLineEnd(line, end);
+		const char * p = line;
+		switch (ReadCommand(p, lineEnd)) {
+			case kCommand_Position:	positions++; break;
+			case kCommand_TexCoord:	texcoords++; break;
+			case kCommand_Normal:	normals++; break;
+			case kCommand_Face:
+			{
+				UInt32 corners = 0;
+				for (;;) {
+					p = SkipBlanks(p, lineEnd);
+					if (p == lineEnd)
+						break;
+					while (p < lineEnd && !IsBlank(*p))
+						p++;
+					corners++;
+				}
+				if (corners > 2)
+					triangles += corners - 2;
+				break;
+			}
+			default:
+				break;
+		}
+		line = lineEnd + 1;
+	}
+
+	m_positions.reserve(positions * 3);
+	m_texcoords.reserve(texcoords * 2);
+	m_normals.reserve(normals * 3);
+	indices.reserve(triangles * 3);
+
+	// Most corners share their position with others, the unique vertex count
+	// lands close to the larger of the position and texcoord counts
+	UInt32 expected = positions > texcoords ? positions : texcoords;
+	vertices.reserve(expected);
+	UInt32 cacheSize = 64;
+	while (cacheSize < expected * 2)
+		cacheSize *= 2;
+	Corner empty = { 0, 0, 0, kNoIndex };
+	m_cache.assign(cacheSize, empty);
+
+	UInt32 lineNumber = 0;
+	for (const char * line = begin; line < end;) {
+		const char * lineEnd = FindLineEnd(line, end);
+		const char * p = line;
+		line = lineEnd + 1;
+		lineNumber++;
+
+		float value[3];
+		switch (ReadCommand(p, lineEnd)) {
+			case kCommand_Position:
+				if (!ReadFloat(p, lineEnd, value[0]) || !ReadFloat(p, lineEnd, value[1]) || !ReadFloat(p, lineEnd, value[2]))
+					return Fail("invalid position", lineNumber);
+				m_positions.insert(m_positions.end(), value, value + 3);
+				break;
+			case kCommand_TexCoord:
+				if (!ReadFloat(p, lineEnd, value[0]) || !ReadFloat(p, lineEnd, value[1]))
+					return Fail("invalid texcoord", lineNumber);
+				m_texcoords.insert(m_texcoords.end(), value, value + 2);
+				break;
+			case kCommand_Normal:
+				if (!ReadFloat(p, lineEnd, value[0]) || !ReadFloat(p, lineEnd, value[1]) || !ReadFloat(p, lineEnd, value[2]))
+					return Fail("invalid normal", lineNumber);
+				m_normals.insert(m_normals.end(), value, value + 3);
+				break;
+			case kCommand_Face:
+			{
+				UInt32 first = 0, previous = 0, corners = 0;
+				for (;;) {
+					p = SkipBlanks(p, lineEnd);
+					if (p == lineEnd)
+						break;
+
+					UInt32 position, texcoord = kNoIndex, normal = kNoIndex;
+					if (!ReadIndex(p, lineEnd, m_positions.size() / 3, position))
+						return Fail("invalid position index", lineNumber);
+
+					if (p < lineEnd && *p == '/') {
+						p++;
+						if (p < lineEnd && *p != '/' && !ReadIndex(p, lineEnd, m_texcoords.size() / 2, texcoord))
+							return Fail("invalid texcoord index", lineNumber);
+
+						if (p < lineEnd && *p == '/') {
+							p++;
+							if (!ReadIndex(p, lineEnd, m_normals.size() / 3, normal))
+								return Fail("invalid normal index", lineNumber);
+						}
+					}
+
+					if (p < lineEnd && !IsBlank(*p))
+						return Fail("invalid face corner", lineNumber);
+
+					// Fan the polygon from its first corner
+					UInt32 vertex = AddCorner(position, texcoord, normal);
+					if (corners == 0)
+						first = vertex;
+					else if (corners >= 2) {
+						indices.push_back(first);
+						indices.push_back(previous);
+						indices.push_back(vertex);
+					}
+
+					previous = vertex;
+					corners++;
+				}
+
+				if (corners < 3)
+					return Fail("face with fewer than three corners", lineNumber);
+				break;
+			}
+			default:
+				break;
+		}
+	}
+
+	// The corner cache is only needed while reading
+	std::vector<Corner>().swap(m_cache);
+	return true;
+}
@@ -0,0 +1,63 @@
+#ifndef __OBJREADER__
+#define __OBJREADER__
+
+#pragma once
+
+#include <vector>
+
+// Vertex of an OBJ triangle list, laid out like the D3DX mesh vertex the
+// mesh loader fills. Corners without a texcoord or normal read as zero.
+struct ObjVertex
+{
+	float	position[3];
+	float	normal[3];
+	float	texcoord[2];
+};
+
+// Parses the geometry of a Wavefront OBJ document held in memory. A counting
+// pass sizes every array once, floats are parsed without the CRT and corners
+// sharing position, texcoord and normal indices are merged through a hash
+// table. Polygons are fanned into triangles, lines other than v, vt, vn and
+// f are ignored. Reading stops at the first malformed element.
+class ObjReader
+{
+public:
+	ObjReader() : m_error(NULL), m_line(0) { }
+
+	bool Read(const char * begin, const char * end);
+	void Clear();
+
+	const char * GetError() const { return m_error; }
+	// 1 based line of the error
+	UInt32 GetLine() const { return m_line; }
+
+	std::vector<ObjVertex>	vertices;
+	std::vector<UInt32>		indices;
+
+private:
+	enum
+	{
+		kNoIndex = 0xFFFFFFFF
+	};
+
+	struct Corner
+	{
+		UInt32	position;
+		UInt32	texcoord;
+		UInt32	normal;
+		UInt32	vertex;
+	};
+
+	bool Fail(const char * error, UInt32 line);
+	UInt32 AddCorner(UInt32 position, UInt32 texcoord, UInt32 normal);
+	void GrowCache();
+
+	const char			* m_error;
+	UInt32				m_line;
+	std::vector<float>	m_positions;
+	std::vector<float>	m_texcoords;
+	std::vector<float>	m_normals;
+	std::vector<Corner>	m_cache;
+};
+
+#endif
@@ -150,11 +150,7 @@ void ApplyPreset(Actor * actor, TESRace * race, TESNPC * npc, PresetDataPtr pres
 		if (!g_overlayInterface->HasOverlays(actor) && presetData->overrideData.size() > 0)
 			g_overlayInterface->AddOverlays(actor);
 
-		for (auto & nodes : presetData->overrideData) {
-			for (auto & value : nodes.second) {
-				g_overrideInterface->AddNodeOverride(actor, gender == 1 ? true : false, nodes.first, value);
-			}
-		}
+		MorphHandler::AddNodeOverrides(actor, gender == 1 ? true : false, presetData->overrideData);
 	}
 
 	if (g_overrideInterface && (applyType & MorphHandler::ApplyTypes::kPresetApplySkinOverrides) == MorphHandler::ApplyTypes::kPresetApplySkinOverrides)
@@ -184,12 +180,7 @@ void ApplyPreset(Actor * actor, TESRace * race, TESNPC * npc, PresetDataPtr pres
 
 	if (g_bodyMorphInterface && (applyType & MorphHandler::ApplyTypes::kPresetApplyBodyMorphs) == MorphHandler::ApplyTypes::kPresetApplyBodyMorphs) {
 		g_bodyMorphInterface->ClearMorphs(actor);
-
-		for (auto & morph : presetData->bodyMorphData) {
-			for (auto & keys : morph.second)
-				g_bodyMorphInterface->SetMorph(actor, morph.first, keys.first, keys.second);
-		}
-
+		MorphHandler::SetBodyMorphs(actor, presetData->bodyMorphData);
 		g_bodyMorphInterface->UpdateModelWeight(actor);
 	}
 }
@@ -0,0 +1,158 @@
+#include "PresetIndex.h"
+
+#include "common/IFileStream.h"
+
+#include <Shlwapi.h>
+#include <vector>
+
+#define PRESET_INDEX_FILE "presets.idx"
+
+bool PresetIndex::Load(const char * folder)
+{
+	char indexPath[MAX_PATH];
+	PathCombine(indexPath, folder, PRESET_INDEX_FILE);
+	m_path = indexPath;
+	m_entries.clear();
+	m_dirty = false;
+
+	IFileStream file;
+	if (!file.Open(indexPath))
+		return true;
+
+	std::vector<UInt8> buffer((size_t)file.GetLength());
+	if (buffer.empty())
+		return true;
+
+	file.ReadBuf(&buffer[0], buffer.size());
+	file.Close();
+
+	const UInt8 * cursor = &buffer[0];
+	const UInt8 * end = cursor + buffer.size();
+
+	UInt32 header[3];
+	if ((size_t)(end - cursor) < sizeof(header)) {
+		_ERROR("%s: truncated index %s", __FUNCTION__, indexPath);
+		return true;
+	}
+	memcpy(header, cursor, sizeof(header));
+	cursor += sizeof(header);
+
+	if (header[0] != kSignature || header[1] != kVersion) {
+		_MESSAGE("%s: discarding index %s of version %d", __FUNCTION__, indexPath, header[1]);
+		m_dirty = true;
+		return true;
+	}
+
+	for (UInt32 i = 0; i < header[2]; i++)
+	{
+		UInt16 nameLength = 0;
+		if ((size_t)(end - cursor) < sizeof(nameLength))
+			break;
+		memcpy(&nameLength, cursor, sizeof(nameLength));
+		cursor += sizeof(nameLength);
+
+		Entry entry;
+		UInt32 metadataLength = 0;
+		if ((size_t)(end - cursor) < nameLength + sizeof(entry.writeTime) + sizeof(entry.size) + sizeof(metadataLength))
+			break;
+
+		std::string name((const char*)cursor, nameLength);
+		cursor += nameLength;
+		memcpy(&entry.writeTime, cursor, sizeof(entry.writeTime));
+		cursor += sizeof(entry.writeTime);
+		memcpy(&entry.size, cursor, sizeof(entry.size));
+		cursor += sizeof(entry.size);
+		memcpy(&metadataLength, cursor, sizeof(metadataLength));
+		cursor += sizeof(metadataLength);
+
+		if ((size_t)(end - cursor) < metadataLength)
+			break;
+
+		entry.metadata.assign((const char*)cursor, metadataLength);
+		entry.used = false;
+		cursor += metadataLength;
+
+		m_entries.emplace(name, entry);
+	}
+
+	if (m_entries.size() != header[2]) {
+		_ERROR("%s: truncated index %s, read %d of %d entries", __FUNCTION__, indexPath, m_entries.size(), header[2]);
+		m_dirty = true;
+	}
+
+	return false;
+}
+
+bool PresetIndex::Save()
+{
+	if (m_path.empty())
+		return true;
+
+	std::vector<UInt8> buffer;
+	auto append = [&buffer](const void * data, size_t length)
+	{
+		buffer.insert(buffer.end(), (const UInt8*)data, (const UInt8*)data + length);
+	};
+
+	UInt32 header[3] = { kSignature, kVersion, m_entries.size() };
+	append(header, sizeof(header));
+
+	for (auto & it : m_entries)
+	{
+		UInt16 nameLength = it.first.length();
+		UInt32 metadataLength = it.second.metadata.length();
+		append(&nameLength, sizeof(nameLength));
+		append(it.first.c_str(), nameLength);
+		append(&it.second.writeTime, sizeof(it.second.writeTime));
+		append(&it.second.size, sizeof(it.second.size));
+		append(&metadataLength, sizeof(metadataLength));
+		append(it.second.metadata.c_str(), metadataLength);
+	}
+
+	IFileStream file;
+	if (!file.Create(m_path.c_str())) {
+		_ERROR("%s: couldn't create index %s Error (%d)", __FUNCTION__, m_path.c_str(), GetLastError());
+		return true;
+	}
+
+	file.WriteBuf(&buffer[0], buffer.size());
+	file.Close();
+	m_dirty = false;
+	return false;
+}
+
+const std::string * PresetIndex::Find(const char * fileName, UInt64 writeTime, UInt64 size)
+{
+	auto it = m_entries.find(fileName);
+	if (it == m_entries.end())
+		return NULL;
+
+	if (it->second.writeTime != writeTime || it->second.size != size)
+		return NULL;
+
+	it->second.used = true;
+	return &it->second.metadata;
+}
+
+void PresetIndex::Insert(const char * fileName, UInt64 writeTime, UInt64 size, const std::string & metadata)
+{
+	Entry & entry = m_entries[fileName];
+	entry.writeTime = writeTime;
+	entry.size = size;
+	entry.metadata = metadata;
+	entry.used = true;
+	m_dirty = true;
+}
+
+void PresetIndex::Prune()
+{
+	for (auto it = m_entries.begin(); it != m_entries.end();)
+	{
+		if (!it->second.used) {
+			it = m_entries.erase(it);
+			m_dirty = true;
+		}
+		else
+			++it;
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "skse/GameTypes.h"
+
+#include <string>
+#include <unordered_map>
+
+// Cache of preset metadata for one folder, stored next to the presets.
+// Entries are keyed by file name and only valid while the file's size and
+// last write time match, so the preset browser only reads presets that
+// changed since the folder was last listed.
+class PresetIndex
+{
+public:
+	enum
+	{
+		kSignature = MACRO_SWAP32('PIDX'),
+		kVersion = 2
+	};
+
+	PresetIndex() : m_dirty(false) { }
+
+	bool Load(const char * folder);
+	bool Save();
+
+	const std::string * Find(const char * fileName, UInt64 writeTime, UInt64 size);
+	void Insert(const char * fileName, UInt64 writeTime, UInt64 size, const std::string & metadata);
+
+	// Drops entries not looked up or inserted since Load
+	void Prune();
+
+	bool IsDirty() const { return m_dirty; }
+
+private:
+	struct Entry
+	{
+		UInt64		writeTime;
+		UInt64		size;
+		std::string	metadata;
+		bool		used;
+	};
+
+	std::string								m_path;
+	std::unordered_map<std::string, Entry>	m_entries;
+	bool									m_dirty;
+};
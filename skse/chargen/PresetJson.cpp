@@ -0,0 +1,1010 @@
+#include "PresetJson.h"
+
+#include <string.h>
+
+PresetJsonData::PresetJsonData()
+{
+	Clear();
+}
+
+void PresetJsonData::Clear()
+{
+	hasVersion = false;
+	hasMods = false;
+	signature = 0;
+	formatVersion = 0;
+	weight = 0.0f;
+	hairColor = 0;
+	mods.clear();
+	headParts.clear();
+	tints.clear();
+	faceTextures.clear();
+	presets.clear();
+	morphs.clear();
+	customMorphs.clear();
+	sculptDivisor = -1;
+	sculpt.clear();
+	transforms.clear();
+	overrides.clear();
+	skinOverrides.clear();
+	bodyMorphs.clear();
+}
+
+void PresetJsonParser::Clear()
+{
+	data.Clear();
+	m_error = NULL;
+	m_offset = 0;
+}
+
+bool PresetJsonParser::EnterObject(JsonStreamReader & reader)
+{
+	if (reader.Peek() == JsonStreamValue::kType_Object)
+		return reader.BeginObject();
+
+	reader.Skip();
+	return false;
+}
+
+bool PresetJsonParser::EnterArray(JsonStreamReader & reader)
+{
+	if (reader.Peek() == JsonStreamValue::kType_Array)
+		return reader.BeginArray();
+
+	reader.Skip();
+	return false;
+}
+
+bool PresetJsonParser::Parse(const char * begin, const char * end)
+{
+	// Skip a byte order mark left by text editors
+	if (end - begin >= 3 && memcmp(begin, "\xEF\xBB\xBF", 3) == 0)
+		begin += 3;
+
+	JsonStreamReader reader(begin, end);
+
+	// The preset index stores several sections back to back
+	std::string name;
+	while (!reader.AtEnd())
+	{
+		if (!EnterObject(reader)) {
+			if (reader.Failed())
+				break;
+
+			m_error = "preset root is not an object";
+			m_offset = reader.GetOffset();
+			return false;
+		}
+
+		bool result = true;
+		while (result && reader.NextMember(name))
+		{
+			if (name == "version")
+				result = ReadVersion(reader);
+			else if (name == "mods")
+				result = ReadMods(reader);
+			else if (name == "headParts")
+				result = ReadHeadParts(reader);
+			else if (name == "actor")
+				result = ReadActor(reader);
+			else if (name == "tintInfo")
+				result = ReadTints(reader);
+			else if (name == "faceTextures")
+				result = ReadFaceTextures(reader);
+			else if (name == "morphs")
+				result = ReadMorphs(reader);
+			else if (name == "transforms")
+				result = ReadTransforms(reader);
+			else if (name == "overrides")
+				result = ReadOverrides(reader);
+			else if (name == "skinOverrides")
+				result = ReadSkinOverrides(reader);
+			else if (name == "bodyMorphs")
+				result = ReadBodyMorphs(reader);
+			else
+				result = reader.Skip();
+		}
+
+		if (!result || reader.Failed())
+			break;
+	}
+
+	if (reader.Failed()) {
+		m_error = reader.GetError();
+		m_offset = reader.GetOffset();
+		return false;
+	}
+
+	return true;
+}
+
+bool PresetJsonParser::ReadVersion(JsonStreamReader & reader)
+{
+	if (!EnterObject(reader))
+		return !reader.Failed();
+
+	std::string name;
+	while (reader.NextMember(name))
+	{
+		if (!reader.ReadValue(m_value))
+			return false;
+
+		data.hasVersion = true;
+		if (name == "signature")
+			data.signature = m_value.AsUInt();
+		else if (name == "formatVersion")
+			data.formatVersion = m_value.AsUInt();
+	}
+
+	return !reader.Failed();
+}
+
+bool PresetJsonParser::ReadMods(JsonStreamReader & reader)
+{
+	if (reader.Peek() != JsonStreamValue::kType_Array) {
+		data.hasMods = reader.Peek() != JsonStreamValue::kType_Null;
+		return reader.Skip();
+	}
+
+	if (!reader.BeginArray())
+		return false;
+
+	std::string name;
+	while (reader.NextElement())
+	{
+		data.hasMods = true;
+		if (!EnterObject(reader)) {
+			if (reader.Failed())
+				return false;
+			continue;
+		}
+
+		PresetJsonData::Mod mod;
+		mod.index = 0;
+		while (reader.NextMember(name))
+		{
+			if (!reader.ReadValue(m_value))
+				return false;
+
+			if (name == "index")
+				mod.index = m_value.AsUInt();
+			else if (name == "name")
+				mod.name = m_value.AsString();
+		}
+
+		if (reader.Failed())
+			return false;
+
+		data.mods.push_back(mod);
+	}
+
+	return !reader.Failed();
+}
+
+bool PresetJsonParser::ReadHeadParts(JsonStreamReader & reader)
+{
+	if (!EnterArray(reader))
+		return !reader.Failed();
+
+	std::string name;
+	while (reader.NextElement())
+	{
+		if (!EnterObject(reader)) {
+			if (reader.Failed())
+				return false;
+			continue;
+		}
+
+		PresetJsonData::HeadPart part;
+		part.type = 0;
+		part.formId = 0;
+		while (reader.NextMember(name))
+		{
+			if (!reader.ReadValue(m_value))
+				return false;
+
+			if (name == "type")
+				part.type = m_value.AsUInt();
+			else if (name == "formId")
+				part.formId = m_value.AsUInt();
+		}
+
+		if (reader.Failed())
+			return false;
+
+		data.headParts.push_back(part);
+	}
+
+	return !reader.Failed();
+}
+
+bool PresetJsonParser::ReadActor(JsonStreamReader & reader)
+{
+	if (!EnterObject(reader))
+		return !reader.Failed();
+
+	std::string name;
+	while (reader.NextMember(name))
+	{
+		if (!reader.ReadValue(m_value))
+			return false;
+
+		if (name == "weight")
+			data.weight = m_value.AsFloat();
+		else if (name == "hairColor")
+			data.hairColor = m_value.AsUInt();
+	}
+
+	return !reader.Failed();
+}
+
+bool PresetJsonParser::ReadTints(JsonStreamReader & reader)
+{
+	if (!EnterArray(reader))
+		return !reader.Failed();
+
+	std::string name;
+	while (reader.NextElement())
+	{
+		if (!EnterObject(reader)) {
+			if (reader.Failed())
+				return false;
+			continue;
+		}
+
+		PresetJsonData::Tint tint;
+		tint.color = 0;
+		tint.index = 0;
+		while (reader.NextMember(name))
+		{
+			if (!reader.ReadValue(m_value))
+				return false;
+
+			if (name == "color")
+				tint.color = m_value.AsUInt();
+			else if (name == "index")
+				tint.index = m_value.AsUInt();
+			else if (name == "texture")
+				tint.texture = m_value.AsString();
+		}
+
+		if (reader.Failed())
+			return false;
+
+		data.tints.push_back(tint);
+	}
+
+	return !reader.Failed();
+}
+
+bool PresetJsonParser::ReadFaceTextures(JsonStreamReader & reader)
+{
+	if (!EnterArray(reader))
+		return !reader.Failed();
+
+	std::string name;
+	while (reader.NextElement())
+	{
+		if (!EnterObject(reader)) {
+			if (reader.Failed())
+				return false;
+			continue;
+		}
+
+		PresetJsonData::Texture texture;
+		texture.index = 0;
+		while (reader.NextMember(name))
+		{
+			if (!reader.ReadValue(m_value))
+				return false;
+
+			if (name == "index")
+				texture.index = m_value.AsUInt();
+			else if (name == "texture")
+				texture.texture = m_value.AsString();
+		}
+
+		if (reader.Failed())
+			return false;
+
+		data.faceTextures.push_back(texture);
+	}
+
+	return !reader.Failed();
+}
+
+bool PresetJsonParser::ReadMorphs(JsonStreamReader & reader)
+{
+	if (!EnterObject(reader))
+		return !reader.Failed();
+
+	std::string name;
+	while (reader.NextMember(name))
+	{
+		bool result = true;
+		if (name == "default")
+			result = ReadDefaultMorphs(reader);
+		else if (name == "custom")
+			result = ReadCustomMorphs(reader);
+		else if (name == "sculpt")
+			result = ReadSculpt(reader);
+		else if (name == "sculptDivisor") {
+			result = reader.ReadValue(m_value);
+			if (result && !m_value.IsNull())
+				data.sculptDivisor = m_value.AsInt();
+		}
+		else
+			result = reader.Skip();
+
+		if (!result)
+			return false;
+	}
+
+	return !reader.Failed();
+}
+
+bool PresetJsonParser::ReadDefaultMorphs(JsonStreamReader & reader)
+{
+	if (!EnterObject(reader))
+		return !reader.Failed();
+
+	std::string name;
+	while (reader.NextMember(name))
+	{
+		bool presets = name == "presets";
+		if (!presets && name != "morphs") {
+			if (!reader.Skip())
+				return false;
+			continue;
+		}
+
+		if (!EnterArray(reader)) {
+			if (reader.Failed())
+				return false;
+			continue;
+		}
+
+		while (reader.NextElement())
+		{
+			if (!reader.ReadValue(m_value))
+				return false;
+
+			if (presets) {
+				UInt32 presetValue = m_value.AsUInt();
+				if (presetValue == 255)
+					presetValue = -1;
+
+				data.presets.push_back(presetValue);
+			}
+			else
+				data.morphs.push_back(m_value.AsFloat());
+		}
+
+		if (reader.Failed())
+			return false;
+	}
+
+	return !reader.Failed();
+}
+
+bool PresetJsonParser::ReadCustomMorphs(JsonStreamReader & reader)
+{
+	if (!EnterArray(reader))
+		return !reader.Failed();
+
+	std::string name;
+	while (reader.NextElement())
+	{
+		if (!EnterObject(reader)) {
+			if (reader.Failed())
+				return false;
+			continue;
+		}
+
+		PresetJsonData::Morph morph;
+		morph.value = 0.0f;
+		while (reader.NextMember(name))
+		{
+			if (!reader.ReadValue(m_value))
+				return false;
+
+			if (name == "name")
+				morph.name = m_value.AsString();
+			else if (name == "value")
+				morph.value = m_value.AsFloat();
+		}
+
+		if (reader.Failed())
+			return false;
+
+		data.customMorphs.push_back(morph);
+	}
+
+	return !reader.Failed();
+}
+
+bool PresetJsonParser::ReadSculpt(JsonStreamReader & reader)
+{
+	if (!EnterArray(reader))
+		return !reader.Failed();
+
+	std::string name;
+	while (reader.NextElement())
+	{
+		// Create the host even if the element is unusable, as the tree reader did
+		data.sculpt.push_back(PresetJsonData::SculptHost());
+		PresetJsonData::SculptHost & sculptHost = data.sculpt.back();
+
+		if (!EnterObject(reader)) {
+			if (reader.Failed())
+				return false;
+			continue;
+		}
+
+		while (reader.NextMember(name))
+		{
+			if (name == "host") {
+				if (!reader.ReadValue(m_value))
+					return false;
+				sculptHost.host = m_value.AsString();
+				continue;
+			}
+
+			if (name != "data") {
+				if (!reader.Skip())
+					return false;
+				continue;
+			}
+
+			if (!EnterArray(reader)) {
+				if (reader.Failed())
+					return false;
+				continue;
+			}
+
+			// Each vertex is [index, x, y, z]
+			while (reader.NextElement())
+			{
+				PresetJsonData::SculptVertex vertex = { 0, { 0, 0, 0 }, { 0.0f, 0.0f, 0.0f } };
+				if (!EnterArray(reader)) {
+					if (reader.Failed())
+						return false;
+					sculptHost.vertices.push_back(vertex);
+					continue;
+				}
+
+				UInt32 i = 0;
+				while (reader.NextElement())
+				{
+					if (!reader.ReadValue(m_value))
+						return false;
+
+					if (i == 0)
+						vertex.index = m_value.AsUInt();
+					else if (i <= 3) {
+						vertex.fixed[i - 1] = m_value.AsInt();
+						vertex.value[i - 1] = m_value.AsFloat();
+					}
+					i++;
+				}
+
+				if (reader.Failed())
+					return false;
+
+				sculptHost.vertices.push_back(vertex);
+			}
+
+			if (reader.Failed())
+				return false;
+		}
+
+		if (reader.Failed())
+			return false;
+	}
+
+	return !reader.Failed();
+}
+
+bool PresetJsonParser::ReadValues(JsonStreamReader & reader, std::vector<PresetJsonData::Value> & values)
+{
+	if (!EnterArray(reader))
+		return !reader.Failed();
+
+	std::string name;
+	while (reader.NextElement())
+	{
+		if (!EnterObject(reader)) {
+			if (reader.Failed())
+				return false;
+			continue;
+		}
+
+		// The data member is written before the type that decides how to read
+		// it, so it is kept as read
+		values.push_back(PresetJsonData::Value());
+		PresetJsonData::Value & value = values.back();
+		value.key = 0;
+		value.type = 0;
+		value.index = 0;
+		while (reader.NextMember(name))
+		{
+			if (name == "data") {
+				if (!reader.ReadValue(value.data))
+					return false;
+				continue;
+			}
+
+			if (!reader.ReadValue(m_value))
+				return false;
+
+			if (name == "key")
+				value.key = m_value.AsUInt();
+			else if (name == "type")
+				value.type = m_value.AsInt();
+			else if (name == "index")
+				value.index = m_value.AsInt();
+		}
+
+		if (reader.Failed())
+			return false;
+	}
+
+	return !reader.Failed();
+}
+
+bool PresetJsonParser::ReadTransforms(JsonStreamReader & reader)
+{
+	if (!EnterArray(reader))
+		return !reader.Failed();
+
+	std::string name;
+	std::string keyMember;
+	while (reader.NextElement())
+	{
+		if (!EnterObject(reader)) {
+			if (reader.Failed())
+				return false;
+			continue;
+		}
+
+		data.transforms.push_back(PresetJsonData::Transform());
+		PresetJsonData::Transform & transform = data.transforms.back();
+		transform.firstPerson = false;
+		while (reader.NextMember(name))
+		{
+			if (name != "keys") {
+				if (!reader.ReadValue(m_value))
+					return false;
+
+				if (name == "firstPerson")
+					transform.firstPerson = m_value.AsBool();
+				else if (name == "node")
+					transform.node = m_value.AsString();
+				continue;
+			}
+
+			if (!EnterArray(reader)) {
+				if (reader.Failed())
+					return false;
+				continue;
+			}
+
+			while (reader.NextElement())
+			{
+				if (!EnterObject(reader)) {
+					if (reader.Failed())
+						return false;
+					continue;
+				}
+
+				transform.keys.push_back(PresetJsonData::TransformKey());
+				PresetJsonData::TransformKey & key = transform.keys.back();
+				while (reader.NextMember(keyMember))
+				{
+					bool result = true;
+					if (keyMember == "name") {
+						result = reader.ReadValue(m_value);
+						key.name = m_value.AsString();
+					}
+					else if (keyMember == "values")
+						result = ReadValues(reader, key.values);
+					else
+						result = reader.Skip();
+
+					if (!result)
+						return false;
+				}
+
+				if (reader.Failed())
+					return false;
+			}
+
+			if (reader.Failed())
+				return false;
+		}
+
+		if (reader.Failed())
+			return false;
+	}
+
+	return !reader.Failed();
+}
+
+bool PresetJsonParser::ReadOverrides(JsonStreamReader & reader)
+{
+	if (!EnterArray(reader))
+		return !reader.Failed();
+
+	std::string name;
+	while (reader.NextElement())
+	{
+		if (!EnterObject(reader)) {
+			if (reader.Failed())
+				return false;
+			continue;
+		}
+
+		data.overrides.push_back(PresetJsonData::Override());
+		PresetJsonData::Override & entry = data.overrides.back();
+		while (reader.NextMember(name))
+		{
+			bool result = true;
+			if (name == "node") {
+				result = reader.ReadValue(m_value);
+				entry.node = m_value.AsString();
+			}
+			else if (name == "values")
+				result = ReadValues(reader, entry.values);
+			else
+				result = reader.Skip();
+
+			if (!result)
+				return false;
+		}
+
+		if (reader.Failed())
+			return false;
+	}
+
+	return !reader.Failed();
+}
+
+bool PresetJsonParser::ReadSkinOverrides(JsonStreamReader & reader)
+{
+	if (!EnterArray(reader))
+		return !reader.Failed();
+
+	std::string name;
+	while (reader.NextElement())
+	{
+		if (!EnterObject(reader)) {
+			if (reader.Failed())
+				return false;
+			continue;
+		}
+
+		data.skinOverrides.push_back(PresetJsonData::SkinOverride());
+		PresetJsonData::SkinOverride & skin = data.skinOverrides.back();
+		skin.firstPerson = false;
+		skin.slotMask = 0;
+		while (reader.NextMember(name))
+		{
+			if (name == "values") {
+				if (!ReadValues(reader, skin.values))
+					return false;
+				continue;
+			}
+
+			if (!reader.ReadValue(m_value))
+				return false;
+
+			if (name == "firstPerson")
+				skin.firstPerson = m_value.AsBool();
+			else if (name == "slotMask")
+				skin.slotMask = m_value.AsUInt();
+		}
+
+		if (reader.Failed())
+			return false;
+	}
+
+	return !reader.Failed();
+}
+
+bool PresetJsonParser::ReadBodyMorphs(JsonStreamReader & reader)
+{
+	if (!EnterArray(reader))
+		return !reader.Failed();
+
+	std::string name;
+	std::string keyMember;
+	while (reader.NextElement())
+	{
+		if (!EnterObject(reader)) {
+			if (reader.Failed())
+				return false;
+			continue;
+		}
+
+		data.bodyMorphs.push_back(PresetJsonData::BodyMorph());
+		PresetJsonData::BodyMorph & morph = data.bodyMorphs.back();
+		morph.hasLegacy = false;
+		morph.legacyValue = 0.0f;
+		while (reader.NextMember(name))
+		{
+			if (name != "keys") {
+				if (!reader.ReadValue(m_value))
+					return false;
+
+				if (name == "name")
+					morph.name = m_value.AsString();
+				else if (name == "value" && !m_value.IsNull()) {
+					morph.hasLegacy = true;
+					morph.legacyValue = m_value.AsFloat();
+				}
+				continue;
+			}
+
+			if (!EnterArray(reader)) {
+				if (reader.Failed())
+					return false;
+				continue;
+			}
+
+			while (reader.NextElement())
+			{
+				if (!EnterObject(reader)) {
+					if (reader.Failed())
+						return false;
+					continue;
+				}
+
+				PresetJsonData::BodyMorphKey key;
+				key.value = 0.0f;
+				while (reader.NextMember(keyMember))
+				{
+					if (!reader.ReadValue(m_value))
+						return false;
+
+					if (keyMember == "key")
+						key.key = m_value.AsString();
+					else if (keyMember == "value")
+						key.value = m_value.AsFloat();
+				}
+
+				if (reader.Failed())
+					return false;
+
+				morph.keys.push_back(key);
+			}
+
+			if (reader.Failed())
+				return false;
+		}
+
+		if (reader.Failed())
+			return false;
+	}
+
+	return !reader.Failed();
+}
+
+// Bounded reads over a packed section, every read past the end fails
+class PresetBinaryCursor
+{
+public:
+	PresetBinaryCursor(const char * begin, const char * end) : m_cursor(begin), m_end(end) { }
+
+	bool Read(void * dest, UInt32 length)
+	{
+		if ((size_t)(m_end - m_cursor) < length)
+			return false;
+
+		memcpy(dest, m_cursor, length);
+		m_cursor += length;
+		return true;
+	}
+
+	bool ReadString(std::string & str)
+	{
+		UInt16 length = 0;
+		if (!Read(&length, sizeof(length)) || (size_t)(m_end - m_cursor) < length)
+			return false;
+
+		str.assign(m_cursor, length);
+		m_cursor += length;
+		return true;
+	}
+
+	bool AtEnd() const { return m_cursor == m_end; }
+
+private:
+	const char	* m_cursor;
+	const char	* m_end;
+};
+
+static void WriteBinary(std::string & out, const void * data, UInt32 length)
+{
+	out.append((const char*)data, length);
+}
+
+static void WriteBinaryCount(std::string & out, size_t count)
+{
+	UInt32 value = (UInt32)count;
+	WriteBinary(out, &value, sizeof(value));
+}
+
+// Longer strings are cut, the old binary format had the same limit
+static void WriteBinaryString(std::string & out, const std::string & str)
+{
+	UInt16 length = str.length() > 0xFFFF ? 0xFFFF : (UInt16)str.length();
+	WriteBinary(out, &length, sizeof(length));
+	WriteBinary(out, str.data(), length);
+}
+
+void PresetBinaryCodec::WriteSliders(const PresetJsonData & data, std::string & out)
+{
+	WriteBinaryCount(out, data.presets.size());
+	if (!data.presets.empty())
+		WriteBinary(out, &data.presets[0], data.presets.size() * sizeof(SInt32));
+
+	WriteBinaryCount(out, data.morphs.size());
+	if (!data.morphs.empty())
+		WriteBinary(out, &data.morphs[0], data.morphs.size() * sizeof(float));
+
+	WriteBinaryCount(out, data.customMorphs.size());
+	for (auto & morph : data.customMorphs)
+	{
+		WriteBinaryString(out, morph.name);
+		WriteBinary(out, &morph.value, sizeof(morph.value));
+	}
+
+	WriteBinaryCount(out, data.bodyMorphs.size());
+	for (auto & morph : data.bodyMorphs)
+	{
+		UInt8 hasLegacy = morph.hasLegacy ? 1 : 0;
+		WriteBinaryString(out, morph.name);
+		WriteBinary(out, &hasLegacy, sizeof(hasLegacy));
+		WriteBinary(out, &morph.legacyValue, sizeof(morph.legacyValue));
+
+		WriteBinaryCount(out, morph.keys.size());
+		for (auto & key : morph.keys)
+		{
+			WriteBinaryString(out, key.key);
+			WriteBinary(out, &key.value, sizeof(key.value));
+		}
+	}
+}
+
+void PresetBinaryCodec::WriteSculpt(const PresetJsonData & data, std::string & out)
+{
+	WriteBinary(out, &data.sculptDivisor, sizeof(data.sculptDivisor));
+
+	WriteBinaryCount(out, data.sculpt.size());
+	for (auto & host : data.sculpt)
+	{
+		WriteBinaryString(out, host.host);
+		WriteBinaryCount(out, host.vertices.size());
+		for (auto & vertex : host.vertices)
+		{
+			WriteBinary(out, &vertex.index, sizeof(vertex.index));
+			if (data.sculptDivisor > 0)
+				WriteBinary(out, vertex.fixed, sizeof(vertex.fixed));
+			else
+				WriteBinary(out, vertex.value, sizeof(vertex.value));
+		}
+	}
+}
+
+// Counts come from the file, elements are added as their bytes arrive so a
+// corrupt count fails on the read instead of allocating
+bool PresetBinaryCodec::ReadSliders(const char * begin, const char * end, PresetJsonData & data)
+{
+	PresetBinaryCursor cursor(begin, end);
+
+	UInt32 count = 0;
+	if (!cursor.Read(&count, sizeof(count)))
+		return false;
+	for (UInt32 i = 0; i < count; i++)
+	{
+		SInt32 preset = 0;
+		if (!cursor.Read(&preset, sizeof(preset)))
+			return false;
+		data.presets.push_back(preset);
+	}
+
+	if (!cursor.Read(&count, sizeof(count)))
+		return false;
+	for (UInt32 i = 0; i < count; i++)
+	{
+		float morph = 0.0f;
+		if (!cursor.Read(&morph, sizeof(morph)))
+			return false;
+		data.morphs.push_back(morph);
+	}
+
+	if (!cursor.Read(&count, sizeof(count)))
+		return false;
+	for (UInt32 i = 0; i < count; i++)
+	{
+		PresetJsonData::Morph morph;
+		if (!cursor.ReadString(morph.name) || !cursor.Read(&morph.value, sizeof(morph.value)))
+			return false;
+		data.customMorphs.push_back(morph);
+	}
+
+	if (!cursor.Read(&count, sizeof(count)))
+		return false;
+	for (UInt32 i = 0; i < count; i++)
+	{
+		PresetJsonData::BodyMorph morph;
+		UInt8 hasLegacy = 0;
+		UInt32 keyCount = 0;
+		if (!cursor.ReadString(morph.name) || !cursor.Read(&hasLegacy, sizeof(hasLegacy)) || !cursor.Read(&morph.legacyValue, sizeof(morph.legacyValue)) || !cursor.Read(&keyCount, sizeof(keyCount)))
+			return false;
+		morph.hasLegacy = hasLegacy != 0;
+
+		for (UInt32 k = 0; k < keyCount; k++)
+		{
+			PresetJsonData::BodyMorphKey key;
+			if (!cursor.ReadString(key.key) || !cursor.Read(&key.value, sizeof(key.value)))
+				return false;
+			morph.keys.push_back(key);
+		}
+
+		data.bodyMorphs.push_back(morph);
+	}
+
+	return cursor.AtEnd();
+}
+
+bool PresetBinaryCodec::ReadSculpt(const char * begin, const char * end, PresetJsonData & data)
+{
+	PresetBinaryCursor cursor(begin, end);
+
+	SInt32 divisor = 0;
+	UInt32 hostCount = 0;
+	if (!cursor.Read(&divisor, sizeof(divisor)) || !cursor.Read(&hostCount, sizeof(hostCount)))
+		return false;
+	data.sculptDivisor = divisor;
+
+	// Converts float offsets to the fixed set with the parser's clamping
+	JsonStreamValue number;
+	number.type = JsonStreamValue::kType_Number;
+
+	for (UInt32 i = 0; i < hostCount; i++)
+	{
+		data.sculpt.push_back(PresetJsonData::SculptHost());
+		PresetJsonData::SculptHost & host = data.sculpt.back();
+
+		UInt32 vertexCount = 0;
+		if (!cursor.ReadString(host.host) || !cursor.Read(&vertexCount, sizeof(vertexCount)))
+			return false;
+
+		for (UInt32 v = 0; v < vertexCount; v++)
+		{
+			PresetJsonData::SculptVertex vertex;
+			if (!cursor.Read(&vertex.index, sizeof(vertex.index)))
+				return false;
+
+			if (divisor > 0) {
+				if (!cursor.Read(vertex.fixed, sizeof(vertex.fixed)))
+					return false;
+				for (UInt32 k = 0; k < 3; k++)
+					vertex.value[k] = (float)vertex.fixed[k];
+			}
+			else {
+				if (!cursor.Read(vertex.value, sizeof(vertex.value)))
+					return false;
+				for (UInt32 k = 0; k < 3; k++) {
+					number.number = vertex.value[k];
+					vertex.fixed[k] = number.AsInt();
+				}
+			}
+
+			host.vertices.push_back(vertex);
+		}
+	}
+
+	return cursor.AtEnd();
+}
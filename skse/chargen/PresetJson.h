@@ -0,0 +1,195 @@
+#ifndef __PRESETJSON__
+#define __PRESETJSON__
+
+#pragma once
+
+#include "JsonStream.h"
+
+#include <string>
+#include <vector>
+
+// Contents of a json preset as written, before anything is looked up in
+// the game. Names stay strings, head parts keep the form id of the mod list
+// they were saved with and override data keeps its json value until the
+// override type decides how to read it.
+struct PresetJsonData
+{
+	struct Mod
+	{
+		UInt8		index;
+		std::string	name;
+	};
+
+	struct HeadPart
+	{
+		UInt8	type;
+		UInt32	formId;
+	};
+
+	struct Tint
+	{
+		UInt32		index;
+		UInt32		color;
+		std::string	texture;
+	};
+
+	struct Texture
+	{
+		UInt8		index;
+		std::string	texture;
+	};
+
+	struct Morph
+	{
+		std::string	name;
+		float		value;
+	};
+
+	// Each vertex is kept both as fixed point and as float, which one
+	// applies depends on sculptDivisor
+	struct SculptVertex
+	{
+		UInt16	index;
+		SInt32	fixed[3];
+		float	value[3];
+	};
+
+	struct SculptHost
+	{
+		std::string					host;
+		std::vector<SculptVertex>	vertices;
+	};
+
+	struct Value
+	{
+		UInt32			key;
+		SInt32			type;
+		SInt32			index;
+		JsonStreamValue	data;
+	};
+
+	struct TransformKey
+	{
+		std::string			name;
+		std::vector<Value>	values;
+	};
+
+	struct Transform
+	{
+		bool						firstPerson;
+		std::string					node;
+		std::vector<TransformKey>	keys;
+	};
+
+	struct Override
+	{
+		std::string			node;
+		std::vector<Value>	values;
+	};
+
+	struct SkinOverride
+	{
+		bool				firstPerson;
+		UInt32				slotMask;
+		std::vector<Value>	values;
+	};
+
+	struct BodyMorphKey
+	{
+		std::string	key;
+		float		value;
+	};
+
+	struct BodyMorph
+	{
+		std::string					name;
+		bool						hasLegacy;
+		float						legacyValue;
+		std::vector<BodyMorphKey>	keys;
+	};
+
+	PresetJsonData();
+	void Clear();
+
+	bool						hasVersion;
+	bool						hasMods;
+	UInt32						signature;
+	UInt32						formatVersion;
+	float						weight;
+	UInt32						hairColor;
+	std::vector<Mod>			mods;
+	std::vector<HeadPart>		headParts;
+	std::vector<Tint>			tints;
+	std::vector<Texture>		faceTextures;
+	std::vector<SInt32>			presets;
+	std::vector<float>			morphs;
+	std::vector<Morph>			customMorphs;
+	SInt32						sculptDivisor;
+	std::vector<SculptHost>		sculpt;
+	std::vector<Transform>		transforms;
+	std::vector<Override>		overrides;
+	std::vector<SkinOverride>	skinOverrides;
+	std::vector<BodyMorph>		bodyMorphs;
+};
+
+// Decodes json presets into PresetJsonData without building a tree.
+// Members may come in any order, binary presets feed each of their
+// sections through Parse and the results accumulate. Unknown members and
+// members of the wrong type are skipped, malformed json stops the parse.
+class PresetJsonParser
+{
+public:
+	PresetJsonParser() : m_error(NULL), m_offset(0) { }
+
+	bool Parse(const char * begin, const char * end);
+	void Clear();
+
+	const char * GetError() const { return m_error; }
+	// Offset of the error within the last parsed section
+	UInt32 GetOffset() const { return m_offset; }
+
+	PresetJsonData	data;
+
+private:
+	static bool EnterObject(JsonStreamReader & reader);
+	static bool EnterArray(JsonStreamReader & reader);
+
+	bool ReadVersion(JsonStreamReader & reader);
+	bool ReadMods(JsonStreamReader & reader);
+	bool ReadHeadParts(JsonStreamReader & reader);
+	bool ReadActor(JsonStreamReader & reader);
+	bool ReadTints(JsonStreamReader & reader);
+	bool ReadFaceTextures(JsonStreamReader & reader);
+	bool ReadMorphs(JsonStreamReader & reader);
+	bool ReadDefaultMorphs(JsonStreamReader & reader);
+	bool ReadCustomMorphs(JsonStreamReader & reader);
+	bool ReadSculpt(JsonStreamReader & reader);
+	bool ReadValues(JsonStreamReader & reader, std::vector<PresetJsonData::Value> & values);
+	bool ReadTransforms(JsonStreamReader & reader);
+	bool ReadOverrides(JsonStreamReader & reader);
+	bool ReadSkinOverrides(JsonStreamReader & reader);
+	bool ReadBodyMorphs(JsonStreamReader & reader);
+
+	const char		* m_error;
+	UInt32			m_offset;
+	JsonStreamValue	m_value;
+};
+
+// Packed form of the slider and sculpt parts of PresetJsonData, which binary
+// presets store instead of json from the binary sections version on. Counts
+// are UInt32, strings a UInt16 length followed by their bytes. Sculpt
+// vertices hold only the offsets sculptDivisor selects, the other set is
+// derived the way the json parser derives it.
+class PresetBinaryCodec
+{
+public:
+	static void WriteSliders(const PresetJsonData & data, std::string & out);
+	static void WriteSculpt(const PresetJsonData & data, std::string & out);
+
+	// Add to data like PresetJsonParser::Parse, false if the section is
+	// truncated or has bytes left over
+	static bool ReadSliders(const char * begin, const char * end, PresetJsonData & data);
+	static bool ReadSculpt(const char * begin, const char * end, PresetJsonData & data);
+};
+
+#endif
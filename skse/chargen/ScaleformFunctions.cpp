@@ -6,6 +6,7 @@
 #include "ScaleformFunctions.h"
 #include "MorphHandler.h"
 #include "PartHandler.h"
+#include "PresetIndex.h"
 
 #include "skse/GameAPI.h"
 #include "skse/GameData.h"
@@ -160,6 +161,143 @@ const char * GetGameSettingString(const char * key)
 	return NULL;
 }
 
+static void RegisterPresetData(GFxMovieView * movie, GFxValue * object, PresetDataPtr presetData)
+{
+	DataHandler * dataHandler = DataHandler::GetSingleton();
+
+	GFxValue modArray;
+	movie->CreateArray(&modArray);
+	for(std::vector<std::string>::iterator it = presetData->modList.begin(); it != presetData->modList.end(); ++it) {
+		GFxValue modObject;
+		movie->CreateObject(&modObject);
+		RegisterString(&modObject, movie, "name", (*it).c_str());
+		RegisterNumber(&modObject, "loadedIndex", dataHandler->GetModIndex((*it).c_str()));
+		modArray.PushBack(&modObject);
+	}
+	object->SetMember("mods", &modArray);
+
+	GFxValue partArray;
+	movie->CreateArray(&partArray);
+	for(std::vector<BGSHeadPart*>::iterator it = presetData->headParts.begin(); it != presetData->headParts.end(); ++it) {
+		GFxValue partObject;
+		movie->CreateString(&partObject, (*it)->partName.data);
+		partArray.PushBack(&partObject);
+	}
+	object->SetMember("headParts", &partArray);
+
+	GFxValue weightObject;
+	movie->CreateObject(&weightObject);
+	RegisterUnmanagedString(&weightObject, "name", GetGameSettingString("sRSMWeight"));
+	RegisterNumber(&weightObject, "value", presetData->weight);
+	object->SetMember("weight", &weightObject);
+
+	GFxValue hairObject;
+	movie->CreateObject(&hairObject);
+	RegisterUnmanagedString(&hairObject, "name", GetGameSettingString("sRSMHairColorPresets"));
+	RegisterNumber(&hairObject, "value", presetData->hairColor);
+	object->SetMember("hair", &hairObject);
+
+	GFxValue tintArray;
+	movie->CreateArray(&tintArray);
+	for(std::vector<PresetData::Tint>::iterator it = presetData->tints.begin(); it != presetData->tints.end(); ++it) {
+		PresetData::Tint & tint = (*it);
+		GFxValue tintObject;
+		movie->CreateObject(&tintObject);
+		RegisterNumber(&tintObject, "color", tint.color);
+		RegisterNumber(&tintObject, "index", tint.index);
+		RegisterString(&tintObject, movie, "texture", tint.name.data);
+		tintArray.PushBack(&tintObject);
+	}
+	object->SetMember("tints", &tintArray);
+
+	GFxValue morphArray;
+	movie->CreateArray(&morphArray);
+
+	const char * presetNames[FacePresetList::kNumPresets];
+	presetNames[FacePresetList::kPreset_NoseType] = GetGameSettingString("sRSMNoseTypes");
+	presetNames[FacePresetList::kPreset_BrowType] = GetGameSettingString("sRSMBrowTypes");
+	presetNames[FacePresetList::kPreset_EyesType] = GetGameSettingString("sRSMEyeTypes");
+	presetNames[FacePresetList::kPreset_LipType] = GetGameSettingString("sRSMMouthTypes");
+
+	const char * morphNames[FaceMorphList::kNumMorphs];
+	morphNames[FaceMorphList::kMorph_NoseShortLong] = GetGameSettingString("sRSMNoseLength");
+	morphNames[FaceMorphList::kMorph_NoseDownUp] = GetGameSettingString("sRSMNoseHeight");
+	morphNames[FaceMorphList::kMorph_JawUpDown] = GetGameSettingString("sRSMJawHeight");
+	morphNames[FaceMorphList::kMorph_JawNarrowWide] = GetGameSettingString("sRSMJawWidth");
+	morphNames[FaceMorphList::kMorph_JawBackForward] = GetGameSettingString("sRSMJawForward");
+	morphNames[FaceMorphList::kMorph_CheeksDownUp] = GetGameSettingString("sRSMCheekboneHeight");
+	morphNames[FaceMorphList::kMorph_CheeksInOut] = GetGameSettingString("sRSMCheekboneWidth");
+	morphNames[FaceMorphList::kMorph_EyesMoveDownUp] = GetGameSettingString("sRSMEyeHeight");
+	morphNames[FaceMorphList::kMorph_EyesMoveInOut] = GetGameSettingString("sRSMEyeDepth");
+	morphNames[FaceMorphList::kMorph_BrowDownUp] = GetGameSettingString("sRSMBrowHeight");
+	morphNames[FaceMorphList::kMorph_BrowInOut] = GetGameSettingString("sRSMBrowWidth");
+	morphNames[FaceMorphList::kMorph_BrowBackForward] = GetGameSettingString("sRSMBrowForward");
+	morphNames[FaceMorphList::kMorph_LipMoveDownUp] = GetGameSettingString("sRSMMouthHeight");
+	morphNames[FaceMorphList::kMorph_LipMoveInOut] = GetGameSettingString("sRSMMouthForward");
+	morphNames[FaceMorphList::kMorph_ChinThinWide] = GetGameSettingString("sRSMChinWidth");
+	morphNames[FaceMorphList::kMorph_ChinMoveUpDown] = GetGameSettingString("sRSMChinLength");
+	morphNames[FaceMorphList::kMorph_OverbiteUnderbite] = GetGameSettingString("sRSMChinForward");
+	morphNames[FaceMorphList::kMorph_EyesBackForward] = GetGameSettingString("sRSMEyeDepth");
+	morphNames[FaceMorphList::kMorph_Vampire] = NULL;
+
+	UInt32 i = 0;
+	for(std::vector<SInt32>::iterator it = presetData->presets.begin(); it != presetData->presets.end(); ++it) {
+		GFxValue presetObject;
+		movie->CreateObject(&presetObject);
+		if(presetNames[i])
+			RegisterUnmanagedString(&presetObject, "name", presetNames[i]);
+		RegisterNumber(&presetObject, "value", *it);
+		RegisterNumber(&presetObject, "type", 0);
+		RegisterNumber(&presetObject, "index", i);
+		morphArray.PushBack(&presetObject);
+		i++;
+	}
+
+	i = 0;
+	for(auto & it : presetData->morphs) {
+		GFxValue presetObject;
+		movie->CreateObject(&presetObject);
+		if (i < FaceMorphList::kNumMorphs && morphNames[i])
+			RegisterUnmanagedString(&presetObject, "name", morphNames[i]);
+		RegisterNumber(&presetObject, "value", it);
+		RegisterNumber(&presetObject, "type", 1);
+		RegisterNumber(&presetObject, "index", i);
+		morphArray.PushBack(&presetObject);
+		i++;
+	}
+
+	i = 0;
+	for(auto & it : presetData->customMorphs) {
+		std::string morphName = "$";
+		morphName.append(it.name.data);
+		GFxValue customObject;
+		movie->CreateObject(&customObject);
+		RegisterString(&customObject, movie, "name", morphName.c_str());
+		RegisterNumber(&customObject, "value", it.value);
+		RegisterNumber(&customObject, "type", 2);
+		RegisterNumber(&customObject, "index", i);
+		morphArray.PushBack(&customObject);
+		i++;
+	}
+	i = 0;
+	for (auto & it : presetData->bodyMorphData) {
+		GFxValue customObject;
+		movie->CreateObject(&customObject);
+		RegisterString(&customObject, movie, "name", it.first.data);
+
+		float morphSum = 0;
+		for (auto & keys : it.second)
+			morphSum += keys.second;
+
+		RegisterNumber(&customObject, "value", morphSum);
+		RegisterNumber(&customObject, "type", 3);
+		RegisterNumber(&customObject, "index", i);
+		morphArray.PushBack(&customObject);
+		i++;
+	}
+	object->SetMember("morphs", &morphArray);
+}
+
 void SKSEScaleform_ReadPreset::Invoke(Args * args)
 {
 	ASSERT(args->numArgs >= 1);
@@ -175,145 +313,11 @@ void SKSEScaleform_ReadPreset::Invoke(Args * args)
 	if (args->numArgs >= 2)
 		object = &args->args[1];
 
-	DataHandler * dataHandler = DataHandler::GetSingleton();
+	// The browser never shows overrides or sculpts, binary presets can skip them
 	auto presetData = std::make_shared<PresetData>();
-	bool loadError = loadJson ? g_morphHandler.LoadJsonPreset(strData, presetData) : g_morphHandler.LoadBinaryPreset(strData, presetData);//g_morphHandler.LoadPreset(strData, args->movie, object);
-	if(!loadError) {
-		PlayerCharacter * player = (*g_thePlayer);
-		TESNPC * npc = DYNAMIC_CAST(player->baseForm, TESForm, TESNPC);
-
-		GFxValue modArray;
-		args->movie->CreateArray(&modArray);
-		for(std::vector<std::string>::iterator it = presetData->modList.begin(); it != presetData->modList.end(); ++it) {
-			GFxValue modObject;
-			args->movie->CreateObject(&modObject);
-			RegisterString(&modObject, args->movie, "name", (*it).c_str());
-			RegisterNumber(&modObject, "loadedIndex", dataHandler->GetModIndex((*it).c_str()));
-			modArray.PushBack(&modObject);
-		}
-		object->SetMember("mods", &modArray);
-
-		GFxValue partArray;
-		args->movie->CreateArray(&partArray);
-		for(std::vector<BGSHeadPart*>::iterator it = presetData->headParts.begin(); it != presetData->headParts.end(); ++it) {
-			GFxValue partObject;
-			args->movie->CreateString(&partObject, (*it)->partName.data);
-			partArray.PushBack(&partObject);
-		}
-		object->SetMember("headParts", &partArray);
-
-		GFxValue weightObject;
-		args->movie->CreateObject(&weightObject);
-		RegisterUnmanagedString(&weightObject, "name", GetGameSettingString("sRSMWeight"));
-		RegisterNumber(&weightObject, "value", presetData->weight);
-		object->SetMember("weight", &weightObject);
-
-		GFxValue hairObject;
-		args->movie->CreateObject(&hairObject);
-		RegisterUnmanagedString(&hairObject, "name", GetGameSettingString("sRSMHairColorPresets"));
-		RegisterNumber(&hairObject, "value", presetData->hairColor);
-		object->SetMember("hair", &hairObject);
-
-		GFxValue tintArray;
-		args->movie->CreateArray(&tintArray);
-		for(std::vector<PresetData::Tint>::iterator it = presetData->tints.begin(); it != presetData->tints.end(); ++it) {
-			PresetData::Tint & tint = (*it);
-			GFxValue tintObject;
-			args->movie->CreateObject(&tintObject);
-			RegisterNumber(&tintObject, "color", tint.color);
-			RegisterNumber(&tintObject, "index", tint.index);
-			RegisterString(&tintObject, args->movie, "texture", tint.name.data);
-			tintArray.PushBack(&tintObject);
-		}
-		object->SetMember("tints", &tintArray);
-
-		GFxValue morphArray;
-		args->movie->CreateArray(&morphArray);
-
-		const char * presetNames[FacePresetList::kNumPresets];
-		presetNames[FacePresetList::kPreset_NoseType] = GetGameSettingString("sRSMNoseTypes");
-		presetNames[FacePresetList::kPreset_BrowType] = GetGameSettingString("sRSMBrowTypes");
-		presetNames[FacePresetList::kPreset_EyesType] = GetGameSettingString("sRSMEyeTypes");
-		presetNames[FacePresetList::kPreset_LipType] = GetGameSettingString("sRSMMouthTypes");
-
-		const char * morphNames[FaceMorphList::kNumMorphs];
-		morphNames[FaceMorphList::kMorph_NoseShortLong] = GetGameSettingString("sRSMNoseLength");
-		morphNames[FaceMorphList::kMorph_NoseDownUp] = GetGameSettingString("sRSMNoseHeight");
-		morphNames[FaceMorphList::kMorph_JawUpDown] = GetGameSettingString("sRSMJawHeight");
-		morphNames[FaceMorphList::kMorph_JawNarrowWide] = GetGameSettingString("sRSMJawWidth");
-		morphNames[FaceMorphList::kMorph_JawBackForward] = GetGameSettingString("sRSMJawForward");
-		morphNames[FaceMorphList::kMorph_CheeksDownUp] = GetGameSettingString("sRSMCheekboneHeight");
-		morphNames[FaceMorphList::kMorph_CheeksInOut] = GetGameSettingString("sRSMCheekboneWidth");
-		morphNames[FaceMorphList::kMorph_EyesMoveDownUp] = GetGameSettingString("sRSMEyeHeight");
-		morphNames[FaceMorphList::kMorph_EyesMoveInOut] = GetGameSettingString("sRSMEyeDepth");
-		morphNames[FaceMorphList::kMorph_BrowDownUp] = GetGameSettingString("sRSMBrowHeight");
-		morphNames[FaceMorphList::kMorph_BrowInOut] = GetGameSettingString("sRSMBrowWidth");
-		morphNames[FaceMorphList::kMorph_BrowBackForward] = GetGameSettingString("sRSMBrowForward");
-		morphNames[FaceMorphList::kMorph_LipMoveDownUp] = GetGameSettingString("sRSMMouthHeight");
-		morphNames[FaceMorphList::kMorph_LipMoveInOut] = GetGameSettingString("sRSMMouthForward");
-		morphNames[FaceMorphList::kMorph_ChinThinWide] = GetGameSettingString("sRSMChinWidth");
-		morphNames[FaceMorphList::kMorph_ChinMoveUpDown] = GetGameSettingString("sRSMChinLength");
-		morphNames[FaceMorphList::kMorph_OverbiteUnderbite] = GetGameSettingString("sRSMChinForward");
-		morphNames[FaceMorphList::kMorph_EyesBackForward] = GetGameSettingString("sRSMEyeDepth");
-		morphNames[FaceMorphList::kMorph_Vampire] = NULL;
-
-		UInt32 i = 0;
-		for(std::vector<SInt32>::iterator it = presetData->presets.begin(); it != presetData->presets.end(); ++it) {
-			GFxValue presetObject;
-			args->movie->CreateObject(&presetObject);
-			if(presetNames[i])
-				RegisterUnmanagedString(&presetObject, "name", presetNames[i]);
-			RegisterNumber(&presetObject, "value", *it);
-			RegisterNumber(&presetObject, "type", 0);
-			RegisterNumber(&presetObject, "index", i);
-			morphArray.PushBack(&presetObject);
-			i++;
-		}
-
-		i = 0;
-		for(auto & it : presetData->morphs) {
-			GFxValue presetObject;
-			args->movie->CreateObject(&presetObject);
-			if (i < FaceMorphList::kNumMorphs && morphNames[i])
-				RegisterUnmanagedString(&presetObject, "name", morphNames[i]);
-			RegisterNumber(&presetObject, "value", it);
-			RegisterNumber(&presetObject, "type", 1);
-			RegisterNumber(&presetObject, "index", i);
-			morphArray.PushBack(&presetObject);
-			i++;
-		}
-
-		i = 0;
-		for(auto & it : presetData->customMorphs) {
-			std::string morphName = "$";
-			morphName.append(it.name.data);
-			GFxValue customObject;
-			args->movie->CreateObject(&customObject);
-			RegisterString(&customObject, args->movie, "name", morphName.c_str());
-			RegisterNumber(&customObject, "value", it.value);
-			RegisterNumber(&customObject, "type", 2);
-			RegisterNumber(&customObject, "index", i);
-			morphArray.PushBack(&customObject);
-			i++;
-		}
-		i = 0;
-		for (auto & it : presetData->bodyMorphData) {
-			GFxValue customObject;
-			args->movie->CreateObject(&customObject);
-			RegisterString(&customObject, args->movie, "name", it.first.data);
-
-			float morphSum = 0;
-			for (auto & keys : it.second)
-				morphSum += keys.second;
-
-			RegisterNumber(&customObject, "value", morphSum);
-			RegisterNumber(&customObject, "type", 3);
-			RegisterNumber(&customObject, "index", i);
-			morphArray.PushBack(&customObject);
-			i++;
-		}
-		object->SetMember("morphs", &morphArray);
-	}
+	bool loadError = loadJson ? g_morphHandler.LoadJsonPreset(strData, presetData) : g_morphHandler.LoadBinaryPreset(strData, presetData, MorphHandler::kPresetSectionMetadata | MorphHandler::kPresetSectionSliders);//g_morphHandler.LoadPreset(strData, args->movie, object);
+	if(!loadError)
+		RegisterPresetData(args->movie, object, presetData);
 
 	args->result->SetBool(loadError);
 }
@@ -326,6 +330,7 @@ void SKSEScaleform_ReloadSliders::Invoke(Args * args)
 		RaceSexMenu* raceMenu = (RaceSexMenu*)mm->GetMenu(&t);
 		if(raceMenu) {
 			PlayerCharacter * player = (*g_thePlayer);
+			s_sliderDataCache.Invalidate();
 			CALL_MEMBER_FN(raceMenu, LoadSliders)((UInt32)player->baseForm, 0);
 			//CALL_MEMBER_FN(raceMenu, UpdatePlayer)();
 			CALL_MEMBER_FN((*g_thePlayer), QueueNiNodeUpdate)(true);
@@ -333,83 +338,121 @@ void SKSEScaleform_ReloadSliders::Invoke(Args * args)
 	}
 }
 
-void SKSEScaleform_GetSliderData::Invoke(Args * args)
+// Value independent part of a slider, cached per race and sex
+struct SliderDescriptor
 {
-	ASSERT(args->numArgs >= 1);
-	ASSERT(args->args[0].GetType() == GFxValue::kType_Number);
-	ASSERT(args->args[1].GetType() == GFxValue::kType_Number);
+	UInt32	type;
+	UInt32	index;
+	SInt32	subType;
+	UInt8	partType;
+};
 
-	UInt32 sliderId = (UInt32)args->args[0].GetNumber();
-	double value = args->args[1].GetNumber();
+class SliderDataCache
+{
+public:
+	SliderDataCache() : m_race(NULL), m_gender(0), m_raceData(NULL), m_count(0) { }
 
-	MenuManager * mm = MenuManager::GetSingleton();
-	if(mm)
+	// Returns the descriptors for the open RaceSex Menu, rebuilt only when the race, sex or slider set changed
+	std::vector<SliderDescriptor> * Get(RaceSexMenu ** outMenu)
 	{
-		BSFixedString t("RaceSex Menu");
-		RaceSexMenu * raceMenu = (RaceSexMenu *)mm->GetMenu(&t);
-		if(raceMenu)
-		{
-			RaceMenuSlider * slider = NULL;
-			RaceSexMenu::RaceComponent * raceData = NULL;
+		MenuManager * mm = MenuManager::GetSingleton();
+		if (!mm)
+			return NULL;
 
-			UInt8 gender = 0;
-			PlayerCharacter * player = (*g_thePlayer);
-			TESNPC * actorBase = DYNAMIC_CAST(player->baseForm, TESForm, TESNPC);
-			if(actorBase)
-				gender = CALL_MEMBER_FN(actorBase, GetSex)();
+		static BSFixedString menuName("RaceSex Menu");
+		RaceSexMenu * raceMenu = (RaceSexMenu *)mm->GetMenu(&menuName);
+		if (!raceMenu)
+			return NULL;
 
-			if(raceMenu->raceIndex < raceMenu->sliderData[gender].count)
-				raceData = &raceMenu->sliderData[gender][raceMenu->raceIndex];
-			if(raceData && sliderId < raceData->sliders.count)
-				slider = &raceData->sliders[sliderId];
+		UInt8 gender = 0;
+		PlayerCharacter * player = (*g_thePlayer);
+		TESNPC * actorBase = DYNAMIC_CAST(player->baseForm, TESForm, TESNPC);
+		if (actorBase)
+			gender = CALL_MEMBER_FN(actorBase, GetSex)();
 
-			if(raceData && slider)
+		RaceSexMenu::RaceComponent * raceData = NULL;
+		if (raceMenu->raceIndex < raceMenu->sliderData[gender].count)
+			raceData = &raceMenu->sliderData[gender][raceMenu->raceIndex];
+		if (!raceData)
+			return NULL;
+
+		if (m_race != player->race || m_gender != gender || m_raceData != raceData || m_count != raceData->sliders.count)
+		{
+			m_race = player->race;
+			m_gender = gender;
+			m_raceData = raceData;
+			m_count = raceData->sliders.count;
+
+			m_sliders.clear();
+			m_sliders.reserve(m_count);
+			for (UInt32 i = 0; i < m_count; i++)
 			{
-				args->movie->CreateObject(args->result);
-				RegisterNumber(args->result, "type", slider->type);
-				RegisterNumber(args->result, "index", slider->index);
+				RaceMenuSlider * slider = &raceData->sliders[i];
+				SliderDescriptor descriptor = { slider->type, slider->index, -1, 0 };
+				if (slider->type == RaceMenuSlider::kTypeDoubleMorph && slider->index >= SLIDER_OFFSET) {
+					SliderInternalPtr sliderInternal = g_morphHandler.GetSliderByIndex(player->race, slider->index - SLIDER_OFFSET);
+					if (sliderInternal) {
+						descriptor.subType = sliderInternal->type;
+						descriptor.partType = sliderInternal->presetCount;
+					}
+				}
+				m_sliders.push_back(descriptor);
+			}
+		}
+
+		*outMenu = raceMenu;
+		return &m_sliders;
+	}
+
+	void Invalidate() { m_raceData = NULL; }
 
-				switch(slider->type)
+private:
+	TESRace							* m_race;
+	UInt8							m_gender;
+	RaceSexMenu::RaceComponent		* m_raceData;
+	UInt32							m_count;
+	std::vector<SliderDescriptor>	m_sliders;
+};
+
+static SliderDataCache s_sliderDataCache;
+
+static void RegisterSliderData(GFxMovieView * movie, GFxValue * object, RaceSexMenu * raceMenu, const SliderDescriptor & slider, double value)
+{
+	RegisterNumber(object, "type", slider.type);
+	RegisterNumber(object, "index", slider.index);
+
+	switch(slider.type)
+	{
+	case RaceMenuSlider::kTypeHeadPart:
+		{
+			if(slider.index < RaceSexMenu::kNumHeadPartLists)
+			{
+				BGSHeadPart * headPart = NULL;
+				raceMenu->headParts[slider.index].GetNthItem((UInt32)value, headPart);
+				if(headPart) {
+					RegisterNumber(object, "formId", headPart->formID);
+					RegisterString(object, movie, "partName", headPart->partName.data);
+				}
+			}
+		}
+		break;
+	case RaceMenuSlider::kTypeDoubleMorph:
+		{
+			// Provide case for custom parts
+			if(slider.subType != -1) {
+				RegisterNumber(object, "subType", slider.subType);
+				switch (slider.subType)
 				{
-				case RaceMenuSlider::kTypeHeadPart:
+					// Only acquire part information for actual part sliders
+					case SliderInternal::kTypeHeadPart:
 					{
-						if(slider->index < RaceSexMenu::kNumHeadPartLists)
+						HeadPartList * partList = g_partSet.GetPartList(slider.partType);
+						if (partList)
 						{
-							BGSHeadPart * headPart = NULL;
-							raceMenu->headParts[slider->index].GetNthItem((UInt32)value, headPart);
-							if(headPart) {
-								RegisterNumber(args->result, "formId", headPart->formID);
-								RegisterString(args->result, args->movie, "partName", headPart->partName.data);
-							}
-						}
-					}
-					break;
-				case RaceMenuSlider::kTypeDoubleMorph:
-					{
-						// Provide case for custom parts
-						if(slider->index >= SLIDER_OFFSET) {
-							UInt32 sliderIndex = slider->index - SLIDER_OFFSET;
-							SliderInternalPtr sliderInternal = g_morphHandler.GetSliderByIndex(player->race, sliderIndex);
-							if(sliderInternal) {
-								RegisterNumber(args->result, "subType", sliderInternal->type);
-								switch (sliderInternal->type)
-								{
-									// Only acquire part information for actual part sliders
-									case SliderInternal::kTypeHeadPart:
-									{
-										UInt8 partType = sliderInternal->presetCount;
-										HeadPartList * partList = g_partSet.GetPartList(partType);
-										if (partList)
-										{
-											BGSHeadPart * targetPart = g_partSet.GetPartByIndex(partList, (UInt32)value - 1);
-											if (targetPart) {
-												RegisterNumber(args->result, "formId", targetPart->formID);
-												RegisterString(args->result, args->movie, "partName", targetPart->partName.data);
-											}
-										}
-									}
-									break;
-								}
+							BGSHeadPart * targetPart = g_partSet.GetPartByIndex(partList, (UInt32)value - 1);
+							if (targetPart) {
+								RegisterNumber(object, "formId", targetPart->formID);
+								RegisterString(object, movie, "partName", targetPart->partName.data);
 							}
 						}
 					}
@@ -417,6 +460,56 @@ void SKSEScaleform_GetSliderData::Invoke(Args * args)
 				}
 			}
 		}
+		break;
+	}
+}
+
+void SKSEScaleform_GetSliderData::Invoke(Args * args)
+{
+	ASSERT(args->numArgs >= 1);
+	ASSERT(args->args[0].GetType() == GFxValue::kType_Number);
+	ASSERT(args->args[1].GetType() == GFxValue::kType_Number);
+
+	UInt32 sliderId = (UInt32)args->args[0].GetNumber();
+	double value = args->args[1].GetNumber();
+
+	RaceSexMenu * raceMenu = NULL;
+	std::vector<SliderDescriptor> * sliders = s_sliderDataCache.Get(&raceMenu);
+	if(sliders && sliderId < sliders->size())
+	{
+		args->movie->CreateObject(args->result);
+		RegisterSliderData(args->movie, args->result, raceMenu, (*sliders)[sliderId], value);
+	}
+}
+
+void SKSEScaleform_GetSliderDataArray::Invoke(Args * args)
+{
+	// Optional array of slider values, only needed to resolve part names
+	GFxValue * values = NULL;
+	if(args->numArgs >= 1 && args->args[0].GetType() == GFxValue::kType_Array)
+		values = &args->args[0];
+
+	RaceSexMenu * raceMenu = NULL;
+	std::vector<SliderDescriptor> * sliders = s_sliderDataCache.Get(&raceMenu);
+	if(!sliders)
+		return;
+
+	args->movie->CreateArray(args->result);
+
+	UInt32 valueCount = values ? values->GetArraySize() : 0;
+	for(UInt32 i = 0; i < sliders->size(); i++)
+	{
+		double value = 0.0;
+		if(i < valueCount) {
+			GFxValue element;
+			if(values->GetElement(i, &element) && element.GetType() == GFxValue::kType_Number)
+				value = element.GetNumber();
+		}
+
+		GFxValue sliderObject;
+		args->movie->CreateObject(&sliderObject);
+		RegisterSliderData(args->movie, &sliderObject, raceMenu, (*sliders)[i], value);
+		args->result->PushBack(&sliderObject);
 	}
 }
 
@@ -1315,3 +1408,74 @@ void SKSEScaleform_GetExternalFiles::Invoke(Args * args)
 	ScaleformHeap_Free(patterns);
 }
 
+
+void SKSEScaleform_GetPresetIndex::Invoke(Args * args)
+{
+	ASSERT(args->numArgs >= 2);
+	ASSERT(args->args[0].GetType() == GFxValue::kType_String);
+	ASSERT(args->args[1].GetType() == GFxValue::kType_Array);
+
+	const char * path = args->args[0].GetString();
+
+	UInt32 numPatterns = args->args[1].GetArraySize();
+
+	const char ** patterns = (const char **)ScaleformHeap_Allocate(numPatterns * sizeof(const char*));
+	for (UInt32 i = 0; i < numPatterns; i++) {
+		GFxValue str;
+		args->args[1].GetElement(i, &str);
+		patterns[i] = str.GetString();
+	}
+
+	PresetIndex presetIndex;
+	presetIndex.Load(path);
+
+	args->movie->CreateArray(args->result);
+
+	ReadFileDirectory(path, patterns, numPatterns, [args, &presetIndex](char* filePath, WIN32_FIND_DATA & fileData, bool dir)
+	{
+		if (dir)
+			return;
+
+		UInt64 fileSize = (UInt64)fileData.nFileSizeHigh << 32 | fileData.nFileSizeLow;
+		UInt64 writeTime = (UInt64)fileData.ftLastWriteTime.dwHighDateTime << 32 | fileData.ftLastWriteTime.dwLowDateTime;
+		bool json = _stricmp(PathFindExtension(fileData.cFileName), ".jslot") == 0;
+
+		GFxValue fileInfo;
+		args->movie->CreateObject(&fileInfo);
+		RegisterString(&fileInfo, args->movie, "path", filePath);
+		RegisterString(&fileInfo, args->movie, "name", fileData.cFileName);
+		RegisterNumber(&fileInfo, "size", fileSize);
+		RegisterBool(&fileInfo, "json", json);
+
+		auto presetData = std::make_shared<PresetData>();
+		bool loadError = true;
+		const std::string * metadata = presetIndex.Find(fileData.cFileName, writeTime, fileSize);
+		if (metadata)
+			loadError = g_morphHandler.LoadPresetMetadata(*metadata, presetData);
+		else
+		{
+			std::string newMetadata;
+			if (!g_morphHandler.ReadPresetMetadata(filePath, json, newMetadata)) {
+				presetIndex.Insert(fileData.cFileName, writeTime, fileSize, newMetadata);
+				loadError = g_morphHandler.LoadPresetMetadata(newMetadata, presetData);
+			}
+			else if (!json) // Binary presets older than the sectioned format are small, read them directly
+				loadError = g_morphHandler.LoadBinaryPreset(filePath, presetData);
+		}
+
+		if (!loadError) {
+			GFxValue presetObject;
+			args->movie->CreateObject(&presetObject);
+			RegisterPresetData(args->movie, &presetObject, presetData);
+			fileInfo.SetMember("preset", &presetObject);
+		}
+
+		args->result->PushBack(&fileInfo);
+	});
+
+	ScaleformHeap_Free(patterns);
+
+	presetIndex.Prune();
+	if (presetIndex.IsDirty())
+		presetIndex.Save();
+}
@@ -28,6 +28,12 @@ public:
 	virtual void	Invoke(Args * args);
 };
 
+class SKSEScaleform_GetSliderDataArray : public GFxFunctionHandler
+{
+public:
+	virtual void	Invoke(Args * args);
+};
+
 class SKSEScaleform_ReloadSliders : public GFxFunctionHandler
 {
 public:
@@ -261,3 +267,9 @@ class SKSEScaleform_GetExternalFiles : public GFxFunctionHandler
 public:
 	virtual void	Invoke(Args * args);
 };
+
+class SKSEScaleform_GetPresetIndex : public GFxFunctionHandler
+{
+public:
+	virtual void	Invoke(Args * args);
+};
@@ -12,6 +12,7 @@
 #include "Hooks.h"
 #include "ScaleformFunctions.h"
 #include "PapyrusCharGen.h"
+#include "NifUtils.h"
 
 #include "interfaces/IPluginInterface.h"
 #include "interfaces/OverrideInterface.h"
@@ -54,6 +55,7 @@ bool	g_externalHeads = false;
 bool	g_extendedMorphs = true;
 bool	g_allowAllMorphs = true;
 bool	g_disableFaceGenCache = true;
+bool	g_parallelTRICache = true;
 float	g_sliderMultiplier = 1.0f;
 float	g_sliderInterval = 0.01f;
 float	g_panSpeed = 0.01f;
@@ -210,6 +212,7 @@ bool RegisterScaleform(GFxMovieView * view, GFxValue * root)
 	RegisterFunction <SKSEScaleform_ReadPreset>(root, view, "ReadPreset");
 	RegisterFunction <SKSEScaleform_ReloadSliders>(root, view, "ReloadSliders");
 	RegisterFunction <SKSEScaleform_GetSliderData>(root, view, "GetSliderData");
+	RegisterFunction <SKSEScaleform_GetSliderDataArray>(root, view, "GetSliderDataArray");
 	RegisterFunction <SKSEScaleform_GetModName>(root, view, "GetModName");
 
 	RegisterFunction <SKSEScaleform_GetPlayerPosition>(root, view, "GetPlayerPosition");
@@ -257,6 +260,7 @@ bool RegisterScaleform(GFxMovieView * view, GFxValue * root)
 	RegisterFunction <SKSEScaleform_SetMeshCameraRadius>(root, view, "SetMeshCameraRadius");
 
 	RegisterFunction <SKSEScaleform_GetExternalFiles>(root, view, "GetExternalFiles");
+	RegisterFunction <SKSEScaleform_GetPresetIndex>(root, view, "GetPresetIndex");
 	return true;
 }
 
@@ -276,6 +280,10 @@ void SKSEMessageHandler(SKSEMessagingInterface::Message * message)
 			}
 		}
 		break;
+		// Let pending head exports land before the game state is replaced
+		case SKSEMessagingInterface::kMessage_PreLoadGame:
+			WaitForHeadExports();
+			break;
 	}
 }
 
@@ -424,6 +432,11 @@ bool SKSEPlugin_Load(const SKSEInterface * skse)
 	{
 		g_allowAllMorphs = (allowAllMorphs > 0);
 	}
+	UInt32	parallelTRICache = 1;
+	if (GetConfigNumber("FaceGen", "bParallelTRICache", &parallelTRICache))
+	{
+		g_parallelTRICache = (parallelTRICache > 0);
+	}
 
 	float	panSpeed = 0.01f;
 	if (GetConfigNumber("FaceGen", "fPanSpeed", &panSpeed))
@@ -0,0 +1,249 @@
+#include "CDXBVH.h"
+#include "TestMeshes.h"
+#include "TestUtils.h"
+
+#include <cfloat>
+
+int g_failures = 0;
+
+static void Subtract(const float * a, const float * b, float * result)
+{
+	for (UInt32 k = 0; k < 3; k++)
+		result[k] = a[k] - b[k];
+}
+
+static void Cross(const float * a, const float * b, float * result)
+{
+	result[0] = a[1] * b[2] - a[2] * b[1];
+	result[1] = a[2] * b[0] - a[0] * b[2];
+	result[2] = a[0] * b[1] - a[1] * b[0];
+}
+
+static float Dot(const float * a, const float * b)
+{
+	return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+// Every face against the ray, the closest front facing hit wins
+static bool BruteForce(TestMesh & mesh, const std::vector<CDXMeshFace> & faces, const float * origin, const float * dir, float & dist, CDXMeshFace & face)
+{
+	bool isHit = false;
+	dist = FLT_MAX;
+	for (auto & test : faces) {
+		const float * v0 = mesh.vertices[test.v1].position;
+		const float * v1 = mesh.vertices[test.v2].position;
+		const float * v2 = mesh.vertices[test.v3].position;
+
+		float f1[3], f2[3], normal[3];
+		Subtract(v1, v0, f1);
+		Subtract(v2, v1, f2);
+		Cross(f1, f2, normal);
+		if (Dot(dir, normal) >= 0)
+			continue;
+
+		float edge1[3], edge2[3], pvec[3], tvec[3], qvec[3];
+		Subtract(v1, v0, edge1);
+		Subtract(v2, v0, edge2);
+		Cross(dir, edge2, pvec);
+		float det = Dot(edge1, pvec);
+		if (det > 0)
+			Subtract(origin, v0, tvec);
+		else {
+			Subtract(v0, origin, tvec);
+			det = -det;
+		}
+		if (det < 0.0001f)
+			continue;
+
+		float u = Dot(tvec, pvec);
+		if (u < 0.0f || u > det)
+			continue;
+		Cross(tvec, edge1, qvec);
+		float v = Dot(dir, qvec);
+		if (v < 0.0f || u + v > det)
+			continue;
+
+		float t = Dot(edge2, qvec) * (1.0f / det);
+		if (t >= 0 && t < dist) {
+			dist = t;
+			face = test;
+			isHit = true;
+		}
+	}
+	return isHit;
+}
+
+static bool SameFace(const CDXMeshFace & a, const CDXMeshFace & b)
+{
+	return a.v1 == b.v1 && a.v2 == b.v2 && a.v3 == b.v3;
+}
+
+// Rays from a shell around the mesh aimed at points inside it, direction
+// lengths vary so distances are checked in units of dir
+static UInt32 CompareRays(TestMesh & mesh, const std::vector<CDXMeshFace> & faces, const CDXBVH & bvh, UInt32 rays, UInt32 & state)
+{
+	UInt32 hits = 0;
+	for (UInt32 r = 0; r < rays; r++) {
+		float origin[3], target[3], dir[3];
+		for (UInt32 k = 0; k < 3; k++) {
+			origin[k] = NextRandom(state) * 3.0f;
+			target[k] = NextRandom(state) * 0.75f;
+		}
+		float scale = 0.25f + (NextRandom(state) + 1.0f);
+		for (UInt32 k = 0; k < 3; k++)
+			dir[k] = (target[k] - origin[k]) * scale;
+
+		// Axis aligned rays exercise the infinite slab reciprocals
+		if (r % 16 == 0) {
+			dir[0] = dir[1] = 0.0f;
+			dir[2] = origin[2] > 0 ? -1.0f : 1.0f;
+		}
+
+		float dist = 0.0f, expectedDist = 0.0f;
+		CDXMeshFace face(0, 0, 0), expectedFace(0, 0, 0);
+		bool isHit = bvh.Intersect(mesh.Positions(), origin, dir, dist, face);
+		bool expected = BruteForce(mesh, faces, origin, dir, expectedDist, expectedFace);
+		CHECK(isHit == expected);
+		if (isHit && expected) {
+			hits++;
+			CHECK(dist == expectedDist);
+
+			// A ray through a shared edge may report either face, whichever
+			// it is has to be hit at that distance
+			if (!SameFace(face, expectedFace)) {
+				std::vector<CDXMeshFace> single(1, face);
+				float singleDist = 0.0f;
+				CHECK(BruteForce(mesh, single, origin, dir, singleDist, expectedFace));
+				CHECK(singleDist == dist);
+			}
+		}
+	}
+	return hits;
+}
+
+static TestMesh MakeSoup(UInt32 triangles, UInt32 & state)
+{
+	TestMesh mesh;
+	for (UInt32 t = 0; t < triangles; t++) {
+		float center[3] = { NextRandom(state), NextRandom(state), NextRandom(state) };
+		CDXMeshIndex first = 0;
+		for (UInt32 c = 0; c < 3; c++) {
+			CDXMeshIndex i = mesh.AddVertex(center[0] + NextRandom(state) * 0.2f, center[1] + NextRandom(state) * 0.2f, center[2] + NextRandom(state) * 0.2f);
+			if (c == 0)
+				first = i;
+		}
+		mesh.faces.push_back(CDXMeshFace(first, first + 1, first + 2));
+	}
+	return mesh;
+}
+
+static void Jitter(TestMesh & mesh, float amount, UInt32 & state)
+{
+	for (auto & v : mesh.vertices) {
+		for (UInt32 k = 0; k < 3; k++)
+			v.position[k] += NextRandom(state) * amount;
+	}
+}
+
+static void TestRandomMeshes()
+{
+	UInt32 state = 17;
+	UInt32 hits = 0, rays = 0;
+	for (UInt32 m = 0; m < 8; m++) {
+		TestMesh mesh = (m & 1) ? MakeSoup(1 + m * 150, state) : MakeSphere(m / 2);
+		if (!(m & 1))
+			Jitter(mesh, 0.05f, state);
+
+		CDXBVH bvh;
+		bvh.Build(mesh.Positions(), TestMesh::kStride, mesh.vertices.size(), (const CDXMeshIndex *)mesh.faces.data(), mesh.faces.size(), false);
+		CHECK(!bvh.IsEmpty());
+		hits += CompareRays(mesh, mesh.faces, bvh, 400, state);
+		rays += 400;
+
+		// Moved vertices only need the bounds refit
+		Jitter(mesh, 0.2f, state);
+		bvh.Refit(mesh.Positions());
+		hits += CompareRays(mesh, mesh.faces, bvh, 400, state);
+		rays += 400;
+	}
+
+	// Both outcomes have to be covered for the comparison to mean anything
+	CHECK(hits > rays / 10);
+	CHECK(hits < rays - rays / 10);
+}
+
+// A strip over a grid row, every other triangle flipped back to the
+// winding of the list
+static void TestStrip()
+{
+	UInt32 state = 23;
+	TestMesh mesh = MakeGrid(12, 1, 0.25f);
+	Jitter(mesh, 0.02f, state);
+
+	// Grid vertices run along rows, pair up the two rows into a strip
+	std::vector<CDXMeshIndex> strip;
+	for (CDXMeshIndex x = 0; x <= 12; x++) {
+		strip.push_back(x + 13);
+		strip.push_back(x);
+	}
+	// Degenerate triangles in the middle are skipped, two repeats keep the
+	// winding parity of the rest
+	CDXMeshIndex repeat = strip[9];
+	strip.insert(strip.begin() + 10, 2, repeat);
+
+	std::vector<CDXMeshFace> faces;
+	for (UInt32 i = 2; i < strip.size(); i++) {
+		CDXMeshIndex v1 = strip[i - 2], v2 = strip[i - 1], v3 = strip[i];
+		if (v1 == v2 || v2 == v3 || v3 == v1)
+			continue;
+		faces.push_back((i & 1) ? CDXMeshFace(v1, v3, v2) : CDXMeshFace(v1, v2, v3));
+	}
+
+	CDXBVH bvh;
+	bvh.Build(mesh.Positions(), TestMesh::kStride, mesh.vertices.size(), strip.data(), strip.size(), true);
+	CompareRays(mesh, faces, bvh, 500, state);
+
+	// Straight down onto every quad off its diagonal, all of them face +z
+	for (UInt32 x = 0; x < 12; x++) {
+		float origin[3] = { (x + 0.5f) * 0.25f, 0.07f, 1.0f };
+		float dir[3] = { 0.0f, 0.0f, -1.0f };
+		float dist = 0.0f;
+		CDXMeshFace face(0, 0, 0);
+		CHECK(bvh.Intersect(mesh.Positions(), origin, dir, dist, face));
+	}
+}
+
+// Faces referencing vertices past the count are dropped, an empty
+// hierarchy never hits
+static void TestInvalid()
+{
+	TestMesh mesh = MakeGrid(2, 2, 1.0f);
+	std::vector<CDXMeshFace> faces = mesh.faces;
+	faces.push_back(CDXMeshFace(0, 1, (CDXMeshIndex)mesh.vertices.size()));
+
+	CDXBVH bvh;
+	bvh.Build(mesh.Positions(), TestMesh::kStride, mesh.vertices.size(), (const CDXMeshIndex *)faces.data(), faces.size(), false);
+	UInt32 state = 29;
+	CompareRays(mesh, mesh.faces, bvh, 200, state);
+
+	float origin[3] = { 0.5f, 0.5f, 1.0f };
+	float dir[3] = { 0.0f, 0.0f, -1.0f };
+	float dist = 0.0f;
+	CDXMeshFace face(0, 0, 0);
+	bvh.Build(mesh.Positions(), TestMesh::kStride, 2, (const CDXMeshIndex *)mesh.faces.data(), mesh.faces.size(), false);
+	CHECK(bvh.IsEmpty());
+	CHECK(!bvh.Intersect(mesh.Positions(), origin, dir, dist, face));
+
+	bvh.Build(mesh.Positions(), TestMesh::kStride, mesh.vertices.size(), (const CDXMeshIndex *)mesh.faces.data(), mesh.faces.size(), false);
+	CHECK(bvh.Intersect(mesh.Positions(), origin, dir, dist, face));
+	bvh.Clear();
+	CHECK(!bvh.Intersect(mesh.Positions(), origin, dir, dist, face));
+}
+
+int main()
+{
+	TestRandomMeshes();
+	TestStrip();
+	TestInvalid();
+	return TEST_MAIN_RESULT();
+}
@@ -0,0 +1,99 @@
+#include "JsonWalk.h"
+#include "PresetJson.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+#include <vector>
+
+// Fuzz entry point for JsonStreamReader and PresetJsonParser. With
+// CHARGEN_FUZZ the target links against libFuzzer, otherwise main replays
+// the files it is given along with every truncation and a fixed set of
+// single byte substitutions of each.
+
+static void Verify(bool condition, const char * what)
+{
+	if (!condition) {
+		fprintf(stderr, "JsonStreamFuzz: %s\n", what);
+		abort();
+	}
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t * data, size_t size)
+{
+	// Exact sized copy so reads past the end land outside the allocation
+	std::vector<char> buffer(data, data + size);
+	const char * begin = buffer.data();
+	const char * end = begin + size;
+
+	std::string walked;
+	bool walkOk = JsonWalk(begin, end, walked);
+	Verify(walkOk == JsonSkip(begin, end), "walk and skip disagree");
+
+	if (walkOk) {
+		std::string rewalked;
+		Verify(JsonWalk(walked.data(), walked.data() + walked.size(), rewalked), "rewritten document does not parse");
+		Verify(rewalked == walked, "rewritten document reads differently");
+	}
+	else {
+		JsonStreamReader reader(begin, end);
+		reader.Skip();
+		reader.AtEnd();
+		Verify(reader.Failed() || !reader.AtEnd(), "failed document reads to the end");
+		Verify(reader.GetOffset() <= size, "error offset past the end");
+	}
+
+	// A single document parses as a preset exactly when it is an object
+	PresetJsonParser parser;
+	bool parseOk = parser.Parse(begin, end);
+	if (walkOk) {
+		JsonStreamReader reader(begin, end);
+		Verify(parseOk == (reader.Peek() == JsonStreamValue::kType_Object), "preset parse disagrees with the walk");
+	}
+	if (!parseOk)
+		Verify(parser.GetError() && parser.GetOffset() <= size, "preset error without a message or past the end");
+
+	return 0;
+}
+
+#ifndef CHARGEN_LIBFUZZER
+
+static const char kSubstitutions[] = { '\0', '"', '\\', '/', '*', '{', '}', '[', ']', ',', ':', '-', '.', '0', 'e', 'u', 'D', 'n' };
+
+int main(int argc, char ** argv)
+{
+	if (argc < 2) {
+		fprintf(stderr, "usage: %s corpus files...\n", argv[0]);
+		return 1;
+	}
+
+	UInt32 runs = 0;
+	for (int a = 1; a < argc; a++)
+	{
+		std::string file;
+		if (!JsonReadFile(argv[a], file)) {
+			fprintf(stderr, "%s: could not read\n", argv[a]);
+			return 1;
+		}
+
+		std::vector<uint8_t> data(file.begin(), file.end());
+		for (size_t length = 0; length <= data.size(); length++, runs++)
+			LLVMFuzzerTestOneInput(data.data(), length);
+
+		std::vector<uint8_t> mutated(data);
+		for (size_t i = 0; i < data.size(); i++)
+		{
+			for (size_t s = 0; s < sizeof(kSubstitutions); s++, runs++) {
+				mutated[i] = kSubstitutions[s];
+				LLVMFuzzerTestOneInput(mutated.data(), mutated.size());
+			}
+			mutated[i] = data[i];
+		}
+	}
+
+	printf("%u inputs from %d files\n", runs, argc - 1);
+	return 0;
+}
+
+#endif
@@ -0,0 +1,300 @@
+#include "JsonWalk.h"
+#include "TestUtils.h"
+
+#include <cstring>
+#include <vector>
+
+int g_failures = 0;
+
+static std::string Walk(const char * text)
+{
+	std::string out;
+	if (!JsonWalk(text, text + strlen(text), out))
+		return "<error>";
+	return out;
+}
+
+static bool ReadScalar(const char * text, JsonStreamValue & value)
+{
+	JsonStreamReader reader(text, text + strlen(text));
+	return reader.ReadValue(value) && reader.AtEnd();
+}
+
+static void TestScalars()
+{
+	JsonStreamValue value;
+	CHECK(ReadScalar("true", value) && value.type == JsonStreamValue::kType_Bool && value.boolean);
+	CHECK(ReadScalar("false", value) && value.type == JsonStreamValue::kType_Bool && !value.boolean);
+	CHECK(ReadScalar("null", value) && value.IsNull());
+	CHECK(ReadScalar("-12", value) && value.type == JsonStreamValue::kType_Number && value.number == -12.0);
+	CHECK(ReadScalar("1.5e2", value) && value.number == 150.0);
+	CHECK(ReadScalar("\"Skyrim.esm\"", value) && value.AsString() == "Skyrim.esm");
+
+	// Containers read through ReadValue are skipped whole
+	CHECK(ReadScalar("{ \"a\" : [ 1, { } ] }", value) && value.type == JsonStreamValue::kType_Object);
+	CHECK(ReadScalar("[ [ ], \"]\" ]", value) && value.type == JsonStreamValue::kType_Array);
+
+	CHECK(!ReadScalar("", value));
+	CHECK(!ReadScalar("nul", value));
+	CHECK(!ReadScalar("truex", value));
+}
+
+// Integers up to 18 digits take the exact path, longer ones go through strtod
+static void TestNumbers()
+{
+	JsonStreamValue value;
+	CHECK(ReadScalar("123456789012345678", value) && value.number == 123456789012345678.0);
+	CHECK(ReadScalar("1234567890123456789", value) && value.number == 1234567890123456789.0);
+	CHECK(ReadScalar("-0", value) && value.number == 0.0 && std::signbit(value.number));
+	CHECK(ReadScalar("1.100000023841858", value) && (float)value.number == 1.1f);
+	CHECK(ReadScalar("1e-400", value) && value.number == 0.0);
+	CHECK(!ReadScalar("1e400", value));
+	CHECK(!ReadScalar("01", value));
+	CHECK(!ReadScalar("+1", value));
+	CHECK(!ReadScalar(".5", value));
+	CHECK(!ReadScalar("1.", value));
+	CHECK(!ReadScalar("1e", value));
+
+	// Past 63 characters the number is copied before strtod
+	std::string longNumber = "0." + std::string(80, '1');
+	JsonStreamReader reader(longNumber.data(), longNumber.data() + longNumber.size());
+	CHECK(reader.ReadValue(value) && reader.AtEnd());
+	CHECK_NEAR(value.number, 1.0 / 9.0, 1e-15);
+}
+
+static void TestConversions()
+{
+	JsonStreamValue value;
+	value.type = JsonStreamValue::kType_Number;
+
+	value.number = 4294967295.0;
+	CHECK(value.AsUInt() == 0xFFFFFFFF);
+	value.number = 1e12;
+	CHECK(value.AsUInt() == 0xFFFFFFFF);
+	CHECK(value.AsInt() == 0x7FFFFFFF);
+	value.number = -1e12;
+	CHECK(value.AsInt() == (SInt32)0x80000000);
+	value.number = -1.0;
+	CHECK(value.AsUInt() == 0xFFFFFFFF);
+	value.number = 2.75;
+	CHECK(value.AsUInt() == 2 && value.AsInt() == 2 && value.AsFloat() == 2.75f && value.AsBool());
+	value.number = 0.0;
+	CHECK(!value.AsBool());
+
+	value.type = JsonStreamValue::kType_Bool;
+	value.boolean = true;
+	CHECK(value.AsUInt() == 1 && value.AsInt() == 1 && value.AsFloat() == 1.0f && value.AsBool());
+	CHECK(value.AsString().empty());
+
+	value.type = JsonStreamValue::kType_String;
+	value.string = "12";
+	CHECK(value.AsUInt() == 0 && value.AsFloat() == 0.0f && !value.AsBool());
+	CHECK(value.AsString() == "12");
+}
+
+static void TestStrings()
+{
+	JsonStreamValue value;
+	CHECK(ReadScalar("\"\\\"\\\\\\/\\b\\f\\n\\r\\t\"", value) && value.string == "\"\\/\b\f\n\r\t");
+	CHECK(ReadScalar("\"\\u0041\\u00e9\\u4E2D\"", value) && value.string == "A\xC3\xA9\xE4\xB8\xAD");
+	CHECK(ReadScalar("\"\\ud83d\\ude00\"", value) && value.string == "\xF0\x9F\x98\x80");
+	CHECK(ReadScalar("\"\\u0000x\"", value) && value.string == std::string("\0x", 2));
+	CHECK(ReadScalar("\"raw \xC3\xA9\"", value) && value.string == "raw \xC3\xA9");
+
+	CHECK(!ReadScalar("\"\\x\"", value));
+	CHECK(!ReadScalar("\"\\u12\"", value));
+	CHECK(!ReadScalar("\"\\u12G4\"", value));
+	CHECK(!ReadScalar("\"\\ud83d\"", value));
+	CHECK(!ReadScalar("\"\\ud83d\\u0041\"", value));
+	CHECK(!ReadScalar("\"open", value));
+	CHECK(!ReadScalar("\"trailing \\", value));
+}
+
+static void TestStructure()
+{
+	CHECK(Walk(" { \"b\" : [ 1 , 2 ] , \"a\" : { } } ") == "{\"b\":[1,2],\"a\":{}}");
+	CHECK(Walk("// line\n[ /* block */ 1, /**/ 2 ] // end") == "[1,2]");
+	CHECK(Walk("[]") == "[]");
+	CHECK(Walk("[ 1, ]") == "<error>");
+	CHECK(Walk("{ \"a\" : 1, }") == "<error>");
+	CHECK(Walk("{ \"a\" 1 }") == "<error>");
+	CHECK(Walk("{ a : 1 }") == "<error>");
+	CHECK(Walk("[ 1 2 ]") == "<error>");
+	CHECK(Walk("[ 1 ] [ 2 ]") == "<error>");
+	CHECK(Walk("[ 1 ] /* open") == "<error>");
+	CHECK(Walk("[ 1") == "<error>");
+
+	// Member and element reads outside of a container fail instead of underflowing
+	const char * text = "[ ]";
+	JsonStreamReader reader(text, text + strlen(text));
+	std::string name;
+	CHECK(reader.BeginArray() && !reader.NextElement() && !reader.Failed());
+	CHECK(!reader.NextElement() && reader.Failed());
+	JsonStreamReader objectReader(text, text + strlen(text));
+	CHECK(!objectReader.NextMember(name) && objectReader.Failed());
+}
+
+static void TestDepth()
+{
+	for (UInt32 depth = JsonStreamReader::kMaxDepth - 1; depth <= JsonStreamReader::kMaxDepth + 1; depth++) {
+		std::string text = std::string(depth, '[') + std::string(depth, ']');
+		bool expected = depth <= JsonStreamReader::kMaxDepth;
+
+		std::string out;
+		CHECK(JsonWalk(text.data(), text.data() + text.size(), out) == expected);
+		CHECK(JsonSkip(text.data(), text.data() + text.size()) == expected);
+		if (expected)
+			CHECK(out == text);
+	}
+
+	// Objects and arrays share the same depth
+	std::string mixed;
+	for (UInt32 i = 0; i < JsonStreamReader::kMaxDepth; i++)
+		mixed += i & 1 ? "{\"a\":" : "[";
+	mixed += "1";
+	for (UInt32 i = JsonStreamReader::kMaxDepth; i-- > 0;)
+		mixed += i & 1 ? "}" : "]";
+	CHECK(JsonSkip(mixed.data(), mixed.data() + mixed.size()));
+
+	std::string deeper = "[" + mixed + "]";
+	CHECK(!JsonSkip(deeper.data(), deeper.data() + deeper.size()));
+}
+
+// Errors stop at the offending character and every read after it fails
+static void TestErrors()
+{
+	const char * text = "{ \"index\" : 0, \"name\" : \"\\q\" }";
+	JsonStreamReader reader(text, text + strlen(text));
+	CHECK(!reader.Skip());
+	CHECK(reader.Failed() && strcmp(reader.GetError(), "invalid escape") == 0);
+	CHECK(reader.GetOffset() == 27);
+
+	std::string name;
+	JsonStreamValue value;
+	CHECK(!reader.NextMember(name));
+	CHECK(!reader.ReadValue(value));
+	CHECK(!reader.AtEnd());
+	CHECK(strcmp(reader.GetError(), "invalid escape") == 0);
+
+	const char * overflow = "[ 1, 1e999 ]";
+	JsonStreamReader overflowReader(overflow, overflow + strlen(overflow));
+	CHECK(!overflowReader.Skip());
+	CHECK(strcmp(overflowReader.GetError(), "number out of range") == 0);
+	CHECK(overflowReader.GetOffset() == 5);
+}
+
+// Reads the sculpt data of a preset the way the preset decoder walks it
+static void TestPresetLayout(const std::string & data)
+{
+	JsonStreamReader reader(data.data(), data.data() + data.size());
+	std::string name, member;
+	UInt32 divisor = 0, vertices = 0, entries = 0;
+	SInt32 firstEntry[4] = { 0 };
+	std::string host;
+
+	CHECK(reader.BeginObject());
+	while (reader.NextMember(name)) {
+		if (name != "morphs") {
+			CHECK(reader.Skip());
+			continue;
+		}
+
+		CHECK(reader.BeginObject());
+		while (reader.NextMember(member)) {
+			JsonStreamValue value;
+			if (member == "sculptDivisor") {
+				CHECK(reader.ReadValue(value));
+				divisor = value.AsUInt();
+			}
+			else if (member == "sculpt") {
+				CHECK(reader.BeginArray());
+				while (reader.NextElement()) {
+					std::string key;
+					CHECK(reader.BeginObject());
+					while (reader.NextMember(key)) {
+						if (key == "host") {
+							CHECK(reader.ReadValue(value));
+							host = value.AsString();
+						}
+						else if (key == "vertices") {
+							CHECK(reader.ReadValue(value));
+							vertices = value.AsUInt();
+						}
+						else if (key == "data") {
+							CHECK(reader.BeginArray());
+							while (reader.NextElement()) {
+								CHECK(reader.BeginArray());
+								for (UInt32 n = 0; reader.NextElement(); n++) {
+									CHECK(reader.ReadValue(value));
+									if (entries == 0 && n < 4)
+										firstEntry[n] = value.AsInt();
+								}
+								entries++;
+							}
+						}
+						else
+							CHECK(reader.Skip());
+					}
+				}
+			}
+			else
+				CHECK(reader.Skip());
+		}
+	}
+
+	CHECK(reader.AtEnd());
+	CHECK(divisor == 10000);
+	CHECK(host == "FemaleHead.nif");
+	CHECK(vertices == 1183);
+	CHECK(entries == 3);
+	CHECK(firstEntry[0] == 12 && firstEntry[1] == 105 && firstEntry[2] == -3 && firstEntry[3] == 27);
+}
+
+// Arguments are corpus files, those after -valid have to read to the end,
+// those after -invalid have to fail
+static void TestCorpus(int argc, char ** argv)
+{
+	bool expectValid = true;
+	UInt32 files = 0;
+	for (int a = 1; a < argc; a++)
+	{
+		if (strcmp(argv[a], "-valid") == 0 || strcmp(argv[a], "-invalid") == 0) {
+			expectValid = argv[a][1] == 'v';
+			continue;
+		}
+
+		std::string data;
+		if (!JsonReadFile(argv[a], data)) {
+			fprintf(stderr, "%s: could not read\n", argv[a]);
+			g_failures++;
+			continue;
+		}
+
+		files++;
+		std::string out;
+		bool valid = JsonWalk(data.data(), data.data() + data.size(), out);
+		if (valid != expectValid) {
+			fprintf(stderr, "%s: expected the document to %s\n", argv[a], expectValid ? "read" : "fail");
+			g_failures++;
+		}
+		CHECK(JsonSkip(data.data(), data.data() + data.size()) == valid);
+
+		if (expectValid && strstr(argv[a], "preset.jslot"))
+			TestPresetLayout(data);
+	}
+
+	CHECK(files > 0);
+}
+
+int main(int argc, char ** argv)
+{
+	TestScalars();
+	TestNumbers();
+	TestConversions();
+	TestStrings();
+	TestStructure();
+	TestDepth();
+	TestErrors();
+	TestCorpus(argc, argv);
+	return TEST_MAIN_RESULT();
+}
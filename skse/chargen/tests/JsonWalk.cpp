@@ -0,0 +1,132 @@
+#include "JsonWalk.h"
+
+#include <cstdio>
+
+static void WriteString(std::string & out, const std::string & str)
+{
+	out += '"';
+	for (size_t i = 0; i < str.size(); i++)
+	{
+		unsigned char c = str[i];
+		switch (c) {
+			case '"':	out += "\\\""; break;
+			case '\\':	out += "\\\\"; break;
+			case '\n':	out += "\\n"; break;
+			case '\r':	out += "\\r"; break;
+			case '\t':	out += "\\t"; break;
+			default:
+				if (c < 0x20) {
+					char buffer[8];
+					sprintf(buffer, "\\u%04x", c);
+					out += buffer;
+				}
+				else
+					out += (char)c;
+				break;
+		}
+	}
+	out += '"';
+}
+
+static bool WalkValue(JsonStreamReader & reader, std::string & out)
+{
+	std::string name;
+	switch (reader.Peek()) {
+		case JsonStreamValue::kType_Object:
+		{
+			if (!reader.BeginObject())
+				return false;
+
+			out += '{';
+			bool first = true;
+			while (reader.NextMember(name)) {
+				if (!first)
+					out += ',';
+				first = false;
+
+				WriteString(out, name);
+				out += ':';
+				if (!WalkValue(reader, out))
+					return false;
+			}
+			out += '}';
+			return !reader.Failed();
+		}
+		case JsonStreamValue::kType_Array:
+		{
+			if (!reader.BeginArray())
+				return false;
+
+			out += '[';
+			bool first = true;
+			while (reader.NextElement()) {
+				if (!first)
+					out += ',';
+				first = false;
+
+				if (!WalkValue(reader, out))
+					return false;
+			}
+			out += ']';
+			return !reader.Failed();
+		}
+		default:
+			break;
+	}
+
+	JsonStreamValue value;
+	if (!reader.ReadValue(value))
+		return false;
+
+	switch (value.type) {
+		case JsonStreamValue::kType_Null:
+			out += "null";
+			break;
+		case JsonStreamValue::kType_Bool:
+			out += value.boolean ? "true" : "false";
+			break;
+		case JsonStreamValue::kType_String:
+			WriteString(out, value.string);
+			break;
+		case JsonStreamValue::kType_Number:
+		{
+			char buffer[32];
+			sprintf(buffer, "%.17g", value.number);
+			out += buffer;
+			break;
+		}
+		default:
+			return false;
+	}
+
+	return true;
+}
+
+bool JsonWalk(const char * begin, const char * end, std::string & out)
+{
+	JsonStreamReader reader(begin, end);
+	out.clear();
+	return WalkValue(reader, out) && reader.AtEnd();
+}
+
+bool JsonSkip(const char * begin, const char * end)
+{
+	JsonStreamReader reader(begin, end);
+	return reader.Skip() && reader.AtEnd();
+}
+
+bool JsonReadFile(const char * path, std::string & data)
+{
+	FILE * file = fopen(path, "rb");
+	if (!file)
+		return false;
+
+	char chunk[4096];
+	size_t read;
+	data.clear();
+	while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0)
+		data.append(chunk, read);
+
+	fclose(file);
+	return true;
+}
@@ -0,0 +1,21 @@
+#ifndef __JSONWALK__
+#define __JSONWALK__
+
+#pragma once
+
+#include "JsonStream.h"
+
+#include <string>
+
+// Reads a whole document through JsonStreamReader and writes it back out
+// without whitespace or comments, numbers as %.17g. Walking the output
+// again has to give the same text.
+bool JsonWalk(const char * begin, const char * end, std::string & out);
+
+// Same document skipped instead of walked, has to agree with JsonWalk
+bool JsonSkip(const char * begin, const char * end);
+
+// Whole file as bytes, false if it can't be opened
+bool JsonReadFile(const char * path, std::string & data);
+
+#endif
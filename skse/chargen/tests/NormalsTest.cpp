@@ -0,0 +1,252 @@
+#include "CDXVertexNormals.h"
+#include "TestMeshes.h"
+#include "TestUtils.h"
+
+#include <algorithm>
+#include <set>
+
+int g_failures = 0;
+
+static void BuildNormals(TestMesh & mesh, CDXMeshTopology & topology, CDXVertexNormals & normals)
+{
+	topology.Build(mesh.faces.data(), mesh.faces.size(), mesh.vertices.size());
+	normals.Build(&topology, mesh.Positions(), TestMesh::kStride);
+	normals.CalculateAll(mesh.Positions(), mesh.Normals());
+}
+
+static void TestGrid()
+{
+	TestMesh mesh = MakeGrid(8, 6, 0.5f);
+	CDXMeshTopology topology;
+	CDXVertexNormals normals;
+	BuildNormals(mesh, topology, normals);
+
+	for (auto & v : mesh.vertices) {
+		CHECK_NEAR(v.normal[0], 0.0, 1e-6);
+		CHECK_NEAR(v.normal[1], 0.0, 1e-6);
+		CHECK_NEAR(v.normal[2], 1.0, 1e-6);
+	}
+}
+
+// Two faces of different area meeting at the origin, the shared normal
+// is their sum weighted by area
+static void TestAreaWeighting()
+{
+	TestMesh mesh;
+	CDXMeshIndex o = mesh.AddVertex(0, 0, 0);
+	CDXMeshIndex a = mesh.AddVertex(1, 0, 0);
+	CDXMeshIndex b = mesh.AddVertex(0, 1, 0);
+	CDXMeshIndex c = mesh.AddVertex(0, 0, 3);
+	mesh.faces.push_back(CDXMeshFace(o, a, b));	// +z, area 0.5
+	mesh.faces.push_back(CDXMeshFace(o, b, c));	// +x, area 1.5
+
+	CDXMeshTopology topology;
+	CDXVertexNormals normals;
+	BuildNormals(mesh, topology, normals);
+
+	float length = sqrtf(10.0f);
+	CHECK_NEAR(mesh.vertices[o].normal[0], 3.0f / length, 1e-6);
+	CHECK_NEAR(mesh.vertices[o].normal[1], 0.0, 1e-6);
+	CHECK_NEAR(mesh.vertices[o].normal[2], 1.0f / length, 1e-6);
+	CHECK_NEAR(mesh.vertices[a].normal[2], 1.0, 1e-6);
+	CHECK_NEAR(mesh.vertices[c].normal[0], 1.0, 1e-6);
+
+	float normal[3];
+	normals.Calculate(mesh.Positions(), o, normal);
+	CHECK_NEAR(normal[0], 3.0f / length, 1e-6);
+	CHECK_NEAR(normal[2], 1.0f / length, 1e-6);
+}
+
+static double SphereNormalError(UInt32 subdivisions)
+{
+	TestMesh mesh = MakeSphere(subdivisions);
+	CDXMeshTopology topology;
+	CDXVertexNormals normals;
+	BuildNormals(mesh, topology, normals);
+
+	// A unit sphere's normal is its position
+	double maxError = 0.0;
+	for (auto & v : mesh.vertices) {
+		double length = sqrt(v.normal[0] * v.normal[0] + v.normal[1] * v.normal[1] + v.normal[2] * v.normal[2]);
+		CHECK_NEAR(length, 1.0, 1e-5);
+		for (UInt32 k = 0; k < 3; k++)
+			maxError = std::max(maxError, fabs(v.normal[k] - v.position[k]));
+	}
+
+	return maxError;
+}
+
+// Normals approach the analytic ones as the sphere is refined
+static void TestSphere()
+{
+	double coarse = SphereNormalError(2);
+	double fine = SphereNormalError(4);
+	CHECK(coarse < 0.05);
+	CHECK(fine < 0.01);
+	CHECK(fine < coarse * 0.5);
+}
+
+// Packed and interleaved positions give the same normals
+static void TestStride()
+{
+	TestMesh mesh = MakeSphere(2);
+	CDXMeshTopology topology;
+	CDXVertexNormals normals;
+	BuildNormals(mesh, topology, normals);
+
+	std::vector<float> positions, packed(mesh.vertices.size() * 3);
+	for (auto & v : mesh.vertices)
+		positions.insert(positions.end(), v.position, v.position + 3);
+
+	CDXVertexNormals packedNormals;
+	packedNormals.Build(&topology, positions.data(), 3);
+	packedNormals.CalculateAll(positions.data(), packed.data());
+
+	for (UInt32 i = 0; i < mesh.vertices.size(); i++) {
+		for (UInt32 k = 0; k < 3; k++)
+			CHECK(packed[i * 3 + k] == mesh.vertices[i].normal[k]);
+	}
+}
+
+// Moving vertices and updating gives the same normals as recomputing all of
+// them, and reports exactly the corners of the faces that moved
+static void TestIncremental()
+{
+	TestMesh mesh = MakeSphere(3);
+	CDXMeshTopology topology;
+	CDXVertexNormals normals;
+	BuildNormals(mesh, topology, normals);
+
+	UInt32 state = 1234;
+	for (UInt32 round = 0; round < 8; round++) {
+		std::set<CDXMeshIndex> expected;
+		for (UInt32 n = 0; n < 40; n++) {
+			CDXMeshIndex i = (CDXMeshIndex)((NextRandom(state) * 0.5f + 0.5f) * mesh.vertices.size()) % mesh.vertices.size();
+			for (UInt32 k = 0; k < 3; k++)
+				mesh.vertices[i].position[k] += NextRandom(state) * 0.05f;
+			normals.MarkDirty(i);
+
+			topology.VisitFaces(i, [&](UInt32, const CDXMeshFace & face)
+			{
+				expected.insert(face.v1);
+				expected.insert(face.v2);
+				expected.insert(face.v3);
+			});
+		}
+
+		CHECK(normals.IsDirty());
+		const std::vector<CDXMeshIndex> & updated = normals.Update(mesh.Positions(), mesh.Normals());
+		CHECK(!normals.IsDirty());
+		CHECK(std::set<CDXMeshIndex>(updated.begin(), updated.end()) == expected);
+		CHECK(updated.size() == expected.size());
+
+		TestMesh reference = mesh;
+		CDXVertexNormals full;
+		full.Build(&topology, reference.Positions(), TestMesh::kStride);
+		full.CalculateAll(reference.Positions(), reference.Normals());
+
+		for (UInt32 i = 0; i < mesh.vertices.size(); i++) {
+			for (UInt32 k = 0; k < 3; k++)
+				CHECK(mesh.vertices[i].normal[k] == reference.vertices[i].normal[k]);
+		}
+	}
+}
+
+static const float * FindNormal(TestMesh & mesh, float x, float y, float z, CDXMeshIndex skip)
+{
+	for (UInt32 i = 0; i < mesh.vertices.size(); i++) {
+		const float * p = mesh.vertices[i].position;
+		if (i != skip && p[0] == x && p[1] == y && p[2] == z)
+			return mesh.vertices[i].normal;
+	}
+	return NULL;
+}
+
+// Ridge vertices duplicated along a seam get the same normal as the shared
+// ridge of an unsplit mesh. Away from the ends, where the triangulation
+// isn't mirrored, the ridge normal points straight up.
+static void TestSeam()
+{
+	TestMesh shared = MakeRoof(3, 4, false);
+	TestMesh split = MakeRoof(3, 4, true);
+	CHECK(split.vertices.size() == shared.vertices.size() + 5);
+
+	CDXMeshTopology sharedTopology, splitTopology;
+	CDXVertexNormals sharedNormals, splitNormals;
+	BuildNormals(shared, sharedTopology, sharedNormals);
+	BuildNormals(split, splitTopology, splitNormals);
+
+	for (UInt32 i = 0; i < split.vertices.size(); i++) {
+		const float * p = split.vertices[i].position;
+		const float * expected = FindNormal(shared, p[0], p[1], p[2], 0xFFFF);
+		CHECK(expected != NULL);
+		if (!expected)
+			continue;
+
+		for (UInt32 k = 0; k < 3; k++)
+			CHECK_NEAR(split.vertices[i].normal[k], expected[k], 1e-6);
+
+		if (p[0] == 0.0f && p[1] > 0.0f && p[1] < 4.0f) {
+			CHECK_NEAR(split.vertices[i].normal[0], 0.0, 1e-6);
+			CHECK(FindNormal(split, p[0], p[1], p[2], i) != NULL);
+		}
+	}
+
+	// Moving one copy of a ridge vertex rewrites the other copy too
+	CDXMeshIndex moved = 0xFFFF;
+	for (UInt32 i = 0; i < split.vertices.size() && moved == 0xFFFF; i++) {
+		if (split.vertices[i].position[0] == 0.0f && split.vertices[i].position[1] == 2.0f)
+			moved = i;
+	}
+	CHECK(moved != 0xFFFF);
+
+	split.vertices[moved].position[2] += 0.5f;
+	splitNormals.MarkDirty(moved);
+	const std::vector<CDXMeshIndex> & updated = splitNormals.Update(split.Positions(), split.Normals());
+
+	for (UInt32 i = 0; i < split.vertices.size(); i++) {
+		const float * p = split.vertices[i].position;
+		if (i == moved || p[0] != 0.0f || p[1] != 2.0f)
+			continue;
+
+		CHECK(std::find(updated.begin(), updated.end(), i) != updated.end());
+		for (UInt32 k = 0; k < 3; k++)
+			CHECK(split.vertices[i].normal[k] == split.vertices[moved].normal[k]);
+	}
+
+	float normal[3];
+	splitNormals.Calculate(split.Positions(), moved, normal);
+	for (UInt32 k = 0; k < 3; k++)
+		CHECK_NEAR(normal[k], split.vertices[moved].normal[k], 1e-6);
+}
+
+// A vertex without faces keeps whatever normal it had
+static void TestIsolatedVertex()
+{
+	TestMesh mesh = MakeGrid(2, 2, 1.0f);
+	CDXMeshIndex loose = mesh.AddVertex(5, 5, 5);
+	mesh.vertices[loose].normal[1] = 1.0f;
+
+	CDXMeshTopology topology;
+	CDXVertexNormals normals;
+	BuildNormals(mesh, topology, normals);
+
+	CHECK(mesh.vertices[loose].normal[0] == 0.0f);
+	CHECK(mesh.vertices[loose].normal[1] == 1.0f);
+	CHECK(mesh.vertices[loose].normal[2] == 0.0f);
+
+	normals.MarkDirty(loose);
+	CHECK(normals.Update(mesh.Positions(), mesh.Normals()).empty());
+}
+
+int main()
+{
+	TestGrid();
+	TestAreaWeighting();
+	TestSphere();
+	TestStride();
+	TestIncremental();
+	TestSeam();
+	TestIsolatedVertex();
+	return TEST_MAIN_RESULT();
+}
@@ -0,0 +1,85 @@
+#include "ObjReader.h"
+#include "TestObj.h"
+
+#include <chrono>
+#include <cstdio>
+
+// Times ObjReader against the stream tokenizer on generated heads, or on
+// the OBJ files given as arguments. Not run by ctest.
+
+static double Milliseconds(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static bool ReadFile(const char * path, std::string & text)
+{
+	FILE * file = fopen(path, "rb");
+	if (!file)
+		return false;
+
+	char chunk[65536];
+	size_t read;
+	while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0)
+		text.append(chunk, read);
+
+	fclose(file);
+	return true;
+}
+
+static void Benchmark(const char * name, const std::string & text)
+{
+	const UInt32 runs = 5;
+	double best = 0.0, bestReference = 0.0;
+	size_t vertices = 0, triangles = 0;
+	for (UInt32 i = 0; i < runs; i++) {
+		auto start = std::chrono::steady_clock::now();
+		ObjReader reader;
+		if (!reader.Read(text.data(), text.data() + text.size())) {
+			printf("%s: %s on line %u\n", name, reader.GetError(), reader.GetLine());
+			return;
+		}
+		double elapsed = Milliseconds(start);
+		if (i == 0 || elapsed < best)
+			best = elapsed;
+		vertices = reader.vertices.size();
+		triangles = reader.indices.size() / 3;
+
+		start = std::chrono::steady_clock::now();
+		std::vector<ObjVertex> referenceVertices;
+		std::vector<UInt32> referenceIndices;
+		ReadObjReference(text, referenceVertices, referenceIndices);
+		elapsed = Milliseconds(start);
+		if (i == 0 || elapsed < bestReference)
+			bestReference = elapsed;
+	}
+
+	printf("%-24s %8.1f MB %9zu vertices %9zu triangles  ObjReader %8.2f ms  stream %8.2f ms  %5.1fx\n",
+		name, text.size() / 1048576.0, vertices, triangles, best, bestReference, bestReference / best);
+}
+
+int main(int argc, char ** argv)
+{
+	if (argc > 1) {
+		for (int a = 1; a < argc; a++) {
+			std::string text;
+			if (!ReadFile(argv[a], text)) {
+				fprintf(stderr, "%s: could not read\n", argv[a]);
+				return 1;
+			}
+			Benchmark(argv[a], text);
+		}
+		return 0;
+	}
+
+	UInt32 sizes[][2] = { { 64, 128 }, { 200, 400 }, { 500, 1000 } };
+	for (auto & size : sizes) {
+		for (UInt32 quads = 0; quads <= 1; quads++) {
+			char name[64];
+			snprintf(name, sizeof(name), "sphere %ux%u %s", size[0], size[1], quads ? "quads" : "tris");
+			Benchmark(name, MakeObjSphere(size[0], size[1], quads != 0));
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,174 @@
+#include "ObjReader.h"
+#include "TestMeshes.h"
+#include "TestObj.h"
+#include "TestUtils.h"
+
+#include <cstdlib>
+#include <cstring>
+
+int g_failures = 0;
+
+static bool Read(ObjReader & reader, const std::string & text)
+{
+	return reader.Read(text.data(), text.data() + text.size());
+}
+
+// Floats match strtof to within one unit in the last place
+static bool SameFloat(float a, float b)
+{
+	return a == b || nextafterf(a, b) == b;
+}
+
+static bool SameVertices(const std::vector<ObjVertex> & a, const std::vector<ObjVertex> & b)
+{
+	if (a.size() != b.size())
+		return false;
+
+	for (size_t i = 0; i < a.size(); i++) {
+		const float * x = a[i].position;
+		const float * y = b[i].position;
+		for (UInt32 k = 0; k < 8; k++) {
+			if (!SameFloat(x[k], y[k]))
+				return false;
+		}
+	}
+	return true;
+}
+
+// Generated spheres against the stream tokenizer, triangles and fanned quads
+static void TestAgainstReference()
+{
+	UInt32 sizes[][2] = { { 2, 3 }, { 3, 4 }, { 8, 16 }, { 40, 64 } };
+	for (auto & size : sizes) {
+		for (UInt32 quads = 0; quads <= 1; quads++) {
+			std::string text = MakeObjSphere(size[0], size[1], quads != 0);
+
+			std::vector<ObjVertex> vertices;
+			std::vector<UInt32> indices;
+			CHECK(ReadObjReference(text, vertices, indices));
+
+			ObjReader reader;
+			CHECK(Read(reader, text));
+			CHECK(SameVertices(reader.vertices, vertices));
+			CHECK(reader.indices == indices);
+
+			// Rings gain a vertex along the texcoord seam, poles split per segment
+			UInt32 triangles = 2 * size[1] * (size[0] - 1);
+			CHECK(reader.indices.size() == triangles * 3);
+			CHECK(reader.vertices.size() == (size[0] - 1) * (size[1] + 1) + 2 * size[1]);
+		}
+	}
+}
+
+static void TestFloats()
+{
+	const char * values[] = {
+		"0", "-0", "1", "-1", "0.5", "3.14159265", "-120.000001", "1e3", "2.5E-4",
+		"+7.25", ".5", "5.", "123456789012345678901234", "0.000000000000000000000123456",
+		"1e-30", "3.4e38", "0.1", "0.2", "0.3", "12.5", "-0.000001"
+	};
+
+	for (auto value : values) {
+		std::string text = std::string("v ") + value + " 0 0\nf 1 1 1\n";
+		ObjReader reader;
+		CHECK(Read(reader, text));
+		CHECK(reader.vertices.size() == 1 && SameFloat(reader.vertices[0].position[0], strtof(value, NULL)));
+	}
+
+	// Random decimals in the range head meshes use
+	UInt32 state = 3;
+	for (UInt32 i = 0; i < 2000; i++) {
+		char value[32];
+		snprintf(value, sizeof(value), "%.*f", (int)(i % 9), NextRandom(state) * 200.0);
+		std::string text = std::string("v ") + value + " 0 0\nf 1 1 1\n";
+		ObjReader reader;
+		CHECK(Read(reader, text) && SameFloat(reader.vertices[0].position[0], strtof(value, NULL)));
+	}
+}
+
+static void TestIndices()
+{
+	std::string header = "v 0 0 0\nv 1 0 0\nv 0 1 0\nv 1 1 0\nvt 0 0\nvt 1 1\nvn 0 0 1\n";
+
+	ObjReader reader;
+	CHECK(Read(reader, header + "f -4 -3 -2 -1\n"));
+	CHECK(reader.vertices.size() == 4);
+	CHECK(reader.indices == std::vector<UInt32>({ 0, 1, 2, 0, 2, 3 }));
+
+	// Same position with another texcoord or normal is another vertex
+	CHECK(Read(reader, header + "f 1/1/1 2/1/1 3/1/1\nf 1/2/1 2/1/1 3//1\n"));
+	CHECK(reader.vertices.size() == 5);
+	CHECK(reader.indices == std::vector<UInt32>({ 0, 1, 2, 3, 1, 4 }));
+	CHECK(reader.vertices[3].texcoord[0] == 1.0f && reader.vertices[3].normal[2] == 1.0f);
+	CHECK(reader.vertices[4].texcoord[0] == 0.0f && reader.vertices[4].texcoord[1] == 0.0f);
+
+	// Comments, groups, materials, CRLF and blank lines are skipped
+	CHECK(Read(reader, "# head\r\nmtllib head.mtl\r\n\r\n  v 0 0 0\r\nv 1 0 0\r\n\tv 0 1 0\r\ng Head\r\nusemtl Skin\r\ns off\r\nf 1 2 3\r\n"));
+	CHECK(reader.vertices.size() == 3 && reader.indices.size() == 3);
+	CHECK(Read(reader, "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3"));
+	CHECK(reader.indices.size() == 3);
+	CHECK(Read(reader, ""));
+	CHECK(reader.vertices.empty() && reader.indices.empty());
+}
+
+static void TestErrors()
+{
+	struct Case
+	{
+		const char	* text;
+		const char	* error;
+		UInt32		line;
+	};
+
+	Case cases[] = {
+		{ "v 0 0\n", "invalid position", 1 },
+		{ "v 0 0 0\nvt x y\n", "invalid texcoord", 2 },
+		{ "vn 0 0 -\n", "invalid normal", 1 },
+		{ "v 0 0 0\nf 1 1 2\n", "invalid position index", 2 },
+		{ "v 0 0 0\nf 0 1 1\n", "invalid position index", 2 },
+		{ "v 0 0 0\nf -2 1 1\n", "invalid position index", 2 },
+		{ "v 0 0 0\nf 1/1 1 1\n", "invalid texcoord index", 2 },
+		{ "v 0 0 0\nf 1//1 1 1\n", "invalid normal index", 2 },
+		{ "v 0 0 0\nf 1 1\n", "face with fewer than three corners", 2 },
+		{ "v 0 0 0\nf 1 1x 1\n", "invalid face corner", 2 },
+		{ "v 0 0 0\n\n# late\nf 1 1 99999999999999999999\n", "invalid position index", 4 },
+	};
+
+	for (auto & c : cases) {
+		ObjReader reader;
+		CHECK(!reader.Read(c.text, c.text + strlen(c.text)));
+		CHECK(reader.GetError() && strcmp(reader.GetError(), c.error) == 0);
+		CHECK(reader.GetLine() == c.line);
+	}
+
+	// A failed read doesn't leave state behind for the next one
+	ObjReader reader;
+	CHECK(!Read(reader, "v 0 0 0\nf 1 1 2\n"));
+	CHECK(Read(reader, "v 0 0 0\nf 1 1 1\n"));
+	CHECK(reader.GetError() == NULL && reader.vertices.size() == 1);
+}
+
+// Every truncation of a valid document reads or fails without reading past it
+static void TestTruncation()
+{
+	std::string text = MakeObjSphere(3, 4, true);
+	for (size_t length = 0; length <= text.size(); length++) {
+		std::vector<char> buffer(text.begin(), text.begin() + length);
+		ObjReader reader;
+		const char * begin = buffer.empty() ? NULL : &buffer[0];
+		if (reader.Read(begin, begin + length)) {
+			for (UInt32 index : reader.indices)
+				CHECK(index < reader.vertices.size());
+		}
+	}
+}
+
+int main()
+{
+	TestAgainstReference();
+	TestFloats();
+	TestIndices();
+	TestErrors();
+	TestTruncation();
+	return TEST_MAIN_RESULT();
+}
@@ -0,0 +1,130 @@
+#include "PresetJson.h"
+#include "JsonWalk.h"
+#include "TestMeshes.h"
+
+#include <chrono>
+#include <cstdio>
+
+// Times PresetJsonParser against skipping the same document with the bare
+// JsonStreamReader, on generated presets laid out like WritePresetJson
+// output or on the presets given as arguments. Not run by ctest.
+
+static double Milliseconds(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Styled the way jsoncpp writes presets, sculpted hosts dominate the size
+static std::string MakePreset(UInt32 hosts, UInt32 vertices)
+{
+	UInt32 state = 7;
+	char line[160];
+	std::string text =
+		"{\n"
+		"   \"actor\" : {\n"
+		"      \"hairColor\" : 3813659,\n"
+		"      \"weight\" : 42.5\n"
+		"   },\n"
+		"   \"mods\" : [\n"
+		"      {\n"
+		"         \"index\" : 0,\n"
+		"         \"name\" : \"Skyrim.esm\"\n"
+		"      }\n"
+		"   ],\n"
+		"   \"morphs\" : {\n"
+		"      \"custom\" : [\n";
+
+	for (UInt32 i = 0; i < 64; i++) {
+		snprintf(line, sizeof(line),
+			"         {\n"
+			"            \"name\" : \"CustomMorph%u\",\n"
+			"            \"value\" : %.16g\n"
+			"         }%s\n", i, (double)(float)NextRandom(state), i + 1 < 64 ? "," : "");
+		text += line;
+	}
+
+	text += "      ],\n      \"sculpt\" : [\n";
+	for (UInt32 h = 0; h < hosts; h++) {
+		text += "         {\n            \"data\" : [\n";
+		for (UInt32 v = 0; v < vertices; v++) {
+			snprintf(line, sizeof(line), "               [ %u, %d, %d, %d ]%s\n", v,
+				(SInt32)(NextRandom(state) * 5000), (SInt32)(NextRandom(state) * 5000), (SInt32)(NextRandom(state) * 5000),
+				v + 1 < vertices ? "," : "");
+			text += line;
+		}
+		snprintf(line, sizeof(line),
+			"            ],\n"
+			"            \"host\" : \"Host%u.nif\",\n"
+			"            \"vertices\" : %u\n"
+			"         }%s\n", h, vertices, h + 1 < hosts ? "," : "");
+		text += line;
+	}
+
+	text +=
+		"      ],\n"
+		"      \"sculptDivisor\" : 10000\n"
+		"   },\n"
+		"   \"version\" : {\n"
+		"      \"formatVersion\" : 3,\n"
+		"      \"runtimeVersion\" : 151584896,\n"
+		"      \"signature\" : 1397770323,\n"
+		"      \"skseVersion\" : 16778880\n"
+		"   }\n"
+		"}\n";
+	return text;
+}
+
+static void Benchmark(const char * name, const std::string & text)
+{
+	const UInt32 runs = 5;
+	double best = 0.0, bestSkip = 0.0;
+	size_t sculpted = 0;
+	for (UInt32 i = 0; i < runs; i++) {
+		auto start = std::chrono::steady_clock::now();
+		PresetJsonParser parser;
+		if (!parser.Parse(text.data(), text.data() + text.size())) {
+			printf("%s: %s at offset %u\n", name, parser.GetError(), parser.GetOffset());
+			return;
+		}
+		double elapsed = Milliseconds(start);
+		if (i == 0 || elapsed < best)
+			best = elapsed;
+
+		sculpted = 0;
+		for (auto & host : parser.data.sculpt)
+			sculpted += host.vertices.size();
+
+		start = std::chrono::steady_clock::now();
+		JsonSkip(text.data(), text.data() + text.size());
+		elapsed = Milliseconds(start);
+		if (i == 0 || elapsed < bestSkip)
+			bestSkip = elapsed;
+	}
+
+	printf("%-24s %8.2f MB %9zu sculpted  parse %8.2f ms %7.1f MB/s  skip %8.2f ms  %5.2fx\n",
+		name, text.size() / 1048576.0, sculpted, best, text.size() / 1048.576 / best, bestSkip, best / bestSkip);
+}
+
+int main(int argc, char ** argv)
+{
+	if (argc > 1) {
+		for (int a = 1; a < argc; a++) {
+			std::string text;
+			if (!JsonReadFile(argv[a], text)) {
+				fprintf(stderr, "%s: could not read\n", argv[a]);
+				return 1;
+			}
+			Benchmark(argv[a], text);
+		}
+		return 0;
+	}
+
+	UInt32 sizes[][2] = { { 1, 200 }, { 4, 2000 }, { 8, 12000 }, { 32, 20000 } };
+	for (auto & size : sizes) {
+		char name[64];
+		snprintf(name, sizeof(name), "%u hosts x %u", size[0], size[1]);
+		Benchmark(name, MakePreset(size[0], size[1]));
+	}
+
+	return 0;
+}
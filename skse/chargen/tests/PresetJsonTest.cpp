@@ -0,0 +1,443 @@
+#include "PresetJson.h"
+#include "JsonWalk.h"
+#include "TestUtils.h"
+
+#include <cstring>
+
+int g_failures = 0;
+
+static std::string s_corpus;
+
+static bool Parse(PresetJsonParser & parser, const std::string & text)
+{
+	return parser.Parse(text.data(), text.data() + text.size());
+}
+
+static bool ReadCorpus(const char * name, std::string & text)
+{
+	if (JsonReadFile((s_corpus + "/" + name).c_str(), text))
+		return true;
+
+	fprintf(stderr, "%s/%s: could not read\n", s_corpus.c_str(), name);
+	g_failures++;
+	return false;
+}
+
+static void DescribeValues(const std::vector<PresetJsonData::Value> & values, std::string & out)
+{
+	for (auto & value : values) {
+		char text[64];
+		snprintf(text, sizeof(text), " (%u %d %d %d %.9g %d ", value.key, value.type, value.index, value.data.type, value.data.number, value.data.boolean);
+		out += text + value.data.string + ")";
+	}
+}
+
+// Every field of the parse in a comparable form
+static std::string Describe(const PresetJsonData & data)
+{
+	std::string out;
+	char text[128];
+	snprintf(text, sizeof(text), "%d %d %08X %u %.9g %u %d\n", data.hasVersion, data.hasMods, data.signature, data.formatVersion, data.weight, data.hairColor, data.sculptDivisor);
+	out += text;
+
+	for (auto & mod : data.mods) {
+		snprintf(text, sizeof(text), "mod %u ", mod.index);
+		out += text + mod.name + "\n";
+	}
+	for (auto & part : data.headParts) {
+		snprintf(text, sizeof(text), "part %u %08X\n", part.type, part.formId);
+		out += text;
+	}
+	for (auto & tint : data.tints) {
+		snprintf(text, sizeof(text), "tint %u %08X ", tint.index, tint.color);
+		out += text + tint.texture + "\n";
+	}
+	for (auto & texture : data.faceTextures) {
+		snprintf(text, sizeof(text), "texture %u ", texture.index);
+		out += text + texture.texture + "\n";
+	}
+	for (SInt32 preset : data.presets) {
+		snprintf(text, sizeof(text), "preset %d\n", preset);
+		out += text;
+	}
+	for (float morph : data.morphs) {
+		snprintf(text, sizeof(text), "morph %.9g\n", morph);
+		out += text;
+	}
+	for (auto & morph : data.customMorphs) {
+		snprintf(text, sizeof(text), " %.9g\n", morph.value);
+		out += "custom " + morph.name + text;
+	}
+	for (auto & host : data.sculpt) {
+		out += "sculpt " + host.host + "\n";
+		for (auto & vertex : host.vertices) {
+			snprintf(text, sizeof(text), " %u %d %d %d %.9g %.9g %.9g\n", vertex.index, vertex.fixed[0], vertex.fixed[1], vertex.fixed[2], vertex.value[0], vertex.value[1], vertex.value[2]);
+			out += text;
+		}
+	}
+	for (auto & transform : data.transforms) {
+		out += "transform " + transform.node + (transform.firstPerson ? " 1\n" : " 0\n");
+		for (auto & key : transform.keys) {
+			out += " key " + key.name;
+			DescribeValues(key.values, out);
+			out += "\n";
+		}
+	}
+	for (auto & entry : data.overrides) {
+		out += "override " + entry.node;
+		DescribeValues(entry.values, out);
+		out += "\n";
+	}
+	for (auto & skin : data.skinOverrides) {
+		snprintf(text, sizeof(text), "skin %d %08X", skin.firstPerson, skin.slotMask);
+		out += text;
+		DescribeValues(skin.values, out);
+		out += "\n";
+	}
+	for (auto & morph : data.bodyMorphs) {
+		snprintf(text, sizeof(text), " %d %.9g\n", morph.hasLegacy, morph.legacyValue);
+		out += "bodyMorph " + morph.name + text;
+		for (auto & key : morph.keys) {
+			snprintf(text, sizeof(text), " %.9g\n", key.value);
+			out += " key " + key.key + text;
+		}
+	}
+
+	return out;
+}
+
+static void TestPreset()
+{
+	std::string text;
+	if (!ReadCorpus("valid/preset.jslot", text))
+		return;
+
+	PresetJsonParser parser;
+	CHECK(Parse(parser, text));
+	CHECK(parser.GetError() == NULL);
+
+	const PresetJsonData & data = parser.data;
+	CHECK(data.hasVersion && data.hasMods);
+	CHECK(data.signature == 0x53504853 && data.formatVersion == 3);
+	CHECK(data.weight == 42.5f && data.hairColor == 3813659);
+	CHECK(data.mods.size() == 2 && data.mods[1].index == 1 && data.mods[1].name == "Update.esm");
+	CHECK(data.headParts.size() == 2 && data.headParts[1].type == 3 && data.headParts[1].formId == 0x01000304);
+	CHECK(data.tints.size() == 1 && data.tints[0].color == 0x55FFFFFF);
+	CHECK(data.tints[0].texture == "Actors\\Character\\Character Assets\\TintMasks\\SkinTone.dds");
+	CHECK(data.faceTextures.size() == 2 && data.faceTextures[1].index == 1);
+	CHECK(data.presets == std::vector<SInt32>({ -1, 3, 0, 7 }));
+	CHECK(data.morphs.size() == 10 && data.morphs[0] == -0.34f && data.morphs[4] == -1.0f);
+	CHECK(data.customMorphs.size() == 2 && data.customMorphs[0].name == "BrowsHeight" && data.customMorphs[0].value == -0.25f);
+
+	CHECK(data.sculptDivisor == 10000);
+	CHECK(data.sculpt.size() == 1 && data.sculpt[0].host == "FemaleHead.nif");
+	if (data.sculpt.size() == 1) {
+		auto & vertices = data.sculpt[0].vertices;
+		CHECK(vertices.size() == 3);
+		CHECK(vertices[2].index == 14 && vertices[2].fixed[0] == -4210 && vertices[2].fixed[1] == 220 && vertices[2].fixed[2] == 18);
+	}
+
+	CHECK(data.transforms.size() == 1 && data.transforms[0].node == "NPC Spine2 [Spn2]" && !data.transforms[0].firstPerson);
+	if (data.transforms.size() == 1) {
+		auto & keys = data.transforms[0].keys;
+		CHECK(keys.size() == 1 && keys[0].name == "RSMPlugin" && keys[0].values.size() == 2);
+		if (keys.size() == 1 && keys[0].values.size() == 2) {
+			auto & scale = keys[0].values[0];
+			CHECK(scale.key == 20 && scale.type == 4 && scale.index == 0 && scale.data.AsFloat() == 1.1f);
+			CHECK(keys[0].values[1].data.type == JsonStreamValue::kType_Bool && keys[0].values[1].data.AsBool());
+		}
+	}
+
+	CHECK(data.overrides.size() == 1 && data.overrides[0].node == "NPC Head [Head]");
+	if (data.overrides.size() == 1) {
+		auto & values = data.overrides[0].values;
+		CHECK(values.size() == 2 && values[0].index == -1 && values[0].data.AsInt() == 0xFF0000);
+		CHECK(values.size() == 2 && values[1].data.AsString() == "textures\\actors\\character\\overlays\\default.dds");
+	}
+
+	CHECK(data.skinOverrides.size() == 1 && data.skinOverrides[0].slotMask == 4 && data.skinOverrides[0].values.size() == 1);
+	CHECK(data.bodyMorphs.size() == 1 && data.bodyMorphs[0].name == "Breasts" && !data.bodyMorphs[0].hasLegacy);
+	CHECK(data.bodyMorphs.size() == 1 && data.bodyMorphs[0].keys.size() == 1 && data.bodyMorphs[0].keys[0].value == 0.65f);
+}
+
+static void TestMalePreset()
+{
+	std::string text;
+	if (!ReadCorpus("valid/preset_male.jslot", text))
+		return;
+
+	PresetJsonParser parser;
+	CHECK(Parse(parser, text));
+
+	const PresetJsonData & data = parser.data;
+	CHECK(data.mods.size() == 3 && data.headParts.size() == 4);
+	CHECK(data.headParts[2].formId >> 24 == 2 && data.mods[2].name == "Dawnguard.esm");
+	CHECK(data.morphs.size() == 19 && data.presets.size() == 4 && data.presets[2] == -1);
+	CHECK(data.sculpt.size() == 2);
+	if (data.sculpt.size() == 2) {
+		CHECK(data.sculpt[0].host == "MaleHead.nif" && data.sculpt[0].vertices.size() == 24);
+		CHECK(data.sculpt[1].host == "MaleHeadEyebrows.nif" && data.sculpt[1].vertices.size() == 6);
+		auto & vertex = data.sculpt[1].vertices[5];
+		CHECK(vertex.index == 81 && vertex.fixed[0] == 521 && vertex.fixed[1] == 4388 && vertex.fixed[2] == -616);
+	}
+
+	// Keys with empty values are kept, Finish drops them
+	CHECK(data.transforms.size() == 2 && data.transforms[0].keys.size() == 2 && data.transforms[0].keys[1].values.empty());
+	CHECK(data.transforms.size() == 2 && data.transforms[1].firstPerson);
+	CHECK(data.overrides.size() == 2 && data.overrides[0].values.size() == 4);
+	CHECK(data.skinOverrides.size() == 2 && data.skinOverrides[1].firstPerson && data.skinOverrides[1].slotMask == 8);
+
+	// Keys of mods outside the load order are filtered by Finish, not here
+	CHECK(data.bodyMorphs.size() == 2 && data.bodyMorphs[0].keys.size() == 2 && data.bodyMorphs[0].keys[1].key == "Unknown Mod.esp");
+}
+
+static void TestLegacyPreset()
+{
+	std::string text;
+	if (!ReadCorpus("valid/preset_legacy.jslot", text))
+		return;
+
+	PresetJsonParser parser;
+	CHECK(Parse(parser, text));
+
+	const PresetJsonData & data = parser.data;
+	CHECK(data.formatVersion == 2);
+	CHECK(data.presets == std::vector<SInt32>({ -1, 1, -1, 0 }));
+	CHECK(data.faceTextures.empty() && data.customMorphs.empty() && data.tints.empty());
+
+	// Without a divisor the sculpt offsets are the floats as written
+	CHECK(data.sculptDivisor == -1);
+	CHECK(data.sculpt.size() == 1 && data.sculpt[0].vertices.size() == 2);
+	if (data.sculpt.size() == 1 && data.sculpt[0].vertices.size() == 2) {
+		auto & vertex = data.sculpt[0].vertices[0];
+		CHECK(vertex.value[0] == 0.0105f && vertex.value[1] == -0.0003f && vertex.value[2] == 0.0027f);
+		CHECK(data.sculpt[0].vertices[1].value[2] == -1.5f);
+	}
+
+	CHECK(data.bodyMorphs.size() == 2);
+	if (data.bodyMorphs.size() == 2) {
+		CHECK(data.bodyMorphs[0].hasLegacy && data.bodyMorphs[0].legacyValue == 0.5f && data.bodyMorphs[0].keys.empty());
+		CHECK(!data.bodyMorphs[1].hasLegacy);
+	}
+
+	// Minimal presets parse, the missing mods header is for Finish to reject
+	PresetJsonParser minimal;
+	CHECK(ReadCorpus("valid/preset_minimal.jslot", text) && Parse(minimal, text));
+	CHECK(minimal.data.hasVersion && !minimal.data.hasMods && minimal.data.sculptDivisor == 10000);
+}
+
+// Binary presets hand over their sections one document at a time or back
+// to back, any split of the members parses to the same data
+static void TestSections()
+{
+	std::string text;
+	if (!ReadCorpus("valid/preset_male.jslot", text))
+		return;
+
+	PresetJsonParser whole;
+	CHECK(Parse(whole, text));
+	std::string expected = Describe(whole.data);
+
+	std::vector<std::string> sections;
+	JsonStreamReader reader(text.data(), text.data() + text.size());
+	std::string name;
+	CHECK(reader.BeginObject());
+	while (reader.NextMember(name)) {
+		UInt32 start = reader.GetOffset();
+		CHECK(reader.Skip());
+		sections.push_back("{ \"" + name + "\" : " + text.substr(start, reader.GetOffset() - start) + " }");
+	}
+	CHECK(sections.size() == 11);
+
+	std::string joined;
+	PresetJsonParser separate;
+	for (size_t i = sections.size(); i-- > 0;) {
+		CHECK(Parse(separate, sections[i]));
+		joined += sections[i] + "\n";
+	}
+	CHECK(Describe(separate.data) == expected);
+
+	PresetJsonParser backToBack;
+	CHECK(Parse(backToBack, "\xEF\xBB\xBF" + joined));
+	CHECK(Describe(backToBack.data) == expected);
+
+	// Parsing the same preset again adds to what is there until cleared
+	CHECK(Parse(whole, text));
+	CHECK(whole.data.sculpt.size() == 4 && whole.data.mods.size() == 6);
+	whole.Clear();
+	CHECK(Parse(whole, text) && Describe(whole.data) == expected);
+}
+
+// Members of the wrong type are skipped the way the tree reader ignored them
+static void TestWrongTypes()
+{
+	PresetJsonParser parser;
+	CHECK(Parse(parser,
+		"{ \"mods\" : 5, \"headParts\" : { \"type\" : 1 }, \"actor\" : [ 1 ],"
+		"  \"tintInfo\" : [ 1, { \"index\" : 2, \"extra\" : [ 3 ] } ],"
+		"  \"morphs\" : { \"sculptDivisor\" : null, \"default\" : { \"presets\" : [ 255, \"x\" ], \"morphs\" : 1 },"
+		"    \"sculpt\" : [ 7, { \"host\" : \"Head.nif\", \"data\" : [ 3, [ 9, 1, 2, 3, 4 ] ] } ] },"
+		"  \"overrides\" : [ { \"node\" : \"Face\", \"values\" : [ { \"type\" : 2, \"key\" : 9 }, null ] } ],"
+		"  \"unknown\" : { \"a\" : [ ] } }"));
+
+	const PresetJsonData & data = parser.data;
+	CHECK(data.hasMods && data.mods.empty());
+	CHECK(data.headParts.empty() && data.weight == 0.0f);
+	CHECK(data.tints.size() == 1 && data.tints[0].index == 2);
+	CHECK(data.sculptDivisor == -1);
+	CHECK(data.presets == std::vector<SInt32>({ -1, 0 }) && data.morphs.empty());
+	CHECK(data.sculpt.size() == 2 && data.sculpt[0].host.empty() && data.sculpt[0].vertices.empty());
+	if (data.sculpt.size() == 2) {
+		auto & vertices = data.sculpt[1].vertices;
+		CHECK(data.sculpt[1].host == "Head.nif" && vertices.size() == 2);
+		CHECK(vertices.size() == 2 && vertices[0].index == 0 && vertices[0].fixed[2] == 0);
+		CHECK(vertices.size() == 2 && vertices[1].index == 9 && vertices[1].fixed[0] == 1 && vertices[1].fixed[2] == 3);
+	}
+	CHECK(data.overrides.size() == 1 && data.overrides[0].values.size() == 1);
+	CHECK(data.overrides.size() == 1 && data.overrides[0].values[0].key == 9 && data.overrides[0].values[0].data.IsNull());
+
+	PresetJsonParser nullMods;
+	CHECK(Parse(nullMods, "{ \"mods\" : null, \"version\" : { } }"));
+	CHECK(!nullMods.data.hasMods && !nullMods.data.hasVersion);
+}
+
+static void TestErrors()
+{
+	PresetJsonParser parser;
+	CHECK(!Parse(parser, "[ ]"));
+	CHECK(parser.GetError() && strcmp(parser.GetError(), "preset root is not an object") == 0);
+	CHECK(parser.GetOffset() == 3);
+
+	CHECK(!Parse(parser, "{ \"mods\" : [ { \"index\" : 0, \"name\" : \"Skyrim.esm\" } "));
+	CHECK(parser.GetError() != NULL);
+
+	CHECK(!Parse(parser, "{ \"morphs\" : { \"sculpt\" : [ { \"data\" : [ [ 1, 2, 3, 4 ], [ 1, 2 3 ] ] } ] } }"));
+	CHECK(parser.GetError() && parser.GetOffset() == 64);
+
+	std::string text;
+	if (ReadCorpus("invalid/truncated_preset.jslot", text)) {
+		CHECK(!Parse(parser, text));
+		CHECK(parser.GetError() && parser.GetOffset() <= text.size());
+	}
+
+	// An error doesn't stop the parser from taking the next preset once cleared
+	parser.Clear();
+	CHECK(Parse(parser, "{ \"actor\" : { \"weight\" : 12 } }") && parser.data.weight == 12.0f && parser.GetError() == NULL);
+}
+
+// Every truncation of a preset parses or fails inside the document, and
+// every one that parses is a prefix of the full parse
+static void TestTruncation()
+{
+	std::string text;
+	if (!ReadCorpus("valid/preset.jslot", text))
+		return;
+
+	for (size_t length = 0; length < text.size(); length++) {
+		std::vector<char> buffer(text.begin(), text.begin() + length);
+		const char * begin = buffer.empty() ? NULL : &buffer[0];
+		PresetJsonParser parser;
+		if (!parser.Parse(begin, begin + length))
+			CHECK(parser.GetError() && parser.GetOffset() <= length);
+		else
+			CHECK(text.find_first_not_of(" \t\r\n", length) == std::string::npos || length == 0);
+	}
+}
+
+// The slider and sculpt parts of a preset, what the packed sections carry
+static PresetJsonData PackedPart(const PresetJsonData & data)
+{
+	PresetJsonData part;
+	part.presets = data.presets;
+	part.morphs = data.morphs;
+	part.customMorphs = data.customMorphs;
+	part.bodyMorphs = data.bodyMorphs;
+	part.sculptDivisor = data.sculptDivisor;
+	part.sculpt = data.sculpt;
+	return part;
+}
+
+// Packed sections read back to what the json parsed to, and any truncation
+// or extra byte fails
+static void TestBinarySections()
+{
+	const char * names[] = { "valid/preset.jslot", "valid/preset_male.jslot", "valid/preset_legacy.jslot", "valid/preset_minimal.jslot" };
+	for (auto name : names) {
+		std::string text;
+		if (!ReadCorpus(name, text))
+			continue;
+
+		PresetJsonParser parser;
+		CHECK(Parse(parser, text));
+		std::string expected = Describe(PackedPart(parser.data));
+
+		std::string sliders, sculpt;
+		PresetBinaryCodec::WriteSliders(parser.data, sliders);
+		PresetBinaryCodec::WriteSculpt(parser.data, sculpt);
+
+		PresetJsonData data;
+		CHECK(PresetBinaryCodec::ReadSculpt(sculpt.data(), sculpt.data() + sculpt.size(), data));
+		CHECK(PresetBinaryCodec::ReadSliders(sliders.data(), sliders.data() + sliders.size(), data));
+		CHECK(Describe(data) == expected);
+
+		std::string * sections[] = { &sliders, &sculpt };
+		for (auto section : sections) {
+			for (size_t length = 0; length < section->size(); length++) {
+				std::vector<char> buffer(section->begin(), section->begin() + length);
+				const char * begin = buffer.empty() ? NULL : &buffer[0];
+				PresetJsonData truncated;
+				bool result = section == &sliders ? PresetBinaryCodec::ReadSliders(begin, begin + length, truncated) : PresetBinaryCodec::ReadSculpt(begin, begin + length, truncated);
+				CHECK(!result);
+			}
+
+			std::string extra = *section + '\0';
+			PresetJsonData trailing;
+			bool result = section == &sliders ? PresetBinaryCodec::ReadSliders(extra.data(), extra.data() + extra.size(), trailing) : PresetBinaryCodec::ReadSculpt(extra.data(), extra.data() + extra.size(), trailing);
+			CHECK(!result);
+		}
+	}
+
+	// A corrupt count runs out of bytes instead of allocating for it
+	std::string sliders;
+	PresetBinaryCodec::WriteSliders(PresetJsonData(), sliders);
+	CHECK(sliders.size() == 16);
+	memset(&sliders[0], 0xFF, 4);
+	PresetJsonData data;
+	CHECK(!PresetBinaryCodec::ReadSliders(sliders.data(), sliders.data() + sliders.size(), data));
+	CHECK(data.presets.size() == 3);
+
+	// Float offsets out of range clamp like the json parser's
+	PresetJsonData floats;
+	PresetJsonData::SculptVertex vertex = { 7, { 0, 0, 0 }, { 3e9f, -3e9f, -2.5f } };
+	floats.sculpt.push_back(PresetJsonData::SculptHost());
+	floats.sculpt[0].vertices.push_back(vertex);
+	std::string sculpt;
+	PresetBinaryCodec::WriteSculpt(floats, sculpt);
+	PresetJsonData decoded;
+	CHECK(PresetBinaryCodec::ReadSculpt(sculpt.data(), sculpt.data() + sculpt.size(), decoded));
+	CHECK(decoded.sculptDivisor == -1 && decoded.sculpt.size() == 1 && decoded.sculpt[0].vertices.size() == 1);
+	if (decoded.sculpt.size() == 1 && decoded.sculpt[0].vertices.size() == 1) {
+		auto & result = decoded.sculpt[0].vertices[0];
+		CHECK(result.index == 7 && result.value[0] == 3e9f && result.value[2] == -2.5f);
+		CHECK(result.fixed[0] == 0x7FFFFFFF && result.fixed[1] == (SInt32)0x80000000 && result.fixed[2] == -2);
+	}
+}
+
+int main(int argc, char ** argv)
+{
+	if (argc < 2) {
+		fprintf(stderr, "usage: %s corpus\n", argv[0]);
+		return 1;
+	}
+
+	s_corpus = argv[1];
+	TestPreset();
+	TestMalePreset();
+	TestLegacyPreset();
+	TestSections();
+	TestWrongTypes();
+	TestErrors();
+	TestTruncation();
+	TestBinarySections();
+	return TEST_MAIN_RESULT();
+}
@@ -0,0 +1,193 @@
+#include "CDXSmooth.h"
+#include "TestMeshes.h"
+#include "TestUtils.h"
+
+#include <algorithm>
+#include <thread>
+
+int g_failures = 0;
+
+static TestMesh MakeNoisySphere(UInt32 & state)
+{
+	TestMesh mesh = MakeSphere(4);
+	for (auto & v : mesh.vertices) {
+		float scale = 1.0f + NextRandom(state) * 0.05f;
+		for (UInt32 k = 0; k < 3; k++)
+			v.position[k] *= scale;
+	}
+	return mesh;
+}
+
+static CDXHitIndexList MakeHits(UInt32 vertexCount, UInt32 & state)
+{
+	CDXHitIndexList hits;
+	for (UInt32 i = 0; i < vertexCount; i += 1 + (i % 3))
+		hits.push_back(std::make_pair((CDXMeshIndex)i, NextRandom(state) * 0.5f + 0.5f));
+	return hits;
+}
+
+// Split the hits into contiguous ranges, one thread each
+static std::vector<float> SmoothThreaded(const CDXMeshTopology & topology, TestMesh & mesh, const CDXHitIndexList & hits, float strength, UInt32 threadCount)
+{
+	std::vector<float> offsets(hits.size() * 3, -1.0f);
+	std::vector<std::thread> threads;
+	size_t block = (hits.size() + threadCount - 1) / threadCount;
+	for (UInt32 t = 0; t < threadCount; t++) {
+		size_t begin = std::min(hits.size(), t * block);
+		size_t end = std::min(hits.size(), begin + block);
+		threads.push_back(std::thread([&, begin, end]()
+		{
+			CDXSmoothHits(topology, mesh.Positions(), TestMesh::kStride, hits, begin, end, strength, offsets.data());
+		}));
+	}
+
+	for (auto & thread : threads)
+		thread.join();
+
+	return offsets;
+}
+
+// Same result bit for bit however the hits are split
+static void TestDeterminism()
+{
+	UInt32 state = 99;
+	TestMesh mesh = MakeNoisySphere(state);
+	CDXMeshTopology topology;
+	topology.Build(mesh.faces.data(), mesh.faces.size(), mesh.vertices.size());
+	CDXHitIndexList hits = MakeHits(mesh.vertices.size(), state);
+
+	std::vector<float> serial(hits.size() * 3);
+	CDXSmoothHits(topology, mesh.Positions(), TestMesh::kStride, hits, 0, hits.size(), 0.7f, serial.data());
+
+	UInt32 threadCounts[] = { 1, 2, 3, 4, 7, 16 };
+	for (auto threadCount : threadCounts) {
+		std::vector<float> threaded = SmoothThreaded(topology, mesh, hits, 0.7f, threadCount);
+		CHECK(threaded == serial);
+	}
+
+	// Interleaved single hits, in reverse
+	std::vector<float> reversed(hits.size() * 3);
+	for (size_t h = hits.size(); h-- > 0;)
+		CDXSmoothHits(topology, mesh.Positions(), TestMesh::kStride, hits, h, h + 1, 0.7f, reversed.data());
+	CHECK(reversed == serial);
+}
+
+// Matches the centroid average worked out directly from the faces
+static void TestReference()
+{
+	UInt32 state = 7;
+	TestMesh mesh = MakeNoisySphere(state);
+	CDXMeshTopology topology;
+	topology.Build(mesh.faces.data(), mesh.faces.size(), mesh.vertices.size());
+	CDXHitIndexList hits = MakeHits(mesh.vertices.size(), state);
+
+	std::vector<float> offsets(hits.size() * 3);
+	CDXSmoothHits(topology, mesh.Positions(), TestMesh::kStride, hits, 0, hits.size(), 0.5f, offsets.data());
+
+	for (size_t h = 0; h < hits.size(); h++) {
+		CDXMeshIndex i = hits[h].first;
+		double target[3] = { 0, 0, 0 };
+		UInt32 count = 0;
+		for (auto & face : mesh.faces) {
+			if (face.v1 != i && face.v2 != i && face.v3 != i)
+				continue;
+
+			for (UInt32 k = 0; k < 3; k++)
+				target[k] += (mesh.vertices[face.v1].position[k] + mesh.vertices[face.v2].position[k] + mesh.vertices[face.v3].position[k]) / 3.0;
+			count++;
+		}
+
+		CHECK(count > 0);
+		for (UInt32 k = 0; k < 3; k++) {
+			double expected = (target[k] / count - mesh.vertices[i].position[k]) * 0.5 * hits[h].second;
+			CHECK_NEAR(offsets[h * 3 + k], expected, 1e-6);
+		}
+	}
+}
+
+// Interior vertices of a regular grid are already at their centroid average,
+// smoothing never leaves the plane
+static void TestFlatGrid()
+{
+	TestMesh mesh = MakeGrid(6, 6, 1.0f);
+	CDXMeshTopology topology;
+	topology.Build(mesh.faces.data(), mesh.faces.size(), mesh.vertices.size());
+
+	for (UInt32 i = 0; i < mesh.vertices.size(); i++) {
+		float offset[3];
+		CDXSmoothVertex(topology, mesh.Positions(), TestMesh::kStride, i, 1.0f, 1.0f, offset);
+		CHECK(offset[2] == 0.0f);
+		if (!topology.IsEdgeVertex(i)) {
+			CHECK_NEAR(offset[0], 0.0, 1e-6);
+			CHECK_NEAR(offset[1], 0.0, 1e-6);
+		}
+	}
+}
+
+// No faces, no strength or no falloff leave the vertex where it is
+static void TestZeroWeight()
+{
+	TestMesh mesh = MakeGrid(2, 2, 1.0f);
+	CDXMeshIndex loose = mesh.AddVertex(4, 4, 4);
+	mesh.vertices[4].position[2] = 1.0f;
+
+	CDXMeshTopology topology;
+	topology.Build(mesh.faces.data(), mesh.faces.size(), mesh.vertices.size());
+
+	float offset[3] = { 1, 1, 1 };
+	CDXSmoothVertex(topology, mesh.Positions(), TestMesh::kStride, loose, 1.0f, 1.0f, offset);
+	CHECK(offset[0] == 0.0f && offset[1] == 0.0f && offset[2] == 0.0f);
+
+	CDXSmoothVertex(topology, mesh.Positions(), TestMesh::kStride, 4, 0.0f, 1.0f, offset);
+	CHECK(offset[2] == 0.0f);
+	CDXSmoothVertex(topology, mesh.Positions(), TestMesh::kStride, 4, 1.0f, 0.0f, offset);
+	CHECK(offset[2] == 0.0f);
+	CDXSmoothVertex(topology, mesh.Positions(), TestMesh::kStride, 4, 1.0f, 1.0f, offset);
+	CHECK(offset[2] < 0.0f);
+}
+
+// Repeated full strength passes pull a noisy sphere towards a smooth one
+static void TestConvergence()
+{
+	UInt32 state = 3;
+	TestMesh mesh = MakeNoisySphere(state);
+	CDXMeshTopology topology;
+	topology.Build(mesh.faces.data(), mesh.faces.size(), mesh.vertices.size());
+
+	CDXHitIndexList hits;
+	for (UInt32 i = 0; i < mesh.vertices.size(); i++)
+		hits.push_back(std::make_pair((CDXMeshIndex)i, 1.0f));
+
+	auto roughness = [&]()
+	{
+		double total = 0.0;
+		for (UInt32 i = 0; i < mesh.vertices.size(); i++) {
+			float offset[3];
+			CDXSmoothVertex(topology, mesh.Positions(), TestMesh::kStride, i, 1.0f, 1.0f, offset);
+			total += sqrt(offset[0] * offset[0] + offset[1] * offset[1] + offset[2] * offset[2]);
+		}
+		return total;
+	};
+
+	double before = roughness();
+	std::vector<float> offsets(hits.size() * 3);
+	for (UInt32 pass = 0; pass < 3; pass++) {
+		CDXSmoothHits(topology, mesh.Positions(), TestMesh::kStride, hits, 0, hits.size(), 1.0f, offsets.data());
+		for (size_t h = 0; h < hits.size(); h++) {
+			for (UInt32 k = 0; k < 3; k++)
+				mesh.vertices[hits[h].first].position[k] += offsets[h * 3 + k];
+		}
+	}
+
+	CHECK(roughness() < before * 0.5);
+}
+
+int main()
+{
+	TestDeterminism();
+	TestReference();
+	TestFlatGrid();
+	TestZeroWeight();
+	TestConvergence();
+	return TEST_MAIN_RESULT();
+}
@@ -0,0 +1,163 @@
+#include "CDXSpatialHash.h"
+#include "TestMeshes.h"
+#include "TestUtils.h"
+
+#include <algorithm>
+
+int g_failures = 0;
+
+static bool Within(const float * position, const float * center, float radius)
+{
+	float dx = position[0] - center[0];
+	float dy = position[1] - center[1];
+	float dz = position[2] - center[2];
+	return dx * dx + dy * dy + dz * dz <= radius * radius;
+}
+
+// The hash only hands out candidates, after the distance test they have to
+// be exactly the vertices a scan over all of them finds. No vertex may be
+// visited twice.
+static void CompareQuery(TestMesh & mesh, const CDXSpatialHash & hash, const float * center, float radius)
+{
+	std::vector<CDXMeshIndex> visited;
+	hash.Visit(center, radius, [&](CDXMeshIndex i)
+	{
+		visited.push_back(i);
+	});
+
+	std::sort(visited.begin(), visited.end());
+	CHECK(std::adjacent_find(visited.begin(), visited.end()) == visited.end());
+
+	std::vector<CDXMeshIndex> found;
+	for (auto i : visited) {
+		CHECK(i < mesh.vertices.size());
+		if (i < mesh.vertices.size() && Within(mesh.vertices[i].position, center, radius))
+			found.push_back(i);
+	}
+
+	std::vector<CDXMeshIndex> expected;
+	for (UInt32 i = 0; i < mesh.vertices.size(); i++) {
+		if (Within(mesh.vertices[i].position, center, radius))
+			expected.push_back((CDXMeshIndex)i);
+	}
+
+	CHECK(found == expected);
+}
+
+static void CompareQueries(TestMesh & mesh, const CDXSpatialHash & hash, UInt32 queries, float scale, UInt32 & state)
+{
+	for (UInt32 q = 0; q < queries; q++) {
+		float center[3] = { NextRandom(state) * scale, NextRandom(state) * scale, NextRandom(state) * scale };
+		// Mostly brush sized, now and then covering everything
+		float radius = (NextRandom(state) + 1.0f) * 0.1f * scale;
+		if (q % 10 == 0)
+			radius *= 20.0f;
+		CompareQuery(mesh, hash, center, radius);
+	}
+}
+
+static TestMesh MakeCloud(UInt32 count, float scale, UInt32 & state)
+{
+	TestMesh mesh;
+	for (UInt32 i = 0; i < count; i++)
+		mesh.AddVertex(NextRandom(state) * scale, NextRandom(state) * scale, NextRandom(state) * scale);
+	return mesh;
+}
+
+static void TestRandomClouds()
+{
+	UInt32 state = 31;
+	float scales[] = { 0.01f, 1.0f, 250.0f };
+	for (auto scale : scales) {
+		for (UInt32 count = 1; count <= 4000; count *= 7) {
+			TestMesh mesh = MakeCloud(count, scale, state);
+			CDXSpatialHash hash;
+			hash.Build(mesh.Positions(), TestMesh::kStride, mesh.vertices.size());
+			CHECK(!hash.IsEmpty());
+			CompareQueries(mesh, hash, 50, scale, state);
+		}
+	}
+}
+
+// Surface meshes, including a flat one whose extent is zero along z
+static void TestSurfaces()
+{
+	UInt32 state = 37;
+	TestMesh meshes[] = { MakeSphere(3), MakeGrid(40, 30, 0.05f), MakeRoof(20, 20, true) };
+	for (auto & mesh : meshes) {
+		CDXSpatialHash hash;
+		hash.Build(mesh.Positions(), TestMesh::kStride, mesh.vertices.size());
+		CompareQueries(mesh, hash, 200, 1.5f, state);
+
+		// Queries centered on vertices, where the brush usually lands
+		for (UInt32 q = 0; q < 100; q++) {
+			UInt32 i = (UInt32)((NextRandom(state) + 1.0f) * 0.5f * mesh.vertices.size()) % mesh.vertices.size();
+			CompareQuery(mesh, hash, mesh.vertices[i].position, 0.15f);
+		}
+	}
+}
+
+// Every vertex at the same point leaves nothing to size cells from
+static void TestDegenerate()
+{
+	TestMesh mesh;
+	for (UInt32 i = 0; i < 100; i++)
+		mesh.AddVertex(3.0f, -2.0f, 0.5f);
+
+	CDXSpatialHash hash;
+	hash.Build(mesh.Positions(), TestMesh::kStride, mesh.vertices.size());
+	float center[3] = { 3.0f, -2.0f, 0.5f };
+	CompareQuery(mesh, hash, center, 0.0f);
+	CompareQuery(mesh, hash, center, 1.0f);
+	float away[3] = { 30.0f, -2.0f, 0.5f };
+	CompareQuery(mesh, hash, away, 1.0f);
+
+	// Far outside the clamped cell range
+	float far[3] = { 1e30f, -1e30f, 1e30f };
+	CompareQuery(mesh, hash, far, 1.0f);
+
+	hash.Build(mesh.Positions(), TestMesh::kStride, 0);
+	CHECK(hash.IsEmpty());
+	UInt32 visits = 0;
+	hash.Visit(center, 1.0f, [&](CDXMeshIndex)
+	{
+		visits++;
+	});
+	CHECK(visits == 0);
+}
+
+// Moved vertices are found at their new position and nowhere else,
+// including moves far outside the bounds the hash was built with
+static void TestUpdate()
+{
+	UInt32 state = 41;
+	TestMesh mesh = MakeSphere(3);
+	CDXSpatialHash hash;
+	hash.Build(mesh.Positions(), TestMesh::kStride, mesh.vertices.size());
+
+	for (UInt32 step = 0; step < 20; step++) {
+		float amount = step < 10 ? 0.05f : 2.0f;
+		for (UInt32 n = 0; n < 100; n++) {
+			CDXMeshIndex i = (CDXMeshIndex)((UInt32)((NextRandom(state) + 1.0f) * 0.5f * mesh.vertices.size()) % mesh.vertices.size());
+			float * position = mesh.vertices[i].position;
+			for (UInt32 k = 0; k < 3; k++)
+				position[k] += NextRandom(state) * amount;
+			hash.Update(i, position);
+		}
+		CompareQueries(mesh, hash, 50, 1.5f + (step < 10 ? 0.0f : 2.0f), state);
+	}
+
+	// Out of range indices are ignored
+	float position[3] = { 0, 0, 0 };
+	hash.Update((CDXMeshIndex)mesh.vertices.size(), position);
+	CompareQueries(mesh, hash, 20, 1.5f, state);
+}
+
+int main()
+{
+	TestRandomClouds();
+	TestSurfaces();
+	TestDegenerate();
+	TestUpdate();
+	return TEST_MAIN_RESULT();
+}
@@ -0,0 +1,130 @@
+#include "TestMeshes.h"
+
+#include <cmath>
+#include <map>
+
+CDXMeshIndex TestMesh::AddVertex(float x, float y, float z)
+{
+	TestVertex vertex = { { x, y, z }, { 0, 0, 0 }, { 0, 0 }, 0xFFFFFFFF };
+	vertices.push_back(vertex);
+	return (CDXMeshIndex)(vertices.size() - 1);
+}
+
+TestMesh MakeGrid(UInt32 columns, UInt32 rows, float spacing)
+{
+	TestMesh mesh;
+	for (UInt32 y = 0; y <= rows; y++) {
+		for (UInt32 x = 0; x <= columns; x++)
+			mesh.AddVertex(x * spacing, y * spacing, 0.0f);
+	}
+
+	for (UInt32 y = 0; y < rows; y++) {
+		for (UInt32 x = 0; x < columns; x++) {
+			CDXMeshIndex a = y * (columns + 1) + x;
+			CDXMeshIndex b = a + 1;
+			CDXMeshIndex d = a + columns + 1;
+			CDXMeshIndex c = d + 1;
+			mesh.faces.push_back(CDXMeshFace(a, b, c));
+			mesh.faces.push_back(CDXMeshFace(a, c, d));
+		}
+	}
+
+	return mesh;
+}
+
+TestMesh MakeRoof(UInt32 columns, UInt32 rows, bool split)
+{
+	TestMesh mesh;
+
+	// Left half runs x = -columns..0, right half 0..columns, z falls off the ridge
+	std::vector<CDXMeshIndex> left((columns + 1) * (rows + 1)), right((columns + 1) * (rows + 1));
+	for (UInt32 y = 0; y <= rows; y++) {
+		for (UInt32 x = 0; x <= columns; x++)
+			left[y * (columns + 1) + x] = mesh.AddVertex((float)x - columns, (float)y, (float)x * 0.5f);
+		for (UInt32 x = 0; x <= columns; x++) {
+			if (x == 0 && !split)
+				right[y * (columns + 1)] = left[y * (columns + 1) + columns];
+			else
+				right[y * (columns + 1) + x] = mesh.AddVertex((float)x, (float)y, (float)(columns - x) * 0.5f);
+		}
+	}
+
+	for (auto * half : { &left, &right }) {
+		for (UInt32 y = 0; y < rows; y++) {
+			for (UInt32 x = 0; x < columns; x++) {
+				CDXMeshIndex a = (*half)[y * (columns + 1) + x];
+				CDXMeshIndex b = (*half)[y * (columns + 1) + x + 1];
+				CDXMeshIndex d = (*half)[(y + 1) * (columns + 1) + x];
+				CDXMeshIndex c = (*half)[(y + 1) * (columns + 1) + x + 1];
+				mesh.faces.push_back(CDXMeshFace(a, b, c));
+				mesh.faces.push_back(CDXMeshFace(a, c, d));
+			}
+		}
+	}
+
+	return mesh;
+}
+
+static CDXMeshIndex Midpoint(TestMesh & mesh, std::map<std::pair<CDXMeshIndex, CDXMeshIndex>, CDXMeshIndex> & cache, CDXMeshIndex a, CDXMeshIndex b)
+{
+	auto key = a < b ? std::make_pair(a, b) : std::make_pair(b, a);
+	auto it = cache.find(key);
+	if (it != cache.end())
+		return it->second;
+
+	const float * pa = mesh.vertices[a].position;
+	const float * pb = mesh.vertices[b].position;
+	float m[3] = { (pa[0] + pb[0]) * 0.5f, (pa[1] + pb[1]) * 0.5f, (pa[2] + pb[2]) * 0.5f };
+	float length = sqrtf(m[0] * m[0] + m[1] * m[1] + m[2] * m[2]);
+
+	CDXMeshIndex index = mesh.AddVertex(m[0] / length, m[1] / length, m[2] / length);
+	cache.emplace(key, index);
+	return index;
+}
+
+TestMesh MakeSphere(UInt32 subdivisions)
+{
+	TestMesh mesh;
+
+	float t = (1.0f + sqrtf(5.0f)) / 2.0f;
+	float s = sqrtf(1.0f + t * t);
+	float corners[12][3] = {
+		{ -1, t, 0 }, { 1, t, 0 }, { -1, -t, 0 }, { 1, -t, 0 },
+		{ 0, -1, t }, { 0, 1, t }, { 0, -1, -t }, { 0, 1, -t },
+		{ t, 0, -1 }, { t, 0, 1 }, { -t, 0, -1 }, { -t, 0, 1 }
+	};
+	for (auto & c : corners)
+		mesh.AddVertex(c[0] / s, c[1] / s, c[2] / s);
+
+	CDXMeshIndex faces[20][3] = {
+		{ 0, 11, 5 }, { 0, 5, 1 }, { 0, 1, 7 }, { 0, 7, 10 }, { 0, 10, 11 },
+		{ 1, 5, 9 }, { 5, 11, 4 }, { 11, 10, 2 }, { 10, 7, 6 }, { 7, 1, 8 },
+		{ 3, 9, 4 }, { 3, 4, 2 }, { 3, 2, 6 }, { 3, 6, 8 }, { 3, 8, 9 },
+		{ 4, 9, 5 }, { 2, 4, 11 }, { 6, 2, 10 }, { 8, 6, 7 }, { 9, 8, 1 }
+	};
+	for (auto & f : faces)
+		mesh.faces.push_back(CDXMeshFace(f[0], f[1], f[2]));
+
+	for (UInt32 level = 0; level < subdivisions; level++) {
+		std::map<std::pair<CDXMeshIndex, CDXMeshIndex>, CDXMeshIndex> cache;
+		std::vector<CDXMeshFace> split;
+		for (auto & f : mesh.faces) {
+			CDXMeshIndex a = Midpoint(mesh, cache, f.v1, f.v2);
+			CDXMeshIndex b = Midpoint(mesh, cache, f.v2, f.v3);
+			CDXMeshIndex c = Midpoint(mesh, cache, f.v3, f.v1);
+			split.push_back(CDXMeshFace(f.v1, a, c));
+			split.push_back(CDXMeshFace(f.v2, b, a));
+			split.push_back(CDXMeshFace(f.v3, c, b));
+			split.push_back(CDXMeshFace(a, b, c));
+		}
+		mesh.faces.swap(split);
+	}
+
+	return mesh;
+}
+
+float NextRandom(UInt32 & state)
+{
+	state = state * 1664525 + 1013904223;
+	return (float)(state >> 8) / (float)(1 << 23) - 1.0f;
+}
@@ -0,0 +1,45 @@
+#ifndef __TESTMESHES__
+#define __TESTMESHES__
+
+#pragma once
+
+#include "CDXMeshTypes.h"
+
+#include <vector>
+
+// Laid out like CDXMeshVert, so the kernels see the same nine float stride
+struct TestVertex
+{
+	float	position[3];
+	float	normal[3];
+	float	tex[2];
+	UInt32	color;
+};
+
+struct TestMesh
+{
+	std::vector<TestVertex>		vertices;
+	std::vector<CDXMeshFace>	faces;
+
+	enum { kStride = sizeof(TestVertex) / sizeof(float) };
+
+	float * Positions() { return vertices[0].position; }
+	float * Normals() { return vertices[0].normal; }
+
+	CDXMeshIndex AddVertex(float x, float y, float z);
+};
+
+// Flat grid in the z = 0 plane facing +z, columns by rows quads
+TestMesh MakeGrid(UInt32 columns, UInt32 rows, float spacing);
+
+// Two grids folded along the x = 0 ridge, both halves rising towards it.
+// With split set the ridge vertices are duplicated, as along a UV seam.
+TestMesh MakeRoof(UInt32 columns, UInt32 rows, bool split);
+
+// Unit icosphere with shared vertices, faces wound outward
+TestMesh MakeSphere(UInt32 subdivisions);
+
+// Deterministic pseudo random float in [-1, 1)
+float NextRandom(UInt32 & state);
+
+#endif
@@ -0,0 +1,163 @@
+#include "TestObj.h"
+
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <sstream>
+#include <tuple>
+
+static void AppendLine(std::string & text, const char * format, ...)
+{
+	char buffer[256];
+	va_list args;
+	va_start(args, format);
+	vsnprintf(buffer, sizeof(buffer), format, args);
+	va_end(args);
+	text += buffer;
+}
+
+std::string MakeObjSphere(UInt32 rings, UInt32 segments, bool quads)
+{
+	const double pi = 3.14159265358979323846;
+	std::string text = "# sphere\no Sphere\n";
+
+	// Positions and normals, one per pole and one per ring and segment
+	AppendLine(text, "v 0.000000 1.000000 0.000000\nvn 0.0000 1.0000 0.0000\n");
+	for (UInt32 r = 1; r < rings; r++) {
+		double theta = pi * r / rings;
+		for (UInt32 s = 0; s < segments; s++) {
+			double phi = 2.0 * pi * s / segments;
+			double x = sin(theta) * cos(phi), y = cos(theta), z = sin(theta) * sin(phi);
+			AppendLine(text, "v %.6f %.6f %.6f\nvn %.4f %.4f %.4f\n", x * 12.5, y * 12.5 + 120.0, z * 12.5, x, y, z);
+		}
+	}
+	AppendLine(text, "v 0.000000 -1.000000 0.000000\nvn 0.0000 -1.0000 0.0000\n");
+
+	// Texcoords wrap with one extra column along the seam
+	for (UInt32 r = 0; r <= rings; r++) {
+		for (UInt32 s = 0; s <= segments; s++)
+			AppendLine(text, "vt %.6f %.6f\n", (double)s / segments, 1.0 - (double)r / rings);
+	}
+
+	text += "usemtl Head\ns 1\n";
+	UInt32 bottom = 2 + (rings - 1) * segments;
+	for (UInt32 r = 0; r < rings; r++) {
+		for (UInt32 s = 0; s < segments; s++) {
+			UInt32 s1 = (s + 1) % segments;
+			UInt32 t00 = 1 + r * (segments + 1) + s, t01 = t00 + 1;
+			UInt32 t10 = t00 + segments + 1, t11 = t10 + 1;
+			if (r == 0) {
+				UInt32 a = 2 + s, b = 2 + s1;
+				AppendLine(text, "f 1/%u/1 %u/%u/%u %u/%u/%u\n", t00, b, t11, b, a, t10, a);
+			}
+			else if (r == rings - 1) {
+				UInt32 a = 2 + (r - 1) * segments + s, b = 2 + (r - 1) * segments + s1;
+				AppendLine(text, "f %u/%u/%u %u/%u/%u %u/%u/%u\n", a, t00, a, b, t01, b, bottom, t10, bottom);
+			}
+			else {
+				UInt32 a = 2 + (r - 1) * segments + s, b = 2 + (r - 1) * segments + s1;
+				UInt32 c = a + segments, d = b + segments;
+				if (quads)
+					AppendLine(text, "f %u/%u/%u %u/%u/%u %u/%u/%u %u/%u/%u\n", a, t00, a, b, t01, b, d, t11, d, c, t10, c);
+				else
+					AppendLine(text, "f %u/%u/%u %u/%u/%u %u/%u/%u\nf %u/%u/%u %u/%u/%u %u/%u/%u\n", a, t00, a, b, t01, b, d, t11, d, a, t00, a, d, t11, d, c, t10, c);
+			}
+		}
+	}
+
+	return text;
+}
+
+static bool ResolveIndex(long value, size_t count, UInt32 & index)
+{
+	if (value > 0 && (size_t)value <= count)
+		index = value - 1;
+	else if (value < 0 && (size_t)-value <= count)
+		index = count + value;
+	else
+		return false;
+	return true;
+}
+
+bool ReadObjReference(const std::string & text, std::vector<ObjVertex> & vertices, std::vector<UInt32> & indices)
+{
+	std::vector<float> positions, texcoords, normals;
+	std::map<std::tuple<UInt32, UInt32, UInt32>, UInt32> corners;
+	vertices.clear();
+	indices.clear();
+
+	std::istringstream stream(text);
+	std::string line;
+	while (std::getline(stream, line)) {
+		std::istringstream tokens(line);
+		std::string command;
+		if (!(tokens >> command))
+			continue;
+
+		if (command == "v" || command == "vn") {
+			float x, y, z;
+			if (!(tokens >> x >> y >> z))
+				return false;
+			std::vector<float> & target = command == "v" ? positions : normals;
+			target.push_back(x);
+			target.push_back(y);
+			target.push_back(z);
+		}
+		else if (command == "vt") {
+			float u, v;
+			if (!(tokens >> u >> v))
+				return false;
+			texcoords.push_back(u);
+			texcoords.push_back(v);
+		}
+		else if (command == "f") {
+			std::vector<UInt32> polygon;
+			std::string corner;
+			while (tokens >> corner) {
+				UInt32 p, t = 0xFFFFFFFF, n = 0xFFFFFFFF;
+				size_t slash = corner.find('/');
+				if (!ResolveIndex(strtol(corner.c_str(), NULL, 10), positions.size() / 3, p))
+					return false;
+				if (slash != std::string::npos) {
+					size_t second = corner.find('/', slash + 1);
+					std::string tex = corner.substr(slash + 1, second == std::string::npos ? std::string::npos : second - slash - 1);
+					if (!tex.empty() && !ResolveIndex(strtol(tex.c_str(), NULL, 10), texcoords.size() / 2, t))
+						return false;
+					if (second != std::string::npos && !ResolveIndex(strtol(corner.c_str() + second + 1, NULL, 10), normals.size() / 3, n))
+						return false;
+				}
+
+				auto key = std::make_tuple(p, t, n);
+				auto it = corners.find(key);
+				if (it == corners.end()) {
+					ObjVertex vertex = {};
+					for (UInt32 k = 0; k < 3; k++)
+						vertex.position[k] = positions[p * 3 + k];
+					if (n != 0xFFFFFFFF) {
+						for (UInt32 k = 0; k < 3; k++)
+							vertex.normal[k] = normals[n * 3 + k];
+					}
+					if (t != 0xFFFFFFFF) {
+						vertex.texcoord[0] = texcoords[t * 2];
+						vertex.texcoord[1] = texcoords[t * 2 + 1];
+					}
+					it = corners.emplace(key, (UInt32)vertices.size()).first;
+					vertices.push_back(vertex);
+				}
+				polygon.push_back(it->second);
+			}
+
+			if (polygon.size() < 3)
+				return false;
+			for (size_t k = 2; k < polygon.size(); k++) {
+				indices.push_back(polygon[0]);
+				indices.push_back(polygon[k - 1]);
+				indices.push_back(polygon[k]);
+			}
+		}
+	}
+
+	return true;
+}
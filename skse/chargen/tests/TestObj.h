@@ -0,0 +1,20 @@
+#ifndef __TESTOBJ__
+#define __TESTOBJ__
+
+#pragma once
+
+#include "ObjReader.h"
+
+#include <string>
+#include <vector>
+
+// Latitude and longitude sphere as OBJ text with positions, texcoords and
+// normals. The texcoord seam column is duplicated and the poles are fans,
+// bands are quads or pairs of triangles.
+std::string MakeObjSphere(UInt32 rings, UInt32 segments, bool quads);
+
+// Straightforward stream tokenizer with the same output as ObjReader,
+// merges corners by index triple and fans polygons. False on bad input.
+bool ReadObjReference(const std::string & text, std::vector<ObjVertex> & vertices, std::vector<UInt32> & indices);
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef __TESTPREFIX__
+#define __TESTPREFIX__
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Integer types the plugin gets from common/ITypes.h
+typedef uint8_t		UInt8;
+typedef uint16_t	UInt16;
+typedef uint32_t	UInt32;
+typedef uint64_t	UInt64;
+typedef int8_t		SInt8;
+typedef int16_t		SInt16;
+typedef int32_t		SInt32;
+typedef int64_t		SInt64;
+
+#endif
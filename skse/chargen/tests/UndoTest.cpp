@@ -0,0 +1,277 @@
+#include "CDXUndo.h"
+#include "CDXVertexDeltas.h"
+#include "TestMeshes.h"
+#include "TestUtils.h"
+
+#include <unordered_map>
+
+int g_failures = 0;
+
+static int s_liveCommands = 0;
+
+// Stands in for an editable mesh. Plain commands record themselves in
+// order, so undoing one out of order shows up; delta commands move the
+// positions.
+struct TestModel
+{
+	std::vector<UInt32>	applied;
+	std::vector<float>	positions;
+};
+
+class TestCommand : public CDXUndoCommand
+{
+public:
+	TestCommand(TestModel * model, UInt32 id, size_t memory) : m_model(model), m_id(id), m_memory(memory) { s_liveCommands++; }
+	virtual ~TestCommand() { s_liveCommands--; }
+
+	virtual void Undo()
+	{
+		CHECK(!m_model->applied.empty() && m_model->applied.back() == m_id);
+		if (!m_model->applied.empty())
+			m_model->applied.pop_back();
+	}
+	virtual void Redo() { m_model->applied.push_back(m_id); }
+	virtual size_t GetMemoryUsage() { return m_memory; }
+
+protected:
+	TestModel	* m_model;
+	UInt32		m_id;
+	size_t		m_memory;
+};
+
+class TestDeltaCommand : public TestCommand
+{
+public:
+	// The position of each TestVertex holds its offset, odd ids are quantized
+	TestDeltaCommand(TestModel * model, UInt32 id, const std::unordered_map<CDXMeshIndex, TestVertex> & offsets) : TestCommand(model, id, 0)
+	{
+		m_deltas.Assign(offsets, (id & 1) != 0);
+		m_memory = sizeof(*this) + m_deltas.GetMemoryUsage();
+	}
+
+	virtual void Undo() { ApplyDeltas(m_deltas, -1.0f); }
+	virtual void Redo() { ApplyDeltas(m_deltas, 1.0f); }
+
+	virtual CDXEditableMesh * GetDeltaMesh() { return (CDXEditableMesh *)m_model; }
+	virtual const CDXVertexDeltas * GetDeltas() { return &m_deltas; }
+	virtual void ApplyDeltas(const CDXVertexDeltas & deltas, float multiplier)
+	{
+		deltas.Visit([&](CDXMeshIndex i, const float * offset)
+		{
+			for (UInt32 k = 0; k < 3; k++)
+				m_model->positions[i * 3 + k] += offset[k] * multiplier;
+		});
+	}
+
+private:
+	CDXVertexDeltas	m_deltas;
+};
+
+// Applies the command the way a stroke does before it is pushed
+static SInt32 Push(CDXUndoStack & stack, CDXUndoCommand * command)
+{
+	command->Redo();
+	return stack.Push(CDXUndoCommandPtr(command));
+}
+
+// The ring holds the newest GetLimit actions, pushing past it releases
+// the oldest and undo walks back through exactly the ones kept
+static void TestRing()
+{
+	TestModel model;
+	{
+		CDXUndoStack stack;
+		UInt32 limit = stack.GetLimit();
+		UInt32 pushed = limit + limit / 2 + 7;
+		for (UInt32 id = 0; id < pushed; id++)
+			CHECK(Push(stack, new TestCommand(&model, id, 16)) == (SInt32)(id < limit ? id : limit - 1));
+
+		CHECK(stack.GetSize() == limit);
+		CHECK(stack.GetIndex() == (SInt32)limit - 1);
+		CHECK(s_liveCommands == (int)limit);
+		CHECK(stack.GetMemoryUsage() == limit * 16);
+
+		for (UInt32 n = 0; n < limit; n++)
+			CHECK(stack.Undo(true) == (SInt32)(limit - 2 - n));
+		CHECK(model.applied.size() == pushed - limit);
+		CHECK(model.applied.back() == pushed - limit - 1);
+
+		// Nothing older is left to undo
+		CHECK(stack.Undo(true) == -1);
+		CHECK(model.applied.size() == pushed - limit);
+
+		for (UInt32 n = 0; n < limit; n++)
+			CHECK(stack.Redo(true) == (SInt32)n);
+		CHECK(stack.Redo(true) == -1);
+		CHECK(model.applied.size() == pushed);
+		for (UInt32 id = 0; id < pushed; id++)
+			CHECK(model.applied[id] == id);
+
+		// Pushing after an undo drops the undone actions, wherever the ring
+		// currently starts
+		for (UInt32 n = 0; n < 10; n++)
+			stack.Undo(true);
+		CHECK(Push(stack, new TestCommand(&model, pushed, 16)) == (SInt32)limit - 10);
+		CHECK(stack.GetSize() == limit - 9);
+		CHECK(s_liveCommands == (int)limit - 9);
+		CHECK(stack.GetMemoryUsage() == (limit - 9) * 16);
+		CHECK(stack.Redo(true) == -1);
+
+		// And the ring wraps again from there
+		for (UInt32 id = pushed + 1; id < pushed + 20; id++)
+			Push(stack, new TestCommand(&model, id, 16));
+		CHECK(stack.GetSize() == limit);
+		CHECK(s_liveCommands == (int)limit);
+		CHECK(stack.GoTo(-1, true) == -1);
+		CHECK(stack.GoTo(limit - 1, true) == (SInt32)limit - 1);
+
+		stack.Release();
+		CHECK(s_liveCommands == 0);
+		CHECK(stack.GetSize() == 0 && stack.GetIndex() == -1 && stack.GetMemoryUsage() == 0);
+	}
+}
+
+// Past the memory budget the oldest actions are released, the newest is
+// always kept and undo stops at the oldest one still held
+static void TestMemoryBudget()
+{
+	const size_t megabyte = 1024 * 1024;
+	TestModel model;
+	CDXUndoStack stack;
+
+	for (UInt32 id = 0; id < 10; id++)
+		Push(stack, new TestCommand(&model, id, 5 * megabyte));
+	CHECK(stack.GetSize() == 10);
+	CHECK(stack.GetMemoryUsage() == 6 * 5 * megabyte);
+	CHECK(s_liveCommands == 6);
+
+	for (UInt32 n = 0; n < 6; n++)
+		CHECK(stack.Undo(true) == (SInt32)(8 - n));
+	CHECK(model.applied.size() == 4);
+
+	// The boundary holds, for single steps and for GoTo
+	CHECK(stack.Undo(true) == 3);
+	CHECK(stack.GoTo(-1, true) == 3);
+	CHECK(stack.GoTo(0, true) == 3);
+	CHECK(model.applied.size() == 4);
+	CHECK(stack.GoTo(9, true) == 9);
+	CHECK(model.applied.size() == 10);
+
+	// One action over the budget on its own still gets pushed
+	Push(stack, new TestCommand(&model, 10, 40 * megabyte));
+	CHECK(stack.GetMemoryUsage() == 40 * megabyte);
+	CHECK(s_liveCommands == 1);
+	CHECK(stack.Undo(true) == 9);
+	CHECK(stack.Undo(true) == 9);
+	CHECK(model.applied.size() == 10);
+
+	// Undone actions give their memory back when a push truncates them
+	Push(stack, new TestCommand(&model, 11, megabyte));
+	CHECK(stack.GetMemoryUsage() == megabyte);
+	CHECK(s_liveCommands == 1);
+	stack.Release();
+
+	// Dropping by memory and reusing ring slots together
+	for (UInt32 id = 0; id < stack.GetLimit() + 100; id++)
+		Push(stack, new TestCommand(&model, id, 100 * 1024));
+	size_t kept = stack.GetMemoryUsage() / (100 * 1024);
+	CHECK(stack.GetMemoryUsage() <= 32 * megabyte);
+	CHECK(stack.GetMemoryUsage() + 100 * 1024 > 32 * megabyte);
+	CHECK(s_liveCommands == (int)kept);
+	UInt32 undone = 0;
+	for (SInt32 index = stack.GetIndex(); stack.Undo(true) < index; index = stack.GetIndex())
+		undone++;
+	CHECK(undone == kept);
+	stack.Release();
+	CHECK(s_liveCommands == 0);
+}
+
+// Random offsets for some vertices of a model
+static std::unordered_map<CDXMeshIndex, TestVertex> RandomOffsets(UInt32 vertexCount, UInt32 & state)
+{
+	std::unordered_map<CDXMeshIndex, TestVertex> offsets;
+	UInt32 count = 1 + (UInt32)((NextRandom(state) + 1.0f) * 20.0f);
+	for (UInt32 n = 0; n < count; n++) {
+		CDXMeshIndex i = (CDXMeshIndex)((UInt32)((NextRandom(state) + 1.0f) * 0.5f * vertexCount) % vertexCount);
+		TestVertex & offset = offsets[i];
+		for (UInt32 k = 0; k < 3; k++)
+			offset.position[k] = NextRandom(state);
+	}
+	return offsets;
+}
+
+// Two stacks fed the same actions, one jumps with GoTo and the other steps
+// there with Undo and Redo. GoTo sums runs of delta commands per model, the
+// results only differ by float rounding.
+static void TestGoTo()
+{
+	const UInt32 vertexCount = 200;
+	TestModel jumping[2], stepping[2];
+	for (UInt32 m = 0; m < 2; m++) {
+		jumping[m].positions.assign(vertexCount * 3, 0.0f);
+		stepping[m].positions.assign(vertexCount * 3, 0.0f);
+	}
+
+	UInt32 state = 13;
+	CDXUndoStack jumpStack, stepStack;
+	UInt32 pushed = jumpStack.GetLimit() + 150;
+	for (UInt32 id = 0; id < pushed; id++) {
+		// Mostly runs of deltas on one model, sometimes another action between
+		float choice = NextRandom(state);
+		UInt32 m = choice < 0.3f ? 1 : 0;
+		if (choice > 0.8f) {
+			Push(jumpStack, new TestCommand(&jumping[m], id, 64));
+			Push(stepStack, new TestCommand(&stepping[m], id, 64));
+		}
+		else {
+			std::unordered_map<CDXMeshIndex, TestVertex> offsets = RandomOffsets(vertexCount, state);
+			Push(jumpStack, new TestDeltaCommand(&jumping[m], id, offsets));
+			Push(stepStack, new TestDeltaCommand(&stepping[m], id, offsets));
+		}
+	}
+
+	SInt32 maxState = jumpStack.GetSize() - 1;
+	for (UInt32 jump = 0; jump < 100; jump++) {
+		SInt32 target = (SInt32)((NextRandom(state) + 1.0f) * 0.5f * (maxState + 2)) - 1;
+		if (jump % 10 == 0)
+			target = jump % 20 == 0 ? -1 : maxState;
+		if (target > maxState)
+			target = maxState;
+
+		CHECK(jumpStack.GoTo(target, true) == target);
+		while (stepStack.GetIndex() > target)
+			stepStack.Undo(true);
+		while (stepStack.GetIndex() < target)
+			stepStack.Redo(true);
+		CHECK(jumpStack.GetIndex() == stepStack.GetIndex());
+
+		for (UInt32 m = 0; m < 2; m++) {
+			CHECK(jumping[m].applied == stepping[m].applied);
+			for (UInt32 n = 0; n < vertexCount * 3; n++)
+				CHECK_NEAR(jumping[m].positions[n], stepping[m].positions[n], 1e-3);
+		}
+	}
+
+	// Out of range targets change nothing
+	SInt32 index = jumpStack.GetIndex();
+	CHECK(jumpStack.GoTo(maxState + 1, true) == -1);
+	CHECK(jumpStack.GoTo(-2, true) == -1);
+	CHECK(jumpStack.GetIndex() == index);
+
+	// Without the update only the index moves
+	std::vector<float> before = jumping[0].positions;
+	CHECK(jumpStack.GoTo(-1, false) == -1);
+	CHECK(jumping[0].positions == before);
+
+	jumpStack.Release();
+	stepStack.Release();
+	CHECK(s_liveCommands == 0);
+}
+
+int main()
+{
+	TestRing();
+	TestMemoryBudget();
+	TestGoTo();
+	return TEST_MAIN_RESULT();
+}
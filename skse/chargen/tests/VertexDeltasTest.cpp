@@ -0,0 +1,172 @@
+#include "CDXVertexDeltas.h"
+#include "CDXVertexStreams.h"
+#include "TestMeshes.h"
+#include "TestUtils.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+int g_failures = 0;
+
+struct TestOffset
+{
+	float	x, y, z;
+};
+
+typedef std::unordered_map<CDXMeshIndex, TestOffset> TestOffsetMap;
+
+static TestOffsetMap RandomOffsets(UInt32 count, float scale, UInt32 & state)
+{
+	TestOffsetMap offsets;
+	while (offsets.size() < count) {
+		CDXMeshIndex i = (CDXMeshIndex)((NextRandom(state) + 1.0f) * 30000.0f);
+		TestOffset offset = { NextRandom(state) * scale, NextRandom(state) * scale, NextRandom(state) * scale };
+		offsets[i] = offset;
+	}
+	return offsets;
+}
+
+// Offsets come back in vertex order whatever order the map holds them in
+static void CheckOrder(const CDXVertexDeltas & deltas, const TestOffsetMap & offsets)
+{
+	CHECK(deltas.Size() == offsets.size());
+	for (UInt32 n = 1; n < deltas.Size(); n++)
+		CHECK(deltas.GetIndex(n - 1) < deltas.GetIndex(n));
+	for (UInt32 n = 0; n < deltas.Size(); n++)
+		CHECK(offsets.count(deltas.GetIndex(n)) == 1);
+}
+
+static void TestExact()
+{
+	UInt32 state = 3;
+	TestOffsetMap offsets = RandomOffsets(500, 2.0f, state);
+
+	CDXVertexDeltas deltas;
+	deltas.Assign(offsets, false);
+	CHECK(!deltas.IsQuantized());
+	CHECK(deltas.GetMaxError() == 0.0f);
+	CheckOrder(deltas, offsets);
+
+	UInt32 n = 0;
+	deltas.Visit([&](CDXMeshIndex i, const float * offset)
+	{
+		CHECK(i == deltas.GetIndex(n));
+		const TestOffset & expected = offsets[i];
+		CHECK(offset[0] == expected.x && offset[1] == expected.y && offset[2] == expected.z);
+		n++;
+	});
+	CHECK(n == offsets.size());
+}
+
+// Every component lands within half a quantization step of where it
+// started, whatever the magnitude of the step
+static void TestQuantizeRoundTrip()
+{
+	UInt32 state = 5;
+	float scales[] = { 1e-5f, 0.01f, 1.0f, 40.0f, 5000.0f };
+	for (auto scale : scales) {
+		for (UInt32 count = 1; count <= 2000; count *= 3) {
+			TestOffsetMap offsets = RandomOffsets(count, scale, state);
+
+			CDXVertexDeltas deltas;
+			deltas.Assign(offsets, true);
+			CHECK(deltas.IsQuantized());
+			CheckOrder(deltas, offsets);
+
+			// The scale is fit to the largest component, which sets the bound
+			float largest = 0.0f;
+			for (auto & it : offsets) {
+				largest = std::max(largest, fabsf(it.second.x));
+				largest = std::max(largest, fabsf(it.second.y));
+				largest = std::max(largest, fabsf(it.second.z));
+			}
+			CHECK_NEAR(deltas.GetMaxError(), largest / 32767.0f * 0.5f, largest * 1e-9);
+
+			// Float rounding in the scaling adds well under a hundredth of a step
+			double bound = deltas.GetMaxError() * 1.01;
+			double worst = 0.0;
+			deltas.Visit([&](CDXMeshIndex i, const float * offset)
+			{
+				const float * expected = &offsets[i].x;
+				for (UInt32 k = 0; k < 3; k++) {
+					double error = fabs((double)offset[k] - expected[k]);
+					worst = std::max(worst, error);
+					CHECK(error <= bound);
+				}
+			});
+
+			// The bound is tight, enough random components come close to it
+			if (count >= 243)
+				CHECK(worst > deltas.GetMaxError() * 0.9);
+		}
+	}
+}
+
+// Everything zero has no scale to fit, all offsets come back as zero
+static void TestZero()
+{
+	TestOffsetMap offsets;
+	for (CDXMeshIndex i = 0; i < 10; i++) {
+		TestOffset zero = { 0.0f, -0.0f, 0.0f };
+		offsets[i * 7] = zero;
+	}
+
+	CDXVertexDeltas deltas;
+	deltas.Assign(offsets, true);
+	CHECK(deltas.GetMaxError() == 0.0f);
+	deltas.Visit([&](CDXMeshIndex, const float * offset)
+	{
+		CHECK(offset[0] == 0.0f && offset[1] == 0.0f && offset[2] == 0.0f);
+	});
+
+	deltas.Clear();
+	CHECK(deltas.IsEmpty());
+	CHECK(!deltas.IsQuantized());
+}
+
+// The unpacked streams match the offsets one at a time
+static void TestGetOffsets()
+{
+	UInt32 state = 7;
+	TestOffsetMap offsets = RandomOffsets(300, 3.0f, state);
+	bool modes[] = { false, true };
+	for (auto quantize : modes) {
+		CDXVertexDeltas deltas;
+		deltas.Assign(offsets, quantize);
+
+		CDXVectorStreams streams;
+		deltas.GetOffsets(streams, -0.5f);
+		CHECK(streams.Size() == deltas.Size());
+		for (UInt32 n = 0; n < deltas.Size(); n++) {
+			float offset[3];
+			deltas.GetOffset(n, offset);
+			CHECK_NEAR(streams.x[n], offset[0] * -0.5f, 1e-6);
+			CHECK_NEAR(streams.y[n], offset[1] * -0.5f, 1e-6);
+			CHECK_NEAR(streams.z[n], offset[2] * -0.5f, 1e-6);
+		}
+	}
+}
+
+// Quantized offsets take 16 bits a component instead of 32
+static void TestMemory()
+{
+	UInt32 state = 11;
+	TestOffsetMap offsets = RandomOffsets(1000, 1.0f, state);
+
+	CDXVertexDeltas exact, quantized;
+	exact.Assign(offsets, false);
+	quantized.Assign(offsets, true);
+	CHECK(exact.GetMemoryUsage() >= 1000 * (sizeof(CDXMeshIndex) + 3 * sizeof(float)));
+	CHECK(quantized.GetMemoryUsage() < exact.GetMemoryUsage());
+	CHECK(quantized.GetMemoryUsage() >= 1000 * (sizeof(CDXMeshIndex) + 3 * sizeof(SInt16)));
+}
+
+int main()
+{
+	TestExact();
+	TestQuantizeRoundTrip();
+	TestZero();
+	TestGetOffsets();
+	TestMemory();
+	return TEST_MAIN_RESULT();
+}
@@ -0,0 +1,176 @@
+#include "CDXVertexShadow.h"
+#include "TestMeshes.h"
+#include "TestUtils.h"
+
+#include <string.h>
+
+int g_failures = 0;
+
+// Stands in for the vertex buffer, UpdateVertexBuffer locks the dirty span
+// and uploads into it
+static void Upload(CDXVertexShadow & shadow, std::vector<TestVertex> & buffer)
+{
+	UInt32 begin = shadow.GetDirtyBegin();
+	shadow.Upload(buffer[begin].position);
+}
+
+static bool SameVertex(const TestVertex & a, const TestVertex & b)
+{
+	return memcmp(&a, &b, sizeof(TestVertex)) == 0;
+}
+
+static void TestAssign()
+{
+	TestMesh mesh = MakeGrid(4, 3, 1.0f);
+	CDXVertexShadow shadow;
+	shadow.Assign(mesh.Positions(), TestMesh::kStride, mesh.vertices.size());
+	CHECK(shadow.Size() == mesh.vertices.size());
+	CHECK(shadow.GetStride() == TestMesh::kStride);
+	CHECK(!shadow.IsDirty());
+	CHECK(memcmp(shadow.GetData(), mesh.Positions(), mesh.vertices.size() * sizeof(TestVertex)) == 0);
+
+	shadow.Clear();
+	CHECK(shadow.Size() == 0);
+	CHECK(shadow.GetData() == NULL);
+	CHECK(!shadow.IsDirty());
+}
+
+// Moving changes only the position, everything else in the vertex stays
+static void TestMove()
+{
+	TestMesh mesh = MakeGrid(4, 3, 1.0f);
+	for (UInt32 i = 0; i < mesh.vertices.size(); i++)
+		mesh.vertices[i].color = 0xFF000000 | i;
+
+	CDXVertexShadow shadow;
+	shadow.Assign(mesh.Positions(), TestMesh::kStride, mesh.vertices.size());
+	TestVertex * vertices = (TestVertex *)shadow.GetData();
+
+	float offset[3] = { 0.5f, -0.25f, 2.0f };
+	CHECK(shadow.Move(5, offset));
+	CHECK(shadow.Move(5, offset));
+	CHECK(vertices[5].position[0] == mesh.vertices[5].position[0] + 1.0f);
+	CHECK(vertices[5].position[1] == mesh.vertices[5].position[1] - 0.5f);
+	CHECK(vertices[5].position[2] == mesh.vertices[5].position[2] + 4.0f);
+	CHECK(memcmp(vertices[5].normal, mesh.vertices[5].normal, sizeof(float) * 6) == 0);
+	for (UInt32 i = 0; i < mesh.vertices.size(); i++) {
+		if (i != 5)
+			CHECK(SameVertex(vertices[i], mesh.vertices[i]));
+	}
+
+	// Past the end nothing moves and nothing is marked
+	std::vector<TestVertex> buffer = mesh.vertices;
+	Upload(shadow, buffer);
+	CHECK(!shadow.Move(shadow.Size(), offset));
+	CHECK(!shadow.Move(0xFFFF, offset));
+	CHECK(!shadow.IsDirty());
+}
+
+// Edits widen one span from the lowest to the highest edited vertex, an
+// upload copies exactly that span and starts over
+static void TestDirtyRange()
+{
+	TestMesh mesh = MakeSphere(2);
+	UInt32 count = mesh.vertices.size();
+
+	CDXVertexShadow shadow;
+	shadow.Assign(mesh.Positions(), TestMesh::kStride, count);
+	std::vector<TestVertex> buffer = mesh.vertices;
+	TestVertex * vertices = (TestVertex *)shadow.GetData();
+
+	float offset[3] = { 0.125f, 0.25f, -0.5f };
+	shadow.Move(40, offset);
+	CHECK(shadow.IsDirty());
+	CHECK(shadow.GetDirtyBegin() == 40 && shadow.GetDirtyEnd() == 41);
+
+	vertices[12].color = 0xFF0000FF;
+	shadow.MarkDirty(12);
+	CHECK(shadow.GetDirtyBegin() == 12 && shadow.GetDirtyEnd() == 41);
+
+	// Inside the span changes nothing, either side widens it
+	shadow.Move(20, offset);
+	CHECK(shadow.GetDirtyBegin() == 12 && shadow.GetDirtyEnd() == 41);
+	shadow.MarkDirty(41);
+	CHECK(shadow.GetDirtyBegin() == 12 && shadow.GetDirtyEnd() == 42);
+	shadow.Move(7, offset);
+	CHECK(shadow.GetDirtyBegin() == 7 && shadow.GetDirtyEnd() == 42);
+
+	// Vertices past the span were not touched by the upload
+	buffer[6].color = buffer[42].color = 0xDEADBEEF;
+	Upload(shadow, buffer);
+	CHECK(!shadow.IsDirty());
+	CHECK(shadow.GetDirtyBegin() == 0 && shadow.GetDirtyEnd() == 0);
+	for (UInt32 i = 7; i < 42; i++)
+		CHECK(SameVertex(buffer[i], vertices[i]));
+	CHECK(buffer[6].color == 0xDEADBEEF && buffer[42].color == 0xDEADBEEF);
+	buffer[6].color = vertices[6].color;
+	buffer[42].color = vertices[42].color;
+
+	// Nothing edited, nothing copied
+	buffer[0].color = 0xDEADBEEF;
+	Upload(shadow, buffer);
+	CHECK(buffer[0].color == 0xDEADBEEF);
+	buffer[0].color = vertices[0].color;
+
+	// The next span starts fresh rather than from the last one, vertex 0
+	// works as either end
+	shadow.Move(count - 1, offset);
+	CHECK(shadow.GetDirtyBegin() == count - 1 && shadow.GetDirtyEnd() == count);
+	shadow.MarkDirty(0);
+	CHECK(shadow.GetDirtyBegin() == 0 && shadow.GetDirtyEnd() == count);
+	Upload(shadow, buffer);
+	CHECK(!shadow.IsDirty());
+	CHECK(memcmp(buffer.data(), vertices, count * sizeof(TestVertex)) == 0);
+
+	shadow.MarkDirty(0);
+	CHECK(shadow.GetDirtyBegin() == 0 && shadow.GetDirtyEnd() == 1);
+
+	// Assigning new data drops the pending span
+	shadow.Assign(mesh.Positions(), TestMesh::kStride, count);
+	CHECK(!shadow.IsDirty());
+}
+
+// Random edits uploaded every few steps keep the buffer equal to the copy
+static void TestRandomEdits()
+{
+	TestMesh mesh = MakeSphere(3);
+	UInt32 count = mesh.vertices.size();
+
+	CDXVertexShadow shadow;
+	shadow.Assign(mesh.Positions(), TestMesh::kStride, count);
+	std::vector<TestVertex> buffer = mesh.vertices;
+	TestVertex * vertices = (TestVertex *)shadow.GetData();
+
+	UInt32 state = 3;
+	for (UInt32 step = 0; step < 200; step++) {
+		UInt32 edits = 1 + (UInt32)((NextRandom(state) + 1.0f) * 8.0f);
+		UInt32 lowest = count, highest = 0;
+		for (UInt32 e = 0; e < edits; e++) {
+			CDXMeshIndex i = (CDXMeshIndex)((NextRandom(state) + 1.0f) * 0.5f * count) % count;
+			if (e & 1) {
+				vertices[i].color = step;
+				shadow.MarkDirty(i);
+			}
+			else {
+				float offset[3] = { NextRandom(state), NextRandom(state), NextRandom(state) };
+				shadow.Move(i, offset);
+			}
+			lowest = i < lowest ? i : lowest;
+			highest = i > highest ? i : highest;
+		}
+
+		CHECK(shadow.GetDirtyBegin() == lowest && shadow.GetDirtyEnd() == highest + 1);
+		Upload(shadow, buffer);
+		CHECK(!shadow.IsDirty());
+		CHECK(memcmp(buffer.data(), vertices, count * sizeof(TestVertex)) == 0);
+	}
+}
+
+int main()
+{
+	TestAssign();
+	TestMove();
+	TestDirtyRange();
+	TestRandomEdits();
+	return TEST_MAIN_RESULT();
+}
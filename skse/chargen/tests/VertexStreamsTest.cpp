@@ -0,0 +1,122 @@
+#include "CDXVertexStreams.h"
+#include "TestMeshes.h"
+#include "TestUtils.h"
+
+#include <algorithm>
+
+int g_failures = 0;
+
+static std::vector<float> RandomFloats(UInt32 count, UInt32 & state)
+{
+	std::vector<float> values(count);
+	for (auto & value : values)
+		value = NextRandom(state) * 10.0f;
+	return values;
+}
+
+// Every count around the four wide blocks, packed and interleaved
+static void TestGatherScatter()
+{
+	UInt32 state = 11;
+	UInt32 strides[] = { 3, 9 };
+	for (auto stride : strides) {
+		for (UInt32 count = 0; count <= 13; count++) {
+			std::vector<float> source = RandomFloats(count * stride + 1, state);
+
+			CDXVectorStreams streams;
+			streams.Gather(source.data(), stride, count);
+			CHECK(streams.Size() == count);
+			for (UInt32 i = 0; i < count; i++) {
+				CHECK(streams.x[i] == source[i * stride + 0]);
+				CHECK(streams.y[i] == source[i * stride + 1]);
+				CHECK(streams.z[i] == source[i * stride + 2]);
+			}
+
+			// Only the xyz of each vector is written back
+			std::vector<float> dest(source.size(), -1.0f);
+			streams.Scatter(dest.data(), stride);
+			for (UInt32 n = 0; n < dest.size(); n++) {
+				bool written = n < count * stride && n % stride < 3;
+				CHECK(dest[n] == (written ? source[n] : -1.0f));
+			}
+		}
+	}
+}
+
+static void TestScaleTransform()
+{
+	UInt32 state = 5;
+	for (UInt32 count = 0; count <= 13; count++) {
+		std::vector<float> source = RandomFloats(count * 3, state);
+
+		CDXVectorStreams streams;
+		streams.Gather(source.data(), 3, count);
+		streams.Scale(0.25f);
+		for (UInt32 i = 0; i < count; i++) {
+			CHECK(streams.x[i] == source[i * 3 + 0] * 0.25f);
+			CHECK(streams.y[i] == source[i * 3 + 1] * 0.25f);
+			CHECK(streams.z[i] == source[i * 3 + 2] * 0.25f);
+		}
+
+		float rotation[9] = { 0, -1, 0, 1, 0, 0, 0, 0, 1 };
+		float translation[3] = { 1, 2, 3 };
+		streams.Gather(source.data(), 3, count);
+		streams.Transform(rotation, translation, 2.0f);
+		for (UInt32 i = 0; i < count; i++) {
+			const float * v = &source[i * 3];
+			CHECK_NEAR(streams.x[i], -v[1] * 2.0f + 1.0f, 1e-5);
+			CHECK_NEAR(streams.y[i], v[0] * 2.0f + 2.0f, 1e-5);
+			CHECK_NEAR(streams.z[i], v[2] * 2.0f + 3.0f, 1e-5);
+		}
+	}
+}
+
+// Sorted unique indices mixing consecutive runs, which take the four wide
+// path, with gaps and a tail past the vector count
+static std::vector<CDXMeshIndex> RandomIndices(UInt32 vectorCount, UInt32 & state)
+{
+	std::vector<CDXMeshIndex> indices;
+	UInt32 i = 0;
+	while (i < vectorCount + 20) {
+		UInt32 run = 1 + (UInt32)((NextRandom(state) * 0.5f + 0.5f) * 9);
+		for (UInt32 n = 0; n < run; n++)
+			indices.push_back((CDXMeshIndex)i++);
+		i += (UInt32)((NextRandom(state) * 0.5f + 0.5f) * 4);
+	}
+	return indices;
+}
+
+static void TestScatterAdd()
+{
+	UInt32 state = 42;
+	for (UInt32 round = 0; round < 50; round++) {
+		UInt32 vectorCount = 1 + round * 37;
+		std::vector<CDXMeshIndex> indices = RandomIndices(vectorCount, state);
+		std::vector<float> offsetData = RandomFloats(indices.size() * 3, state);
+
+		CDXVectorStreams offsets;
+		offsets.Gather(offsetData.data(), 3, indices.size());
+
+		std::vector<float> vectors = RandomFloats(vectorCount * 3, state);
+		std::vector<float> expected = vectors;
+
+		float multiplier = round % 2 ? -0.5f : 1.0f;
+		for (UInt32 n = 0; n < indices.size(); n++) {
+			if (indices[n] >= vectorCount)
+				break;
+			for (UInt32 k = 0; k < 3; k++)
+				expected[indices[n] * 3 + k] += offsetData[n * 3 + k] * multiplier;
+		}
+
+		CDXScatterAdd(vectors.data(), vectorCount, indices.data(), offsets, multiplier);
+		CHECK(vectors == expected);
+	}
+}
+
+int main()
+{
+	TestGatherScatter();
+	TestScaleTransform();
+	TestScatterAdd();
+	return TEST_MAIN_RESULT();
+}
@@ -9,6 +9,7 @@
 #include <limits>
 #include <cctype>
 #include <random>
+#include <chrono>
 #include <ppl.h>
 
 #include "skse/PluginAPI.h"
@@ -42,6 +43,7 @@ UInt32 BodyMorphInterface::GetVersion()
 void BodyMorphInterface::Revert()
 {
 	SimpleLocker<ActorMorphs::MorphMap> locker(&actorMorphs);
+	actorMorphs.MarkAllDirty();
 	actorMorphs.m_data.clear();
 }
 
@@ -50,6 +52,7 @@ void BodyMorphInterface::SetMorph(TESObjectREFR * actor, BSFixedString morphName
 	UInt64 handle = g_overrideInterface.GetHandle(actor, TESObjectREFR::kTypeID);
 
 	SimpleLocker<ActorMorphs::MorphMap> locker(&actorMorphs);
+	actorMorphs.MarkDirty(handle);
 	actorMorphs.m_data[handle][morphName][morphKey] = relative;
 }
 
@@ -80,6 +83,7 @@ void BodyMorphInterface::ClearMorph(TESObjectREFR * actor, BSFixedString morphNa
 	UInt64 handle = g_overrideInterface.GetHandle(actor, TESObjectREFR::kTypeID);
 
 	SimpleLocker<ActorMorphs::MorphMap> locker(&actorMorphs);
+	actorMorphs.MarkDirty(handle);
 	auto & it = actorMorphs.m_data.find(handle);
 	if (it != actorMorphs.m_data.end())
 	{
@@ -177,6 +181,7 @@ void BodyMorphInterface::ClearBodyMorphKeys(TESObjectREFR * actor, BSFixedString
 	UInt64 handle = g_overrideInterface.GetHandle(actor, TESObjectREFR::kTypeID);
 
 	SimpleLocker<ActorMorphs::MorphMap> locker(&actorMorphs);
+	actorMorphs.MarkDirty(handle);
 	auto & it = actorMorphs.m_data.find(handle);
 	if (it != actorMorphs.m_data.end())
 	{
@@ -214,6 +219,7 @@ void BodyMorphInterface::ClearBodyMorphNames(TESObjectREFR * actor, BSFixedStrin
 	UInt64 handle = g_overrideInterface.GetHandle(actor, TESObjectREFR::kTypeID);
 
 	SimpleLocker<ActorMorphs::MorphMap> locker(&actorMorphs);
+	actorMorphs.MarkDirty(handle);
 	auto & it = actorMorphs.m_data.find(handle);
 	if (it != actorMorphs.m_data.end())
 	{
@@ -230,6 +236,7 @@ void BodyMorphInterface::ClearMorphs(TESObjectREFR * actor)
 	UInt64 handle = g_overrideInterface.GetHandle(actor, TESObjectREFR::kTypeID);
 
 	SimpleLocker<ActorMorphs::MorphMap> locker(&actorMorphs);
+	actorMorphs.MarkDirty(handle);
 	auto & it = actorMorphs.m_data.find(handle);
 	if(it != actorMorphs.m_data.end())
 	{
@@ -251,6 +258,63 @@ bool BodyMorphInterface::HasMorphs(TESObjectREFR * actor)
 	return false;
 }
 
+void BodyMorphInterface::SetMorphArray(TESObjectREFR * actor, UInt32 count, const BSFixedString * morphNames, const BSFixedString * morphKeys, const float * values)
+{
+	UInt64 handle = g_overrideInterface.GetHandle(actor, TESObjectREFR::kTypeID);
+
+	SimpleLocker<ActorMorphs::MorphMap> locker(&actorMorphs);
+	actorMorphs.MarkDirty(handle);
+	auto & morphs = actorMorphs.m_data[handle];
+	for (UInt32 i = 0; i < count; i++)
+	{
+		morphs[morphNames[i]][morphKeys[i]] = values[i];
+	}
+}
+
+void BodyMorphInterface::GetMorphArray(TESObjectREFR * actor, UInt32 count, const BSFixedString * morphNames, const BSFixedString * morphKeys, float * values)
+{
+	UInt64 handle = g_overrideInterface.GetHandle(actor, TESObjectREFR::kTypeID);
+
+	SimpleLocker<ActorMorphs::MorphMap> locker(&actorMorphs);
+	auto & it = actorMorphs.m_data.find(handle);
+	for (UInt32 i = 0; i < count; i++)
+	{
+		values[i] = 0.0;
+		if (it == actorMorphs.m_data.end())
+			continue;
+
+		auto & mit = it->second.find(morphNames[i]);
+		if (mit != it->second.end())
+		{
+			auto & kit = mit->second.find(morphKeys[i]);
+			if (kit != mit->second.end())
+			{
+				values[i] = kit->second;
+			}
+		}
+	}
+}
+
+void BodyMorphInterface::ClearMorphArray(TESObjectREFR * actor, UInt32 count, const BSFixedString * morphNames, const BSFixedString * morphKeys)
+{
+	UInt64 handle = g_overrideInterface.GetHandle(actor, TESObjectREFR::kTypeID);
+
+	SimpleLocker<ActorMorphs::MorphMap> locker(&actorMorphs);
+	auto & it = actorMorphs.m_data.find(handle);
+	if (it == actorMorphs.m_data.end())
+		return;
+
+	actorMorphs.MarkDirty(handle);
+	for (UInt32 i = 0; i < count; i++)
+	{
+		auto & mit = it->second.find(morphNames[i]);
+		if (mit != it->second.end())
+		{
+			mit->second.erase(morphKeys[i]);
+		}
+	}
+}
+
 void TriShapeFullVertexData::ApplyMorph(UInt16 vertCount, NiPoint3 * vertices, float factor)
 {
 	if (!vertices)
@@ -864,6 +928,8 @@ void NIOVTaskUpdateModelWeight::Run()
 void BodyMorphInterface::VisitMorphs(TESObjectREFR * actor, std::function<void(BSFixedString name, std::unordered_map<BSFixedString, float> * map)> functor)
 {
 	UInt64 handle = g_overrideInterface.GetHandle(actor, TESObjectREFR::kTypeID);
+	SimpleLocker<ActorMorphs::MorphMap> locker(&actorMorphs);
+	actorMorphs.MarkDirty(handle); // The visitor receives mutable maps
 	auto & it = actorMorphs.m_data.find(handle);
 	if (it != actorMorphs.m_data.end())
 	{
@@ -896,18 +962,104 @@ void BodyMorphInterface::UpdateModelWeight(TESObjectREFR * refr, bool immediate)
 {
 	Actor * actor = DYNAMIC_CAST(refr, TESObjectREFR, Actor);
 	if(actor) {
-		NIOVTaskUpdateModelWeight * updateTask = new NIOVTaskUpdateModelWeight(actor);
 		if (immediate) {
+			NIOVTaskUpdateModelWeight * updateTask = new NIOVTaskUpdateModelWeight(actor);
 			updateTask->Run();
 			updateTask->Dispose();
 		}
 		else
 		{
-			g_task->AddTask(updateTask);
+			updateQueue.Push(actor->formID);
 		}
 	}
 }
 
+void BodyMorphInterface::SetUpdateBudget(UInt32 microseconds)
+{
+	updateQueue.SetBudget(microseconds);
+}
+
+void MorphUpdateQueue::Push(UInt32 formId)
+{
+	SimpleLocker<UpdateSet> locker(this);
+	m_data.insert(formId);
+	if (!m_scheduled) {
+		m_scheduled = true;
+		g_task->AddTask(new NIOVTaskFlushMorphUpdates());
+	}
+}
+
+void MorphUpdateQueue::Flush()
+{
+	std::vector<UInt32> pending;
+	Lock();
+	pending.assign(m_data.begin(), m_data.end());
+	m_data.clear();
+	m_scheduled = false;
+	Release();
+
+	struct PendingUpdate
+	{
+		Actor	* actor;
+		float	priority;
+	};
+
+	std::vector<PendingUpdate> updates;
+	updates.reserve(pending.size());
+
+	PlayerCharacter * player = (*g_thePlayer);
+	for (auto formId : pending)
+	{
+		TESForm * form = LookupFormByID(formId);
+		Actor * actor = DYNAMIC_CAST(form, TESForm, Actor);
+		if (!actor)
+			continue;
+
+		// Player first, then loaded actors by distance, unloaded actors last
+		float priority = 0.0f;
+		if (actor != player) {
+			if (player && actor->GetNiNode()) {
+				float dx = actor->pos.x - player->pos.x;
+				float dy = actor->pos.y - player->pos.y;
+				float dz = actor->pos.z - player->pos.z;
+				priority = 1.0f + dx * dx + dy * dy + dz * dz;
+			}
+			else
+				priority = std::numeric_limits<float>::max();
+		}
+
+		updates.push_back({ actor, priority });
+	}
+
+	std::sort(updates.begin(), updates.end(), [](const PendingUpdate & a, const PendingUpdate & b)
+	{
+		return a.priority < b.priority;
+	});
+
+	auto start = std::chrono::high_resolution_clock::now();
+	for (UInt32 i = 0; i < updates.size(); i++)
+	{
+		// Always make progress, at least one actor per frame
+		if (i > 0 && std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - start).count() >= m_budget) {
+			for (; i < updates.size(); i++)
+				Push(updates[i].actor->formID);
+			break;
+		}
+
+		g_morphInterface.ApplyBodyMorphs(updates[i].actor);
+	}
+}
+
+void NIOVTaskFlushMorphUpdates::Dispose(void)
+{
+	delete this;
+}
+
+void NIOVTaskFlushMorphUpdates::Run()
+{
+	g_morphInterface.updateQueue.Flush();
+}
+
 namespace std
 {
 	std::string &ltrim(std::string &s) {
@@ -1503,19 +1655,24 @@ bool BodyMorphSet::Load(SKSESerializationInterface * intfc, UInt32 kVersion)
 // Serialize ActorMorphs
 void ActorMorphs::Save(SKSESerializationInterface * intfc, UInt32 kVersion)
 {
+	m_cache.Validate(g_stringTable.GetGeneration());
 	for(auto & morph : m_data) {
-		intfc->OpenRecord('MRPH', kVersion);
+		// Unchanged handles replay the records from the previous save
+		m_cache.Write(intfc, morph.first, [&](SKSESerializationInterface * intfc)
+		{
+			intfc->OpenRecord('MRPH', kVersion);
 
-		// Key
-		UInt64 handle = morph.first;
-		intfc->WriteRecordData(&handle, sizeof(handle));
+			// Key
+			UInt64 handle = morph.first;
+			intfc->WriteRecordData(&handle, sizeof(handle));
 
 #ifdef _DEBUG
-		_MESSAGE("%s - Saving Morph Handle %016llX", __FUNCTION__, handle);
+			_MESSAGE("%s - Saving Morph Handle %016llX", __FUNCTION__, handle);
 #endif
 
-		// Value
-		morph.second.Save(intfc, kVersion);
+			// Value
+			morph.second.Save(intfc, kVersion);
+		});
 	}
 }
 
@@ -1673,6 +1830,7 @@ bool ActorMorphs::Load(SKSESerializationInterface * intfc, UInt32 kVersion)
 
 	if (g_enableBodyGen)
 	{
+		MarkDirty(newHandle);
 		m_data.insert_or_assign(newHandle, morphMap);
 
 		TESObjectREFR * refr = (TESObjectREFR *)g_overrideInterface.GetObject(handle, TESObjectREFR::kTypeID);
@@ -2,6 +2,7 @@
 
 #include "interfaces/IPluginInterface.h"
 #include "interfaces/IHashType.h"
+#include "nioverride/RecordStream.h"
 
 #include "skse/GameTypes.h"
 #include "skse/GameThreads.h"
@@ -11,6 +12,7 @@
 #include <set>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include <functional>
 #include <memory>
 #include <ctime>
@@ -62,6 +64,12 @@ public:
 	// Serialization
 	void Save(SKSESerializationInterface * intfc, UInt32 kVersion);
 	bool Load(SKSESerializationInterface * intfc, UInt32 kVersion);
+
+	void MarkDirty(UInt64 handle) { m_cache.Invalidate(handle); }
+	void MarkAllDirty() { m_cache.Clear(); }
+
+private:
+	RecordCache	m_cache;
 };
 
 class TriShapeVertexDelta
@@ -169,6 +177,35 @@ private:
 	UInt32	m_formId;
 };
 
+// Actors waiting for a model weight update. Requests for the same actor
+// merge, the set is flushed by a single task on the next frame.
+class MorphUpdateQueue : public SafeDataHolder<std::unordered_set<UInt32>>
+{
+public:
+	typedef std::unordered_set<UInt32>	UpdateSet;
+
+	MorphUpdateQueue() : m_scheduled(false), m_budget(2000) { }
+
+	void Push(UInt32 formId);
+
+	// Updates the player first, then the nearest actors, until the budget
+	// is spent. Whatever is left is pushed to the next frame.
+	void Flush();
+
+	void SetBudget(UInt32 microseconds) { m_budget = microseconds; }
+
+private:
+	bool	m_scheduled;
+	UInt32	m_budget;
+};
+
+class NIOVTaskFlushMorphUpdates : public TaskDelegate
+{
+public:
+	virtual void Run();
+	virtual void Dispose();
+};
+
 class BodyGenMorphData
 {
 public:
@@ -219,7 +256,8 @@ class BodyMorphInterface : public IPluginInterface
 public:
 	enum
 	{
-		kCurrentPluginVersion = 3,
+		kCurrentPluginVersion = 4,
+		kPluginVersion_MorphArrays = 4,	// SetMorphArray, GetMorphArray, ClearMorphArray, SetUpdateBudget
 		kSerializationVersion1 = 1,
 		kSerializationVersion2 = 2,
 		kSerializationVersion = kSerializationVersion2
@@ -261,9 +299,19 @@ public:
 	virtual void VisitStrings(std::function<void(BSFixedString)> functor);
 	virtual void VisitActors(std::function<void(TESObjectREFR*)> functor);
 
+	// Batched variants of SetMorph/GetMorph/ClearMorph, each entry is a (name, key) pair
+	virtual void SetMorphArray(TESObjectREFR * actor, UInt32 count, const BSFixedString * morphNames, const BSFixedString * morphKeys, const float * values);
+	virtual void GetMorphArray(TESObjectREFR * actor, UInt32 count, const BSFixedString * morphNames, const BSFixedString * morphKeys, float * values);
+	virtual void ClearMorphArray(TESObjectREFR * actor, UInt32 count, const BSFixedString * morphNames, const BSFixedString * morphKeys);
+
+	virtual void SetUpdateBudget(UInt32 microseconds);
+
 private:
 	ActorMorphs	actorMorphs;
 	MorphCache	morphCache;
 	BodyGenTemplates bodyGenTemplates;
 	BodyGenData	bodyGenData;
+	MorphUpdateQueue	updateQueue;
+
+	friend class NIOVTaskFlushMorphUpdates;
 };
\ No newline at end of file
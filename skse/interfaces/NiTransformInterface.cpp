@@ -108,19 +108,24 @@ bool NodeTransformKeys::Load(SKSESerializationInterface * intfc, UInt32 kVersion
 
 void NodeTransformRegistrationMapHolder::Save(SKSESerializationInterface* intfc, UInt32 kVersion)
 {
+	m_cache.Validate(g_stringTable.GetGeneration());
 	for (NodeTransformRegistrationMapHolder::RegMap::iterator it = m_data.begin(); it != m_data.end(); ++it) {
-		intfc->OpenRecord('ACTM', kVersion);
+		// Unchanged handles replay the records from the previous save
+		m_cache.Write(intfc, it->first, [&](SKSESerializationInterface * intfc)
+		{
+			intfc->OpenRecord('ACTM', kVersion);
 
-		// Key
-		UInt64 handle = it->first;
-		intfc->WriteRecordData(&handle, sizeof(handle));
+			// Key
+			UInt64 handle = it->first;
+			intfc->WriteRecordData(&handle, sizeof(handle));
 
 #ifdef _DEBUG
-		_MESSAGE("%s - Saving Handle %016llX", __FUNCTION__, handle);
+			_MESSAGE("%s - Saving Handle %016llX", __FUNCTION__, handle);
 #endif
 
-		// Value
-		it->second.Save(intfc, kVersion);
+			// Value
+			it->second.Save(intfc, kVersion);
+		});
 	}
 }
 
@@ -166,6 +171,7 @@ bool NodeTransformRegistrationMapHolder::Load(SKSESerializationInterface* intfc,
 	*outHandle = newHandle;
 
 	Lock();
+	MarkDirty(newHandle);
 	m_data[newHandle] = reg;
 	Release();
 
@@ -250,6 +256,7 @@ bool NiTransformInterface::AddNodeTransform(TESObjectREFR * refr, bool firstPers
 	SimpleLocker<NodeTransformRegistrationMapHolder::RegMap> lock(&transformData);
 
 	UInt64 handle = g_overrideInterface.GetHandle(refr, refr->formType);
+	transformData.MarkDirty(handle);
 	transformData.m_data[handle][isFemale ? 1 : 0][firstPerson ? 1 : 0][node][name].erase(value);
 	transformData.m_data[handle][isFemale ? 1 : 0][firstPerson ? 1 : 0][node][name].insert(value);
 	return true;
@@ -263,6 +270,7 @@ bool NiTransformInterface::RemoveNodeTransform(TESObjectREFR * refr, bool firstP
 	UInt8 gender = isFemale ? 1 : 0;
 	UInt8 fp = firstPerson ? 1 : 0;
 	UInt64 handle = g_overrideInterface.GetHandle(refr, refr->formType);
+	transformData.MarkDirty(handle);
 
 	auto & it = transformData.m_data.find(handle);
 	if (it != transformData.m_data.end())
@@ -284,6 +292,8 @@ bool NiTransformInterface::RemoveNodeTransform(TESObjectREFR * refr, bool firstP
 
 void NiTransformInterface::RemoveInvalidTransforms(UInt64 handle)
 {
+	SimpleLocker<NodeTransformRegistrationMapHolder::RegMap> lock(&transformData);
+	transformData.MarkDirty(handle);
 	auto & it = transformData.m_data.find(handle);
 	if (it != transformData.m_data.end())
 	{
@@ -313,6 +323,7 @@ void NiTransformInterface::RemoveInvalidTransforms(UInt64 handle)
 void NiTransformInterface::RemoveNamedTransforms(UInt64 handle, BSFixedString name)
 {
 	SimpleLocker<NodeTransformRegistrationMapHolder::RegMap> lock(&transformData);
+	transformData.MarkDirty(handle);
 
 	auto & it = transformData.m_data.find(handle);
 	if (it != transformData.m_data.end())
@@ -342,6 +353,7 @@ void NiTransformInterface::Revert()
 	}
 
 	SimpleLocker<NodeTransformRegistrationMapHolder::RegMap> lock(&transformData);
+	transformData.MarkAllDirty();
 	transformData.m_data.clear();
 }
 
@@ -350,6 +362,7 @@ void NiTransformInterface::RemoveAllReferenceTransforms(TESObjectREFR * refr)
 	SimpleLocker<NodeTransformRegistrationMapHolder::RegMap> lock(&transformData);
 
 	UInt64 handle = g_overrideInterface.GetHandle(refr, refr->formType);
+	transformData.MarkDirty(handle);
 	auto & it = transformData.m_data.find(handle);
 	if (it != transformData.m_data.end())
 	{
@@ -364,6 +377,7 @@ bool NiTransformInterface::RemoveNodeTransformComponent(TESObjectREFR * refr, bo
 	UInt8 gender = isFemale ? 1 : 0;
 	UInt8 fp = firstPerson ? 1 : 0;
 	UInt64 handle = g_overrideInterface.GetHandle(refr, refr->formType);
+	transformData.MarkDirty(handle);
 	auto & it = transformData.m_data.find(handle);
 	if (it != transformData.m_data.end())
 	{
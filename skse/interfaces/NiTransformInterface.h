@@ -28,6 +28,12 @@ public:
 
 	void Save(SKSESerializationInterface * intfc, UInt32 kVersion);
 	bool Load(SKSESerializationInterface * intfc, UInt32 kVersion, UInt64 * outHandle);
+
+	void MarkDirty(UInt64 handle) { m_cache.Invalidate(handle); }
+	void MarkAllDirty() { m_cache.Clear(); }
+
+private:
+	RecordCache	m_cache;
 };
 
 // Node names are hashed here due to some case where the node "NPC" gets overwritten for some unknown reason
@@ -27,6 +27,7 @@ UInt32 OverrideInterface::GetVersion()
 void OverrideInterface::AddRawOverride(UInt64 handle, bool isFemale, UInt64 armorHandle, UInt64 addonHandle, BSFixedString nodeName, OverrideVariant & value)
 {
 	armorData.Lock();
+	armorData.MarkDirty(handle);
 	armorData.m_data[handle][isFemale ? 1 : 0][armorHandle][addonHandle][nodeName].erase(value);
 	armorData.m_data[handle][isFemale ? 1 : 0][armorHandle][addonHandle][nodeName].insert(value);
 	armorData.Release();
@@ -38,6 +39,7 @@ void OverrideInterface::AddOverride(TESObjectREFR * refr, bool isFemale, TESObje
 	UInt64 armorHandle = GetHandle(armor, armor->formType);
 	UInt64 addonHandle = GetHandle(addon, addon->formType);
 	armorData.Lock();
+	armorData.MarkDirty(handle);
 	armorData.m_data[handle][isFemale ? 1 : 0][armorHandle][addonHandle][nodeName].erase(value);
 	armorData.m_data[handle][isFemale ? 1 : 0][armorHandle][addonHandle][nodeName].insert(value);
 	armorData.Release();
@@ -46,6 +48,7 @@ void OverrideInterface::AddOverride(TESObjectREFR * refr, bool isFemale, TESObje
 void OverrideInterface::AddRawNodeOverride(UInt64 handle, bool isFemale, BSFixedString nodeName, OverrideVariant & value)
 {
 	nodeData.Lock();
+	nodeData.MarkDirty(handle);
 	nodeData.m_data[handle][isFemale ? 1 : 0][nodeName].erase(value);
 	nodeData.m_data[handle][isFemale ? 1 : 0][nodeName].insert(value);
 	nodeData.Release();
@@ -55,11 +58,27 @@ void OverrideInterface::AddNodeOverride(TESObjectREFR * refr, bool isFemale, BSF
 {
 	UInt64 handle = GetHandle(refr, refr->formType);
 	nodeData.Lock();
+	nodeData.MarkDirty(handle);
 	nodeData.m_data[handle][isFemale ? 1 : 0][nodeName].erase(value);
 	nodeData.m_data[handle][isFemale ? 1 : 0][nodeName].insert(value);
 	nodeData.Release();
 }
 
+void OverrideInterface::AddNodeOverrideArray(TESObjectREFR * refr, bool isFemale, UInt32 count, const BSFixedString * nodeNames, OverrideVariant * values)
+{
+	UInt64 handle = GetHandle(refr, refr->formType);
+	nodeData.Lock();
+	nodeData.MarkDirty(handle);
+	auto & nodes = nodeData.m_data[handle][isFemale ? 1 : 0];
+	for (UInt32 i = 0; i < count; i++)
+	{
+		auto & set = nodes[nodeNames[i]];
+		set.erase(values[i]);
+		set.insert(values[i]);
+	}
+	nodeData.Release();
+}
+
 void OverrideInterface::AddRawWeaponOverride(UInt64 handle, bool isFemale, bool firstPerson, UInt64 weaponHandle, BSFixedString nodeName, OverrideVariant & value)
 {
 	weaponData.Lock();
@@ -254,6 +273,7 @@ void OverrideInterface::RemoveAllReferenceSkinOverrides(TESObjectREFR * refr)
 void OverrideInterface::RemoveAllReferenceOverrides(UInt64 handle)
 {
 	armorData.Lock();
+	armorData.MarkDirty(handle);
 	armorData.m_data.erase(handle);
 	armorData.Release();
 }
@@ -261,6 +281,7 @@ void OverrideInterface::RemoveAllReferenceOverrides(UInt64 handle)
 void OverrideInterface::RemoveAllReferenceNodeOverrides(UInt64 handle)
 {
 	nodeData.Lock();
+	nodeData.MarkDirty(handle);
 	nodeData.m_data.erase(handle);
 	nodeData.Release();
 }
@@ -284,6 +305,7 @@ void OverrideInterface::RemoveAllArmorOverrides(TESObjectREFR * refr, bool isFem
 	UInt8 gender = isFemale ? 1 : 0;
 	UInt64 handle = GetHandle(refr, refr->formType);
 	SimpleLocker<ActorRegistrationMapHolder::RegMap> locker(&armorData);
+	armorData.MarkDirty(handle);
 	auto & it = armorData.m_data.find(handle);
 	if(it != armorData.m_data.end())
 	{
@@ -300,6 +322,7 @@ void OverrideInterface::RemoveAllArmorAddonOverrides(TESObjectREFR * refr, bool
 	UInt8 gender = isFemale ? 1 : 0;
 	UInt64 handle = GetHandle(refr, refr->formType);
 	SimpleLocker<ActorRegistrationMapHolder::RegMap> locker(&armorData);
+	armorData.MarkDirty(handle);
 	auto & it = armorData.m_data.find(handle);
 	if(it != armorData.m_data.end())
 	{
@@ -322,6 +345,7 @@ void OverrideInterface::RemoveAllArmorAddonNodeOverrides(TESObjectREFR * refr, b
 	UInt8 gender = isFemale ? 1 : 0;
 	UInt64 handle = GetHandle(refr, refr->formType);
 	SimpleLocker<ActorRegistrationMapHolder::RegMap> locker(&armorData);
+	armorData.MarkDirty(handle);
 	auto & it = armorData.m_data.find(handle);
 	if(it != armorData.m_data.end())
 	{
@@ -348,6 +372,7 @@ void OverrideInterface::RemoveArmorAddonOverride(TESObjectREFR * refr, bool isFe
 	UInt8 gender = isFemale ? 1 : 0;
 	UInt64 handle = GetHandle(refr, refr->formType);
 	SimpleLocker<ActorRegistrationMapHolder::RegMap> locker(&armorData);
+	armorData.MarkDirty(handle);
 	auto & it = armorData.m_data.find(handle);
 	if(it != armorData.m_data.end())
 	{
@@ -381,6 +406,7 @@ void OverrideInterface::RemoveAllNodeNameOverrides(TESObjectREFR * refr, bool is
 	UInt8 gender = isFemale ? 1 : 0;
 	UInt64 handle = GetHandle(refr, refr->formType);
 	SimpleLocker<NodeRegistrationMapHolder::RegMap> locker(&nodeData);
+	nodeData.MarkDirty(handle);
 	auto & it = nodeData.m_data.find(handle);
 	if(it != nodeData.m_data.end())
 	{
@@ -397,6 +423,7 @@ void OverrideInterface::RemoveNodeOverride(TESObjectREFR * refr, bool isFemale,
 	UInt8 gender = isFemale ? 1 : 0;
 	UInt64 handle = GetHandle(refr, refr->formType);
 	SimpleLocker<NodeRegistrationMapHolder::RegMap> locker(&nodeData);
+	nodeData.MarkDirty(handle);
 	auto & it = nodeData.m_data.find(handle);
 	if(it != nodeData.m_data.end())
 	{
@@ -838,6 +865,42 @@ void OverrideInterface::SetNodeProperty(TESObjectREFR * refr, BSFixedString node
 	}
 }
 
+void OverrideInterface::SetNodePropertyArray(TESObjectREFR * refr, UInt32 count, const BSFixedString * nodeNames, OverrideVariant * values, bool immediate)
+{
+	NiNode * lastRoot = NULL;
+	for(UInt32 i = 0; i <= 1; i++)
+	{
+		NiNode * root = refr->GetNiRootNode(i); // Apply to third and first person
+		if(root == lastRoot) // First and Third are the same, skip
+			continue;
+
+		if(root) {
+			root->IncRef();
+
+			// Search each distinct node once per root, deferred texture
+			// changes go out as one task per geometry
+			std::unordered_map<const char*, NiAVObject*> foundNodes;
+			NIOVTextureBatch textureBatch;
+			for (UInt32 n = 0; n < count; n++)
+			{
+				const char * nodeName = nodeNames[n].data;
+				auto it = foundNodes.find(nodeName);
+				if (it == foundNodes.end())
+					it = foundNodes.emplace(nodeName, root->GetObjectByName(&nodeName)).first;
+
+				if(it->second) {
+					SetShaderProperty(it->second, &values[n], immediate, &textureBatch);
+				}
+			}
+			textureBatch.Flush();
+
+			root->DecRef();
+		}
+
+		lastRoot = root;
+	}
+}
+
 void OverrideInterface::GetNodeProperty(TESObjectREFR * refr, bool firstPerson, BSFixedString nodeName, OverrideVariant * value)
 {
 	NiNode * root = refr->GetNiRootNode(firstPerson ? 1 : 0); // Apply to third and first person
@@ -1423,10 +1486,12 @@ void OverrideRegistration<T>::Visit(std::function<bool(const T & key, OverrideSe
 void OverrideInterface::Revert()
 {
 	armorData.Lock();
+	armorData.MarkAllDirty();
 	armorData.m_data.clear();
 	armorData.Release();
 
 	nodeData.Lock();
+	nodeData.MarkAllDirty();
 	nodeData.m_data.clear();
 	nodeData.Release();
 
@@ -1438,6 +1503,7 @@ void OverrideInterface::Revert()
 void OverrideInterface::RemoveAllOverrides()
 {
 	armorData.Lock();
+	armorData.MarkAllDirty();
 	armorData.m_data.clear();
 	armorData.Release();
 }
@@ -1445,6 +1511,7 @@ void OverrideInterface::RemoveAllOverrides()
 void OverrideInterface::RemoveAllNodeOverrides()
 {
 	nodeData.Lock();
+	nodeData.MarkAllDirty();
 	nodeData.m_data.clear();
 	nodeData.Release();
 }
@@ -2264,6 +2331,7 @@ bool NodeRegistrationMapHolder::Load(SKSESerializationInterface * intfc, UInt32
 	*outHandle = newHandle;
 
 	Lock();
+	MarkDirty(newHandle);
 	m_data[newHandle] = reg;
 	Release();
 	return error;
@@ -2271,37 +2339,47 @@ bool NodeRegistrationMapHolder::Load(SKSESerializationInterface * intfc, UInt32
 
 void NodeRegistrationMapHolder::Save(SKSESerializationInterface* intfc, UInt32 kVersion)
 {
+	m_cache.Validate(g_stringTable.GetGeneration());
 	for(auto it = m_data.begin(); it != m_data.end(); ++it) {
-		intfc->OpenRecord('NDEN', kVersion);
+		// Unchanged handles replay the records from the previous save
+		m_cache.Write(intfc, it->first, [&](SKSESerializationInterface * intfc)
+		{
+			intfc->OpenRecord('NDEN', kVersion);
 
-		// Key
-		UInt64 handle = it->first;
-		intfc->WriteRecordData(&handle, sizeof(handle));
+			// Key
+			UInt64 handle = it->first;
+			intfc->WriteRecordData(&handle, sizeof(handle));
 
 #ifdef _DEBUG
-		_MESSAGE("%s - Saving Handle %016llX", __FUNCTION__, handle);
+			_MESSAGE("%s - Saving Handle %016llX", __FUNCTION__, handle);
 #endif
 
-		// Value
-		it->second.Save(intfc, kVersion);
+			// Value
+			it->second.Save(intfc, kVersion);
+		});
 	}
 }
 
 void ActorRegistrationMapHolder::Save(SKSESerializationInterface* intfc, UInt32 kVersion)
 {
+	m_cache.Validate(g_stringTable.GetGeneration());
 	for(auto it = m_data.begin(); it != m_data.end(); ++it) {
-		intfc->OpenRecord('ACEN', kVersion);
+		// Unchanged handles replay the records from the previous save
+		m_cache.Write(intfc, it->first, [&](SKSESerializationInterface * intfc)
+		{
+			intfc->OpenRecord('ACEN', kVersion);
 
-		// Key
-		UInt64 handle = it->first;
-		intfc->WriteRecordData(&handle, sizeof(handle));
+			// Key
+			UInt64 handle = it->first;
+			intfc->WriteRecordData(&handle, sizeof(handle));
 
 #ifdef _DEBUG
-		_MESSAGE("%s - Saving Handle %016llX", __FUNCTION__, handle);
+			_MESSAGE("%s - Saving Handle %016llX", __FUNCTION__, handle);
 #endif
 
-		// Value
-		it->second.Save(intfc, kVersion);
+			// Value
+			it->second.Save(intfc, kVersion);
+		});
 	}
 }
 
@@ -2349,6 +2427,7 @@ bool ActorRegistrationMapHolder::Load(SKSESerializationInterface* intfc, UInt32
 	*outHandle = newHandle;
 
 	Lock();
+	MarkDirty(newHandle);
 	m_data[newHandle] = reg;
 	Release();
 
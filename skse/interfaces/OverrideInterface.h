@@ -2,6 +2,7 @@
 
 #include "interfaces/IPluginInterface.h"
 #include "interfaces/IHashType.h"
+#include "nioverride/RecordStream.h"
 
 #include "skse/GameTypes.h"
 #include "skse/NiTypes.h"
@@ -179,6 +180,12 @@ public:
 	// Serialization
 	void Save(SKSESerializationInterface * intfc, UInt32 kVersion);
 	bool Load(SKSESerializationInterface * intfc, UInt32 kVersion, UInt64 * outHandle);
+
+	void MarkDirty(UInt64 handle) { m_cache.Invalidate(handle); }
+	void MarkAllDirty() { m_cache.Clear(); }
+
+private:
+	RecordCache	m_cache;
 };
 
 class NodeRegistrationMapHolder : public SafeDataHolder<std::unordered_map<UInt64, MultiRegistration<OverrideRegistration<BSFixedString>, 2>>>
@@ -189,6 +196,12 @@ public:
 	// Serialization
 	void Save(SKSESerializationInterface * intfc, UInt32 kVersion);
 	bool Load(SKSESerializationInterface * intfc, UInt32 kVersion, UInt64 * outHandle);
+
+	void MarkDirty(UInt64 handle) { m_cache.Invalidate(handle); }
+	void MarkAllDirty() { m_cache.Clear(); }
+
+private:
+	RecordCache	m_cache;
 };
 
 class WeaponRegistrationMapHolder : public SafeDataHolder<std::unordered_map<UInt64, MultiRegistration<MultiRegistration<WeaponRegistration, 2>, 2>>>
@@ -216,7 +229,8 @@ class OverrideInterface : public IPluginInterface
 public:
 	enum
 	{
-		kCurrentPluginVersion = 1,
+		kCurrentPluginVersion = 2,
+		kPluginVersion_NodeArrays = 2,	// AddNodeOverrideArray, SetNodePropertyArray
 		kSerializationVersion1 = 1,
 		kSerializationVersion2 = 2,
 		kSerializationVersion = kSerializationVersion2
@@ -326,6 +340,10 @@ public:
 	virtual void VisitSkin(TESObjectREFR * refr, bool isFemale, bool firstPerson, std::function<void(UInt32, OverrideVariant&)> functor);
 	virtual void VisitStrings(std::function<void(BSFixedString)> functor);
 
+	// Batched AddNodeOverride/SetNodeProperty, each value belongs to the node at the same position
+	virtual void AddNodeOverrideArray(TESObjectREFR * refr, bool isFemale, UInt32 count, const BSFixedString * nodeNames, OverrideVariant * values);
+	virtual void SetNodePropertyArray(TESObjectREFR * refr, UInt32 count, const BSFixedString * nodeNames, OverrideVariant * values, bool immediate);
+
 #ifdef _DEBUG
 	void DumpMap();
 #endif
@@ -205,24 +205,16 @@ void TintMaskInterface::ApplyMasks(TESObjectREFR * refr, bool isFirstPerson, TES
 				if(lightingShader) {
 					BSLightingShaderMaterial * material = (BSLightingShaderMaterial *)lightingShader->material;
 					
-					BSRenderTargetGroup * newTarget = NULL;
-					if (m_maskMap.IsCaching())
-						newTarget = m_maskMap.GetRenderTargetGroup(lightingShader);
-					if (!newTarget) {
-						UInt32 width = 0;
-						UInt32 height = 0;
-						if (mask.resolutionWData)
-							width = mask.resolutionWData;
-						if (mask.resolutionHData)
-							height = mask.resolutionHData;
-						else
-							height = mask.resolutionWData;
-
-						newTarget = CreateMaskTarget(width, height);
-						if (newTarget && m_maskMap.IsCaching()) {
-							m_maskMap.AddRenderTargetGroup(lightingShader, newTarget);
-						}
-					}
+					UInt32 width = 0;
+					UInt32 height = 0;
+					if (mask.resolutionWData)
+						width = mask.resolutionWData;
+					if (mask.resolutionHData)
+						height = mask.resolutionHData;
+					else
+						height = mask.resolutionWData;
+
+					BSRenderTargetGroup * newTarget = m_maskMap.AcquireRenderTargetGroup(lightingShader, width, height);
 					if(newTarget) {
 						tArray<TintMask*> tintMasks;
 						CreateTintsFromData(tintMasks, mask.layerCount, mask.textureData, mask.colorData, mask.alphaData, overrideMap);
@@ -249,13 +241,15 @@ void TintMaskInterface::ApplyMasks(TESObjectREFR * refr, bool isFirstPerson, TES
 						if (ApplyMasksToRenderTarget(&tintMasks, (BSRenderTargetGroup **)&target)) {
 							BSMaskedShaderMaterial * tintedMaterial = static_cast<BSMaskedShaderMaterial*>(CreateShaderMaterial(BSMaskedShaderMaterial::kShaderType_FaceGen));
 							CALL_MEMBER_FN(tintedMaterial, CopyFrom)(material);
+							// The material takes over a reference without adding its own, hand it
+							// one so the pooled target keeps the reference it was created with
+							if (renderedTexture)
+								renderedTexture->IncRef();
 							tintedMaterial->renderedTexture = renderedTexture;
 							CALL_MEMBER_FN(lightingShader, SetFlags)(0x0A, true); // Enable detailmap
 							CALL_MEMBER_FN(lightingShader, SetFlags)(0x15, false); // Disable FaceGen_RGB
 							//material->ReleaseTextures();
 							CALL_MEMBER_FN(lightingShader, SetMaterial)((BSMaskedShaderMaterial*)tintedMaterial, 1); // New material takes texture ownership
-							if (renderedTexture) // Let the material now take ownership since the old target is destroyed now
-								renderedTexture->DecRef();
 							CALL_MEMBER_FN(lightingShader, InitializeShader)(mask.object);
 						}
 
@@ -270,40 +264,141 @@ void TintMaskInterface::ApplyMasks(TESObjectREFR * refr, bool isFirstPerson, TES
 	}
 }
 
+UInt32 GetMaskTargetMemory(UInt32 width, UInt32 height)
+{
+	// Unsized targets are created at the renderer's default, assume 512x512
+	if (width == 0 || height == 0)
+		width = height = 512;
+
+	return width * height * 4;
+}
+
+void DestroyMaskTarget(TintMaskTarget & entry)
+{
+	// The target releases only its own texture reference, every material it
+	// was applied to holds a separate one from ApplyMasks
+	entry.target->DecRef();
+	entry.target = NULL;
+}
+
 void TintMaskMap::ManageRenderTargetGroups()
 {
 	SimpleLocker<TintMaskCacheMap> locker(this);
 	m_caching = true;
 }
 
-BSRenderTargetGroup * TintMaskMap::GetRenderTargetGroup(BSLightingShaderProperty* key)
+BSRenderTargetGroup * TintMaskMap::AcquireRenderTargetGroup(BSLightingShaderProperty* key, UInt32 width, UInt32 height)
 {
+	SimpleLocker<TintMaskCacheMap> locker(this);
+
+	UInt64 size = ((UInt64)width << 32) | (UInt64)height;
+
+	// Re-tinting the same shader renders into the target it already owns
 	auto & it = m_data.find(key);
-	if (it != m_data.end())
-		return it->second;
+	if (it != m_data.end()) {
+		if (it->second.key == size) {
+			it->second.accessed = std::time(nullptr);
+			return it->second.target;
+		}
+
+		// Resolution changed, the old texture is still bound so it can't be pooled
+		DestroyMaskTarget(it->second);
+		it->first->DecRef();
+		m_data.erase(it);
+	}
 
-	return NULL;
+	auto popIdle = [&](TintMaskTarget & entry)
+	{
+		auto & bucket = m_pool.find(size);
+		if (bucket == m_pool.end() || bucket->second.empty())
+			return false;
+
+		entry = bucket->second.back();
+		bucket->second.pop_back();
+		m_idleMemory -= entry.memoryUsage;
+		return true;
+	};
+
+	TintMaskTarget entry;
+	if (!popIdle(entry)) {
+		// Reclaim targets from unloaded geometry before allocating
+		Collect();
+		if (!popIdle(entry)) {
+			entry.target = CreateMaskTarget(width, height);
+			if (!entry.target)
+				return NULL;
+
+			entry.target->IncRef();
+			entry.key = size;
+			entry.memoryUsage = GetMaskTargetMemory(width, height);
+		}
+	}
+
+	entry.accessed = std::time(nullptr);
+
+	key->IncRef();
+	m_data.emplace(key, entry);
+
+	Shrink();
+	return entry.target;
 }
 
-void TintMaskMap::AddRenderTargetGroup(BSLightingShaderProperty* key, BSRenderTargetGroup* value)
+void TintMaskMap::ReleaseRenderTargetGroups()
 {
 	SimpleLocker<TintMaskCacheMap> locker(this);
-	auto & it = m_data.emplace(key, value);
-	if (it.second == true) {
-		key->IncRef();
-		value->IncRef();
+	m_caching = false;
+	Collect();
+	Shrink();
+}
+
+void TintMaskMap::Collect()
+{
+	std::time_t now = std::time(nullptr);
+	for (auto it = m_data.begin(); it != m_data.end();)
+	{
+		// Only we still reference the shader, the armor was unequipped or unloaded
+		if (it->first->m_uiRefCount == 1) {
+			it->first->DecRef();
+			it->second.accessed = now;
+			m_idleMemory += it->second.memoryUsage;
+			m_pool[it->second.key].push_back(it->second);
+			it = m_data.erase(it);
+		}
+		else
+			++it;
 	}
 }
 
-void TintMaskMap::ReleaseRenderTargetGroups()
+void TintMaskMap::Shrink()
 {
-	SimpleLocker<TintMaskCacheMap> locker(this);
-	for (auto & it : m_data) {
-		it.first->DecRef();
-		it.second->DecRef();
+	// Keep everything around while a load is in progress
+	if (m_caching)
+		return;
+
+	while (m_idleMemory > m_memoryLimit)
+	{
+		std::vector<TintMaskTarget> * oldestBucket = NULL;
+		std::vector<TintMaskTarget>::iterator oldest;
+		for (auto & bucket : m_pool)
+		{
+			for (auto it = bucket.second.begin(); it != bucket.second.end(); ++it)
+			{
+				if (!oldestBucket || it->accessed < oldest->accessed) {
+					oldestBucket = &bucket.second;
+					oldest = it;
+				}
+			}
+		}
+
+		if (!oldestBucket) { // Just in case we erased but messed up
+			m_idleMemory = 0;
+			break;
+		}
+
+		m_idleMemory -= oldest->memoryUsage;
+		DestroyMaskTarget(*oldest);
+		oldestBucket->erase(oldest);
 	}
-	m_data.clear();
-	m_caching = false;
 }
 
 void BSReadAll(BSResourceNiBinaryStream* fin, std::string * out)
@@ -316,66 +411,54 @@ void BSReadAll(BSResourceNiBinaryStream* fin, std::string * out)
 	}
 }
 
-MaskLayerTuple * MaskDiffuseMap::GetMaskLayers(BSFixedString texture)
-{
-	auto & it = find(texture.data);
-	if (it != end()) {
-		return &it->second;
-	}
-
-	return NULL;
-}
-
-MaskDiffuseMap * MaskTriShapeMap::GetDiffuseMap(BSFixedString triShape)
+UInt64 MaskKey::Hash(const char * str, UInt64 seed)
 {
-	auto & it = find(triShape.data);
-	if (it != end()) {
-		return &it->second;
+	UInt64 hash = seed;
+	if (str) {
+		for (const char * c = str; *c; c++)
+		{
+			hash ^= (UInt8)tolower(*c);
+			hash *= kPrime;
+		}
 	}
 
-	return NULL;
+	return hash;
 }
 
 MaskLayerTuple * MaskModelMap::GetMask(BSFixedString nif, BSFixedString trishape, BSFixedString diffuse)
 {
-	return &m_data[nif.data][trishape.data][diffuse.data];
+	UInt64 nifHash = MaskKey::Hash(nif.data);
+	UInt64 shapeHash = MaskKey::Combine(nifHash, trishape.data);
+	m_shapes.insert(nifHash);
+	m_shapes.insert(shapeHash);
+	return &m_data[MaskKey::Combine(shapeHash, diffuse.data)];
 }
 
-MaskTriShapeMap * MaskModelMap::GetTriShapeMap(BSFixedString nifPath)
-{
-	auto & it = m_data.find(nifPath.data);
-	if (it != m_data.end()) {
-		return &it->second;
-	}
-
-	return NULL;
-}
-
-bool ApplyMaskData(MaskTriShapeMap * triShapeMap, NiAVObject * object, const char * nameOverride, std::function<void(NiGeometry*, MaskLayerTuple*)> functor)
+bool MaskModelMap::ApplyMaskData(UInt64 nifHash, NiAVObject * object, const char * nameOverride, std::function<void(NiGeometry*, MaskLayerTuple*)> functor)
 {
 	if (NiGeometry * geometry = object->GetAsNiGeometry()) {
+		UInt64 shapeHash = MaskKey::Combine(nifHash, nameOverride ? nameOverride : object->m_name);
+		if (m_shapes.find(shapeHash) == m_shapes.end())
+			return false;
+
 		geometry->IncRef();
-		auto textureMap = triShapeMap->GetDiffuseMap(nameOverride ? BSFixedString(nameOverride) : object->m_name);
-		if (textureMap) {
-			NiProperty * shaderProperty = niptr_cast<NiProperty>(geometry->m_spEffectState);
-			if (shaderProperty) {
-				shaderProperty->IncRef();
-				BSLightingShaderProperty * lightingShader = ni_cast(shaderProperty, BSLightingShaderProperty);
-				if (lightingShader) {
-					BSLightingShaderMaterial * material = (BSLightingShaderMaterial *)lightingShader->material;
-					if (material->textureSet) {
-						auto layerList = textureMap->GetMaskLayers(material->textureSet->GetTexturePath(0));
-						if (layerList) {
-							functor(geometry, layerList);
-						}
+		NiProperty * shaderProperty = niptr_cast<NiProperty>(geometry->m_spEffectState);
+		if (shaderProperty) {
+			shaderProperty->IncRef();
+			BSLightingShaderProperty * lightingShader = ni_cast(shaderProperty, BSLightingShaderProperty);
+			if (lightingShader) {
+				BSLightingShaderMaterial * material = (BSLightingShaderMaterial *)lightingShader->material;
+				if (material->textureSet) {
+					auto & it = m_data.find(MaskKey::Combine(shapeHash, material->textureSet->GetTexturePath(0)));
+					if (it != m_data.end()) {
+						functor(geometry, &it->second);
 					}
 				}
-				shaderProperty->DecRef();
 			}
-			
-			return true;
+			shaderProperty->DecRef();
 		}
-		geometry->DecRef();
+
+		return true;
 	}
 
 	return false;
@@ -390,25 +473,21 @@ void MaskModelMap::ApplyLayers(TESObjectREFR * refr, bool isFirstPerson, TESObje
 
 	SimpleLocker<MaskModelContainer> locker(this);
 
-	auto triShapeMap = GetTriShapeMap(arma->models[isFirstPerson == true ? 1 : 0][gender].GetModelName());
-	if (!triShapeMap) {
-		triShapeMap = GetTriShapeMap(arma->models[isFirstPerson == true ? 1 : 0][gender].GetModelName());
-		if (!triShapeMap) {
-			return;
-		}
-	}
+	UInt64 nifHash = MaskKey::Hash(arma->models[isFirstPerson == true ? 1 : 0][gender].GetModelName());
+	if (m_shapes.find(nifHash) == m_shapes.end())
+		return;
 
 	UInt32 count = 0;
 	VisitObjects(node, [&](NiAVObject* object)
 	{
-		if (ApplyMaskData(triShapeMap, object, NULL, functor))
+		if (ApplyMaskData(nifHash, object, NULL, functor))
 			count++;
 
 		return false;
 	});
 
 	if (count == 0)
-		ApplyMaskData(triShapeMap, node, "", functor);
+		ApplyMaskData(nifHash, node, "", functor);
 }
 
 void TintMaskInterface::ReadTintData(LPCTSTR lpFolder, LPCTSTR lpFilePattern)
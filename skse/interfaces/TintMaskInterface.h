@@ -24,7 +24,9 @@ class BSRenderTargetGroup;
 #include "skse/GameTypes.h"
 
 #include <unordered_map>
+#include <unordered_set>
 #include <functional>
+#include <ctime>
 
 /*
 MAKE_NI_POINTER(NiRenderedTexture);
@@ -174,20 +176,53 @@ public:
 	BSRenderTargetGroupPtr renderTarget;		// 7C
 };*/
 
-typedef std::unordered_map<BSLightingShaderProperty*, BSRenderTargetGroup*> TintMaskCacheMap;
+class TintMaskTarget
+{
+public:
+	TintMaskTarget() : target(NULL), key(0), memoryUsage(0), accessed(0) { }
+
+	BSRenderTargetGroup	* target;
+	UInt64				key;
+	UInt32				memoryUsage;
+	std::time_t			accessed;
+};
+
+// Render targets currently bound to a shader property
+typedef std::unordered_map<BSLightingShaderProperty*, TintMaskTarget> TintMaskCacheMap;
+
+// Idle render targets bucketed by their resolution
+typedef std::unordered_map<UInt64, std::vector<TintMaskTarget>> TintMaskPoolMap;
 
 class TintMaskMap : public SafeDataHolder<TintMaskCacheMap>
 {
 public:
+	enum
+	{
+		kDefaultMemoryLimit = 32000000
+	};
+
+	TintMaskMap()
+	{
+		m_caching = false;
+		m_idleMemory = 0;
+		m_memoryLimit = kDefaultMemoryLimit;
+	}
+
 	void ManageRenderTargetGroups();
-	BSRenderTargetGroup * GetRenderTargetGroup(BSLightingShaderProperty* key);
-	void AddRenderTargetGroup(BSLightingShaderProperty* key, BSRenderTargetGroup* value);
+	BSRenderTargetGroup * AcquireRenderTargetGroup(BSLightingShaderProperty* key, UInt32 width, UInt32 height);
 	void ReleaseRenderTargetGroups();
 
+	void SetMemoryLimit(UInt32 limit) { m_memoryLimit = limit; }
 	bool IsCaching() const { return m_caching; }
 
 private:
-	bool m_caching;
+	void Collect();
+	void Shrink();
+
+	bool			m_caching;
+	UInt32			m_idleMemory;
+	UInt32			m_memoryLimit;
+	TintMaskPoolMap	m_pool;
 };
 
 typedef std::vector<const char*> MaskTextureList;
@@ -196,31 +231,36 @@ typedef std::vector<float> MaskAlphaList;
 
 typedef std::tuple<UInt16, UInt16, MaskTextureList, MaskColorList, MaskAlphaList, UInt8> MaskLayerTuple;
 
-// maps diffuse names to layer data
-class MaskDiffuseMap : public std::unordered_map<const char*, MaskLayerTuple>
+// Case-insensitive FNV-1a hash of the (nif, trishape, diffuse) path components
+class MaskKey
 {
 public:
-	MaskLayerTuple * GetMaskLayers(BSFixedString texture);
-};
+	enum : UInt64
+	{
+		kOffsetBasis = 0xCBF29CE484222325ULL,
+		kPrime = 0x100000001B3ULL
+	};
 
-// maps trishape names to diffuse names
-class MaskTriShapeMap : public std::unordered_map<const char*, MaskDiffuseMap>
-{
-public:
-	MaskDiffuseMap * GetDiffuseMap(BSFixedString triShape);
+	static UInt64 Hash(const char * str, UInt64 seed = kOffsetBasis);
+	static UInt64 Combine(UInt64 parent, const char * str) { return Hash(str, (parent ^ '|') * kPrime); }
 };
 
+typedef std::unordered_map<UInt64, MaskLayerTuple> MaskModelContainer;
 
-typedef std::unordered_map<const char*, MaskTriShapeMap> MaskModelContainer;
-
-// Maps model names to trishape names
+// Flat index of every (nif, trishape, diffuse) triple, m_shapes holds the
+// nif and (nif, trishape) prefix hashes so geometry without tint data is
+// rejected with a single probe
 class MaskModelMap : public SafeDataHolder<MaskModelContainer>
 {
 public:
 	MaskLayerTuple * GetMask(BSFixedString nif, BSFixedString trishape, BSFixedString diffuse);
 
 	void ApplyLayers(TESObjectREFR * refr, bool isFirstPerson, TESObjectARMA * arma, NiAVObject * node, std::function<void(NiGeometry*, MaskLayerTuple*)> functor);
-	MaskTriShapeMap * GetTriShapeMap(BSFixedString nifPath);
+
+private:
+	bool ApplyMaskData(UInt64 nifHash, NiAVObject * object, const char * nameOverride, std::function<void(NiGeometry*, MaskLayerTuple*)> functor);
+
+	std::unordered_set<UInt64>	m_shapes;
 };
 
 class TintMaskInterface : public IPluginInterface
@@ -228,7 +268,8 @@ class TintMaskInterface : public IPluginInterface
 public:
 	enum
 	{
-		kCurrentPluginVersion = 0,
+		kCurrentPluginVersion = 1,
+		kPluginVersion_TargetPool = 1,	// SetTargetPoolLimit
 		kSerializationVersion1 = 1,
 		kSerializationVersion = kSerializationVersion1
 	};
@@ -249,6 +290,7 @@ public:
 	virtual void ApplyMasks(TESObjectREFR * refr, bool isFirstPerson, TESObjectARMO * armor, TESObjectARMA * addon, NiAVObject * object, std::function<void(ColorMap*)> overrides);
 	virtual void ManageTints() { m_maskMap.ManageRenderTargetGroups(); }
 	virtual void ReleaseTints() { m_maskMap.ReleaseRenderTargetGroups(); }
+	virtual void SetTargetPoolLimit(UInt32 limit) { m_maskMap.SetMemoryLimit(limit); }
 
 	void CreateTintsFromData(tArray<TintMask*> & masks, UInt32 size, const char ** textureData, SInt32 * colorData, float * alphaData, ColorMap & overrides);
 	void ReleaseTintsFromData(tArray<TintMask*> & masks);
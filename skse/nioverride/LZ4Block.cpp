@@ -0,0 +1,182 @@
+#include "LZ4Block.h"
+
+#include <vector>
+
+namespace LZ4Block
+{
+	inline UInt32 Read32(const UInt8 * p)
+	{
+		UInt32 value;
+		memcpy(&value, p, sizeof(value));
+		return value;
+	}
+
+	inline UInt32 HashSequence(UInt32 sequence)
+	{
+		return (sequence * 2654435761U) >> (32 - kHashLog);
+	}
+
+	inline bool WriteLength(UInt8 *& op, UInt8 * oend, UInt32 length)
+	{
+		while (length >= 255) {
+			if (op >= oend)
+				return false;
+			*op++ = 255;
+			length -= 255;
+		}
+		if (op >= oend)
+			return false;
+		*op++ = (UInt8)length;
+		return true;
+	}
+
+	inline bool ReadLength(const UInt8 *& ip, const UInt8 * iend, UInt32 & length)
+	{
+		UInt8 value;
+		do {
+			if (ip >= iend)
+				return false;
+			value = *ip++;
+			length += value;
+		} while (value == 255);
+		return true;
+	}
+
+	bool WriteSequence(UInt8 *& op, UInt8 * oend, const UInt8 * literals, UInt32 literalLength, UInt32 offset, UInt32 matchLength, bool last)
+	{
+		if (op >= oend)
+			return false;
+
+		UInt8 * token = op++;
+		*token = (literalLength >= 15 ? 15 : literalLength) << 4;
+		if (literalLength >= 15 && !WriteLength(op, oend, literalLength - 15))
+			return false;
+
+		if ((UInt32)(oend - op) < literalLength)
+			return false;
+		memcpy(op, literals, literalLength);
+		op += literalLength;
+
+		if (last)
+			return true;
+
+		if (oend - op < 2)
+			return false;
+		*op++ = offset & 0xFF;
+		*op++ = (offset >> 8) & 0xFF;
+
+		matchLength -= kMinMatch;
+		*token |= (matchLength >= 15 ? 15 : matchLength);
+		if (matchLength >= 15 && !WriteLength(op, oend, matchLength - 15))
+			return false;
+
+		return true;
+	}
+}
+
+UInt32 LZ4Block::CompressBound(UInt32 srcSize)
+{
+	return srcSize + (srcSize / 255) + 16;
+}
+
+UInt32 LZ4Block::Compress(const UInt8 * src, UInt32 srcSize, UInt8 * dst, UInt32 dstCapacity)
+{
+	const UInt8 * ip = src;
+	const UInt8 * anchor = src;
+	const UInt8 * iend = src + srcSize;
+	UInt8 * op = dst;
+	UInt8 * oend = dst + dstCapacity;
+
+	if (srcSize > kMatchFindLimit)
+	{
+		const UInt8 * matchLimit = iend - kLastLiterals;
+		const UInt8 * findLimit = iend - kMatchFindLimit;
+
+		std::vector<UInt32> table(1 << kHashLog, 0xFFFFFFFF);
+		while (ip < findLimit)
+		{
+			UInt32 sequence = Read32(ip);
+			UInt32 & entry = table[HashSequence(sequence)];
+			UInt32 candidate = entry;
+			entry = ip - src;
+
+			if (candidate == 0xFFFFFFFF || (ip - src) - candidate > kMaxOffset || Read32(src + candidate) != sequence) {
+				ip++;
+				continue;
+			}
+
+			const UInt8 * match = src + candidate;
+			const UInt8 * matchEnd = ip + kMinMatch;
+			const UInt8 * reference = match + kMinMatch;
+			while (matchEnd < matchLimit && *matchEnd == *reference) {
+				matchEnd++;
+				reference++;
+			}
+
+			if (!WriteSequence(op, oend, anchor, ip - anchor, ip - match, matchEnd - ip, false))
+				return 0;
+
+			ip = matchEnd;
+			anchor = ip;
+		}
+	}
+
+	if (!WriteSequence(op, oend, anchor, iend - anchor, 0, 0, true))
+		return 0;
+
+	return op - dst;
+}
+
+UInt64 LZ4Block::DecompressBound(UInt32 srcSize)
+{
+	return (UInt64)srcSize * 255;
+}
+
+bool LZ4Block::Decompress(const UInt8 * src, UInt32 srcSize, UInt8 * dst, UInt32 dstSize)
+{
+	const UInt8 * ip = src;
+	const UInt8 * iend = src + srcSize;
+	UInt8 * op = dst;
+	UInt8 * oend = dst + dstSize;
+
+	while (ip < iend)
+	{
+		UInt8 token = *ip++;
+
+		UInt32 literalLength = token >> 4;
+		if (literalLength == 15 && !ReadLength(ip, iend, literalLength))
+			return false;
+
+		if ((UInt32)(iend - ip) < literalLength || (UInt32)(oend - op) < literalLength)
+			return false;
+		memcpy(op, ip, literalLength);
+		ip += literalLength;
+		op += literalLength;
+
+		// The last sequence has no match
+		if (ip == iend)
+			break;
+
+		if (iend - ip < 2)
+			return false;
+		UInt32 offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+		if (offset == 0 || offset > (UInt32)(op - dst))
+			return false;
+
+		UInt32 matchLength = token & 0x0F;
+		if (matchLength == 15 && !ReadLength(ip, iend, matchLength))
+			return false;
+		matchLength += kMinMatch;
+
+		if ((UInt32)(oend - op) < matchLength)
+			return false;
+
+		// Matches may overlap the bytes they produce
+		const UInt8 * match = op - offset;
+		for (UInt32 i = 0; i < matchLength; i++)
+			*op++ = *match++;
+	}
+
+	return op == oend;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+// Minimal codec for the LZ4 block format, only what the co-save needs.
+// Compression is a single greedy pass with a 64K entry hash table,
+// decompression validates every length and offset against both buffers.
+namespace LZ4Block
+{
+	enum
+	{
+		kMinMatch = 4,
+		kLastLiterals = 5,
+		kMatchFindLimit = 12,
+		kMaxOffset = 0xFFFF,
+		kHashLog = 16
+	};
+
+	UInt32 CompressBound(UInt32 srcSize);
+
+	// Returns the compressed size, or 0 if dst was too small
+	UInt32 Compress(const UInt8 * src, UInt32 srcSize, UInt8 * dst, UInt32 dstCapacity);
+
+	// Largest size srcSize bytes can decode to, every input byte adds at
+	// most 255 bytes of literal or match length
+	UInt64 DecompressBound(UInt32 srcSize);
+
+	// Fails unless src decodes to exactly dstSize bytes
+	bool Decompress(const UInt8 * src, UInt32 srcSize, UInt8 * dst, UInt32 dstSize);
+}
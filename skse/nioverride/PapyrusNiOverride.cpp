@@ -286,6 +286,75 @@ namespace papyrusNiOverride
 			g_overrideInterface.SetNodeProperty(refr, nodeName, &value, false);
 	}
 
+	// Node names either pair up with the values or a single node receives all of them
+	template<typename T>
+	void AddNodeOverrideArray(StaticFunctionTag* base, TESObjectREFR * refr, bool isFemale, VMArray<BSFixedString> nodeNames, VMArray<UInt32> keys, VMArray<UInt32> indices, VMArray<T> dataTypes, bool persist)
+	{
+		if(!refr)
+			return;
+
+		UInt32 count = dataTypes.Length();
+		UInt32 nodeCount = nodeNames.Length();
+		if((nodeCount != count && nodeCount != 1) || keys.Length() != count || indices.Length() != count) {
+			_ERROR("%s - Array sizes do not match (nodes: %d keys: %d indices: %d values: %d)", __FUNCTION__, nodeCount, keys.Length(), indices.Length(), count);
+			return;
+		}
+
+		std::vector<BSFixedString> nodes;
+		std::vector<OverrideVariant> values;
+		nodes.reserve(count);
+		values.reserve(count);
+
+		BSFixedString nodeName("");
+		for(UInt32 i = 0; i < count; i++)
+		{
+			if(nodeCount > 1 || i == 0)
+				nodeNames.Get(&nodeName, nodeCount > 1 ? i : 0);
+
+			UInt32 key = 0;
+			UInt32 index = 0;
+			T dataType;
+			keys.Get(&key, i);
+			indices.Get(&index, i);
+			dataTypes.Get(&dataType, i);
+
+			if(key > OverrideVariant::kKeyMax)
+				continue;
+
+			if(!OverrideVariant::IsIndexValid(key))
+				index = OverrideVariant::kIndexMax;
+			if(index > OverrideVariant::kIndexMax)
+				index = OverrideVariant::kIndexMax;
+
+			OverrideVariant value;
+			PackValue<T>(&value, key, index, &dataType);
+
+			if(value.type == OverrideVariant::kType_None) {
+				_ERROR("%s - Failed to pack value for \"%s\" node key: %d. Most likely invalid key for type", __FUNCTION__, nodeName.data, key);
+				continue;
+			}
+
+			nodes.push_back(nodeName);
+			values.push_back(value);
+		}
+
+		if(values.empty())
+			return;
+
+		// Adds the properties to the map
+		if(persist)
+			g_overrideInterface.AddNodeOverrideArray(refr, isFemale, values.size(), &nodes[0], &values[0]);
+
+		UInt8 gender = 0;
+		TESNPC * actorBase = DYNAMIC_CAST(refr->baseForm, TESForm, TESNPC);
+		if(actorBase)
+			gender = CALL_MEMBER_FN(actorBase, GetSex)();
+
+		// Applies the properties visually, only if the current gender matches
+		if(isFemale == (gender == 1))
+			g_overrideInterface.SetNodePropertyArray(refr, values.size(), &nodes[0], &values[0], false);
+	}
+
 	template<typename T>
 	T GetNodeOverride(StaticFunctionTag* base, TESObjectREFR * refr, bool isFemale, BSFixedString nodeName, UInt32 key, UInt32 index)
 	{
@@ -785,6 +854,87 @@ namespace papyrusNiOverride
 		g_morphInterface.UpdateModelWeight(refr);
 	}
 
+	// Keys either pair up with the names or a single key applies to all of them
+	bool UnpackMorphArrays(VMArray<BSFixedString> & morphNames, VMArray<BSFixedString> & keyNames, std::vector<BSFixedString> & names, std::vector<BSFixedString> & keys)
+	{
+		UInt32 count = morphNames.Length();
+		UInt32 keyCount = keyNames.Length();
+		if (keyCount != count && keyCount != 1) {
+			_ERROR("%s - Key array size %d does not match morph array size %d", __FUNCTION__, keyCount, count);
+			return false;
+		}
+
+		names.resize(count, BSFixedString(""));
+		keys.resize(count, BSFixedString(""));
+		for (UInt32 i = 0; i < count; i++) {
+			morphNames.Get(&names[i], i);
+			if (keyCount > 1 || i == 0)
+				keyNames.Get(&keys[i], keyCount > 1 ? i : 0);
+			else
+				keys[i] = keys[0];
+		}
+
+		return true;
+	}
+
+	void SetBodyMorphArray(StaticFunctionTag* base, TESObjectREFR * refr, VMArray<BSFixedString> morphNames, VMArray<BSFixedString> keyNames, VMArray<float> values, bool updateWeight)
+	{
+		if (!refr)
+			return;
+
+		std::vector<BSFixedString> names, keys;
+		if (!UnpackMorphArrays(morphNames, keyNames, names, keys))
+			return;
+
+		if (values.Length() != names.size()) {
+			_ERROR("%s - Value array size %d does not match morph array size %d", __FUNCTION__, values.Length(), names.size());
+			return;
+		}
+
+		std::vector<float> data(names.size());
+		for (UInt32 i = 0; i < data.size(); i++)
+			values.Get(&data[i], i);
+
+		if (!data.empty())
+			g_morphInterface.SetMorphArray(refr, data.size(), &names[0], &keys[0], &data[0]);
+
+		if (updateWeight)
+			g_morphInterface.UpdateModelWeight(refr);
+	}
+
+	VMResultArray<float> GetBodyMorphArray(StaticFunctionTag* base, TESObjectREFR * refr, VMArray<BSFixedString> morphNames, VMArray<BSFixedString> keyNames)
+	{
+		VMResultArray<float> result;
+		if (!refr)
+			return result;
+
+		std::vector<BSFixedString> names, keys;
+		if (!UnpackMorphArrays(morphNames, keyNames, names, keys))
+			return result;
+
+		result.resize(names.size(), 0.0);
+		if (!names.empty())
+			g_morphInterface.GetMorphArray(refr, names.size(), &names[0], &keys[0], &result[0]);
+
+		return result;
+	}
+
+	void ClearBodyMorphArray(StaticFunctionTag* base, TESObjectREFR * refr, VMArray<BSFixedString> morphNames, VMArray<BSFixedString> keyNames, bool updateWeight)
+	{
+		if (!refr)
+			return;
+
+		std::vector<BSFixedString> names, keys;
+		if (!UnpackMorphArrays(morphNames, keyNames, names, keys))
+			return;
+
+		if (!names.empty())
+			g_morphInterface.ClearMorphArray(refr, names.size(), &names[0], &keys[0]);
+
+		if (updateWeight)
+			g_morphInterface.UpdateModelWeight(refr);
+	}
+
 	void EnableTintTextureCache(StaticFunctionTag* base)
 	{
 		g_tintMaskInterface.ManageTints();
@@ -1532,6 +1682,21 @@ void papyrusNiOverride::RegisterFuncs(VMClassRegistry* registry)
 	registry->RegisterFunction(
 		new NativeFunction7<StaticFunctionTag, void, TESObjectREFR*, bool, BSFixedString, UInt32, UInt32, BGSTextureSet*, bool>("AddNodeOverrideTextureSet", "NiOverride", papyrusNiOverride::AddNodeOverride<BGSTextureSet*>, registry));
 
+	registry->RegisterFunction(
+		new NativeFunction7<StaticFunctionTag, void, TESObjectREFR*, bool, VMArray<BSFixedString>, VMArray<UInt32>, VMArray<UInt32>, VMArray<float>, bool>("AddNodeOverrideFloatArray", "NiOverride", papyrusNiOverride::AddNodeOverrideArray<float>, registry));
+
+	registry->RegisterFunction(
+		new NativeFunction7<StaticFunctionTag, void, TESObjectREFR*, bool, VMArray<BSFixedString>, VMArray<UInt32>, VMArray<UInt32>, VMArray<UInt32>, bool>("AddNodeOverrideIntArray", "NiOverride", papyrusNiOverride::AddNodeOverrideArray<UInt32>, registry));
+
+	registry->RegisterFunction(
+		new NativeFunction7<StaticFunctionTag, void, TESObjectREFR*, bool, VMArray<BSFixedString>, VMArray<UInt32>, VMArray<UInt32>, VMArray<bool>, bool>("AddNodeOverrideBoolArray", "NiOverride", papyrusNiOverride::AddNodeOverrideArray<bool>, registry));
+
+	registry->RegisterFunction(
+		new NativeFunction7<StaticFunctionTag, void, TESObjectREFR*, bool, VMArray<BSFixedString>, VMArray<UInt32>, VMArray<UInt32>, VMArray<BSFixedString>, bool>("AddNodeOverrideStringArray", "NiOverride", papyrusNiOverride::AddNodeOverrideArray<BSFixedString>, registry));
+
+	registry->RegisterFunction(
+		new NativeFunction7<StaticFunctionTag, void, TESObjectREFR*, bool, VMArray<BSFixedString>, VMArray<UInt32>, VMArray<UInt32>, VMArray<BGSTextureSet*>, bool>("AddNodeOverrideTextureSetArray", "NiOverride", papyrusNiOverride::AddNodeOverrideArray<BGSTextureSet*>, registry));
+
 	registry->RegisterFunction(
 		new NativeFunction1<StaticFunctionTag, void, TESObjectREFR*>("ApplyNodeOverrides", "NiOverride", papyrusNiOverride::ApplyNodeOverrides, registry));
 
@@ -1780,6 +1945,15 @@ void papyrusNiOverride::RegisterFuncs(VMClassRegistry* registry)
 	registry->RegisterFunction(
 		new NativeFunction2<StaticFunctionTag, void, BSFixedString, TESForm*>("ForEachMorphedReference", "NiOverride", papyrusNiOverride::ForEachMorphedReference, registry));
 
+	registry->RegisterFunction(
+		new NativeFunction5<StaticFunctionTag, void, TESObjectREFR*, VMArray<BSFixedString>, VMArray<BSFixedString>, VMArray<float>, bool>("SetBodyMorphArray", "NiOverride", papyrusNiOverride::SetBodyMorphArray, registry));
+
+	registry->RegisterFunction(
+		new NativeFunction3<StaticFunctionTag, VMResultArray<float>, TESObjectREFR*, VMArray<BSFixedString>, VMArray<BSFixedString>>("GetBodyMorphArray", "NiOverride", papyrusNiOverride::GetBodyMorphArray, registry));
+
+	registry->RegisterFunction(
+		new NativeFunction4<StaticFunctionTag, void, TESObjectREFR*, VMArray<BSFixedString>, VMArray<BSFixedString>, bool>("ClearBodyMorphArray", "NiOverride", papyrusNiOverride::ClearBodyMorphArray, registry));
+
 
 	// Unique Item manipulation
 	registry->RegisterFunction(
@@ -1968,6 +2142,11 @@ void papyrusNiOverride::RegisterFuncs(VMClassRegistry* registry)
 	registry->SetFunctionFlags("NiOverride", "AddNodeOverrideBool", VMClassRegistry::kFunctionFlag_NoWait);
 	registry->SetFunctionFlags("NiOverride", "AddNodeOverrideString", VMClassRegistry::kFunctionFlag_NoWait);
 	registry->SetFunctionFlags("NiOverride", "AddNodeOverrideTextureSet", VMClassRegistry::kFunctionFlag_NoWait);
+	registry->SetFunctionFlags("NiOverride", "AddNodeOverrideFloatArray", VMClassRegistry::kFunctionFlag_NoWait);
+	registry->SetFunctionFlags("NiOverride", "AddNodeOverrideIntArray", VMClassRegistry::kFunctionFlag_NoWait);
+	registry->SetFunctionFlags("NiOverride", "AddNodeOverrideBoolArray", VMClassRegistry::kFunctionFlag_NoWait);
+	registry->SetFunctionFlags("NiOverride", "AddNodeOverrideStringArray", VMClassRegistry::kFunctionFlag_NoWait);
+	registry->SetFunctionFlags("NiOverride", "AddNodeOverrideTextureSetArray", VMClassRegistry::kFunctionFlag_NoWait);
 
 	registry->SetFunctionFlags("NiOverride", "GetNodeOverrideFloat", VMClassRegistry::kFunctionFlag_NoWait);
 	registry->SetFunctionFlags("NiOverride", "GetNodeOverrideInt", VMClassRegistry::kFunctionFlag_NoWait);
@@ -2074,6 +2253,9 @@ void papyrusNiOverride::RegisterFuncs(VMClassRegistry* registry)
 	registry->SetFunctionFlags("NiOverride", "ClearBodyMorphKeys", VMClassRegistry::kFunctionFlag_NoWait);
 	registry->SetFunctionFlags("NiOverride", "ClearMorphs", VMClassRegistry::kFunctionFlag_NoWait);
 	registry->SetFunctionFlags("NiOverride", "UpdateModelWeight", VMClassRegistry::kFunctionFlag_NoWait);
+	registry->SetFunctionFlags("NiOverride", "SetBodyMorphArray", VMClassRegistry::kFunctionFlag_NoWait);
+	registry->SetFunctionFlags("NiOverride", "GetBodyMorphArray", VMClassRegistry::kFunctionFlag_NoWait);
+	registry->SetFunctionFlags("NiOverride", "ClearBodyMorphArray", VMClassRegistry::kFunctionFlag_NoWait);
 
 	registry->SetFunctionFlags("NiOverride", "EnableTintTextureCache", VMClassRegistry::kFunctionFlag_NoWait);
 	registry->SetFunctionFlags("NiOverride", "ReleaseTintTextureCache", VMClassRegistry::kFunctionFlag_NoWait);
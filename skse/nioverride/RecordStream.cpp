@@ -0,0 +1,239 @@
+#include "RecordStream.h"
+#include "LZ4Block.h"
+
+RecordWriter * RecordWriter::s_active = NULL;
+RecordReader * RecordReader::s_active = NULL;
+
+struct RecordHeader
+{
+	UInt32	type;
+	UInt32	version;
+	UInt32	length;
+};
+
+RecordWriter::RecordWriter(SKSESerializationInterface * intfc, bool compress)
+{
+	m_compress = compress;
+	m_parent = intfc;
+	m_intfc = *intfc;
+	m_intfc.WriteRecord = WriteRecord;
+	m_intfc.OpenRecord = OpenRecord;
+	m_intfc.WriteRecordData = WriteRecordData;
+	m_record = std::numeric_limits<size_t>::max();
+	m_previous = s_active;
+	if (m_compress)
+		s_active = this;
+}
+
+RecordWriter::~RecordWriter()
+{
+	if (m_compress)
+		s_active = m_previous;
+}
+
+bool RecordWriter::WriteRecord(UInt32 type, UInt32 version, const void * buf, UInt32 length)
+{
+	return OpenRecord(type, version) && WriteRecordData(buf, length);
+}
+
+bool RecordWriter::OpenRecord(UInt32 type, UInt32 version)
+{
+	RecordWriter * writer = s_active;
+	if (!writer)
+		return false;
+
+	RecordHeader header = { type, version, 0 };
+	writer->m_record = writer->m_buffer.size();
+	writer->m_buffer.insert(writer->m_buffer.end(), (UInt8*)&header, (UInt8*)&header + sizeof(header));
+	return true;
+}
+
+bool RecordWriter::WriteRecordData(const void * buf, UInt32 length)
+{
+	RecordWriter * writer = s_active;
+	if (!writer || writer->m_record == std::numeric_limits<size_t>::max())
+		return false;
+
+	writer->m_buffer.insert(writer->m_buffer.end(), (const UInt8*)buf, (const UInt8*)buf + length);
+	RecordHeader * header = (RecordHeader*)&writer->m_buffer[writer->m_record];
+	header->length += length;
+	return true;
+}
+
+void RecordWriter::Flush()
+{
+	if (!m_compress)
+		return;
+
+	// Stop capturing, the parent may itself be a redirected interface
+	s_active = m_previous;
+	if (m_buffer.empty())
+		return;
+
+	UInt32 rawSize = m_buffer.size();
+	std::vector<UInt8> compressed(sizeof(rawSize) + LZ4Block::CompressBound(rawSize));
+	memcpy(&compressed[0], &rawSize, sizeof(rawSize));
+	UInt32 compressedSize = LZ4Block::Compress(&m_buffer[0], rawSize, &compressed[sizeof(rawSize)], compressed.size() - sizeof(rawSize));
+	if (compressedSize > 0 && compressedSize < rawSize) {
+		m_parent->OpenRecord(kCompressedType, kCompressedVersion);
+		m_parent->WriteRecordData(&compressed[0], sizeof(rawSize) + compressedSize);
+	}
+	else {
+		Replay(m_parent, m_buffer);
+	}
+
+	m_buffer.clear();
+	m_record = std::numeric_limits<size_t>::max();
+}
+
+void RecordWriter::Detach(std::vector<UInt8> & records)
+{
+	if (m_compress)
+		s_active = m_previous;
+
+	records.swap(m_buffer);
+	m_buffer.clear();
+	m_record = std::numeric_limits<size_t>::max();
+}
+
+void RecordWriter::Replay(SKSESerializationInterface * intfc, const std::vector<UInt8> & records)
+{
+	size_t offset = 0;
+	while (offset + sizeof(RecordHeader) <= records.size())
+	{
+		const RecordHeader * header = (const RecordHeader*)&records[offset];
+		offset += sizeof(RecordHeader);
+		intfc->OpenRecord(header->type, header->version);
+		if (header->length > 0)
+			intfc->WriteRecordData(&records[offset], header->length);
+		offset += header->length;
+	}
+}
+
+void RecordCache::Validate(UInt32 generation)
+{
+	if (m_generation != generation) {
+		m_records.clear();
+		m_generation = generation;
+	}
+}
+
+void RecordCache::Write(SKSESerializationInterface * intfc, UInt64 handle, std::function<void(SKSESerializationInterface*)> functor)
+{
+	auto it = m_records.find(handle);
+	if (it == m_records.end()) {
+		std::vector<UInt8> records;
+		RecordWriter writer(intfc, true);
+		functor(writer.GetInterface());
+		writer.Detach(records);
+		it = m_records.emplace(handle, std::move(records)).first;
+	}
+
+	RecordWriter::Replay(intfc, it->second);
+}
+
+RecordReader::RecordReader(SKSESerializationInterface * intfc)
+{
+	m_parent = intfc;
+	m_intfc = *intfc;
+	m_intfc.GetNextRecordInfo = GetNextRecordInfo;
+	m_intfc.ReadRecordData = ReadRecordData;
+	m_next = 0;
+	m_position = 0;
+	m_end = 0;
+	m_previous = NULL;
+	m_loaded = false;
+}
+
+RecordReader::~RecordReader()
+{
+	if (m_loaded)
+		s_active = m_previous;
+}
+
+bool RecordReader::Load(UInt32 version, UInt32 length)
+{
+	if (version != RecordWriter::kCompressedVersion) {
+		_ERROR("%s - Unknown compressed record version %d", __FUNCTION__, version);
+		return false;
+	}
+
+	UInt32 rawSize = 0;
+	if (length < sizeof(rawSize) || !m_parent->ReadRecordData(&rawSize, sizeof(rawSize))) {
+		_ERROR("%s - Error loading compressed record size", __FUNCTION__);
+		return false;
+	}
+
+	// The stored size is only trusted as far as the payload could expand,
+	// a corrupt record must not allocate gigabytes before failing to decode
+	UInt32 compressedSize = length - sizeof(rawSize);
+	if (rawSize > LZ4Block::DecompressBound(compressedSize)) {
+		_ERROR("%s - Compressed record of %d bytes can't hold %u bytes", __FUNCTION__, compressedSize, rawSize);
+		return false;
+	}
+
+	std::vector<UInt8> compressed(compressedSize);
+	if (!compressed.empty() && m_parent->ReadRecordData(&compressed[0], compressed.size()) != compressed.size()) {
+		_ERROR("%s - Error loading compressed record of %d bytes", __FUNCTION__, compressed.size());
+		return false;
+	}
+
+	m_buffer.resize(rawSize);
+	if (rawSize > 0 && (compressed.empty() || !LZ4Block::Decompress(&compressed[0], compressed.size(), &m_buffer[0], rawSize))) {
+		_ERROR("%s - Error decompressing record to %d bytes", __FUNCTION__, rawSize);
+		m_buffer.clear();
+		return false;
+	}
+
+	m_next = 0;
+	m_position = 0;
+	m_end = 0;
+
+	// Only redirect once the parent stream has been consumed
+	m_previous = s_active;
+	m_loaded = true;
+	s_active = this;
+	return true;
+}
+
+bool RecordReader::GetNextRecordInfo(UInt32 * type, UInt32 * version, UInt32 * length)
+{
+	RecordReader * reader = s_active;
+	if (!reader || reader->m_next + sizeof(RecordHeader) > reader->m_buffer.size())
+		return false;
+
+	RecordHeader header;
+	memcpy(&header, &reader->m_buffer[reader->m_next], sizeof(header));
+	reader->m_position = reader->m_next + sizeof(header);
+	if (header.length > reader->m_buffer.size() - reader->m_position) {
+		_ERROR("%s - Truncated record %.4s", __FUNCTION__, &header.type);
+		reader->m_next = reader->m_buffer.size();
+		return false;
+	}
+
+	reader->m_end = reader->m_position + header.length;
+	reader->m_next = reader->m_end;
+
+	*type = header.type;
+	*version = header.version;
+	*length = header.length;
+	return true;
+}
+
+UInt32 RecordReader::ReadRecordData(void * buf, UInt32 length)
+{
+	RecordReader * reader = s_active;
+	if (!reader)
+		return 0;
+
+	UInt32 remaining = reader->m_end - reader->m_position;
+	if (length > remaining)
+		length = remaining;
+
+	if (length > 0) {
+		memcpy(buf, &reader->m_buffer[reader->m_position], length);
+		reader->m_position += length;
+	}
+
+	return length;
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "skse/PluginAPI.h"
+
+#include <vector>
+#include <unordered_map>
+#include <functional>
+
+// Co-save records can be buffered and written as a single LZ4 compressed
+// 'NIOZ' record. The payload is the sequence of records that would have
+// been written directly, each prefixed by its type, version and length.
+// Both classes hand out a copy of the SKSE interface whose record functions
+// are redirected to the buffer, so existing Save/Load code runs unchanged.
+class RecordWriter
+{
+public:
+	enum
+	{
+		kCompressedType = 'NIOZ',
+		kCompressedVersion = 1
+	};
+
+	RecordWriter(SKSESerializationInterface * intfc, bool compress);
+	~RecordWriter();
+
+	SKSESerializationInterface * GetInterface() { return m_compress ? &m_intfc : m_parent; }
+
+	// Writes the buffered records, stored as-is if they don't compress.
+	// Nothing is captured after flushing.
+	void Flush();
+
+	// Stops capturing and hands over the buffered records
+	void Detach(std::vector<UInt8> & records);
+
+	// Writes previously captured records to intfc
+	static void Replay(SKSESerializationInterface * intfc, const std::vector<UInt8> & records);
+
+private:
+	static bool WriteRecord(UInt32 type, UInt32 version, const void * buf, UInt32 length);
+	static bool OpenRecord(UInt32 type, UInt32 version);
+	static bool WriteRecordData(const void * buf, UInt32 length);
+
+	bool							m_compress;
+	SKSESerializationInterface		* m_parent;
+	SKSESerializationInterface		m_intfc;
+	std::vector<UInt8>				m_buffer;
+	size_t							m_record;
+	RecordWriter					* m_previous;
+
+	static RecordWriter				* s_active;
+};
+
+class RecordReader
+{
+public:
+	RecordReader(SKSESerializationInterface * intfc);
+	~RecordReader();
+
+	SKSESerializationInterface * GetInterface() { return &m_intfc; }
+
+	// Reads and decompresses the current 'NIOZ' record
+	bool Load(UInt32 version, UInt32 length);
+
+private:
+	static bool GetNextRecordInfo(UInt32 * type, UInt32 * version, UInt32 * length);
+	static UInt32 ReadRecordData(void * buf, UInt32 length);
+
+	SKSESerializationInterface		* m_parent;
+	SKSESerializationInterface		m_intfc;
+	std::vector<UInt8>				m_buffer;
+	size_t							m_next;
+	size_t							m_position;
+	size_t							m_end;
+	bool							m_loaded;
+	RecordReader					* m_previous;
+
+	static RecordReader				* s_active;
+};
+
+// Captured records of each handle, replayed on save until the handle is
+// invalidated. String ids inside the records are only stable for one
+// string table generation, so a new generation drops everything.
+class RecordCache
+{
+public:
+	RecordCache() : m_generation(0) { }
+
+	void Invalidate(UInt64 handle) { m_records.erase(handle); }
+	void Clear() { m_records.clear(); }
+	void Validate(UInt32 generation);
+
+	void Write(SKSESerializationInterface * intfc, UInt64 handle, std::function<void(SKSESerializationInterface*)> functor);
+
+private:
+	UInt32										m_generation;
+	std::unordered_map<UInt64, std::vector<UInt8>>	m_records;
+};
@@ -153,13 +153,21 @@ NIOVTaskUpdateTexture::NIOVTaskUpdateTexture(NiGeometry * geometry, UInt32 index
 	if (m_geometry)
 		m_geometry->IncRef();
 
-	m_index = index;
-	m_texture = texture;
+	m_slots = 0;
+	AddTexture(index, texture);
+}
+
+void NIOVTaskUpdateTexture::AddTexture(UInt32 index, BSFixedString texture)
+{
+	if (index < BSTextureSet::kNumTextures) {
+		m_slots |= 1 << index;
+		m_textures[index] = texture;
+	}
 }
 
 void NIOVTaskUpdateTexture::Run()
 {
-	if(m_geometry)
+	if(m_geometry && m_slots)
 	{
 		BSShaderProperty * shaderProperty = niptr_cast<BSShaderProperty>(m_geometry->m_spEffectState);
 		if(!shaderProperty) {
@@ -171,19 +179,16 @@ void NIOVTaskUpdateTexture::Run()
 		if(lightingShader)
 		{
 			BSLightingShaderMaterial * material = (BSLightingShaderMaterial *)shaderProperty->material;
-			if(m_index < BSTextureSet::kNumTextures) {
-				BSShaderTextureSet * newTextureSet = BSShaderTextureSet::Create();
-				for(UInt32 i = 0; i < BSTextureSet::kNumTextures; i++)
-				{
-					const char * texturePath = material->textureSet->GetTexturePath(i);
-					newTextureSet->SetTexturePath(i, texturePath);
-				}
-				newTextureSet->SetTexturePath(m_index, m_texture.data);
-				material->ReleaseTextures();
-				material->SetTextureSet(newTextureSet);
-				CALL_MEMBER_FN(lightingShader, InvalidateTextures)(0);
-				CALL_MEMBER_FN(lightingShader, InitializeShader)(m_geometry);
+			BSShaderTextureSet * newTextureSet = BSShaderTextureSet::Create();
+			for(UInt32 i = 0; i < BSTextureSet::kNumTextures; i++)
+			{
+				const char * texturePath = (m_slots & (1 << i)) ? m_textures[i].data : material->textureSet->GetTexturePath(i);
+				newTextureSet->SetTexturePath(i, texturePath);
 			}
+			material->ReleaseTextures();
+			material->SetTextureSet(newTextureSet);
+			CALL_MEMBER_FN(lightingShader, InvalidateTextures)(0);
+			CALL_MEMBER_FN(lightingShader, InitializeShader)(m_geometry);
 		}
 	}
 }
@@ -195,7 +200,23 @@ void NIOVTaskUpdateTexture::Dispose()
 	delete this;
 }
 
-void SetShaderProperty(NiAVObject * node, OverrideVariant * value, bool immediate)
+void NIOVTextureBatch::AddTexture(NiGeometry * geometry, UInt32 index, BSFixedString texture)
+{
+	auto it = m_tasks.find(geometry);
+	if (it != m_tasks.end())
+		it->second->AddTexture(index, texture);
+	else
+		m_tasks.emplace(geometry, new NIOVTaskUpdateTexture(geometry, index, texture));
+}
+
+void NIOVTextureBatch::Flush()
+{
+	for (auto & it : m_tasks)
+		g_task->AddTask(it.second);
+	m_tasks.clear();
+}
+
+void SetShaderProperty(NiAVObject * node, OverrideVariant * value, bool immediate, NIOVTextureBatch * textureBatch)
 {
 	NiGeometry * geometry = node->GetAsNiGeometry();
 	if(geometry)
@@ -314,6 +335,8 @@ void SetShaderProperty(NiAVObject * node, OverrideVariant * value, bool immediat
 							CALL_MEMBER_FN(lightingShader, InvalidateTextures)(0);
 							CALL_MEMBER_FN(lightingShader, InitializeShader)(geometry);
 						}
+					} else if (textureBatch) {
+						textureBatch->AddTexture(geometry, value->index, texture);
 					} else {
 						g_task->AddTask(new NIOVTaskUpdateTexture(geometry, value->index, texture));
 					}
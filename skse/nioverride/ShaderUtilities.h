@@ -8,6 +8,7 @@
 #include "skse/NiTypes.h"
 
 #include <functional>
+#include <unordered_map>
 
 class NiExtraData;
 class NiGeometry;
@@ -15,17 +16,22 @@ class OverrideVariant;
 
 struct SKSESerializationInterface;
 
+// Swaps in a texture set with the given slots replaced, every slot added
+// before the task runs goes in with the same swap
 class NIOVTaskUpdateTexture : public TaskDelegate
 {
 public:
 	NIOVTaskUpdateTexture(NiGeometry * geometry, UInt32 index, BSFixedString texture);
 
+	// Later textures for the same slot replace earlier ones
+	void AddTexture(UInt32 index, BSFixedString texture);
+
 	virtual void Run();
 	virtual void Dispose();
 
 	NiGeometry		* m_geometry;
-	UInt32			m_index;
-	BSFixedString	m_texture;
+	UInt32			m_slots;
+	BSFixedString	m_textures[BSTextureSet::kNumTextures];
 };
 
 class NIOVTaskUpdateWorldData : public TaskDelegate
@@ -83,8 +89,22 @@ public:
 	NiNode * m_destination;
 };
 
+// Collects the texture slots deferred SetShaderProperty calls set so each
+// geometry gets a single NIOVTaskUpdateTexture, queued by Flush
+class NIOVTextureBatch
+{
+public:
+	~NIOVTextureBatch() { Flush(); }
+
+	void AddTexture(NiGeometry * geometry, UInt32 index, BSFixedString texture);
+	void Flush();
+
+private:
+	std::unordered_map<NiGeometry*, NIOVTaskUpdateTexture*> m_tasks;
+};
+
 void GetShaderProperty(NiAVObject * node, OverrideVariant * value);
-void SetShaderProperty(NiAVObject * node, OverrideVariant * value, bool immediate);
+void SetShaderProperty(NiAVObject * node, OverrideVariant * value, bool immediate, NIOVTextureBatch * textureBatch = NULL);
 
 TESForm* GetWornForm(Actor* thisActor, UInt32 mask);
 TESForm* GetSkinForm(Actor* thisActor, UInt32 mask);
@@ -7,20 +7,14 @@ void StringTable::Save(SKSESerializationInterface * intfc, UInt32 kVersion)
 {
 	intfc->OpenRecord('STTB', kVersion);
 
-	UInt32 totalStrings = m_stringToId.size();
+	UInt32 totalStrings = m_count;
 	intfc->WriteRecordData(&totalStrings, sizeof(totalStrings));
 
-	for (auto & str : m_stringToId)
-	{
-		UInt16 length = strlen(str.first.data);
-		UInt32 strId = str.second;
-		intfc->WriteRecordData(&length, sizeof(length));
-		intfc->WriteRecordData(str.first.data, length);
-		intfc->WriteRecordData(&strId, sizeof(strId));
-	}
+	if (!m_arena.empty())
+		intfc->WriteRecordData(&m_arena[0], m_arena.size());
 }
 
-bool StringTable::Load(SKSESerializationInterface* intfc, UInt32 kVersion)
+bool StringTable::Load(SKSESerializationInterface* intfc, UInt32 kVersion, UInt32 length)
 {
 	bool error = false;
 	UInt32 totalStrings = 0;
@@ -32,56 +26,155 @@ bool StringTable::Load(SKSESerializationInterface* intfc, UInt32 kVersion)
 		return error;
 	}
 
+	UInt32 arenaSize = length > sizeof(totalStrings) ? length - sizeof(totalStrings) : 0;
+	m_arena.resize(arenaSize);
+	if (arenaSize > 0 && intfc->ReadRecordData(&m_arena[0], arenaSize) != arenaSize)
+	{
+		_ERROR("%s - Error loading string table of %d bytes", __FUNCTION__, arenaSize);
+		m_arena.clear();
+		error = true;
+		return error;
+	}
+
+	// Every entry takes at least a length and an id, don't reserve past what the record holds
+	UInt32 maxStrings = arenaSize / (sizeof(UInt16) + sizeof(UInt32));
+	m_idToString.reserve(m_idToString.size() + (totalStrings < maxStrings ? totalStrings : maxStrings));
+
+	char * cursor = arenaSize > 0 ? &m_arena[0] : NULL;
+	char * end = cursor + arenaSize;
 	for (UInt32 i = 0; i < totalStrings; i++)
 	{
-		char * stringName = NULL;
 		UInt16 stringLength = 0;
-		if (!intfc->ReadRecordData(&stringLength, sizeof(stringLength)))
+		if ((size_t)(end - cursor) < sizeof(stringLength))
 		{
 			_ERROR("%s - Error loading string length", __FUNCTION__);
 			error = true;
-			return error;
+			break;
 		}
+		memcpy(&stringLength, cursor, sizeof(stringLength));
+		cursor += sizeof(stringLength);
 
-		stringName = new char[stringLength + 1];
-
-		if (stringLength > 0 && !intfc->ReadRecordData(stringName, stringLength)) {
+		UInt32 stringId = 0;
+		if ((size_t)(end - cursor) < stringLength + sizeof(stringId))
+		{
 			_ERROR("%s - Error loading string of length %d", __FUNCTION__, stringLength);
 			error = true;
-			return error;
+			break;
 		}
 
-		stringName[stringLength] = 0;
+		char * stringName = cursor;
+		cursor += stringLength;
+		memcpy(&stringId, cursor, sizeof(stringId));
 
-		BSFixedString str(stringName);
-		delete[] stringName;
+		// The id has been consumed, its first byte terminates the string in place
+		*cursor = 0;
+		cursor += sizeof(stringId);
 
-		UInt32 stringId = 0;
-		if (!intfc->ReadRecordData(&stringId, sizeof(stringId)))
+		// Ids are trusted only up to the table size, anything past that is
+		// either sparse from an older save or corrupt and kept out of the dense index
+		if (stringId < totalStrings)
 		{
-			_ERROR("%s - Error loading string id", __FUNCTION__);
-			error = true;
-			return error;
+			if (stringId >= m_idToIndex.size())
+				m_idToIndex.resize(stringId + 1, kInvalidId);
+
+			m_idToIndex[stringId] = m_idToString.size();
 		}
+		else
+			m_sparseIdToIndex[stringId] = m_idToString.size();
 
-		m_idToString.insert_or_assign(stringId, str);
+		m_idToString.push_back(BSFixedString(stringName));
 	}
 
+	m_arena.clear();
 	return error;
 }
 
-void StringTable::StringToId(const BSFixedString & str, const UInt32 & id)
+UInt32 StringTable::FindId(const char * key) const
+{
+	if (m_slots.empty())
+		return kInvalidId;
+
+	UInt32 mask = m_slots.size() - 1;
+	for (UInt32 i = HashKey(key) & mask; m_slots[i].key; i = (i + 1) & mask)
+	{
+		if (m_slots[i].key == key)
+			return m_slots[i].id;
+	}
+
+	return kInvalidId;
+}
+
+void StringTable::Grow()
 {
-	m_stringToId.insert_or_assign(str, id);
+	std::vector<Slot> slots(m_slots.empty() ? kMinSlots : m_slots.size() * 2, Slot{ NULL, kInvalidId });
+	UInt32 mask = slots.size() - 1;
+	for (auto & slot : m_slots)
+	{
+		if (!slot.key)
+			continue;
+
+		UInt32 i = HashKey(slot.key) & mask;
+		while (slots[i].key)
+			i = (i + 1) & mask;
+
+		slots[i] = slot;
+	}
+
+	m_slots.swap(slots);
+}
+
+UInt32 StringTable::StringToId(const BSFixedString & str)
+{
+	// Keep the load factor under 3/4
+	if ((m_count + 1) * 4 > m_slots.size() * 3)
+		Grow();
+
+	UInt32 mask = m_slots.size() - 1;
+	UInt32 i = HashKey(str.data) & mask;
+	for (; m_slots[i].key; i = (i + 1) & mask)
+	{
+		if (m_slots[i].key == str.data) {
+			UInt32 id = m_slots[i].id;
+			if (!m_referenced[id]) {
+				m_referenced[id] = 1;
+				m_referencedCount++;
+			}
+			return id;
+		}
+	}
+
+	UInt32 id = m_count++;
+	m_referenced.push_back(1);
+	m_referencedCount++;
+	m_slots[i].key = str.data;
+	m_slots[i].id = id;
+	m_idToString.push_back(str);
+
+	// Append the entry in its serialized form
+	UInt16 length = strlen(str.data);
+	size_t offset = m_arena.size();
+	m_arena.resize(offset + sizeof(length) + length + sizeof(id));
+	memcpy(&m_arena[offset], &length, sizeof(length));
+	memcpy(&m_arena[offset + sizeof(length)], str.data, length);
+	memcpy(&m_arena[offset + sizeof(length) + length], &id, sizeof(id));
+	return id;
 }
 
-void StringTable::IdToString(const UInt32 & id, const BSFixedString & str)
+void StringTable::BeginPooling()
 {
-	m_idToString.insert_or_assign(id, str);
+	m_referenced.assign(m_count, 0);
+	m_referencedCount = 0;
 }
 
 void StringTable::Clear()
 {
-	m_stringToId.clear();
+	m_generation++;
+	m_count = 0;
+	m_referencedCount = 0;
+	m_referenced.clear();
+	m_slots.clear();
+	m_arena.clear();
 	m_idToString.clear();
+	m_idToIndex.clear();
+	m_sparseIdToIndex.clear();
 }
@@ -2,8 +2,17 @@
 
 #include "skse/GameTypes.h"
 
+#include <vector>
+#include <unordered_map>
+
 struct SKSESerializationInterface;
 
+// Strings are interned into a single arena laid out exactly like the STTB
+// record body ([UInt16 length][chars][UInt32 id] per entry) so the whole
+// table is written and read as one block. Lookups during save go through an
+// open addressing table keyed on the interned BSFixedString pointer.
+// Ids persist between saves so cached records stay valid, every Clear
+// starts a new generation.
 class StringTable
 {
 public:
@@ -14,13 +23,26 @@ public:
 		kSerializationVersion = kSerializationVersion2
 	};
 
+	enum : UInt32
+	{
+		kInvalidId = 0xFFFFFFFF,
+		kMinSlots = 256
+	};
+
+	StringTable() : m_count(0), m_generation(0), m_referencedCount(0) { }
+
 	void Save(SKSESerializationInterface * intfc, UInt32 kVersion);
-	bool Load(SKSESerializationInterface* intfc, UInt32 kVersion);
+	bool Load(SKSESerializationInterface* intfc, UInt32 kVersion, UInt32 length);
 
 	void Clear();
 
-	void StringToId(const BSFixedString & str, const UInt32 & id);
-	void IdToString(const UInt32 & id, const BSFixedString & str);
+	// Resets the reference marks set by StringToId
+	void BeginPooling();
+	UInt32 StringToId(const BSFixedString & str);
+
+	UInt32 GetCount() const { return m_count; }
+	UInt32 GetUnreferencedCount() const { return m_count - m_referencedCount; }
+	UInt32 GetGeneration() const { return m_generation; }
 
 	template<typename T>
 	BSFixedString ReadString(SKSESerializationInterface* intfc, UInt32 kVersion)
@@ -35,10 +57,10 @@ public:
 				return BSFixedString("");
 			}
 
-			auto & it = m_idToString.find(stringId);
-			if (it != m_idToString.end())
+			UInt32 index = FindIndex(stringId);
+			if (index != kInvalidId)
 			{
-				str = it->second;
+				str = m_idToString[index];
 			}
 			else
 			{
@@ -74,18 +96,11 @@ public:
 	{
 		if (kVersion >= kSerializationVersion2)
 		{
-			auto & it = m_stringToId.find(str);
-			if (it != m_stringToId.end())
-			{
-				UInt32 stringId = it->second;
-				intfc->WriteRecordData(&stringId, sizeof(stringId));
-			}
-			else
-			{
+			UInt32 stringId = FindId(str.data);
+			if (stringId == kInvalidId)
 				_ERROR("%s - Error mapping string %s to id", __FUNCTION__, str.data);
-				UInt32 stringId = std::numeric_limits<UInt32>::max();
-				intfc->WriteRecordData(&stringId, sizeof(stringId));
-			}
+
+			intfc->WriteRecordData(&stringId, sizeof(stringId));
 		}
 		else
 		{
@@ -96,6 +111,40 @@ public:
 	}
 
 private:
-	std::map<BSFixedString, UInt32> m_stringToId;
-	std::map<UInt32, BSFixedString> m_idToString;
-};
\ No newline at end of file
+	struct Slot
+	{
+		const char	* key;
+		UInt32		id;
+	};
+
+	static UInt32 HashKey(const char * key)
+	{
+		// BSFixedString data is interned, the pointer identifies the string
+		UInt32 value = (UInt32)(uintptr_t)key;
+		UInt32 hash = (value >> 2) * 0x9E3779B1;
+		return hash ^ (hash >> 16);
+	}
+
+	UInt32 FindId(const char * key) const;
+	UInt32 FindIndex(UInt32 stringId) const
+	{
+		if (stringId < m_idToIndex.size() && m_idToIndex[stringId] != kInvalidId)
+			return m_idToIndex[stringId];
+
+		auto it = m_sparseIdToIndex.find(stringId);
+		return it != m_sparseIdToIndex.end() ? it->second : kInvalidId;
+	}
+	void Grow();
+
+	UInt32							m_count;
+	UInt32							m_generation;
+	UInt32							m_referencedCount;
+	std::vector<UInt8>				m_referenced;
+	std::vector<Slot>				m_slots;
+	std::vector<char>				m_arena;
+
+	// Keeps saved strings interned and maps loaded ids back to them
+	std::vector<BSFixedString>		m_idToString;
+	std::vector<UInt32>				m_idToIndex;
+	std::unordered_map<UInt32, UInt32>	m_sparseIdToIndex;	// Ids at or past the loaded table size
+};
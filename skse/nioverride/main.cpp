@@ -28,6 +28,7 @@
 #include "ShaderUtilities.h"
 #include "ScaleformFunctions.h"
 #include "StringTable.h"
+#include "RecordStream.h"
 
 #include <shlobj.h>
 #include <string>
@@ -84,6 +85,7 @@ bool	g_enableFaceOverlays = true;
 bool	g_immediateFace = false;
 bool	g_enableEquippableTransforms = true;
 bool	g_parallelMorphing = true;
+bool	g_compressCoSave = true;
 UInt16	g_scaleMode = 0;
 UInt16	g_bodyMorphMode = 0;
 
@@ -202,6 +204,7 @@ void NIOVSerialization_Revert(SKSESerializationInterface * intfc)
 	g_itemDataInterface.Revert();
 	g_dyeMap.Revert();
 	g_transformInterface.Revert();
+	g_stringTable.Clear();
 //#endif
 }
 
@@ -234,51 +237,120 @@ void NIOVSerialization_Save(SKSESerializationInterface * intfc)
 	_MESSAGE("Saving...");
 
 	StopWatch sw;
-	UInt32 strCount = 0;
 	sw.Start();
-	g_transformInterface.VisitStrings([&](BSFixedString str)
-	{
-		g_stringTable.StringToId(str.data, strCount);
-		strCount++;
-	});
-	g_overrideInterface.VisitStrings([&](BSFixedString str)
+	auto poolStrings = [&]()
 	{
-		g_stringTable.StringToId(str.data, strCount);
-		strCount++;
-	});
-	g_morphInterface.VisitStrings([&](BSFixedString str)
-	{
-		g_stringTable.StringToId(str.data, strCount);
-		strCount++;
-	});
+		g_stringTable.BeginPooling();
+		g_transformInterface.VisitStrings([&](BSFixedString str)
+		{
+			g_stringTable.StringToId(str);
+		});
+		g_overrideInterface.VisitStrings([&](BSFixedString str)
+		{
+			g_stringTable.StringToId(str);
+		});
+		g_morphInterface.VisitStrings([&](BSFixedString str)
+		{
+			g_stringTable.StringToId(str);
+		});
+	};
+
+	poolStrings();
+
+	// The table is kept between saves so cached records stay valid, start over once it's mostly stale
+	if (g_stringTable.GetUnreferencedCount() > g_stringTable.GetCount() / 2) {
+		g_stringTable.Clear();
+		poolStrings();
+	}
 
 	_DMESSAGE("%s - Pooled strings %dms", __FUNCTION__, sw.Stop());
 
 	sw.Start();
-	g_stringTable.Save(intfc, StringTable::kSerializationVersion);
+	{
+		RecordWriter writer(intfc, g_compressCoSave);
+		g_stringTable.Save(writer.GetInterface(), StringTable::kSerializationVersion);
+		writer.Flush();
+	}
 	_DMESSAGE("%s - Serialized string table %dms", __FUNCTION__, sw.Stop());
 
 	sw.Start();
-	g_transformInterface.Save(intfc, NiTransformInterface::kSerializationVersion);
+	{
+		RecordWriter writer(intfc, g_compressCoSave);
+		g_transformInterface.Save(writer.GetInterface(), NiTransformInterface::kSerializationVersion);
+		writer.Flush();
+	}
 	_DMESSAGE("%s - Serialized transforms %dms", __FUNCTION__, sw.Stop());
 
 	sw.Start();
-	g_overlayInterface.Save(intfc, OverlayInterface::kSerializationVersion);
+	{
+		RecordWriter writer(intfc, g_compressCoSave);
+		g_overlayInterface.Save(writer.GetInterface(), OverlayInterface::kSerializationVersion);
+		writer.Flush();
+	}
 	_DMESSAGE("%s - Serialized overlays %dms", __FUNCTION__, sw.Stop());
 
 	sw.Start();
-	g_overrideInterface.Save(intfc, OverrideInterface::kSerializationVersion);
+	{
+		RecordWriter writer(intfc, g_compressCoSave);
+		g_overrideInterface.Save(writer.GetInterface(), OverrideInterface::kSerializationVersion);
+		writer.Flush();
+	}
 	_DMESSAGE("%s - Serialized overrides %dms", __FUNCTION__, sw.Stop());
 
 	sw.Start();
-	g_morphInterface.Save(intfc, BodyMorphInterface::kSerializationVersion);
+	{
+		RecordWriter writer(intfc, g_compressCoSave);
+		g_morphInterface.Save(writer.GetInterface(), BodyMorphInterface::kSerializationVersion);
+		writer.Flush();
+	}
 	_DMESSAGE("%s - Serialized body morphs %dms", __FUNCTION__, sw.Stop());
 
 	sw.Start();
-	g_itemDataInterface.Save(intfc, ItemDataInterface::kSerializationVersion);
+	{
+		RecordWriter writer(intfc, g_compressCoSave);
+		g_itemDataInterface.Save(writer.GetInterface(), ItemDataInterface::kSerializationVersion);
+		writer.Flush();
+	}
 	_DMESSAGE("%s - Serialized item data %dms", __FUNCTION__, sw.Stop());
+}
 
-	g_stringTable.Clear();
+bool NIOVSerialization_LoadRecord(SKSESerializationInterface * intfc, UInt32 type, UInt32 version, UInt32 length)
+{
+	bool error = false;
+	switch (type)
+	{
+		case 'STTB':	g_stringTable.Load(intfc, version, length);					break;
+		case 'AOVL':	g_overlayInterface.Load(intfc, version);					break;
+		case 'ACEN':	g_overrideInterface.LoadOverrides(intfc, version);			break;
+		case 'NDEN':	g_overrideInterface.LoadNodeOverrides(intfc, version);		break;
+		case 'WPEN':	g_overrideInterface.LoadWeaponOverrides(intfc, version);	break;
+		case 'SKNR':	g_overrideInterface.LoadSkinOverrides(intfc, version);		break;
+		case 'MRPH':	g_morphInterface.Load(intfc, version);						break;
+		case 'ITEE':	g_itemDataInterface.Load(intfc, version);					break;
+		case 'ACTM':	g_transformInterface.Load(intfc, version);					break;
+		case RecordWriter::kCompressedType:
+		{
+			RecordReader reader(intfc);
+			if (!reader.Load(version, length)) {
+				error = true;
+				break;
+			}
+
+			SKSESerializationInterface * stream = reader.GetInterface();
+			while (stream->GetNextRecordInfo(&type, &version, &length))
+			{
+				if (NIOVSerialization_LoadRecord(stream, type, version, length))
+					error = true;
+			}
+			break;
+		}
+		default:
+			_MESSAGE("unhandled type %08X (%.4s)", type, &type);
+			error = true;
+			break;
+	}
+
+	return error;
 }
 
 void NIOVSerialization_Load(SKSESerializationInterface * intfc)
@@ -292,22 +364,8 @@ void NIOVSerialization_Load(SKSESerializationInterface * intfc)
 	sw.Start();
 	while (intfc->GetNextRecordInfo(&type, &version, &length))
 	{
-		switch (type)
-		{
-			case 'STTB':	g_stringTable.Load(intfc, version);							break;
-			case 'AOVL':	g_overlayInterface.Load(intfc, version);					break;
-			case 'ACEN':	g_overrideInterface.LoadOverrides(intfc, version);			break;
-			case 'NDEN':	g_overrideInterface.LoadNodeOverrides(intfc, version);		break;
-			case 'WPEN':	g_overrideInterface.LoadWeaponOverrides(intfc, version);	break;
-			case 'SKNR':	g_overrideInterface.LoadSkinOverrides(intfc, version);		break;
-			case 'MRPH':	g_morphInterface.Load(intfc, version);						break;
-			case 'ITEE':	g_itemDataInterface.Load(intfc, version);					break;
-			case 'ACTM':	g_transformInterface.Load(intfc, version);					break;
-			default:
-				_MESSAGE("unhandled type %08X (%.4s)", type, &type);
-				error = true;
-				break;
-		}
+		if (NIOVSerialization_LoadRecord(intfc, type, version, length))
+			error = true;
 	}
 	_DMESSAGE("%s - Loaded %dms", __FUNCTION__, sw.Stop());
 
@@ -598,6 +656,7 @@ bool SKSEPlugin_Load(const SKSEInterface * skse)
 	UInt32	scaleMode = 0;
 	UInt32	parallelMorphing = 1;
 	UInt32	bodyMorphMode = 0;
+	UInt32	compressCoSave = 1;
 
 	if(GetConfigOption_UInt32("Overlays", "bPlayerOnly", &playerOnly))
 	{
@@ -722,12 +781,29 @@ bool SKSEPlugin_Load(const SKSEInterface * skse)
 		g_parallelMorphing = (parallelMorphing > 0);
 	}
 
+	if (GetConfigOption_UInt32("General", "bCompressCoSave", &compressCoSave))
+	{
+		g_compressCoSave = (compressCoSave > 0);
+	}
+
 	UInt32 bodyMorphMemoryLimit = 256000000;
 	if (GetConfigOption_UInt32("General", "uBodyMorphMemoryLimit", &bodyMorphMemoryLimit))
 	{
 		g_morphInterface.SetCacheLimit(bodyMorphMemoryLimit);
 	}
 
+	UInt32 morphUpdateBudget = 2000;
+	if (GetConfigOption_UInt32("General", "uMorphUpdateBudget", &morphUpdateBudget))
+	{
+		g_morphInterface.SetUpdateBudget(morphUpdateBudget);
+	}
+
+	UInt32 tintMaskMemoryLimit = TintMaskMap::kDefaultMemoryLimit;
+	if (GetConfigOption_UInt32("General", "uTintMaskMemoryLimit", &tintMaskMemoryLimit))
+	{
+		g_tintMaskInterface.SetTargetPoolLimit(tintMaskMemoryLimit);
+	}
+
 	if(!g_enableFaceOverlays) {
 		g_numFaceOverlays = 0;
 		g_numSpellFaceOverlays = 0;
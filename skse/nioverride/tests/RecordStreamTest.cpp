@@ -0,0 +1,226 @@
+#include "RecordStream.h"
+#include "LZ4Block.h"
+#include "TestUtils.h"
+
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+int g_failures = 0;
+
+// Largest single allocation since the last reset, the reader must reject
+// a bad size before it asks for the memory
+static size_t s_largestAllocation = 0;
+
+void * operator new(size_t size)
+{
+	if (size > s_largestAllocation)
+		s_largestAllocation = size;
+
+	void * p = malloc(size ? size : 1);
+	if (!p)
+		throw std::bad_alloc();
+	return p;
+}
+
+void operator delete(void * p) noexcept
+{
+	free(p);
+}
+
+void operator delete(void * p, size_t) noexcept
+{
+	free(p);
+}
+
+// Co-save held in memory, records are appended on write and read back in order
+struct MemoryRecord
+{
+	UInt32				type;
+	UInt32				version;
+	std::vector<UInt8>	data;
+};
+
+static std::vector<MemoryRecord>	s_records;
+static size_t						s_next;
+static size_t						s_position;
+
+static bool MemoryOpenRecord(UInt32 type, UInt32 version)
+{
+	MemoryRecord record = { type, version };
+	s_records.push_back(record);
+	return true;
+}
+
+static bool MemoryWriteRecordData(const void * buf, UInt32 length)
+{
+	if (s_records.empty())
+		return false;
+
+	std::vector<UInt8> & data = s_records.back().data;
+	data.insert(data.end(), (const UInt8*)buf, (const UInt8*)buf + length);
+	return true;
+}
+
+static bool MemoryWriteRecord(UInt32 type, UInt32 version, const void * buf, UInt32 length)
+{
+	return MemoryOpenRecord(type, version) && MemoryWriteRecordData(buf, length);
+}
+
+static bool MemoryGetNextRecordInfo(UInt32 * type, UInt32 * version, UInt32 * length)
+{
+	if (s_next >= s_records.size())
+		return false;
+
+	const MemoryRecord & record = s_records[s_next++];
+	*type = record.type;
+	*version = record.version;
+	*length = record.data.size();
+	s_position = 0;
+	return true;
+}
+
+static UInt32 MemoryReadRecordData(void * buf, UInt32 length)
+{
+	const std::vector<UInt8> & data = s_records[s_next - 1].data;
+	if (length > data.size() - s_position)
+		length = data.size() - s_position;
+
+	memcpy(buf, data.data() + s_position, length);
+	s_position += length;
+	return length;
+}
+
+static SKSESerializationInterface MakeInterface()
+{
+	s_records.clear();
+	s_next = 0;
+	s_position = 0;
+
+	SKSESerializationInterface intfc = { 4 };
+	intfc.WriteRecord = MemoryWriteRecord;
+	intfc.OpenRecord = MemoryOpenRecord;
+	intfc.WriteRecordData = MemoryWriteRecordData;
+	intfc.GetNextRecordInfo = MemoryGetNextRecordInfo;
+	intfc.ReadRecordData = MemoryReadRecordData;
+	return intfc;
+}
+
+// Writes three records that compress well into one 'NIOZ' record
+static void WriteCompressed(SKSESerializationInterface * intfc)
+{
+	RecordWriter writer(intfc, true);
+	SKSESerializationInterface * stream = writer.GetInterface();
+
+	std::string text(2000, 'a');
+	stream->WriteRecord('AAAA', 1, text.data(), text.size());
+
+	stream->OpenRecord('BBBB', 2);
+	for (UInt32 i = 0; i < 500; i++)
+		stream->WriteRecordData(&i, sizeof(i));
+
+	stream->OpenRecord('CCCC', 3);
+	writer.Flush();
+}
+
+static void TestRoundTrip()
+{
+	SKSESerializationInterface intfc = MakeInterface();
+	WriteCompressed(&intfc);
+	CHECK(s_records.size() == 1);
+	CHECK(s_records[0].type == RecordWriter::kCompressedType);
+
+	UInt32 type, version, length;
+	CHECK(intfc.GetNextRecordInfo(&type, &version, &length));
+
+	RecordReader reader(&intfc);
+	CHECK(reader.Load(version, length));
+
+	SKSESerializationInterface * stream = reader.GetInterface();
+	CHECK(stream->GetNextRecordInfo(&type, &version, &length));
+	CHECK(type == 'AAAA' && version == 1 && length == 2000);
+	std::string text(length, 0);
+	CHECK(stream->ReadRecordData(&text[0], length) == length);
+	CHECK(text == std::string(2000, 'a'));
+
+	CHECK(stream->GetNextRecordInfo(&type, &version, &length));
+	CHECK(type == 'BBBB' && version == 2 && length == 2000);
+	std::vector<UInt32> values(500);
+	CHECK(stream->ReadRecordData(values.data(), length) == length);
+	for (UInt32 i = 0; i < 500; i++)
+		CHECK(values[i] == i);
+
+	CHECK(stream->GetNextRecordInfo(&type, &version, &length));
+	CHECK(type == 'CCCC' && version == 3 && length == 0);
+	CHECK(!stream->GetNextRecordInfo(&type, &version, &length));
+}
+
+// Loads the first record after replacing its stored raw size
+static bool LoadWithRawSize(UInt32 rawSize, UInt32 payloadSize)
+{
+	SKSESerializationInterface intfc = MakeInterface();
+	WriteCompressed(&intfc);
+
+	std::vector<UInt8> & data = s_records[0].data;
+	memcpy(data.data(), &rawSize, sizeof(rawSize));
+	data.resize(sizeof(rawSize) + payloadSize);
+
+	UInt32 type, version, length;
+	intfc.GetNextRecordInfo(&type, &version, &length);
+
+	RecordReader reader(&intfc);
+	s_largestAllocation = 0;
+	bool loaded = reader.Load(version, length);
+	CHECK(s_largestAllocation <= LZ4Block::DecompressBound(payloadSize));
+	return loaded;
+}
+
+// Sizes no payload could expand to fail before anything is allocated
+static void TestInflatedRawSize()
+{
+	SKSESerializationInterface intfc = MakeInterface();
+	WriteCompressed(&intfc);
+	UInt32 rawSize;
+	memcpy(&rawSize, s_records[0].data.data(), sizeof(rawSize));
+	UInt32 payloadSize = s_records[0].data.size() - sizeof(rawSize);
+	CHECK(rawSize <= LZ4Block::DecompressBound(payloadSize));
+
+	CHECK(LoadWithRawSize(rawSize, payloadSize));
+	CHECK(!LoadWithRawSize(0xFFFFFFFF, payloadSize));
+	CHECK(!LoadWithRawSize((UInt32)LZ4Block::DecompressBound(payloadSize) + 1, payloadSize));
+	CHECK(!LoadWithRawSize(rawSize, 0));
+
+	// Within the bound the decoder still rejects a size that doesn't match
+	CHECK(!LoadWithRawSize(rawSize + 1, payloadSize));
+	CHECK(!LoadWithRawSize(rawSize - 1, payloadSize));
+	CHECK(!LoadWithRawSize(rawSize, payloadSize - 1));
+}
+
+// Readers fail on their own and leave the parent stream usable
+static void TestFailedLoadKeepsParent()
+{
+	SKSESerializationInterface intfc = MakeInterface();
+	WriteCompressed(&intfc);
+	intfc.WriteRecord('DDDD', 1, "x", 1);
+	UInt32 inflated = 0x7FFFFFFF;
+	memcpy(s_records[0].data.data(), &inflated, sizeof(inflated));
+
+	UInt32 type, version, length;
+	CHECK(intfc.GetNextRecordInfo(&type, &version, &length));
+	{
+		RecordReader reader(&intfc);
+		CHECK(!reader.Load(version, length));
+	}
+
+	CHECK(intfc.GetNextRecordInfo(&type, &version, &length));
+	CHECK(type == 'DDDD' && length == 1);
+}
+
+int main()
+{
+	TestRoundTrip();
+	TestInflatedRawSize();
+	TestFailedLoadKeepsParent();
+	return TEST_MAIN_RESULT();
+}
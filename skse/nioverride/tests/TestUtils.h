@@ -0,0 +1,30 @@
+#ifndef __TESTUTILS__
+#define __TESTUTILS__
+
+#pragma once
+
+#include <cstdio>
+#include <cmath>
+
+extern int g_failures;
+
+#define CHECK(expr) \
+	do { \
+		if (!(expr)) { \
+			fprintf(stderr, "%s(%d): CHECK(%s) failed\n", __FILE__, __LINE__, #expr); \
+			g_failures++; \
+		} \
+	} while (0)
+
+#define CHECK_NEAR(a, b, tolerance) \
+	do { \
+		double _a = (a), _b = (b); \
+		if (!(fabs(_a - _b) <= (tolerance))) { \
+			fprintf(stderr, "%s(%d): CHECK_NEAR(%s, %s) failed, %g vs %g\n", __FILE__, __LINE__, #a, #b, _a, _b); \
+			g_failures++; \
+		} \
+	} while (0)
+
+#define TEST_MAIN_RESULT() (g_failures ? (fprintf(stderr, "%d checks failed\n", g_failures), 1) : 0)
+
+#endif
@@ -0,0 +1,15 @@
+#pragma once
+
+// Stands in for the SKSE header, only the serialization record functions
+// the co-save streams redirect
+struct SKSESerializationInterface
+{
+	UInt32	version;
+
+	bool	(* WriteRecord)(UInt32 type, UInt32 version, const void * buf, UInt32 length);
+	bool	(* OpenRecord)(UInt32 type, UInt32 version);
+	bool	(* WriteRecordData)(const void * buf, UInt32 length);
+
+	bool	(* GetNextRecordInfo)(UInt32 * type, UInt32 * version, UInt32 * length);
+	UInt32	(* ReadRecordData)(void * buf, UInt32 length);
+};